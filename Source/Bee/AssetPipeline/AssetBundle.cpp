@@ -0,0 +1,620 @@
+/*
+ *  AssetBundle.cpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#include "Bee/AssetPipeline/AssetPipeline.inl"
+
+#include "Bee/Core/Plugin.hpp"
+#include "Bee/Core/Logger.hpp"
+#include "Bee/Core/Math/Math.hpp"
+#include "Bee/Core/Memory/Memory.hpp"
+
+#include <algorithm>
+
+
+namespace bee {
+
+
+extern AssetDatabaseModule g_assetdb;
+
+extern Result<void, AssetPipelineError> register_locator(AssetPipeline* pipeline, AssetLocator* locator);
+extern Result<void, AssetPipelineError> unregister_locator(AssetPipeline* pipeline, AssetLocator* locator);
+
+static constexpr u64 asset_bundle_name_seed = 0xB0B1E5;
+
+struct AssetBundle
+{
+    Path                        path;
+    const fs::MemoryMappedFile* mapping { nullptr };
+    AssetBundleTables           tables;
+    AssetLocator                locator;
+};
+
+static i32 find_blob(const AssetBundleBlob* blobs, const i32 count, const u128& content_hash)
+{
+    const auto* end = blobs + count;
+    const auto* blob = std::lower_bound(blobs, end, content_hash, [](const AssetBundleBlob& lhs, const u128& rhs)
+    {
+        return lhs.content_hash < rhs;
+    });
+    return blob != end && blob->content_hash == content_hash ? static_cast<i32>(blob - blobs) : -1;
+}
+
+/*
+ **********************************
+ *
+ * Bundle writer
+ *
+ **********************************
+ */
+static bool gather_bundle_assets(AssetTxn* txn, const AssetBundleWriteInfo& info, DynamicArray<GUID>* assets)
+{
+    DynamicHashMap<GUID, i32> visited;
+    DynamicArray<GUID> pending;
+    DynamicArray<GUID> sub_assets;
+
+    for (int i = info.asset_count - 1; i >= 0; --i)
+    {
+        pending.push_back(info.assets[i]);
+    }
+
+    while (!pending.empty())
+    {
+        const auto guid = pending.back();
+        pending.pop_back();
+
+        if (visited.find(guid) != nullptr)
+        {
+            continue;
+        }
+
+        if (!g_assetdb.asset_exists(txn, guid))
+        {
+            log_error("Cannot add asset %s to bundle: asset doesn't exist", format_guid(guid, GUIDFormat::digits));
+            return false;
+        }
+
+        visited.insert(guid, assets->size());
+        assets->push_back(guid);
+
+        if (!info.include_sub_assets)
+        {
+            continue;
+        }
+
+        auto sub_asset_count = g_assetdb.get_sub_assets(txn, guid, nullptr);
+        if (!sub_asset_count || sub_asset_count.unwrap() <= 0)
+        {
+            continue;
+        }
+
+        sub_assets.resize(sub_asset_count.unwrap());
+        g_assetdb.get_sub_assets(txn, guid, sub_assets.data());
+
+        for (const auto& sub_asset : sub_assets)
+        {
+            pending.push_back(sub_asset);
+        }
+    }
+
+    return true;
+}
+
+static bool write_bundle_blob(const fs::File& file, const AssetBundleWriteInfo& info, const PathView& artifact_path, AssetBundleBlob* blob)
+{
+    if (!artifact_path.exists())
+    {
+        log_error("Missing artifact %" BEE_PRIsv, BEE_FMT_SV(artifact_path));
+        return false;
+    }
+
+    const auto contents = fs::read_all_bytes(artifact_path);
+    const void* data = contents.data();
+    i64 size = contents.size();
+
+    DynamicArray<u8> compressed;
+
+    // The asset database might have already compressed the artifact so only compress if it's still raw
+    if (is_compressed_frame(contents.data(), contents.size()))
+    {
+        blob->flags = AssetBundleBlobFlags::compressed;
+        blob->uncompressed_size = sign_cast<u64>(get_decompressed_frame_size(contents.data(), contents.size()));
+    }
+    else
+    {
+        blob->uncompressed_size = sign_cast<u64>(size);
+
+        if (info.codec != CompressionCodec::none && compress_frame(info.codec, contents.data(), contents.size(), &compressed))
+        {
+            // Store incompressible artifacts as-is rather than paying to decompress them for nothing
+            if (compressed.size() < size)
+            {
+                blob->flags = AssetBundleBlobFlags::compressed;
+                data = compressed.data();
+                size = compressed.size();
+            }
+        }
+    }
+
+    blob->size = sign_cast<u64>(size);
+    return fs::write_at(file, sign_cast<i64>(blob->offset), data, size) == size;
+}
+
+template <typename T>
+static bool write_bundle_table(const fs::File& file, const u64 offset, const DynamicArray<T>& table)
+{
+    const auto size = static_cast<i64>(sizeof(T)) * table.size();
+    return size == 0 || fs::write_at(file, sign_cast<i64>(offset), table.data(), size) == size;
+}
+
+bool write_asset_bundle(
+    const PathView& path,
+    const AssetBundleWriteInfo& info,
+    const AssetBundleWriteAsset* assets_to_write,
+    const i32 asset_count,
+    get_bundle_artifact_path_t get_artifact_path,
+    void* user_data
+)
+{
+    if (BEE_FAIL_F(math::is_power_of_two(info.blob_alignment), "AssetBundleWriteInfo::blob_alignment must be a power of two"))
+    {
+        return false;
+    }
+
+    // The asset table is sorted by GUID and the artifacts are grouped by asset in the same order
+    DynamicArray<i32> order;
+    order.resize(asset_count);
+    for (int i = 0; i < asset_count; ++i)
+    {
+        order[i] = i;
+    }
+
+    std::sort(order.begin(), order.end(), [&](const i32 lhs, const i32 rhs)
+    {
+        return assets_to_write[lhs].guid < assets_to_write[rhs].guid;
+    });
+
+    DynamicArray<AssetBundleAsset> assets;
+    DynamicArray<AssetBundleName> names;
+    DynamicArray<AssetBundleArtifact> artifacts;
+    DynamicArray<AssetBundleBlob> blobs;
+    DynamicHashMap<u128, i32> blob_lookup;
+    String strings;
+
+    for (const auto index : order)
+    {
+        const auto& src = assets_to_write[index];
+
+        if (!assets.empty() && assets.back().guid == src.guid)
+        {
+            log_error("Cannot add asset %s to bundle: it was added more than once", format_guid(src.guid, GUIDFormat::digits));
+            return false;
+        }
+
+        if (src.artifact_count < 0 || src.artifact_count > BEE_ASSET_LOCATION_MAX_STREAMS)
+        {
+            log_error("Cannot add asset %s to bundle: it has more than %d artifacts", format_guid(src.guid, GUIDFormat::digits), BEE_ASSET_LOCATION_MAX_STREAMS);
+            return false;
+        }
+
+        assets.emplace_back();
+        assets.back().guid = src.guid;
+        assets.back().first_artifact = artifacts.size();
+        assets.back().artifact_count = src.artifact_count;
+
+        for (int i = 0; i < src.artifact_count; ++i)
+        {
+            const auto& artifact = src.artifacts[i];
+            artifacts.emplace_back();
+            artifacts.back().content_hash = artifact.content_hash;
+            artifacts.back().type_hash = artifact.type_hash;
+            artifacts.back().key = artifact.key;
+
+            // Artifacts shared between assets are only stored once
+            if (blob_lookup.find(artifact.content_hash) == nullptr)
+            {
+                blob_lookup.insert(artifact.content_hash, blobs.size());
+                blobs.emplace_back();
+                blobs.back().content_hash = artifact.content_hash;
+            }
+        }
+
+        if (!src.name.empty())
+        {
+            names.emplace_back();
+            names.back().hash = get_hash64(src.name.data(), src.name.size(), asset_bundle_name_seed);
+            names.back().string_offset = sign_cast<u32>(strings.size());
+            names.back().string_size = sign_cast<u32>(src.name.size());
+            names.back().asset_index = assets.size() - 1;
+            strings.append(src.name);
+        }
+    }
+
+    std::sort(names.begin(), names.end(), [](const AssetBundleName& lhs, const AssetBundleName& rhs)
+    {
+        return lhs.hash < rhs.hash;
+    });
+
+    std::sort(blobs.begin(), blobs.end(), [](const AssetBundleBlob& lhs, const AssetBundleBlob& rhs)
+    {
+        return lhs.content_hash < rhs.content_hash;
+    });
+
+    for (auto& artifact : artifacts)
+    {
+        artifact.blob_index = find_blob(blobs.data(), blobs.size(), artifact.content_hash);
+    }
+
+    // Lay out the tables back to back and start the blob data at the first aligned offset after them
+    AssetBundleHeader header{};
+    header.asset_count = assets.size();
+    header.name_count = names.size();
+    header.artifact_count = artifacts.size();
+    header.blob_count = blobs.size();
+    header.blob_alignment = info.blob_alignment;
+    header.strings_size = sign_cast<u32>(strings.size());
+    header.assets_offset = sizeof(AssetBundleHeader);
+    header.names_offset = header.assets_offset + sizeof(AssetBundleAsset) * assets.size();
+    header.artifacts_offset = header.names_offset + sizeof(AssetBundleName) * names.size();
+    header.blobs_offset = header.artifacts_offset + sizeof(AssetBundleArtifact) * artifacts.size();
+    header.strings_offset = header.blobs_offset + sizeof(AssetBundleBlob) * blobs.size();
+    header.data_offset = round_up(header.strings_offset + strings.size(), info.blob_alignment);
+
+    auto file = fs::open_file(path, fs::OpenMode::write);
+    if (!file)
+    {
+        return false;
+    }
+
+    Path artifact_path;
+    u64 blob_offset = header.data_offset;
+
+    for (auto& blob : blobs)
+    {
+        artifact_path.clear();
+        get_artifact_path(blob.content_hash, &artifact_path, user_data);
+
+        blob.offset = blob_offset;
+        if (!write_bundle_blob(file, info, artifact_path.view(), &blob))
+        {
+            return false;
+        }
+
+        blob_offset = round_up(blob.offset + blob.size, info.blob_alignment);
+    }
+
+    const auto tables_written = write_bundle_table(file, header.assets_offset, assets)
+        && write_bundle_table(file, header.names_offset, names)
+        && write_bundle_table(file, header.artifacts_offset, artifacts)
+        && write_bundle_table(file, header.blobs_offset, blobs)
+        && (strings.empty() || fs::write_at(file, sign_cast<i64>(header.strings_offset), strings.data(), strings.size()) == strings.size());
+
+    if (!tables_written)
+    {
+        return false;
+    }
+
+    // The header goes in last so a partially written bundle is never mistaken for a valid one
+    header.size = sign_cast<u64>(fs::get_size(file));
+    return fs::write_at(file, 0, &header, sizeof(AssetBundleHeader)) == sizeof(AssetBundleHeader);
+}
+
+static void get_database_artifact_path(const u128& content_hash, Path* dst, void* user_data)
+{
+    g_assetdb.get_artifact_path(static_cast<AssetTxn*>(user_data), content_hash, dst);
+}
+
+Result<void, AssetPipelineError> write_bundle(AssetPipeline* pipeline, const PathView& path, const AssetBundleWriteInfo& info)
+{
+    if (!pipeline->can_import())
+    {
+        return { AssetPipelineError::import };
+    }
+
+    auto txn = g_assetdb.read(pipeline->import.db);
+
+    DynamicArray<GUID> guids;
+    if (!gather_bundle_assets(&txn, info, &guids))
+    {
+        return { AssetPipelineError::failed_to_write_bundle };
+    }
+
+    DynamicArray<AssetBundleWriteAsset> assets;
+    DynamicArray<AssetBundleArtifact> artifacts;
+    DynamicArray<AssetArtifact> asset_artifacts;
+    assets.resize(guids.size());
+
+    for (int i = 0; i < guids.size(); ++i)
+    {
+        auto artifact_count = g_assetdb.get_artifacts(&txn, guids[i], nullptr);
+        if (!artifact_count)
+        {
+            return { AssetPipelineError::failed_to_write_bundle };
+        }
+
+        asset_artifacts.resize(artifact_count.unwrap());
+        g_assetdb.get_artifacts(&txn, guids[i], asset_artifacts.data());
+
+        auto& asset = assets[i];
+        asset.guid = guids[i];
+        asset.artifact_count = asset_artifacts.size();
+
+        for (const auto& artifact : asset_artifacts)
+        {
+            artifacts.emplace_back();
+            artifacts.back().content_hash = artifact.content_hash;
+            artifacts.back().type_hash = artifact.type_hash;
+            artifacts.back().key = artifact.key;
+        }
+
+        // The name points into the database so it's only valid until the transaction ends
+        auto name = g_assetdb.get_asset_name(&txn, guids[i]);
+        if (name)
+        {
+            asset.name = name.unwrap().to_string();
+        }
+    }
+
+    // Point the assets at their artifacts once the array has stopped growing
+    const auto* next_artifact = artifacts.data();
+    for (auto& asset : assets)
+    {
+        asset.artifacts = next_artifact;
+        next_artifact += asset.artifact_count;
+    }
+
+    if (!write_asset_bundle(path, info, assets.data(), assets.size(), get_database_artifact_path, &txn))
+    {
+        return { AssetPipelineError::failed_to_write_bundle };
+    }
+
+    return {};
+}
+
+/*
+ **********************************
+ *
+ * Bundle locator
+ *
+ **********************************
+ */
+static bool is_section_valid(const AssetBundleHeader& header, const u64 offset, const i32 count, const size_t element_size)
+{
+    return count >= 0 && offset <= header.size && sign_cast<u64>(count) * element_size <= header.size - offset;
+}
+
+bool is_valid_asset_bundle(const void* data, const i64 size)
+{
+    if (data == nullptr || size < static_cast<i64>(sizeof(AssetBundleHeader)))
+    {
+        return false;
+    }
+
+    const auto& header = *static_cast<const AssetBundleHeader*>(data);
+    if (header.magic != asset_bundle_magic || header.version != asset_bundle_version || header.size != sign_cast<u64>(size))
+    {
+        return false;
+    }
+
+    if (!math::is_power_of_two(header.blob_alignment)
+        || !is_section_valid(header, header.assets_offset, header.asset_count, sizeof(AssetBundleAsset))
+        || !is_section_valid(header, header.names_offset, header.name_count, sizeof(AssetBundleName))
+        || !is_section_valid(header, header.artifacts_offset, header.artifact_count, sizeof(AssetBundleArtifact))
+        || !is_section_valid(header, header.blobs_offset, header.blob_count, sizeof(AssetBundleBlob))
+        || !is_section_valid(header, header.strings_offset, sign_cast<i32>(header.strings_size), sizeof(char)))
+    {
+        return false;
+    }
+
+    // Check every index and offset once up-front so that locating assets doesn't have to
+    const auto tables = get_asset_bundle_tables(data);
+    const auto* assets = tables.assets;
+    const auto* names = tables.names;
+    const auto* artifacts = tables.artifacts;
+    const auto* blobs = tables.blobs;
+
+    for (int i = 0; i < header.asset_count; ++i)
+    {
+        const auto& asset = assets[i];
+        if (asset.first_artifact < 0 || asset.artifact_count < 0 || asset.artifact_count > BEE_ASSET_LOCATION_MAX_STREAMS || asset.first_artifact > header.artifact_count - asset.artifact_count)
+        {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < header.name_count; ++i)
+    {
+        const auto& name = names[i];
+        if (name.asset_index < 0 || name.asset_index >= header.asset_count || name.string_offset > header.strings_size || name.string_size > header.strings_size - name.string_offset)
+        {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < header.artifact_count; ++i)
+    {
+        if (artifacts[i].blob_index < 0 || artifacts[i].blob_index >= header.blob_count)
+        {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < header.blob_count; ++i)
+    {
+        if (blobs[i].offset < header.data_offset || blobs[i].offset > header.size || blobs[i].size > header.size - blobs[i].offset)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+AssetBundleTables get_asset_bundle_tables(const void* data)
+{
+    const auto* base = static_cast<const u8*>(data);
+
+    AssetBundleTables tables{};
+    tables.header = static_cast<const AssetBundleHeader*>(data);
+    tables.assets = reinterpret_cast<const AssetBundleAsset*>(base + tables.header->assets_offset);
+    tables.names = reinterpret_cast<const AssetBundleName*>(base + tables.header->names_offset);
+    tables.artifacts = reinterpret_cast<const AssetBundleArtifact*>(base + tables.header->artifacts_offset);
+    tables.blobs = reinterpret_cast<const AssetBundleBlob*>(base + tables.header->blobs_offset);
+    tables.strings = reinterpret_cast<const char*>(base + tables.header->strings_offset);
+    return tables;
+}
+
+i32 find_asset_bundle_asset(const AssetBundleTables& tables, const GUID& guid)
+{
+    const auto* end = tables.assets + tables.header->asset_count;
+    const auto* asset = std::lower_bound(tables.assets, end, guid, [](const AssetBundleAsset& lhs, const GUID& rhs)
+    {
+        return lhs.guid < rhs;
+    });
+    return asset != end && asset->guid == guid ? static_cast<i32>(asset - tables.assets) : -1;
+}
+
+i32 find_asset_bundle_asset(const AssetBundleTables& tables, const StringView& name)
+{
+    const auto hash = get_hash64(name.data(), name.size(), asset_bundle_name_seed);
+    const auto* end = tables.names + tables.header->name_count;
+    const auto* entry = std::lower_bound(tables.names, end, hash, [](const AssetBundleName& lhs, const u64 rhs)
+    {
+        return lhs.hash < rhs;
+    });
+
+    // Names with colliding hashes are adjacent so check each one against the actual string
+    for (; entry != end && entry->hash == hash; ++entry)
+    {
+        if (entry->string_size == sign_cast<u32>(name.size()) && memcmp(tables.strings + entry->string_offset, name.data(), name.size()) == 0)
+        {
+            return entry->asset_index;
+        }
+    }
+
+    return -1;
+}
+
+static bool locate_bundle_asset(const AssetKey& key, const Type type, AssetLocation* location, void* user_data)
+{
+    const auto* bundle = static_cast<const AssetBundle*>(user_data);
+
+    i32 asset_index = -1;
+    if (key.kind == AssetKey::Kind::guid)
+    {
+        asset_index = find_asset_bundle_asset(bundle->tables, key.guid);
+    }
+    else if (key.kind == AssetKey::Kind::name)
+    {
+        asset_index = find_asset_bundle_asset(bundle->tables, key.name.to_string());
+    }
+
+    if (asset_index < 0)
+    {
+        return false;
+    }
+
+    const auto& tables = bundle->tables;
+    const auto& asset = tables.assets[asset_index];
+    location->streams.size = asset.artifact_count;
+
+    if (asset.artifact_count > 0)
+    {
+        location->type = get_type(tables.artifacts[asset.first_artifact].type_hash);
+    }
+
+    // Every stream points into the same bundle file so loaders that map it share a single mapping
+    for (int i = 0; i < asset.artifact_count; ++i)
+    {
+        const auto& artifact = tables.artifacts[asset.first_artifact + i];
+        const auto& blob = tables.blobs[artifact.blob_index];
+        auto& stream = location->streams[i];
+
+        stream.kind = AssetStreamInfo::Kind::file;
+        stream.key = artifact.key;
+        stream.hash = artifact.content_hash;
+        stream.path = bundle->path;
+        // The next blob starts right after this one so loaders must only read `[offset, offset + size)`
+        stream.offset = static_cast<size_t>(blob.offset);
+        stream.size = static_cast<size_t>(blob.size);
+    }
+
+    return true;
+}
+
+Result<AssetBundle*, AssetPipelineError> mount_bundle(AssetPipeline* pipeline, const PathView& path)
+{
+    if (!pipeline->can_load())
+    {
+        return { AssetPipelineError::load };
+    }
+
+    const auto* mapping = fs::mmap_file_acquire_shared(path);
+    if (mapping == nullptr)
+    {
+        return { AssetPipelineError::missing_data };
+    }
+
+    if (!is_valid_asset_bundle(mapping->data, mapping->size))
+    {
+        log_error("%" BEE_PRIsv " is not a valid asset bundle", BEE_FMT_SV(path));
+        fs::mmap_file_release_shared(mapping);
+        return { AssetPipelineError::invalid_bundle };
+    }
+
+    // Index lookups jump around the tables rather than reading them in order
+    fs::mmap_file_advise(*mapping, fs::MemoryMappedAdvice::random);
+
+    auto* bundle = BEE_NEW(system_allocator(), AssetBundle);
+    bundle->path = path;
+    bundle->mapping = mapping;
+    bundle->tables = get_asset_bundle_tables(mapping->data);
+    bundle->locator.user_data = bundle;
+    bundle->locator.locate = locate_bundle_asset;
+
+    register_locator(pipeline, &bundle->locator);
+    pipeline->load.bundles.push_back(bundle);
+    return bundle;
+}
+
+Result<void, AssetPipelineError> unmount_bundle(AssetPipeline* pipeline, AssetBundle* bundle)
+{
+    if (!pipeline->can_load())
+    {
+        return { AssetPipelineError::load };
+    }
+
+    const auto index = find_index(pipeline->load.bundles, bundle);
+    if (index < 0)
+    {
+        return { AssetPipelineError::invalid_bundle };
+    }
+
+    // Assets that are already loaded keep working as loaders hold their own reference to the mapping
+    unregister_locator(pipeline, &bundle->locator);
+    pipeline->load.bundles.erase(index);
+    fs::mmap_file_release_shared(bundle->mapping);
+    BEE_DELETE(system_allocator(), bundle);
+    return {};
+}
+
+void destroy_asset_bundles(AssetPipeline* pipeline)
+{
+    while (!pipeline->load.bundles.empty())
+    {
+        unmount_bundle(pipeline, pipeline->load.bundles.back());
+    }
+}
+
+void set_asset_bundles(AssetPipelineModule* module, PluginLoader* loader, const PluginState state)
+{
+    module->write_bundle = write_bundle;
+    module->mount_bundle = mount_bundle;
+    module->unmount_bundle = unmount_bundle;
+}
+
+
+} // namespace bee
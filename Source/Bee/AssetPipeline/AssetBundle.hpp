@@ -0,0 +1,165 @@
+/*
+ *  AssetBundle.hpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#pragma once
+
+#include "Bee/Core/GUID.hpp"
+#include "Bee/Core/Compression.hpp"
+#include "Bee/Core/Path.hpp"
+
+
+namespace bee {
+
+
+/*
+ ********************************************************************************************************************
+ *
+ * # Asset bundles
+ *
+ * A single file containing the artifacts of a set of assets, used in shipping builds instead of the one-file-per-
+ * content-hash artifact cache written by the asset database. A bundle is laid out so that it can be used straight
+ * out of a memory mapping - every table is sorted so lookups are a binary search and every offset is relative to the
+ * start of the file:
+ *
+ * | Section                                  | Order                                            |
+ * |------------------------------------------|--------------------------------------------------|
+ * | `AssetBundleHeader`                      |                                                  |
+ * | `AssetBundleAsset[asset_count]`          | sorted by GUID                                   |
+ * | `AssetBundleName[name_count]`            | sorted by name hash                              |
+ * | `AssetBundleArtifact[artifact_count]`    | grouped by asset, in the asset database's order  |
+ * | `AssetBundleBlob[blob_count]`            | sorted by content hash, one per unique artifact  |
+ * | name strings                             |                                                  |
+ * | blob data                                | each blob aligned to `blob_alignment`            |
+ *
+ * Blobs are stored exactly as the asset database wrote them, or as compressed frames if the bundle was written with
+ * a codec, so loaders handle them the same way as artifacts loaded from the cache
+ *
+ ********************************************************************************************************************
+ */
+static constexpr u32 asset_bundle_magic = 0x4E424142; // 'BABN'
+static constexpr u32 asset_bundle_version = 1;
+
+struct AssetBundleHeader
+{
+    u32 magic { asset_bundle_magic };
+    u32 version { asset_bundle_version };
+    i32 asset_count { 0 };
+    i32 name_count { 0 };
+    i32 artifact_count { 0 };
+    i32 blob_count { 0 };
+    u32 blob_alignment { 0 };
+    u32 strings_size { 0 };
+    u64 assets_offset { 0 };
+    u64 names_offset { 0 };
+    u64 artifacts_offset { 0 };
+    u64 blobs_offset { 0 };
+    u64 strings_offset { 0 };
+    u64 data_offset { 0 };
+    u64 size { 0 };
+};
+
+struct AssetBundleAsset
+{
+    GUID    guid;
+    i32     first_artifact { 0 };
+    i32     artifact_count { 0 };
+};
+
+struct AssetBundleName
+{
+    u64     hash { 0 };
+    u32     string_offset { 0 };    // relative to `AssetBundleHeader::strings_offset`
+    u32     string_size { 0 };
+    i32     asset_index { -1 };
+    BEE_PAD(4);
+};
+
+struct AssetBundleArtifact
+{
+    u128    content_hash;
+    u32     type_hash { 0 };
+    u32     key { 0 };
+    i32     blob_index { -1 };
+    BEE_PAD(4);
+};
+
+BEE_FLAGS(AssetBundleBlobFlags, u32)
+{
+    none        = 0u,
+    compressed  = 1u << 0u
+};
+
+struct AssetBundleBlob
+{
+    u128                    content_hash;
+    u64                     offset { 0 };
+    u64                     size { 0 };
+    AssetBundleBlobFlags    flags { AssetBundleBlobFlags::none };
+    BEE_PAD(4);
+    u64                     uncompressed_size { 0 };
+};
+
+struct AssetBundleWriteInfo
+{
+    const GUID*         assets { nullptr };
+    i32                 asset_count { 0 };
+    u32                 blob_alignment { 4096 };            // must be a power of two
+    CompressionCodec    codec { CompressionCodec::none };   // compresses artifacts that aren't already compressed
+    bool                include_sub_assets { true };
+    BEE_PAD(6);
+};
+
+// An asset to pack into a bundle along with the artifacts it was imported with - `blob_index` is ignored
+struct AssetBundleWriteAsset
+{
+    GUID                        guid;
+    StringView                  name;
+    const AssetBundleArtifact*  artifacts { nullptr };
+    i32                         artifact_count { 0 };
+    BEE_PAD(4);
+};
+
+// Writes the path of the artifact file with `content_hash` into `dst` so its contents can be copied into a bundle
+using get_bundle_artifact_path_t = void(*)(const u128& content_hash, Path* dst, void* user_data);
+
+// The tables of a bundle that's been read or mapped into memory
+struct AssetBundleTables
+{
+    const AssetBundleHeader*    header { nullptr };
+    const AssetBundleAsset*     assets { nullptr };
+    const AssetBundleName*      names { nullptr };
+    const AssetBundleArtifact*  artifacts { nullptr };
+    const AssetBundleBlob*      blobs { nullptr };
+    const char*                 strings { nullptr };
+};
+
+/*
+ * Writes a bundle containing `assets` to `path`. `AssetPipelineModule::write_bundle` calls this once it's gathered the
+ * assets from the asset database - only the `blob_alignment` and `codec` members of `info` are used here
+ */
+BEE_ASSETPIPELINE_API bool write_asset_bundle(
+    const PathView& path,
+    const AssetBundleWriteInfo& info,
+    const AssetBundleWriteAsset* assets,
+    const i32 asset_count,
+    get_bundle_artifact_path_t get_artifact_path,
+    void* user_data
+);
+
+// Checks every section, index and offset in the bundle up-front so that its tables can be used without bounds checks
+BEE_ASSETPIPELINE_API bool is_valid_asset_bundle(const void* data, const i64 size);
+
+// `data` must be a bundle that passed `is_valid_asset_bundle`
+BEE_ASSETPIPELINE_API AssetBundleTables get_asset_bundle_tables(const void* data);
+
+// Returns the index of the asset in `tables.assets` or -1 if the bundle doesn't contain it
+BEE_ASSETPIPELINE_API i32 find_asset_bundle_asset(const AssetBundleTables& tables, const GUID& guid);
+
+BEE_ASSETPIPELINE_API i32 find_asset_bundle_asset(const AssetBundleTables& tables, const StringView& name);
+
+
+} // namespace bee
@@ -305,7 +305,7 @@ static void db_txn_list_remove(AssetTxnData* item)
     item->prev = item->next = nullptr;
 }
 
-static AssetTxnData* db_create_txn(AssetDatabase* db, const AssetTxnAccess access)
+static AssetTxnData* db_create_txn(AssetDatabase* db, const AssetTxnAccess access, AssetTxnData* parent = nullptr)
 {
     auto& thread = db_get_thread(db);
     auto txn = BEE_NEW(thread.txn_allocator, AssetTxnData);
@@ -313,8 +313,10 @@ static AssetTxnData* db_create_txn(AssetDatabase* db, const AssetTxnAccess acces
     txn->db = db;
     txn->access = access;
     txn->allocator = &thread.txn_allocator;
+    txn->parent = parent;
 
-    if (BEE_LMDB_FAIL(mdb_txn_begin(db->env, nullptr, access == AssetTxnAccess::read_only ? MDB_RDONLY : 0, &txn->handle)))
+    MDB_txn* parent_handle = parent != nullptr ? parent->handle : nullptr;
+    if (BEE_LMDB_FAIL(mdb_txn_begin(db->env, parent_handle, access == AssetTxnAccess::read_only ? MDB_RDONLY : 0, &txn->handle)))
     {
         BEE_DELETE(thread.txn_allocator, txn);
         return nullptr;
@@ -538,6 +540,15 @@ AssetTxn write(AssetDatabase* db)
     return { &g_assetdb, db_create_txn(db, AssetTxnAccess::read_write) };
 }
 
+AssetTxn write_nested(AssetTxn* parent)
+{
+    auto* parent_data = parent->data();
+    BEE_ASSERT(parent_data->access == AssetTxnAccess::read_write);
+    BEE_ASSERT_F(parent_data->thread == job_worker_id(), "Nested transactions must be created on the same thread as their parent");
+
+    return { &g_assetdb, db_create_txn(parent_data->db, AssetTxnAccess::read_write, parent_data) };
+}
+
 void abort(AssetTxn* txn)
 {
     auto* txn_data = txn->data();
@@ -545,17 +556,90 @@ void abort(AssetTxn* txn)
 
     mdb_txn_abort(txn_data->handle);
     txn_data->handle = nullptr;
+    txn_data->file_writes.abort();
 
     db_txn_list_remove(txn_data);
     db_txn_list_append(&thread.gc_transactions, txn_data);
 }
 
+// Deletes the artifacts removed in a committed transaction along with any artifact directories left empty
+static void commit_artifact_removals(AssetTxnData* txn)
+{
+    TempAllocScope tmp_alloc(txn->db);
+    DynamicArray<Path> artifact_dirs(tmp_alloc);
+
+    for (const auto& path : txn->file_writes.pending_removals())
+    {
+        const auto dir = path.parent();
+        const auto dir_index = find_index_if(artifact_dirs, [&](const Path& existing)
+        {
+            return existing == dir;
+        });
+
+        if (dir_index < 0)
+        {
+            artifact_dirs.emplace_back(dir, tmp_alloc);
+        }
+    }
+
+    txn->file_writes.commit_removals();
+
+    for (const auto& dir : artifact_dirs)
+    {
+        if (!dir.exists())
+        {
+            continue;
+        }
+
+        bool is_empty_artifact_dir = true;
+        for (const auto path : fs::read_dir(dir.view()))
+        {
+            if (fs::is_file(path))
+            {
+                is_empty_artifact_dir = false;
+                break;
+            }
+        }
+
+        if (is_empty_artifact_dir)
+        {
+            fs::rmdir(dir.view(), true);
+        }
+    }
+}
+
 bool commit(AssetTxn* txn)
 {
     auto* txn_data = txn->data();
     auto& thread = db_get_thread(txn->data()->db);
 
-    BEE_LMDB_ASSERT(mdb_txn_commit(txn_data->handle));
+    if (txn_data->parent != nullptr)
+    {
+        // The parent owns syncing the files so the whole batch of nested transactions only syncs once
+        BEE_LMDB_ASSERT(mdb_txn_commit(txn_data->handle));
+        txn_data->parent->file_writes.merge(&txn_data->file_writes);
+    }
+    else
+    {
+        /*
+         * Make sure every file written in the transaction is on disk before the database references them. If some of
+         * the files were already moved into place when a rename fails they're left on disk without the database
+         * knowing about them - artifacts are named by their content hash so this only leaves an unreferenced file
+         * behind and a `.meta` file that was replaced has a new timestamp so its source is reimported next time
+         */
+        if (!txn_data->file_writes.commit_writes())
+        {
+            log_error("Failed to write the transactions files to disk - aborting transaction");
+            abort(txn);
+            return false;
+        }
+
+        BEE_LMDB_ASSERT(mdb_txn_commit(txn_data->handle));
+
+        // Removed artifacts can only be deleted once the database no longer references them
+        commit_artifact_removals(txn_data);
+    }
+
     txn_data->handle = nullptr;
 
     db_txn_list_remove(txn_data);
@@ -882,7 +966,47 @@ bool is_read_only(AssetTxn* txn)
 
 u128 get_artifact_hash(const void* buffer, const size_t buffer_size)
 {
-    return get_hash128(buffer, buffer_size, 0x284fa80);
+    // Artifacts up to the parallel hash chunk size hash identically to a plain XXH3-128 hash, larger ones (cooked
+    // textures, meshes etc.) are tree-hashed across the job system
+    return get_parallel_hash128(buffer, buffer_size, 0x284fa80);
+}
+
+void set_artifact_compression(AssetDatabase* db, const Type artifact_type, const CompressionCodec codec)
+{
+    scoped_rw_write_lock_t lock(db->artifact_codecs_mutex);
+
+    auto* existing = db->artifact_codecs.find(artifact_type->hash);
+    if (existing != nullptr)
+    {
+        existing->value = codec;
+    }
+    else
+    {
+        db->artifact_codecs.insert(artifact_type->hash, codec);
+    }
+}
+
+CompressionCodec get_artifact_compression(AssetDatabase* db, const Type artifact_type)
+{
+    scoped_rw_read_lock_t lock(db->artifact_codecs_mutex);
+
+    const auto* codec = db->artifact_codecs.find(artifact_type->hash);
+    return codec != nullptr ? codec->value : CompressionCodec::none;
+}
+
+// Artifacts are shared between assets so one that's still on disk may have been removed by this transaction or one
+// of its parents in which case it needs to be written again to cancel the removal
+static bool is_artifact_pending_removal(AssetTxnData* txn, const PathView& artifact_path)
+{
+    for (auto* parent = txn; parent != nullptr; parent = parent->parent)
+    {
+        if (parent->file_writes.is_pending_removal(artifact_path))
+        {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 Result<u128, AssetDatabaseError> add_artifact_with_key(AssetTxn* txn, const GUID guid, const Type artifact_type, const u32 artifact_key, const void* buffer, const size_t buffer_size)
@@ -895,6 +1019,7 @@ Result<u128, AssetDatabaseError> add_artifact_with_key(AssetTxn* txn, const GUID
     }
 
     const u128 hash = get_artifact_hash(buffer, buffer_size);
+    const auto codec = get_artifact_compression(txn_data->db, artifact_type);
     TempAllocScope tmp_alloc(txn_data->db);
     Path artifact_path(tmp_alloc);
     get_artifact_path(txn, hash, &artifact_path);
@@ -924,7 +1049,7 @@ Result<u128, AssetDatabaseError> add_artifact_with_key(AssetTxn* txn, const GUID
         return { AssetDatabaseError::lmdb_error };;
     }
 
-    if (!artifact_path.exists())
+    if (!artifact_path.exists() || is_artifact_pending_removal(txn_data, artifact_path.view()))
     {
         auto artifact_dir = artifact_path.parent();
         if (!artifact_dir.exists())
@@ -932,7 +1057,22 @@ Result<u128, AssetDatabaseError> add_artifact_with_key(AssetTxn* txn, const GUID
             fs::mkdir(artifact_dir, true);
         }
 
-        if (!fs::write_all(artifact_path.view(), buffer, buffer_size))
+        const void* write_buffer = buffer;
+        size_t write_size = buffer_size;
+        DynamicArray<u8> compressed;
+
+        if (codec != CompressionCodec::none)
+        {
+            if (!compress_frame(codec, buffer, sign_cast<i64>(buffer_size), &compressed))
+            {
+                return { AssetDatabaseError::failed_to_write_artifact_to_disk };
+            }
+
+            write_buffer = compressed.data();
+            write_size = sign_cast<size_t>(compressed.size());
+        }
+
+        if (!txn_data->file_writes.write(artifact_path.view(), write_buffer, sign_cast<i64>(write_size)))
         {
             return { AssetDatabaseError::failed_to_write_artifact_to_disk };
         }
@@ -941,6 +1081,24 @@ Result<u128, AssetDatabaseError> add_artifact_with_key(AssetTxn* txn, const GUID
     return hash;
 }
 
+Result<u64, AssetDatabaseError> write_file(AssetTxn* txn, const PathView& path, const void* buffer, const size_t buffer_size)
+{
+    auto* txn_data = txn->data();
+
+    if (txn_data->access != AssetTxnAccess::read_write)
+    {
+        return { AssetDatabaseError::invalid_access };
+    }
+
+    u64 last_modified = 0;
+    if (!txn_data->file_writes.write(path, buffer, sign_cast<i64>(buffer_size), &last_modified))
+    {
+        return { AssetDatabaseError::failed_to_write_file_to_disk };
+    }
+
+    return last_modified;
+}
+
 Result<u128, AssetDatabaseError> add_artifact(AssetTxn* txn, const GUID guid, const Type artifact_type, const void* buffer, const size_t buffer_size)
 {
     return add_artifact_with_key(txn, guid, artifact_type, 0, buffer, buffer_size);
@@ -981,30 +1139,12 @@ Result<void, AssetDatabaseError> remove_artifact(AssetTxn* txn, const GUID guid,
         return {};
     }
 
-    // delete the artifact from disk if no more guids reference it
+    // delete the artifact from disk if no more guids reference it - this is staged until the transaction commits so
+    // aborting it doesn't leave the database referencing a file that's gone
     TempAllocScope tmp_alloc(txn_data->db);
     Path artifact_path(tmp_alloc);
     get_artifact_path(txn, hash, &artifact_path);
-    if (!fs::remove(artifact_path.view()))
-    {
-        return { AssetDatabaseError::failed_to_write_artifact_to_disk };
-    }
-
-    // Remove the directory if this is the last artifact file remaining
-    bool is_empty_artifact_dir = true;
-    for (const auto path : fs::read_dir(artifact_path.parent()))
-    {
-        if (fs::is_file(path))
-        {
-            is_empty_artifact_dir = false;
-            break;
-        }
-    }
-
-    if (is_empty_artifact_dir)
-    {
-        fs::rmdir(artifact_path.parent(), true);
-    }
+    txn_data->file_writes.remove(artifact_path.view());
 
     return {};
 }
@@ -1187,6 +1327,7 @@ void set_asset_database_module(bee::PluginLoader* loader, const bee::PluginState
     g_assetdb.gc = bee::gc;
     g_assetdb.read = bee::read;
     g_assetdb.write = bee::write;
+    g_assetdb.write_nested = bee::write_nested;
     g_assetdb.abort = bee::abort;
     g_assetdb.commit = bee::commit;
     g_assetdb.is_valid_txn = bee::is_valid_txn;
@@ -1214,9 +1355,12 @@ void set_asset_database_module(bee::PluginLoader* loader, const bee::PluginState
     g_assetdb.get_artifact_path = bee::get_artifact_path;
     g_assetdb.add_artifact = bee::add_artifact;
     g_assetdb.add_artifact_with_key = bee::add_artifact_with_key;
+    g_assetdb.set_artifact_compression = bee::set_artifact_compression;
+    g_assetdb.get_artifact_compression = bee::get_artifact_compression;
     g_assetdb.remove_artifact = bee::remove_artifact;
     g_assetdb.remove_all_artifacts = bee::remove_all_artifacts;
     g_assetdb.get_artifacts = bee::get_artifacts;
+    g_assetdb.write_file = bee::write_file;
 
     g_assetdb.add_dependency = bee::add_dependency;
     g_assetdb.remove_dependency = bee::remove_dependency;
@@ -10,6 +10,7 @@
 #include "Bee/Core/Path.hpp"
 #include "Bee/Core/GUID.hpp"
 #include "Bee/Core/Serialization/StreamSerializer.hpp"
+#include "Bee/Core/Compression.hpp"
 #include "Bee/Core/Result.hpp"
 #include "Bee/Core/Handle.hpp"
 
@@ -87,6 +88,7 @@ struct AssetDatabaseError
         invalid_access,
         not_found,
         failed_to_write_artifact_to_disk,
+        failed_to_write_file_to_disk,
         lmdb_error,
         guid_exists,
         unknown
@@ -103,6 +105,7 @@ struct AssetDatabaseError
             "Attempted to modify an asset in a read-only transaction",                      // invalid_access
             "Asset not found",                                                              // not_found
             "Failed to write artifact buffer to disk",                                      // failed_to_write_artifact_to_disk
+            "Failed to write file to disk",                                                 // failed_to_write_file_to_disk
             "LMDB error",                                                                   // lmdb_error
             "An asset already exists with the provided GUID",                               // guid_exists
         );
@@ -172,6 +175,11 @@ struct AssetDatabaseModule
 
     AssetTxn (*write)(AssetDatabase* db) { nullptr };
 
+    // Begins a write transaction inside `parent` on the same thread. Committing it hands its changes and files to the
+    // parent, aborting it discards them without affecting the parent - files are only synced to disk once when the
+    // outermost transaction commits
+    AssetTxn (*write_nested)(AssetTxn* parent) { nullptr };
+
     void (*abort)(AssetTxn* txn) { nullptr };
 
     bool (*commit)(AssetTxn* txn) { nullptr };
@@ -221,12 +229,23 @@ struct AssetDatabaseModule
 
     Result<u128, AssetDatabaseError> (*add_artifact_with_key)(AssetTxn*, const GUID guid, const Type artifact_type, const u32 key, const void* buffer, const size_t buffer_size) { nullptr };
 
+    // Artifacts of `artifact_type` added after this call are written to disk as compressed frames using `codec`.
+    // Artifact hashes are always calculated from the uncompressed data
+    void (*set_artifact_compression)(AssetDatabase* db, const Type artifact_type, const CompressionCodec codec) { nullptr };
+
+    CompressionCodec (*get_artifact_compression)(AssetDatabase* db, const Type artifact_type) { nullptr };
+
     Result<void, AssetDatabaseError> (*remove_artifact)(AssetTxn* txn, const GUID guid, const u128& hash) { nullptr };
 
     Result<void, AssetDatabaseError> (*remove_all_artifacts)(AssetTxn* txn, const GUID guid) { nullptr };
 
     Result<i32, AssetDatabaseError> (*get_artifacts)(AssetTxn* txn, const GUID guid, AssetArtifact* dst) { nullptr };
 
+    // Writes a file (i.e. a .meta file) atomically alongside the transactions artifacts. It's moved into place and
+    // synced to disk when the outermost transaction is committed and discarded if it's aborted. Returns the
+    // modification time the file will have once committed
+    Result<u64, AssetDatabaseError> (*write_file)(AssetTxn* txn, const PathView& path, const void* buffer, const size_t buffer_size) { nullptr };
+
     Result<void, AssetDatabaseError> (*add_dependency)(AssetTxn* txn, const GUID guid, const GUID dependency) { nullptr };
 
     Result<void, AssetDatabaseError> (*remove_dependency)(AssetTxn* txn, const GUID guid, const GUID dependency) { nullptr };
@@ -10,6 +10,9 @@
 #include "Bee/AssetPipeline/AssetDatabase.hpp"
 
 #include "Bee/Core/Reflection.hpp"
+#include "Bee/Core/Concurrency.hpp"
+#include "Bee/Core/Containers/HashMap.hpp"
+#include "Bee/Core/Filesystem.hpp"
 #include "Bee/Core/Memory/LinearAllocator.hpp"
 #include "Bee/Core/Memory/ChunkAllocator.hpp"
 
@@ -63,6 +66,11 @@ struct AssetTxnData
     AssetDatabase*          db { nullptr };
     Allocator*              allocator { nullptr };
     MDB_txn*                handle { nullptr };
+    AssetTxnData*           parent { nullptr };
+
+    // artifacts and other files written or removed in the transaction - nested transactions merge theirs into the
+    // parent so they're only applied once the outermost transaction commits
+    fs::FileWriteBatch      file_writes;
 };
 
 struct AssetDatabase
@@ -83,6 +91,10 @@ struct AssetDatabase
     BEE_PAD(8 - (sizeof(db_maps) % 8));
     RecursiveMutex          gc_mutex;
     FixedArray<ThreadData>  thread_data;
+
+    // artifact type hash -> codec used when writing artifacts of that type to disk
+    ReaderWriterMutex                           artifact_codecs_mutex;
+    DynamicHashMap<u32, CompressionCodec>       artifact_codecs;
 };
 
 struct TempAllocScope
@@ -35,6 +35,12 @@ Result<void, AssetPipelineError> init_import_pipeline(AssetPipeline* pipeline, c
         return { AssetPipelineError::asset_database };
     }
 
+    // The journal only lets startup skip unchanged files so the pipeline still works without it
+    if (!import_pipeline.file_states.open(import_pipeline.cache_path.join("FileStates.journal").view()))
+    {
+        log_warning("Failed to open the file state journal - all source files will be checked against the asset database");
+    }
+
     // start the source asset watcher after adding all the new source roots
     for (int i = 0; i < info.source_root_count; ++i)
     {
@@ -67,6 +73,7 @@ void destroy_import_pipeline(AssetPipeline* pipeline)
 //    }
 
     pipeline->import.source_watcher.stop();
+    pipeline->import.file_states.close();
     g_assetdb.close(pipeline->import.db);
 }
 
@@ -79,6 +86,16 @@ static FileTypeInfo& add_file_type(ImportPipeline* pipeline, const char* file_ty
     return info;
 }
 
+/*
+ * Importer hashes are written to .meta files so they have to stay on XXH32 with the original seed rather than going
+ * through `Hash<T>`, which is free to change between versions
+ */
+static u32 get_importer_hash(const AssetImporter* importer)
+{
+    const char* name = importer->name();
+    return get_hash(name, str::length(name), 0xF00D);
+}
+
 Result<void, AssetPipelineError> register_importer(AssetPipeline* pipeline, AssetImporter* importer, void* user_data)
 {
     if (!pipeline->can_import())
@@ -89,7 +106,7 @@ Result<void, AssetPipelineError> register_importer(AssetPipeline* pipeline, Asse
     auto& import_pipeline = pipeline->import;
 
     // Check if the importer has already been registered
-    const u32 hash = get_hash(importer->name());
+    const u32 hash = get_importer_hash(importer);
     const int existing_index = find_index(import_pipeline.importer_hashes, hash);
 
     if (existing_index >= 0)
@@ -139,7 +156,7 @@ Result<void, AssetPipelineError> unregister_importer(AssetPipeline* pipeline, As
     }
 
     auto& import_pipeline = pipeline->import;
-    const u32 hash = get_hash(importer->name());
+    const u32 hash = get_importer_hash(importer);
     const int index = find_index(import_pipeline.importer_hashes, hash);
 
     if (index < 0)
@@ -188,7 +205,32 @@ static i32 get_default_importer_for_file_type(const ImportPipeline& pipeline, co
     return -1;
 }
 
-Result<void, AssetPipelineError> import_asset(AssetPipeline* pipeline, const PathView& path, const AssetPlatform platform)
+// Returns the path of the source file for either the source itself or its .meta file
+static StringView get_source_path(const PathView& path)
+{
+    if (path.extension() != ".meta")
+    {
+        return path.string_view();
+    }
+
+    // the path with extensions except for the .meta part
+    return str::substring(path.string_view(), 0, str::first_index_of(path.string_view(), ".meta"));
+}
+
+/*
+ * `source_entry` and `meta_entry` are the already-scanned directory entries for the source and .meta file if the
+ * caller has them - this lets importing a whole directory skip stat-ing every file again to check its timestamps.
+ * The asset is imported in a transaction nested inside `batch` so a failed import doesn't affect the rest of the
+ * batch and the files written by every asset in it are only synced to disk once when `batch` is committed
+ */
+static Result<void, AssetPipelineError> import_asset(
+    AssetPipeline* pipeline,
+    AssetTxn* batch,
+    const PathView& path,
+    const AssetPlatform platform,
+    const fs::DirectoryEntryInfo* source_entry,
+    const fs::DirectoryEntryInfo* meta_entry
+)
 {
     if (!pipeline->can_import())
     {
@@ -198,19 +240,13 @@ Result<void, AssetPipelineError> import_asset(AssetPipeline* pipeline, const Pat
     auto& thread = pipeline->get_thread();
     thread.meta_path.clear();
     thread.source_path.clear();
+    thread.source_path.append(get_source_path(path));
     if (path.extension() == ".meta")
     {
         thread.meta_path.append(path);
-        // the path with extensions except for the .meta part
-        thread.source_path.append(str::substring(
-            path.string_view(),
-            0,
-            str::first_index_of(path.string_view(), ".meta")
-        ));
     }
     else
     {
-        thread.source_path.append(path);
         thread.meta_path.append(path).append_extension(".meta");
     }
 
@@ -222,13 +258,15 @@ Result<void, AssetPipelineError> import_asset(AssetPipeline* pipeline, const Pat
         return { AssetPipelineError::unsupported_file_type };
     }
 
-    auto txn = g_assetdb.write(pipeline->import.db);
+    auto txn = g_assetdb.write_nested(batch);
 
     AssetMetadata meta{};
     bool is_new_file = true;
 
+    const bool has_meta_file = source_entry != nullptr ? meta_entry != nullptr : fs::is_file(thread.meta_path.view());
+
     // If the file exists on disk - use it as source metadata info
-    if (fs::is_file(thread.meta_path.view()))
+    if (has_meta_file)
     {
         auto json = fs::read_all_text(thread.meta_path.view(), temp_allocator());
         JSONSerializer serializer(json.data(), JSONSerializeFlags::parse_in_situ, temp_allocator());
@@ -281,12 +319,23 @@ Result<void, AssetPipelineError> import_asset(AssetPipeline* pipeline, const Pat
         info = res.unwrap();
     }
 
-    const u64 new_timestamp = fs::last_modified(thread.source_path.view());
-    const u64 new_meta_timestamp = fs::last_modified(thread.meta_path.view());
+    u64 new_timestamp = 0;
+    u64 new_meta_timestamp = 0;
+
+    if (source_entry != nullptr)
+    {
+        new_timestamp = source_entry->last_modified;
+        new_meta_timestamp = meta_entry != nullptr ? meta_entry->last_modified : 0;
+    }
+    else
+    {
+        new_timestamp = fs::last_modified(thread.source_path.view());
+        new_meta_timestamp = has_meta_file ? fs::last_modified(thread.meta_path.view()) : 0;
+    }
 
     // if the timestamps are up to date and the meta file exists (i.e. hasn't been deleted for whatever reason)
     // then there's no need to re-import the asset as it hasn't been modified
-    if (new_timestamp == info.timestamp && new_meta_timestamp == info.meta_timestamp && thread.meta_path.exists())
+    if (new_timestamp == info.timestamp && new_meta_timestamp == info.meta_timestamp && has_meta_file)
     {
         return {};
     }
@@ -356,22 +405,25 @@ Result<void, AssetPipelineError> import_asset(AssetPipeline* pipeline, const Pat
 
     JSONSerializer serializer(temp_allocator());
     serialize(SerializerMode::writing, &serializer, &meta, temp_allocator());
+    const StringView meta_json(serializer.c_str());
+    auto meta_res = g_assetdb.write_file(&txn, thread.meta_path.view(), meta_json.data(), sign_cast<size_t>(meta_json.size()));
+    if (!meta_res)
     {
-        if (!fs::write_all(thread.meta_path.view(), serializer.c_str()))
-        {
-            return { AssetPipelineError::failed_to_write_metadata };
-        }
+        return { AssetPipelineError::failed_to_write_metadata };
     }
 
-    // Set the metadata timestamp after writing the file to disk
-    info.meta_timestamp = fs::last_modified(thread.meta_path.view());
+    // The .meta file is written along with the artifacts when the transaction commits but its timestamp is known now
+    info.meta_timestamp = meta_res.unwrap();
     res = g_assetdb.set_asset_info(&txn, info);
     if (!res)
     {
         return { AssetPipelineError::failed_to_write_metadata };
     }
 
-    txn.commit();
+    if (!txn.commit())
+    {
+        return { AssetPipelineError::failed_to_write_metadata };
+    }
 
     log_info("Imported %s", thread.source_path.c_str());
 
@@ -388,22 +440,177 @@ Result<AssetDatabase*, AssetPipelineError> get_asset_database(AssetPipeline* pip
     return pipeline->import.db;
 }
 
+Result<void, AssetPipelineError> import_asset(AssetPipeline* pipeline, const PathView& path, const AssetPlatform platform)
+{
+    if (!pipeline->can_import())
+    {
+        return { AssetPipelineError::import };
+    }
+
+    auto batch = g_assetdb.write(pipeline->import.db);
+    auto res = import_asset(pipeline, &batch, path, platform, nullptr, nullptr);
+    if (!res)
+    {
+        return res;
+    }
+
+    if (!batch.commit())
+    {
+        return { AssetPipelineError::failed_to_write_metadata };
+    }
+
+    return {};
+}
+
+static bool is_importable_file(const PathView& path, const fs::DirectoryEntryType type, void* user_data)
+{
+    if (type == fs::DirectoryEntryType::directory)
+    {
+        return true;
+    }
+
+    const auto ext = path.extension();
+    if (ext == ".meta")
+    {
+        return true;
+    }
+
+    const auto* import_pipeline = static_cast<const ImportPipeline*>(user_data);
+    return find_index(import_pipeline->file_type_hashes, get_hash(ext)) >= 0;
+}
+
+// A source imported as part of a batch - its file states can only be recorded once the batch is committed and its
+// .meta file has been moved into place
+struct ImportedSource
+{
+    Path                            path;
+    const fs::DirectoryEntryInfo*   entry { nullptr };
+    u128                            hash;
+};
+
+// Records the state of an imported source and its .meta file so the next startup can skip them if unchanged
+static void record_file_states(AssetPipeline* pipeline, const ImportedSource& source)
+{
+    auto& journal = pipeline->import.file_states;
+    if (!journal.is_open())
+    {
+        return;
+    }
+
+    auto& thread = pipeline->get_thread();
+    fs::DirectoryEntryInfo info{};
+
+    if (source.entry != nullptr)
+    {
+        journal.record(*source.entry, source.hash);
+    }
+    else if (fs::get_entry_info(source.path.view(), &info))
+    {
+        journal.record(info);
+    }
+
+    // Importing rewrites the .meta file so it always needs to be read again
+    thread.meta_path.clear();
+    thread.meta_path.append(source.path.view()).append_extension(".meta");
+
+    if (fs::get_entry_info(thread.meta_path.view(), &info))
+    {
+        journal.record(info);
+    }
+}
+
+static void commit_import_batch(AssetPipeline* pipeline, AssetTxn* batch, const Span<const ImportedSource>& imported)
+{
+    if (!batch->commit())
+    {
+        log_error("Failed to commit a batch of %d imported assets", imported.size());
+        return;
+    }
+
+    for (const auto& source : imported)
+    {
+        record_file_states(pipeline, source);
+    }
+}
+
+/*
+ * The journal and the asset database are stored separately so the journal can't be trusted on its own - the database
+ * may have been deleted or rebuilt since the journal was written, in which case unchanged files still need importing
+ */
+static bool is_source_in_asset_database(AssetTxn* batch, const PathView& source_path)
+{
+    auto guid = g_assetdb.get_guid_from_path(batch, source_path.string_view());
+    return guid && g_assetdb.asset_exists(batch, guid.unwrap());
+}
+
 static void import_assets_at_path(AssetPipeline* pipeline, const PathView& root)
 {
-    for (auto& entry : fs::read_dir(root))
+    // Only files with a registered importer (and their .meta files) are returned so nothing else is ever stat-ed
+    fs::DirectoryScanInfo scan_info{};
+    scan_info.recursive = true;
+    scan_info.filter = is_importable_file;
+    scan_info.filter_user_data = &pipeline->import;
+
+    DynamicArray<fs::DirectoryEntryInfo> entries;
+    if (!fs::scan_dir(root, scan_info, &entries))
+    {
+        return;
+    }
+
+    // Pair up the sources with their .meta files so their timestamps can be diffed without touching the disk again
+    DynamicHashMap<StringView, i32> meta_files;
+    for (int i = 0; i < entries.size(); ++i)
     {
-        if (fs::is_dir(entry))
+        const auto path = entries[i].path.view();
+        if (path.extension() == ".meta")
+        {
+            meta_files.insert(str::substring(path.string_view(), 0, path.size() - 5), i);
+        }
+    }
+
+    // Everything under the root is imported in one batch so the files are only synced to disk once
+    auto batch = g_assetdb.write(pipeline->import.db);
+    DynamicArray<ImportedSource> imported;
+
+    for (auto& entry : entries)
+    {
+        if (entry.type != fs::DirectoryEntryType::file || entry.path.extension() == ".meta")
         {
-            import_assets_at_path(pipeline, entry);
             continue;
         }
 
-        auto res = import_asset(pipeline, entry, AssetPlatform::unknown);
+        auto* meta = meta_files.find(entry.path.string_view());
+        const auto* meta_entry = meta != nullptr ? &entries[meta->value] : nullptr;
+        u128 source_hash{};
+
+        // Skip parsing the .meta file and importing entirely if neither file has changed
+        if (meta_entry != nullptr && pipeline->import.file_states.is_open())
+        {
+            const auto source_change = pipeline->import.file_states.check(entry, &source_hash);
+            const auto meta_change = pipeline->import.file_states.check(*meta_entry);
+
+            if (source_change == fs::FileStateChange::unchanged
+                && meta_change == fs::FileStateChange::unchanged
+                && is_source_in_asset_database(&batch, entry.path.view()))
+            {
+                continue;
+            }
+        }
+
+        auto res = import_asset(pipeline, &batch, entry.path.view(), AssetPlatform::unknown, &entry, meta_entry);
         if (!res)
         {
-            log_error("%" BEE_PRIsv ": %s", BEE_FMT_SV(entry), res.unwrap_error().to_string());
+            log_error("%s: %s", entry.path.c_str(), res.unwrap_error().to_string());
+            continue;
         }
+
+        imported.emplace_back();
+        imported.back().path = entry.path;
+        imported.back().entry = &entry;
+        imported.back().hash = source_hash;
     }
+
+    commit_import_batch(pipeline, &batch, imported.const_span());
 }
 
 void add_import_root(AssetPipeline* pipeline, const PathView& path)
@@ -436,6 +643,16 @@ Result<void, AssetPipelineError> refresh_import_pipeline(AssetPipeline* pipeline
 {
     pipeline->import.source_watcher.pop_events(&pipeline->import.source_events);
 
+    if (pipeline->import.source_events.empty())
+    {
+        g_assetdb.gc(pipeline->import.db);
+        return {};
+    }
+
+    // Everything changed since the last refresh is imported in one batch so the files are only synced to disk once
+    auto batch = g_assetdb.write(pipeline->import.db);
+    DynamicArray<ImportedSource> imported;
+
     for (auto& event : pipeline->import.source_events)
     {
         switch (event.action)
@@ -443,11 +660,24 @@ Result<void, AssetPipelineError> refresh_import_pipeline(AssetPipeline* pipeline
             case fs::FileAction::added:
             case fs::FileAction::modified:
             {
-                import_asset(pipeline, event.file.view(), AssetPlatform::unknown);
+                // The .meta file isn't moved into place until the batch is committed so importing the same source again
+                // would read the old one - the first import already read the latest version of the source anyway
+                const auto source_path = get_source_path(event.file.view());
+                const auto imported_index = find_index_if(imported, [&](const ImportedSource& source)
+                {
+                    return source.path.string_view() == source_path;
+                });
+
+                if (imported_index < 0 && import_asset(pipeline, &batch, event.file.view(), AssetPlatform::unknown, nullptr, nullptr))
+                {
+                    imported.emplace_back();
+                    imported.back().path = source_path;
+                }
                 break;
             }
             case fs::FileAction::removed:
             {
+                pipeline->import.file_states.remove(event.file.view());
                 // TODO(Jacob): get guid from path and delete
                 break;
             }
@@ -455,6 +685,7 @@ Result<void, AssetPipelineError> refresh_import_pipeline(AssetPipeline* pipeline
         }
     }
 
+    commit_import_batch(pipeline, &batch, imported.const_span());
     g_assetdb.gc(pipeline->import.db);
     return {};
 }
@@ -288,15 +288,11 @@ Result<AssetHandle, AssetPipelineError> load_asset_from_key(AssetPipeline* pipel
 
     auto& loader = load_pipeline.loaders[loader_id->value];
 
-    // lock the loader resource pool and allocate the asset info & id
-    AssetId asset_id{};
+    // allocate the asset info & id - the loaders asset pool is lock-free so this is safe to do from any thread
+    const auto asset_id = loader.assets.allocate();
+    if (!asset_id.is_valid())
     {
-        scoped_recursive_lock_t lock(loader.mutex);
-        asset_id = loader.assets.allocate();
-        if (!asset_id.is_valid())
-        {
-            return { AssetPipelineError::failed_to_allocate };
-        }
+        return { AssetPipelineError::failed_to_allocate };
     }
 
     auto& asset = loader.assets[asset_id];
@@ -311,8 +307,7 @@ Result<AssetHandle, AssetPipelineError> load_asset_from_key(AssetPipeline* pipel
     auto res = loader.instance->load(asset.guid, &asset.location, loader.user_data, handle, asset.data.data());
     if (!res)
     {
-        // Lock the pool and deallocate immediately if the load failed for whatever reason
-        scoped_recursive_lock_t lock(loader.mutex);
+        // Deallocate immediately if the load failed for whatever reason
         loader.assets.deallocate(asset_id);
         return res.unwrap_error();
     }
@@ -28,6 +28,9 @@ extern void destroy_load_pipeline(AssetPipeline* pipeline);
 extern Result<void, AssetPipelineError> refresh_load_pipeline(AssetPipeline* pipeline);
 extern void set_load_pipeline(AssetPipelineModule* module, PluginLoader* loader, const PluginState state);
 
+extern void destroy_asset_bundles(AssetPipeline* pipeline);
+extern void set_asset_bundles(AssetPipelineModule* module, PluginLoader* loader, const PluginState state);
+
 /*
  **********************************
  *
@@ -91,6 +94,7 @@ void destroy_pipeline(AssetPipeline* pipeline)
 
     if (pipeline->can_load())
     {
+        destroy_asset_bundles(pipeline);
         destroy_load_pipeline(pipeline);
         destruct(&pipeline->load);
     }
@@ -142,6 +146,7 @@ BEE_PLUGIN_API void bee_load_plugin(bee::PluginLoader* loader, const bee::Plugin
     bee::set_asset_database_module(loader, state);
     bee::set_import_pipeline(&g_module, loader, state);
     bee::set_load_pipeline(&g_module, loader, state);
+    bee::set_asset_bundles(&g_module, loader, state);
 
     loader->set_module(BEE_ASSET_PIPELINE_MODULE_NAME, &g_module, state);
 }
\ No newline at end of file
@@ -11,6 +11,7 @@
 #include "Bee/Core/Serialization/BinarySerializer.hpp"
 
 #include "Bee/AssetPipeline/AssetDatabase.hpp"
+#include "Bee/AssetPipeline/AssetBundle.hpp"
 
 
 namespace bee {
@@ -36,6 +37,7 @@ struct AssetPipelineError
         failed_to_write_artifacts,
         failed_to_update_dependencies,
         failed_to_update_sub_assets,
+        failed_to_write_bundle,
 
         load,
         failed_to_locate,
@@ -48,6 +50,7 @@ struct AssetPipelineError
         invalid_data,
         loader_type_conflict,
         invalid_loader,
+        invalid_bundle,
         count
     };
 
@@ -69,6 +72,7 @@ struct AssetPipelineError
             "Failed to write artifacts",                                        // failed_to_write_artifacts
             "Failed to update dependencies",                                    // failed_to_update_dependencies
             "Failed to update sub_assets",                                      // failed_to_update_sub_assets
+            "Failed to write asset bundle",                                     // failed_to_write_bundle
 
             "Load stage is not enabled",                                        // load
             "Failed to locate asset from GUID",                                 // failed_to_locate
@@ -81,6 +85,7 @@ struct AssetPipelineError
             "Asset data has an invalid format or is corrupted",                 // invalid_data
             "A loader is already registered for that asset type",               // loader_type_conflict
             "The AssetLoader is not a valid or registered loader",              // invalid_loader
+            "Asset bundle has an invalid format or is corrupted",               // invalid_bundle
         )
     }
 };
@@ -404,6 +409,7 @@ struct AssetPipelineInfo
 };
 
 struct AssetDatabase;
+struct AssetBundle;
 struct AssetPipeline;
 struct AssetPipelineModule
 {
@@ -476,6 +482,19 @@ struct AssetPipelineModule
 
         return BEE_MOVE(asset);
     }
+
+    /*
+     ***************
+     * Bundle API
+     ***************
+     */
+    // Packs the artifacts of the assets in `info` into a single bundle file - requires the import stage
+    Result<void, AssetPipelineError> (*write_bundle)(AssetPipeline* pipeline, const PathView& path, const AssetBundleWriteInfo& info) { nullptr };
+
+    // Maps a bundle and registers a locator that resolves asset keys from it - requires the load stage
+    Result<AssetBundle*, AssetPipelineError> (*mount_bundle)(AssetPipeline* pipeline, const PathView& path) { nullptr };
+
+    Result<void, AssetPipelineError> (*unmount_bundle)(AssetPipeline* pipeline, AssetBundle* bundle) { nullptr };
 };
 
 template <typename T>
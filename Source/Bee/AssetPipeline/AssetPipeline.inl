@@ -11,6 +11,7 @@
 
 #include "Bee/Core/Path.hpp"
 #include "Bee/Core/Filesystem.hpp"
+#include "Bee/Core/FileStateJournal.hpp"
 #include "Bee/Core/Containers/ResourcePool.hpp"
 #include "Bee/Core/Atomic.hpp"
 
@@ -44,6 +45,7 @@ struct ImportPipeline
     Path                                cache_path;
     Path                                db_path;
     AssetDatabase*                      db { nullptr };
+    fs::FileStateJournal                file_states;
     fs::DirectoryWatcher                source_watcher;
     DynamicArray<fs::FileNotifyInfo>    source_events;
     AssetLocator                        asset_database_locator;
@@ -92,11 +94,10 @@ struct LoadedAsset
 
 struct Loader
 {
-    AssetLoader*                        instance { nullptr };
-    void*                               user_data { nullptr };
-    FixedArray<Type>                    types;
-    ResourcePool<AssetId, LoadedAsset>  assets;
-    RecursiveMutex                      mutex;
+    AssetLoader*                                instance { nullptr };
+    void*                                       user_data { nullptr };
+    FixedArray<Type>                            types;
+    AtomicResourcePool<AssetId, LoadedAsset>    assets;
 
     Loader()
         : assets(sizeof(LoadedAsset) * 64)
@@ -106,6 +107,7 @@ struct Loader
 struct LoadPipeline
 {
     DynamicArray<AssetLocator*>         locators;
+    DynamicArray<AssetBundle*>          bundles;
     ResourcePool<LoaderId, Loader>      loaders;
     DynamicHashMap<Type, LoaderId>      type_to_loader;
     DynamicHashMap<u32, AssetHandle>    cache;
@@ -130,8 +132,8 @@ struct AssetPipeline
     {
         DynamicArray<u8>            artifact_buffer;
         DynamicArray<AssetHandle>   pending_unloads;
-        Path                        meta_path;
-        Path                        source_path;
+        StaticPath<>                meta_path;
+        StaticPath<>                source_path;
         String                      target_platform_string;
         DynamicArray<u8>            settings_buffer;
     };
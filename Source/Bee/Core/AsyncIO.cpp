@@ -0,0 +1,493 @@
+/*
+ *  AsyncIO.cpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#include "Bee/Core/AsyncIO.hpp"
+#include "Bee/Core/Jobs/JobSystem.hpp"
+#include "Bee/Core/Logger.hpp"
+#include "Bee/Core/Math/Math.hpp"
+
+
+namespace bee {
+namespace fs {
+
+
+#if BEE_OS_LINUX == 1
+// Implemented in Linux_AsyncIO.cpp
+bool native_async_io_init(const AsyncIOInitInfo& info);
+
+void native_async_io_shutdown();
+
+void native_async_io_submit(AsyncIORequest* requests, const i32 count);
+
+bool native_async_io_register_buffers(const AsyncIOBuffer* buffers, const i32 count);
+
+void native_async_io_unregister_buffers();
+#endif // BEE_OS_LINUX == 1
+
+
+struct AsyncIOThreadPool
+{
+    Mutex               mutex;
+    ConditionVariable   cv;
+    AsyncIORequest*     head { nullptr };
+    AsyncIORequest*     tail { nullptr };
+    bool                is_shutting_down { false };
+    BEE_PAD(7);
+    DynamicArray<Thread> threads;
+};
+
+struct AsyncIOContext
+{
+    std::atomic_bool                initialized { false };
+    BEE_PAD(3);
+    AsyncIOBackend                  backend { AsyncIOBackend::none };
+    i32                             queue_depth { 0 };
+    i32                             queued_count { 0 };
+    SpinLock                        queue_mutex;
+    AsyncIORequest*                 queued_head { nullptr };
+    AsyncIORequest*                 queued_tail { nullptr };
+    DynamicArray<AsyncIOBuffer>     registered_buffers;
+    AsyncIOThreadPool               thread_pool;
+
+    // async_io_wait sleeps on this until a request completes
+    Mutex                           wait_mutex;
+    ConditionVariable               wait_cv;
+    std::atomic_int32_t             waiter_count { 0 };
+};
+
+static AsyncIOContext g_async_io;
+
+
+AsyncIORequest::~AsyncIORequest()
+{
+    BEE_ASSERT_F(!is_pending(), "AsyncIORequest was destroyed while it was still in flight");
+}
+
+// Called by the backend from any thread once the OS has finished with the request
+void complete_async_request(AsyncIORequest* request, const i64 result, const i32 error)
+{
+    // The request can be destroyed by its owner as soon as its status changes so nothing else can touch it after that
+    auto* job = request->job;
+    request->job = nullptr;
+    request->next = nullptr;
+    request->result = result;
+    request->error = error;
+    request->status.store(static_cast<i32>(error == 0 ? AsyncIOStatus::complete : AsyncIOStatus::failed), std::memory_order_seq_cst);
+
+    // Waiters check the status under the lock so taking it here means they're either asleep or about to see the new
+    // status - either way the request itself isn't touched again
+    if (g_async_io.waiter_count.load(std::memory_order_seq_cst) > 0)
+    {
+        {
+            scoped_lock_t lock(g_async_io.wait_mutex);
+        }
+        g_async_io.wait_cv.notify_all();
+    }
+
+    if (job != nullptr)
+    {
+        job_complete_external(job);
+    }
+}
+
+
+/*
+ ********************************************
+ *
+ * Thread pool backend - implementation
+ *
+ ********************************************
+ */
+static void thread_pool_worker(AsyncIOThreadPool* pool)
+{
+    while (true)
+    {
+        AsyncIORequest* request = nullptr;
+        {
+            scoped_lock_t lock(pool->mutex);
+            pool->cv.wait(lock, [&]()
+            {
+                return pool->head != nullptr || pool->is_shutting_down;
+            });
+
+            if (pool->head == nullptr)
+            {
+                return;
+            }
+
+            request = pool->head;
+            pool->head = request->next;
+            if (pool->head == nullptr)
+            {
+                pool->tail = nullptr;
+            }
+        }
+
+        i64 result = 0;
+        i32 error = 0;
+
+        if (request->operation == AsyncIOOperation::read)
+        {
+            result = read_at(*request->file, request->offset, request->size, request->buffer);
+            // read_at returns the bytes read so far if it fails so a short read that stops before the end of the file is an error
+            if (result < request->size && request->offset + result < get_size(*request->file))
+            {
+                error = -1;
+            }
+        }
+        else
+        {
+            result = write_at(*request->file, request->offset, request->buffer, request->size);
+            // short writes are always an error - short reads just mean the request reached the end of the file
+            error = result == request->size ? 0 : -1;
+        }
+
+        complete_async_request(request, result, error);
+    }
+}
+
+static void thread_pool_init(const AsyncIOInitInfo& info)
+{
+    auto& pool = g_async_io.thread_pool;
+    pool.is_shutting_down = false;
+
+    ThreadCreateInfo thread_info{};
+    StaticString<BEE_THREAD_MAX_NAME> thread_name;
+
+    for (int i = 0; i < math::max(1, info.thread_pool_size); ++i)
+    {
+        str::format_buffer(&thread_name, "Bee.AsyncIO%d", i + 1);
+        thread_info.name = thread_name.c_str();
+        pool.threads.emplace_back(thread_info, &thread_pool_worker, &pool);
+    }
+}
+
+static void thread_pool_shutdown()
+{
+    auto& pool = g_async_io.thread_pool;
+    {
+        scoped_lock_t lock(pool.mutex);
+        pool.is_shutting_down = true;
+    }
+
+    // Workers drain the remaining requests before exiting
+    pool.cv.notify_all();
+
+    for (auto& thread : pool.threads)
+    {
+        thread.join();
+    }
+
+    pool.threads.clear();
+}
+
+static void thread_pool_submit(AsyncIORequest* requests, const i32 count)
+{
+    auto& pool = g_async_io.thread_pool;
+
+    auto* last = requests;
+    while (last->next != nullptr)
+    {
+        last = last->next;
+    }
+
+    {
+        scoped_lock_t lock(pool.mutex);
+        if (pool.tail == nullptr)
+        {
+            pool.head = requests;
+        }
+        else
+        {
+            pool.tail->next = requests;
+        }
+        pool.tail = last;
+    }
+
+    if (count == 1)
+    {
+        pool.cv.notify_one();
+    }
+    else
+    {
+        pool.cv.notify_all();
+    }
+}
+
+
+/*
+ ********************************************
+ *
+ * Async IO API - implementation
+ *
+ ********************************************
+ */
+bool async_io_init(const AsyncIOInitInfo& info)
+{
+    if (BEE_FAIL_F(!g_async_io.initialized.load(), "Async IO is already initialized"))
+    {
+        return false;
+    }
+
+    g_async_io.queue_depth = math::max(1, info.queue_depth);
+    g_async_io.backend = AsyncIOBackend::thread_pool;
+
+#if BEE_OS_LINUX == 1
+    if (!info.force_thread_pool && native_async_io_init(info))
+    {
+        g_async_io.backend = AsyncIOBackend::io_uring;
+    }
+#endif // BEE_OS_LINUX == 1
+
+    if (g_async_io.backend == AsyncIOBackend::thread_pool)
+    {
+        thread_pool_init(info);
+    }
+
+    g_async_io.initialized.store(true, std::memory_order_release);
+    return true;
+}
+
+void async_io_shutdown()
+{
+    if (!g_async_io.initialized.load())
+    {
+        return;
+    }
+
+    async_io_submit();
+
+    switch (g_async_io.backend)
+    {
+        case AsyncIOBackend::thread_pool:
+        {
+            thread_pool_shutdown();
+            break;
+        }
+#if BEE_OS_LINUX == 1
+        case AsyncIOBackend::io_uring:
+        {
+            native_async_io_shutdown();
+            break;
+        }
+#endif // BEE_OS_LINUX == 1
+        default:
+        {
+            break;
+        }
+    }
+
+    g_async_io.registered_buffers.clear();
+    g_async_io.backend = AsyncIOBackend::none;
+    g_async_io.initialized.store(false, std::memory_order_release);
+}
+
+bool is_async_io_running()
+{
+    return g_async_io.initialized.load(std::memory_order_acquire);
+}
+
+AsyncIOBackend async_io_backend()
+{
+    return g_async_io.backend;
+}
+
+static bool queue_request(AsyncIORequest* request, JobGroup* group)
+{
+    if (BEE_FAIL_F(g_async_io.initialized.load(std::memory_order_acquire), "Async IO is not initialized"))
+    {
+        return false;
+    }
+
+    if (BEE_FAIL_F(!request->is_pending(), "AsyncIORequest is already in flight"))
+    {
+        return false;
+    }
+
+    if (BEE_FAIL_F(request->file != nullptr && request->file->is_valid(), "Invalid file for async IO request"))
+    {
+        return false;
+    }
+
+    request->result = 0;
+    request->error = 0;
+    request->next = nullptr;
+    request->job = group != nullptr ? job_add_external(group) : nullptr;
+    request->buffer_index = -1;
+
+    const auto* begin = static_cast<const u8*>(request->buffer);
+    for (int i = 0; i < g_async_io.registered_buffers.size(); ++i)
+    {
+        const auto* registered = static_cast<const u8*>(g_async_io.registered_buffers[i].data);
+        if (begin >= registered && begin + request->size <= registered + g_async_io.registered_buffers[i].size)
+        {
+            request->buffer_index = i;
+            break;
+        }
+    }
+
+    request->status.store(static_cast<i32>(AsyncIOStatus::queued), std::memory_order_release);
+
+    bool is_queue_full = false;
+    {
+        scoped_spinlock_t lock(g_async_io.queue_mutex);
+
+        if (g_async_io.queued_tail == nullptr)
+        {
+            g_async_io.queued_head = request;
+        }
+        else
+        {
+            g_async_io.queued_tail->next = request;
+        }
+
+        g_async_io.queued_tail = request;
+        ++g_async_io.queued_count;
+        is_queue_full = g_async_io.queued_count >= g_async_io.queue_depth;
+    }
+
+    if (is_queue_full)
+    {
+        async_io_submit();
+    }
+
+    return true;
+}
+
+bool async_read(AsyncIORequest* request, const File& file, const i64 offset, const i64 size, void* buffer, JobGroup* group)
+{
+    request->operation = AsyncIOOperation::read;
+    request->file = &file;
+    request->offset = offset;
+    request->size = size;
+    request->buffer = buffer;
+    return queue_request(request, group);
+}
+
+bool async_write(AsyncIORequest* request, const File& file, const i64 offset, const void* buffer, const i64 size, JobGroup* group)
+{
+    request->operation = AsyncIOOperation::write;
+    request->file = &file;
+    request->offset = offset;
+    request->size = size;
+    request->buffer = const_cast<void*>(buffer);
+    return queue_request(request, group);
+}
+
+i32 async_io_submit()
+{
+    AsyncIORequest* requests = nullptr;
+    i32 count = 0;
+    {
+        scoped_spinlock_t lock(g_async_io.queue_mutex);
+        requests = g_async_io.queued_head;
+        count = g_async_io.queued_count;
+        g_async_io.queued_head = nullptr;
+        g_async_io.queued_tail = nullptr;
+        g_async_io.queued_count = 0;
+    }
+
+    if (requests == nullptr)
+    {
+        return 0;
+    }
+
+    // The status has to change before the requests are handed over as they can complete at any time afterwards
+    for (auto* request = requests; request != nullptr; request = request->next)
+    {
+        request->status.store(static_cast<i32>(AsyncIOStatus::pending), std::memory_order_release);
+    }
+
+    switch (g_async_io.backend)
+    {
+        case AsyncIOBackend::thread_pool:
+        {
+            thread_pool_submit(requests, count);
+            break;
+        }
+#if BEE_OS_LINUX == 1
+        case AsyncIOBackend::io_uring:
+        {
+            native_async_io_submit(requests, count);
+            break;
+        }
+#endif // BEE_OS_LINUX == 1
+        default:
+        {
+            BEE_UNREACHABLE("Invalid async IO backend");
+        }
+    }
+
+    return count;
+}
+
+bool async_io_wait(AsyncIORequest* request)
+{
+    if (request->get_status() == AsyncIOStatus::queued)
+    {
+        async_io_submit();
+    }
+
+    if (request->is_pending())
+    {
+        g_async_io.waiter_count.fetch_add(1, std::memory_order_seq_cst);
+        {
+            scoped_lock_t lock(g_async_io.wait_mutex);
+            g_async_io.wait_cv.wait(lock, [&]()
+            {
+                // seq_cst pairs with the status store and waiter count load in complete_async_request
+                const auto status = static_cast<AsyncIOStatus>(request->status.load(std::memory_order_seq_cst));
+                return status != AsyncIOStatus::queued && status != AsyncIOStatus::pending;
+            });
+        }
+        g_async_io.waiter_count.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    return request->get_status() == AsyncIOStatus::complete;
+}
+
+bool async_io_register_buffers(const AsyncIOBuffer* buffers, const i32 count)
+{
+    if (BEE_FAIL_F(g_async_io.initialized.load(std::memory_order_acquire), "Async IO is not initialized"))
+    {
+        return false;
+    }
+
+    async_io_unregister_buffers();
+
+#if BEE_OS_LINUX == 1
+    if (g_async_io.backend == AsyncIOBackend::io_uring && !native_async_io_register_buffers(buffers, count))
+    {
+        return false;
+    }
+#endif // BEE_OS_LINUX == 1
+
+    // The thread pool has nothing to register but the buffers are still tracked so requests behave the same
+    g_async_io.registered_buffers.append(Span<const AsyncIOBuffer>(buffers, count));
+    return true;
+}
+
+void async_io_unregister_buffers()
+{
+    if (g_async_io.registered_buffers.empty())
+    {
+        return;
+    }
+
+#if BEE_OS_LINUX == 1
+    if (g_async_io.backend == AsyncIOBackend::io_uring)
+    {
+        native_async_io_unregister_buffers();
+    }
+#endif // BEE_OS_LINUX == 1
+
+    g_async_io.registered_buffers.clear();
+}
+
+
+} // namespace fs
+} // namespace bee
@@ -0,0 +1,150 @@
+/*
+ *  AsyncIO.hpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#pragma once
+
+#include "Bee/Core/Filesystem.hpp"
+
+
+namespace bee {
+
+
+class Job;
+class JobGroup;
+
+
+namespace fs {
+
+
+/*
+ ********************************************************************************************************************
+ *
+ * # Asynchronous file IO
+ *
+ * Reads and writes are queued with `async_read`/`async_write` and submitted to the OS in batches - on Linux this uses
+ * io_uring so a whole batch is a single syscall, otherwise (or if io_uring isn't available) requests are executed on
+ * a small pool of IO threads with `read_at`/`write_at`.
+ *
+ * Requests are owned by the caller and must stay alive, along with their file, buffer and job group, until they
+ * complete. Passing a `JobGroup` adds a job to the group that completes with the request so that `job_wait` can be
+ * used to wait for a batch of IO while the waiting thread helps execute other jobs instead of blocking on the disk
+ *
+ ********************************************************************************************************************
+ */
+enum class AsyncIOStatus : i32
+{
+    none,
+    queued,
+    pending,
+    complete,
+    failed
+};
+
+enum class AsyncIOOperation : u8
+{
+    read,
+    write
+};
+
+enum class AsyncIOBackend : i32
+{
+    none,
+    thread_pool,
+    io_uring
+};
+
+struct AsyncIOInitInfo
+{
+    i32     queue_depth { 256 };        // max number of requests that can be in flight at once
+    i32     thread_pool_size { 2 };     // number of IO threads used by the thread pool backend
+    bool    force_thread_pool { false };
+    BEE_PAD(7);
+};
+
+struct AsyncIOBuffer
+{
+    void*   data { nullptr };
+    i64     size { 0 };
+};
+
+struct BEE_CORE_API AsyncIORequest final : public Noncopyable
+{
+    std::atomic_int32_t status { static_cast<i32>(AsyncIOStatus::none) };
+    AsyncIOOperation    operation { AsyncIOOperation::read };
+    BEE_PAD(3);
+    const File*         file { nullptr };
+    i64                 offset { 0 };
+    i64                 size { 0 };
+    void*               buffer { nullptr };
+    i64                 result { 0 };           // bytes transferred
+    i32                 error { 0 };            // native error code if the request failed
+    i32                 buffer_index { -1 };    // index of the registered buffer containing `buffer` if any
+    Job*                job { nullptr };
+    AsyncIORequest*     next { nullptr };
+
+    AsyncIORequest() = default;
+
+    ~AsyncIORequest();
+
+    inline AsyncIOStatus get_status() const
+    {
+        return static_cast<AsyncIOStatus>(status.load(std::memory_order_acquire));
+    }
+
+    inline bool is_complete() const
+    {
+        const auto current = get_status();
+        return current == AsyncIOStatus::complete || current == AsyncIOStatus::failed;
+    }
+
+    inline bool is_pending() const
+    {
+        const auto current = get_status();
+        return current == AsyncIOStatus::queued || current == AsyncIOStatus::pending;
+    }
+
+    inline i64 bytes_transferred() const
+    {
+        return get_status() == AsyncIOStatus::complete ? result : 0;
+    }
+};
+
+
+BEE_CORE_API bool async_io_init(const AsyncIOInitInfo& info);
+
+BEE_CORE_API void async_io_shutdown();
+
+BEE_CORE_API bool is_async_io_running();
+
+BEE_CORE_API AsyncIOBackend async_io_backend();
+
+/*
+ * Queues a read of `size` bytes at `offset` into `buffer`. Requests aren't sent to the OS until `async_io_submit` is
+ * called or the queue fills up. Reads that reach the end of the file complete with fewer bytes than requested
+ */
+BEE_CORE_API bool async_read(AsyncIORequest* request, const File& file, const i64 offset, const i64 size, void* buffer, JobGroup* group = nullptr);
+
+BEE_CORE_API bool async_write(AsyncIORequest* request, const File& file, const i64 offset, const void* buffer, const i64 size, JobGroup* group = nullptr);
+
+// Submits all queued requests in a single batch and returns the number of requests submitted
+BEE_CORE_API i32 async_io_submit();
+
+// Submits all queued requests and blocks until `request` completes. Returns false if the request failed
+BEE_CORE_API bool async_io_wait(AsyncIORequest* request);
+
+/*
+ * Registers buffers with the kernel so that requests reading into or writing from them skip mapping the buffer pages
+ * for every request. Requests whose buffer is inside a registered buffer use it automatically. Registering replaces
+ * any previously registered buffers and both functions must only be called when no requests are in flight
+ */
+BEE_CORE_API bool async_io_register_buffers(const AsyncIOBuffer* buffers, const i32 count);
+
+BEE_CORE_API void async_io_unregister_buffers();
+
+
+} // namespace fs
+} // namespace bee
@@ -45,6 +45,22 @@ BEE_FORCE_INLINE u32 count_trailing_zeroes(const u32 value)
 #endif // BEE_COMPILER_*
 };
 
+BEE_FORCE_INLINE u32 count_trailing_zeroes_64(const u64 value)
+{
+#if BEE_COMPILER_GCC == 1 || BEE_COMPILER_CLANG == 1
+    return static_cast<u32>(__builtin_ctzll(value));
+#elif BEE_COMPILER_MSVC == 1
+    unsigned long result = 0;
+    if (_BitScanForward64(&result, value))
+    {
+        return result;
+    }
+    return 64u;
+#else
+    #error Unsupported platform
+#endif // BEE_COMPILER_*
+}
+
 /**
  * # count_leading_zeroes
  *
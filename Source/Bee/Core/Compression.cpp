@@ -0,0 +1,829 @@
+/*
+ *  Compression.cpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#include "Bee/Core/Compression.hpp"
+#include "Bee/Core/Math/Math.hpp"
+#include "Bee/Core/Jobs/JobSystem.hpp"
+#include "Bee/Core/Logger.hpp"
+
+#include <string.h>
+#include <inttypes.h>
+
+
+namespace bee {
+
+
+/*
+ *****************************************
+ *
+ * LZ codec - uses the LZ4 block format:
+ *
+ * each sequence is a token byte (4 bits
+ * literal length, 4 bits match length)
+ * followed by the extended literal
+ * length, the literals, a 2 byte match
+ * offset and the extended match length.
+ * The last sequence is literals only
+ *
+ *****************************************
+ */
+static constexpr i32 lz_min_match = 4;
+static constexpr i32 lz_last_literals = 5;     // the last 5 bytes of a block are always literals
+static constexpr i32 lz_match_find_limit = 12; // the last match must start at least 12 bytes before the end
+static constexpr i32 lz_max_offset = 65535;
+static constexpr i32 lz_hash_bits = 12;
+static constexpr i32 lz_skip_trigger = 6;      // search step increases for every 2^6 bytes without a match
+
+static inline u32 lz_read32(const u8* ptr)
+{
+    u32 value = 0;
+    memcpy(&value, ptr, sizeof(u32));
+    return value;
+}
+
+static inline u32 lz_hash(const u32 sequence)
+{
+    return (sequence * 2654435761u) >> (32 - lz_hash_bits);
+}
+
+static inline u8* lz_write_length(u8* dst, i32 length)
+{
+    while (length >= 255)
+    {
+        *dst++ = 255;
+        length -= 255;
+    }
+
+    *dst++ = static_cast<u8>(length);
+    return dst;
+}
+
+static u8* lz_write_sequence(u8* dst, const u8* literals, const i32 literal_count, const i32 match_offset, const i32 match_length)
+{
+    auto* token = dst++;
+
+    if (literal_count >= 15)
+    {
+        *token = 15u << 4u;
+        dst = lz_write_length(dst, literal_count - 15);
+    }
+    else
+    {
+        *token = static_cast<u8>(literal_count << 4);
+    }
+
+    memcpy(dst, literals, literal_count);
+    dst += literal_count;
+
+    // the last sequence in a block has no match
+    if (match_length <= 0)
+    {
+        return dst;
+    }
+
+    *dst++ = static_cast<u8>(match_offset & 0xFF);
+    *dst++ = static_cast<u8>((match_offset >> 8) & 0xFF);
+
+    const auto length = match_length - lz_min_match;
+    if (length >= 15)
+    {
+        *token |= 15u;
+        dst = lz_write_length(dst, length - 15);
+    }
+    else
+    {
+        *token |= static_cast<u8>(length);
+    }
+
+    return dst;
+}
+
+static i32 lz_compress_bound(const i32 src_size)
+{
+    return src_size + src_size / 255 + 16;
+}
+
+static i32 lz_compress(const u8* src, const i32 src_size, u8* dst)
+{
+    i32 table[1 << lz_hash_bits];
+    memset(table, 0, sizeof(table));
+
+    auto* op = dst;
+    i32 anchor = 0;
+
+    if (src_size > lz_match_find_limit)
+    {
+        const auto match_limit = src_size - lz_match_find_limit;
+        const auto extend_limit = src_size - lz_last_literals;
+        i32 ip = 1;
+
+        while (ip <= match_limit)
+        {
+            const auto sequence = lz_read32(src + ip);
+            const auto hash = lz_hash(sequence);
+            auto candidate = table[hash];
+            table[hash] = ip;
+
+            const auto is_match = candidate < ip
+                && ip - candidate <= lz_max_offset
+                && lz_read32(src + candidate) == sequence;
+
+            if (!is_match)
+            {
+                // skip through incompressible data faster the longer it's been since the last match
+                ip += 1 + ((ip - anchor) >> lz_skip_trigger);
+                continue;
+            }
+
+            // extend the match backwards into the pending literals
+            while (ip > anchor && candidate > 0 && src[ip - 1] == src[candidate - 1])
+            {
+                --ip;
+                --candidate;
+            }
+
+            auto match_end = ip + lz_min_match;
+            auto candidate_end = candidate + lz_min_match;
+
+            while (match_end < extend_limit && src[match_end] == src[candidate_end])
+            {
+                ++match_end;
+                ++candidate_end;
+            }
+
+            op = lz_write_sequence(op, src + anchor, ip - anchor, ip - candidate, match_end - ip);
+
+            // seed the table with the position just before the end of the match so runs are found quickly
+            if (match_end - 2 <= match_limit)
+            {
+                table[lz_hash(lz_read32(src + match_end - 2))] = match_end - 2;
+            }
+
+            ip = match_end;
+            anchor = ip;
+        }
+    }
+
+    op = lz_write_sequence(op, src + anchor, src_size - anchor, 0, 0);
+    return static_cast<i32>(op - dst);
+}
+
+static i32 lz_decompress(const u8* src, const i32 src_size, u8* dst, const i32 dst_size)
+{
+    i64 ip = 0;
+    i64 op = 0;
+
+    while (true)
+    {
+        if (ip >= src_size)
+        {
+            return -1;
+        }
+
+        const auto token = src[ip++];
+        i64 literal_count = token >> 4u;
+
+        if (literal_count == 15)
+        {
+            u8 length_byte = 255;
+            while (length_byte == 255)
+            {
+                if (ip >= src_size)
+                {
+                    return -1;
+                }
+                length_byte = src[ip++];
+                literal_count += length_byte;
+            }
+        }
+
+        if (literal_count > src_size - ip || literal_count > dst_size - op)
+        {
+            return -1;
+        }
+
+        memcpy(dst + op, src + ip, literal_count);
+        ip += literal_count;
+        op += literal_count;
+
+        // The last sequence is literals only
+        if (ip == src_size)
+        {
+            break;
+        }
+
+        if (ip + 2 > src_size)
+        {
+            return -1;
+        }
+
+        const i64 offset = src[ip] | (src[ip + 1] << 8u);
+        ip += 2;
+
+        if (offset == 0 || offset > op)
+        {
+            return -1;
+        }
+
+        i64 match_length = token & 15u;
+
+        if (match_length == 15)
+        {
+            u8 length_byte = 255;
+            while (length_byte == 255)
+            {
+                if (ip >= src_size)
+                {
+                    return -1;
+                }
+                length_byte = src[ip++];
+                match_length += length_byte;
+            }
+        }
+
+        match_length += lz_min_match;
+
+        if (match_length > dst_size - op)
+        {
+            return -1;
+        }
+
+        auto* match = dst + op - offset;
+
+        if (offset >= match_length)
+        {
+            memcpy(dst + op, match, match_length);
+        }
+        else
+        {
+            // overlapping matches repeat the last `offset` bytes so have to be copied forwards one byte at a time
+            for (i64 i = 0; i < match_length; ++i)
+            {
+                dst[op + i] = match[i];
+            }
+        }
+
+        op += match_length;
+    }
+
+    return static_cast<i32>(op);
+}
+
+
+/*
+ *****************************************
+ *
+ * Block codec API
+ *
+ *****************************************
+ */
+const char* compression_codec_name(const CompressionCodec codec)
+{
+    switch (codec)
+    {
+        case CompressionCodec::none:
+        {
+            return "none";
+        }
+        case CompressionCodec::lz:
+        {
+            return "lz";
+        }
+        default: break;
+    }
+
+    return "unknown";
+}
+
+i32 compress_bound(const CompressionCodec codec, const i32 src_size)
+{
+    switch (codec)
+    {
+        case CompressionCodec::none:
+        {
+            return src_size;
+        }
+        case CompressionCodec::lz:
+        {
+            return lz_compress_bound(src_size);
+        }
+        default: break;
+    }
+
+    BEE_UNREACHABLE("Invalid compression codec");
+}
+
+i32 compress_block(const CompressionCodec codec, const void* src, const i32 src_size, void* dst, const i32 dst_capacity)
+{
+    if (dst_capacity < compress_bound(codec, src_size))
+    {
+        return 0;
+    }
+
+    switch (codec)
+    {
+        case CompressionCodec::none:
+        {
+            memcpy(dst, src, src_size);
+            return src_size;
+        }
+        case CompressionCodec::lz:
+        {
+            return lz_compress(static_cast<const u8*>(src), src_size, static_cast<u8*>(dst));
+        }
+        default: break;
+    }
+
+    BEE_UNREACHABLE("Invalid compression codec");
+}
+
+i32 decompress_block(const CompressionCodec codec, const void* src, const i32 src_size, void* dst, const i32 dst_size)
+{
+    switch (codec)
+    {
+        case CompressionCodec::none:
+        {
+            if (src_size > dst_size)
+            {
+                return -1;
+            }
+
+            memcpy(dst, src, src_size);
+            return src_size;
+        }
+        case CompressionCodec::lz:
+        {
+            return lz_decompress(static_cast<const u8*>(src), src_size, static_cast<u8*>(dst), dst_size);
+        }
+        default: break;
+    }
+
+    return -1;
+}
+
+
+/*
+ *****************************************
+ *
+ * Compressed frames
+ *
+ *****************************************
+ */
+static bool is_valid_frame_header(const CompressedFrameHeader& header)
+{
+    return header.magic == compressed_frame_magic
+        && header.version == compressed_frame_version
+        && header.codec < CompressionCodec::count
+        && header.block_size > 0
+        && header.block_size <= compressed_frame_max_block_size;
+}
+
+static bool is_valid_frame_footer(const CompressedFrameFooter& footer, const CompressedFrameHeader& header, const i64 frame_size)
+{
+    const auto table_size = static_cast<i64>(footer.block_count) * static_cast<i64>(sizeof(CompressedBlockInfo));
+    const auto expected_block_count = (footer.size + header.block_size - 1) / header.block_size;
+
+    return footer.magic == compressed_frame_magic
+        && footer.size >= 0
+        && footer.block_count == expected_block_count
+        && footer.block_table_offset >= static_cast<i64>(sizeof(CompressedFrameHeader))
+        && footer.block_table_offset + table_size + static_cast<i64>(sizeof(CompressedFrameFooter)) == frame_size;
+}
+
+static bool is_valid_block(const CompressedBlockInfo& block, const i32 index, const CompressedFrameHeader& header, const CompressedFrameFooter& footer)
+{
+    const auto expected_size = math::min(static_cast<i64>(header.block_size), footer.size - static_cast<i64>(index) * header.block_size);
+
+    return block.size == expected_size
+        && block.compressed_size > 0
+        && block.compressed_size <= compress_bound(header.codec, block.size)
+        && block.offset >= static_cast<i64>(sizeof(CompressedFrameHeader))
+        && block.offset + block.compressed_size <= footer.block_table_offset;
+}
+
+static bool decompress_frame_block(const CompressionCodec codec, const CompressedBlockInfo& block, const u8* frame, u8* dst)
+{
+    // blocks that didn't compress are stored raw
+    if (block.compressed_size == block.size)
+    {
+        memcpy(dst, frame + block.offset, block.size);
+        return true;
+    }
+
+    return decompress_block(codec, frame + block.offset, block.compressed_size, dst, block.size) == block.size;
+}
+
+static const CompressedFrameFooter* get_frame_footer(const void* frame, const i64 frame_size)
+{
+    if (frame_size < static_cast<i64>(sizeof(CompressedFrameHeader) + sizeof(CompressedFrameFooter)))
+    {
+        return nullptr;
+    }
+
+    const auto* header = static_cast<const CompressedFrameHeader*>(frame);
+    const auto* footer = reinterpret_cast<const CompressedFrameFooter*>(static_cast<const u8*>(frame) + frame_size - sizeof(CompressedFrameFooter));
+
+    if (!is_valid_frame_header(*header) || !is_valid_frame_footer(*footer, *header, frame_size))
+    {
+        return nullptr;
+    }
+
+    return footer;
+}
+
+bool is_compressed_frame(const void* data, const i64 size)
+{
+    // Check the footer as well so that truncated frames aren't mistaken for valid ones
+    return get_frame_footer(data, size) != nullptr;
+}
+
+i64 get_decompressed_frame_size(const void* frame, const i64 frame_size)
+{
+    const auto* footer = get_frame_footer(frame, frame_size);
+    return footer != nullptr ? footer->size : -1;
+}
+
+bool compress_frame(const CompressionCodec codec, const void* src, const i64 src_size, DynamicArray<u8>* dst, const i32 block_size)
+{
+    dst->clear();
+
+    io::MemoryStream dst_stream(dst);
+    io::CompressedStream stream(&dst_stream, codec, block_size, dst->allocator());
+
+    if (stream.write(src, src_size) != src_size)
+    {
+        return false;
+    }
+
+    return stream.finish();
+}
+
+bool decompress_frame(const void* frame, const i64 frame_size, void* dst, const i64 dst_size, JobGroup* group)
+{
+    const auto* footer = get_frame_footer(frame, frame_size);
+    if (footer == nullptr)
+    {
+        log_error("Invalid compressed frame: frame is truncated or has an invalid header");
+        return false;
+    }
+
+    if (footer->size > dst_size)
+    {
+        log_error("Cannot decompress frame: destination buffer is too small (%" PRIi64 " bytes) for the decompressed frame (%" PRIi64 " bytes)", dst_size, footer->size);
+        return false;
+    }
+
+    const auto* frame_bytes = static_cast<const u8*>(frame);
+    const auto* header = static_cast<const CompressedFrameHeader*>(frame);
+    const auto* blocks = reinterpret_cast<const CompressedBlockInfo*>(frame_bytes + footer->block_table_offset);
+    auto* dst_bytes = static_cast<u8*>(dst);
+
+    // Validate all the blocks up front so the jobs don't have to
+    for (int i = 0; i < footer->block_count; ++i)
+    {
+        if (!is_valid_block(blocks[i], i, *header, *footer))
+        {
+            log_error("Invalid compressed frame: block %d is out of range", i);
+            return false;
+        }
+    }
+
+    if (group == nullptr || !is_job_system_running() || footer->block_count <= 1)
+    {
+        for (int i = 0; i < footer->block_count; ++i)
+        {
+            if (!decompress_frame_block(header->codec, blocks[i], frame_bytes, dst_bytes + static_cast<i64>(i) * header->block_size))
+            {
+                log_error("Invalid compressed frame: failed to decompress block %d", i);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::atomic<i32> failed_block(-1);
+
+    parallel_for(group, footer->block_count, 1, [&](const i32 index)
+    {
+        if (!decompress_frame_block(header->codec, blocks[index], frame_bytes, dst_bytes + static_cast<i64>(index) * header->block_size))
+        {
+            failed_block.store(index, std::memory_order_relaxed);
+        }
+    });
+
+    job_wait(group);
+
+    const auto failed_index = failed_block.load(std::memory_order_relaxed);
+    if (failed_index >= 0)
+    {
+        log_error("Invalid compressed frame: failed to decompress block %d", failed_index);
+        return false;
+    }
+
+    return true;
+}
+
+
+/*
+ *****************************************
+ *
+ * CompressedStream
+ *
+ *****************************************
+ */
+namespace io {
+
+
+CompressedStream::CompressedStream(Stream* inner, const CompressionCodec codec, const i32 block_size, Allocator* allocator)
+    : Stream(Mode::write_only),
+      inner_(inner),
+      frame_begin_(inner->offset()),
+      blocks_(allocator),
+      block_(allocator),
+      compressed_(allocator)
+{
+    header_.codec = codec;
+    header_.block_size = math::clamp(block_size, 1, compressed_frame_max_block_size);
+
+    if (BEE_FAIL_F(codec < CompressionCodec::count && inner_->can_write(), "CompressedStream: invalid codec or inner stream is not writable"))
+    {
+        stream_mode = Mode::invalid;
+        return;
+    }
+
+    if (inner_->write(&header_, sizeof(CompressedFrameHeader)) != sizeof(CompressedFrameHeader))
+    {
+        stream_mode = Mode::invalid;
+        return;
+    }
+
+    compressed_size_ = sizeof(CompressedFrameHeader);
+    block_.resize_no_raii(header_.block_size);
+    compressed_.resize_no_raii(compress_bound(codec, header_.block_size));
+}
+
+CompressedStream::CompressedStream(Stream* inner, Allocator* allocator)
+    : CompressedStream(inner, inner->size() - inner->offset(), allocator)
+{}
+
+CompressedStream::CompressedStream(Stream* inner, const i64 frame_size, Allocator* allocator)
+    : Stream(Mode::invalid),
+      inner_(inner),
+      frame_begin_(inner->offset()),
+      finished_(true),
+      blocks_(allocator),
+      block_(allocator),
+      compressed_(allocator)
+{
+    if (BEE_FAIL_F(inner_->can_read(), "CompressedStream: inner stream is not readable"))
+    {
+        return;
+    }
+
+    if (inner_->read(&header_, sizeof(CompressedFrameHeader)) != sizeof(CompressedFrameHeader) || !is_valid_frame_header(header_))
+    {
+        log_error("CompressedStream: stream does not contain a valid compressed frame");
+        return;
+    }
+
+    CompressedFrameFooter footer{};
+
+    if (frame_size < static_cast<i64>(sizeof(CompressedFrameHeader) + sizeof(CompressedFrameFooter)) || frame_size > inner_->size() - frame_begin_)
+    {
+        log_error("CompressedStream: compressed frame is truncated");
+        return;
+    }
+
+    // The footer is at the end of the frame rather than the inner stream as there may be other data after the frame
+    inner_->seek(frame_begin_ + frame_size - static_cast<i64>(sizeof(CompressedFrameFooter)), SeekOrigin::begin);
+
+    if (inner_->read(&footer, sizeof(CompressedFrameFooter)) != sizeof(CompressedFrameFooter) || !is_valid_frame_footer(footer, header_, frame_size))
+    {
+        log_error("CompressedStream: compressed frame is truncated or has an invalid footer");
+        return;
+    }
+
+    const auto table_size = static_cast<i64>(footer.block_count) * static_cast<i64>(sizeof(CompressedBlockInfo));
+    blocks_.resize(footer.block_count);
+    inner_->seek(frame_begin_ + footer.block_table_offset, SeekOrigin::begin);
+
+    if (inner_->read(blocks_.data(), table_size) != table_size)
+    {
+        log_error("CompressedStream: failed to read the compressed frames block table");
+        return;
+    }
+
+    for (const auto block : enumerate(blocks_))
+    {
+        if (!is_valid_block(block.value, block.index, header_, footer))
+        {
+            log_error("CompressedStream: compressed frame block %d is out of range", block.index);
+            return;
+        }
+    }
+
+    block_.resize_no_raii(header_.block_size);
+    compressed_.resize_no_raii(compress_bound(header_.codec, header_.block_size));
+    size_ = footer.size;
+    compressed_size_ = frame_size;
+    stream_mode = Mode::read_only;
+}
+
+CompressedStream::~CompressedStream()
+{
+    if (mode() == Mode::write_only && !finished_)
+    {
+        finish();
+    }
+}
+
+bool CompressedStream::is_compressed(Stream* stream)
+{
+    const auto offset = stream->offset();
+    CompressedFrameHeader header{};
+    const auto size_read = stream->read(&header, sizeof(CompressedFrameHeader));
+    stream->seek(offset, SeekOrigin::begin);
+    return size_read == sizeof(CompressedFrameHeader) && is_valid_frame_header(header);
+}
+
+bool CompressedStream::flush_block()
+{
+    if (block_fill_ <= 0)
+    {
+        return true;
+    }
+
+    CompressedBlockInfo info{};
+    info.offset = inner_->offset() - frame_begin_;
+    info.size = block_fill_;
+    info.compressed_size = compress_block(header_.codec, block_.data(), block_fill_, compressed_.data(), compressed_.size());
+
+    const u8* data = compressed_.data();
+
+    // store the block raw if it didn't compress
+    if (info.compressed_size <= 0 || info.compressed_size >= info.size)
+    {
+        info.compressed_size = info.size;
+        data = block_.data();
+    }
+
+    if (inner_->write(data, info.compressed_size) != info.compressed_size)
+    {
+        log_error("CompressedStream: failed to write block %d to the inner stream", blocks_.size());
+        return false;
+    }
+
+    compressed_size_ += info.compressed_size;
+    blocks_.push_back(info);
+    block_fill_ = 0;
+    return true;
+}
+
+bool CompressedStream::finish()
+{
+    if (mode() != Mode::write_only || finished_)
+    {
+        return false;
+    }
+
+    finished_ = true;
+
+    if (!flush_block())
+    {
+        return false;
+    }
+
+    CompressedFrameFooter footer{};
+    footer.size = size_;
+    footer.block_table_offset = inner_->offset() - frame_begin_;
+    footer.block_count = blocks_.size();
+
+    const auto table_size = static_cast<i64>(blocks_.size()) * static_cast<i64>(sizeof(CompressedBlockInfo));
+
+    if (inner_->write(blocks_.data(), table_size) != table_size)
+    {
+        return false;
+    }
+
+    if (inner_->write(&footer, sizeof(CompressedFrameFooter)) != sizeof(CompressedFrameFooter))
+    {
+        return false;
+    }
+
+    compressed_size_ += table_size + sizeof(CompressedFrameFooter);
+    return true;
+}
+
+bool CompressedStream::load_block(const i32 index)
+{
+    if (index == current_block_)
+    {
+        return true;
+    }
+
+    const auto& info = blocks_[index];
+    inner_->seek(frame_begin_ + info.offset, SeekOrigin::begin);
+
+    if (info.compressed_size == info.size)
+    {
+        if (inner_->read(block_.data(), info.size) != info.size)
+        {
+            return false;
+        }
+    }
+    else
+    {
+        if (inner_->read(compressed_.data(), info.compressed_size) != info.compressed_size)
+        {
+            return false;
+        }
+
+        if (decompress_block(header_.codec, compressed_.data(), info.compressed_size, block_.data(), info.size) != info.size)
+        {
+            log_error("CompressedStream: failed to decompress block %d", index);
+            return false;
+        }
+    }
+
+    current_block_ = index;
+    return true;
+}
+
+i64 CompressedStream::read(void* dst_buffer, i64 dst_buffer_size)
+{
+    if (BEE_FAIL(can_read()))
+    {
+        return 0;
+    }
+
+    auto* dst = static_cast<u8*>(dst_buffer);
+    i64 total_read = 0;
+
+    while (total_read < dst_buffer_size && offset_ < size_)
+    {
+        const auto block_index = sign_cast<i32>(offset_ / header_.block_size);
+
+        if (!load_block(block_index))
+        {
+            break;
+        }
+
+        const auto block_offset = offset_ - static_cast<i64>(block_index) * header_.block_size;
+        const auto copy_size = math::min(dst_buffer_size - total_read, blocks_[block_index].size - block_offset);
+
+        memcpy(dst + total_read, block_.data() + block_offset, copy_size);
+        total_read += copy_size;
+        offset_ += copy_size;
+    }
+
+    return total_read;
+}
+
+i64 CompressedStream::write(const void* src_buffer, i64 src_buffer_size)
+{
+    if (BEE_FAIL(can_write()) || BEE_FAIL_F(!finished_, "CompressedStream: cannot write to a finished frame"))
+    {
+        return 0;
+    }
+
+    const auto* src = static_cast<const u8*>(src_buffer);
+    i64 total_written = 0;
+
+    while (total_written < src_buffer_size)
+    {
+        const auto copy_size = math::min(src_buffer_size - total_written, static_cast<i64>(header_.block_size - block_fill_));
+
+        memcpy(block_.data() + block_fill_, src + total_written, copy_size);
+        block_fill_ += sign_cast<i32>(copy_size);
+        total_written += copy_size;
+
+        if (block_fill_ >= header_.block_size && !flush_block())
+        {
+            break;
+        }
+    }
+
+    offset_ += total_written;
+    size_ = offset_;
+    return total_written;
+}
+
+i64 CompressedStream::seek(const i64 offset, const SeekOrigin origin)
+{
+    if (BEE_FAIL_F(mode() == Mode::read_only, "CompressedStream: only streams opened for reading can seek"))
+    {
+        return offset_;
+    }
+
+    offset_ = get_seek_position(origin, size_, offset_, offset);
+    return offset_;
+}
+
+
+} // namespace io
+} // namespace bee
@@ -0,0 +1,220 @@
+/*
+ *  Compression.hpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#pragma once
+
+#include "Bee/Core/IO.hpp"
+#include "Bee/Core/Containers/Array.hpp"
+
+
+namespace bee {
+
+
+class JobGroup;
+
+
+/*
+ ********************************************************************************************************************
+ *
+ * # Block codecs
+ *
+ * `lz` is a byte-oriented LZ77 codec using the LZ4 block format (4 byte min match, 64KB window, no entropy coding) -
+ * it's designed to decompress at close to memcpy speed rather than get the best ratio so it can be used for data
+ * that is loaded frequently, i.e. cooked artifacts and network packets. Blocks are self-contained and compressing
+ * and decompressing them is thread safe
+ *
+ ********************************************************************************************************************
+ */
+enum class CompressionCodec : u8
+{
+    none,
+    lz,
+    count
+};
+
+BEE_CORE_API const char* compression_codec_name(const CompressionCodec codec);
+
+// Returns the worst-case compressed size of a block of `src_size` bytes
+BEE_CORE_API i32 compress_bound(const CompressionCodec codec, const i32 src_size);
+
+/*
+ * Compresses `src` into `dst` and returns the compressed size, or 0 if `dst_capacity` is smaller than
+ * `compress_bound`. The result can be larger than `src_size` for incompressible data
+ */
+BEE_CORE_API i32 compress_block(const CompressionCodec codec, const void* src, const i32 src_size, void* dst, const i32 dst_capacity);
+
+/*
+ * Decompresses `src` into `dst` and returns the decompressed size, or -1 if the block is corrupt or decompresses to
+ * more than `dst_size` bytes. Safe to call on untrusted data
+ */
+BEE_CORE_API i32 decompress_block(const CompressionCodec codec, const void* src, const i32 src_size, void* dst, const i32 dst_size);
+
+
+/*
+ ********************************************************************************************************************
+ *
+ * # Compressed frames
+ *
+ * Data larger than a single block is split into fixed-size blocks that are compressed independently so that a
+ * frame can be decompressed in parallel or seeked into by only decompressing the block containing the offset:
+ *
+ * | header | block 0 | block 1 | ... | block N | block table | footer |
+ *
+ * Blocks that don't compress are stored raw. The block table and footer are written last so frames can be written
+ * in a single pass, which means reading a frame requires a seekable stream whose end is the end of the frame.
+ * Offsets in the block table are relative to the start of the frame so frames can be appended to other data
+ *
+ ********************************************************************************************************************
+ */
+static constexpr u32 compressed_frame_magic = 0x5A454542; // 'BEEZ'
+static constexpr u32 compressed_frame_version = 1;
+static constexpr i32 compressed_frame_default_block_size = 256 * 1024;
+static constexpr i32 compressed_frame_max_block_size = 64 * 1024 * 1024;
+
+struct CompressedFrameHeader
+{
+    u32                 magic { compressed_frame_magic };
+    u32                 version { compressed_frame_version };
+    CompressionCodec    codec { CompressionCodec::none };
+    BEE_PAD(3);
+    i32                 block_size { 0 };
+};
+
+struct CompressedBlockInfo
+{
+    i64 offset { 0 };           // byte offset of the block from the start of the frame
+    i32 compressed_size { 0 };  // equal to `size` if the block is stored raw
+    i32 size { 0 };
+};
+
+struct CompressedFrameFooter
+{
+    i64 size { 0 };                 // total decompressed size
+    i64 block_table_offset { 0 };   // byte offset of the block table from the start of the frame
+    i32 block_count { 0 };
+    u32 magic { compressed_frame_magic };
+};
+
+// Returns true if `data` starts with a valid frame header and ends with a footer matching `size`
+BEE_CORE_API bool is_compressed_frame(const void* data, const i64 size);
+
+// Returns the decompressed size of an in-memory frame or -1 if the frame is invalid
+BEE_CORE_API i64 get_decompressed_frame_size(const void* frame, const i64 frame_size);
+
+BEE_CORE_API bool compress_frame(const CompressionCodec codec, const void* src, const i64 src_size, DynamicArray<u8>* dst, const i32 block_size = compressed_frame_default_block_size);
+
+/*
+ * Decompresses a whole in-memory frame into `dst`. If `group` is not null and the job system is running each block is
+ * decompressed in its own job and this waits on `group` before returning
+ */
+BEE_CORE_API bool decompress_frame(const void* frame, const i64 frame_size, void* dst, const i64 dst_size, JobGroup* group = nullptr);
+
+
+namespace io {
+
+
+/**
+ * # CompressedStream
+ *
+ * Adapts another stream to read or write a compressed frame. Writing is append-only - data is gathered into a block
+ * and compressed into the inner stream each time the block fills up, and the block table is written when the stream
+ * is finished or destroyed. Reading supports seeking anywhere in the decompressed data: only the block that contains
+ * the new offset is read and decompressed
+ */
+class BEE_CORE_API CompressedStream final : public Stream
+{
+public:
+    // Starts writing a new frame at the inner streams current offset
+    CompressedStream(Stream* inner, const CompressionCodec codec, const i32 block_size = compressed_frame_default_block_size, Allocator* allocator = system_allocator());
+
+    // Opens the frame that starts at the inner streams current offset for reading - the frame must end where the inner stream does
+    explicit CompressedStream(Stream* inner, Allocator* allocator = system_allocator());
+
+    // Opens the `frame_size` byte frame that starts at the inner streams current offset for reading
+    CompressedStream(Stream* inner, const i64 frame_size, Allocator* allocator = system_allocator());
+
+    CompressedStream(const CompressedStream& other) = delete;
+
+    ~CompressedStream() override;
+
+    CompressedStream& operator=(const CompressedStream& other) = delete;
+
+    // Returns true if a compressed frame starts at the streams current offset without changing the offset
+    static bool is_compressed(Stream* stream);
+
+    bool finish();
+
+    i64 read(void* dst_buffer, i64 dst_buffer_size) override;
+
+    i64 write(const void* src_buffer, i64 src_buffer_size) override;
+
+    i64 seek(i64 offset, SeekOrigin origin) override;
+
+    inline i64 offset() const override
+    {
+        return offset_;
+    }
+
+    inline i64 size() const override
+    {
+        return size_;
+    }
+
+    inline i64 capacity() const override
+    {
+        return mode() == Mode::read_only ? size_ : limits::max<i64>();
+    }
+
+    inline bool is_valid() const
+    {
+        return mode() != Mode::invalid;
+    }
+
+    inline CompressionCodec codec() const
+    {
+        return header_.codec;
+    }
+
+    inline i32 block_size() const
+    {
+        return header_.block_size;
+    }
+
+    inline i32 block_count() const
+    {
+        return blocks_.size();
+    }
+
+    // Total bytes written to or read from the inner stream for the frame
+    inline i64 compressed_size() const
+    {
+        return compressed_size_;
+    }
+
+private:
+    Stream*                             inner_ { nullptr };
+    i64                                 frame_begin_ { 0 };
+    i64                                 offset_ { 0 };
+    i64                                 size_ { 0 };
+    i64                                 compressed_size_ { 0 };
+    CompressedFrameHeader               header_;
+    i32                                 current_block_ { -1 };
+    i32                                 block_fill_ { 0 };
+    bool                                finished_ { false };
+    BEE_PAD(7);
+    DynamicArray<CompressedBlockInfo>   blocks_;
+    DynamicArray<u8>                    block_;
+    DynamicArray<u8>                    compressed_;
+
+    bool flush_block();
+
+    bool load_block(const i32 index);
+};
+
+
+} // namespace io
+} // namespace bee
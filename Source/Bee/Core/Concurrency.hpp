@@ -14,9 +14,11 @@
 
 #if BEE_OS_WINDOWS == 1
     #include "Bee/Core/Win32/Win32_Concurrency.hpp"
+#elif BEE_OS_LINUX == 1
+    #include "Bee/Core/Linux/Linux_Concurrency.hpp"
 #else
     #error Platform not supported
-#endif // BEE_OS_WINDOWS == 1
+#endif // BEE_OS_*
 
 
 namespace bee {
@@ -104,6 +106,8 @@ struct BEE_CORE_API ReaderWriterMutex
 
     ReaderWriterMutex() noexcept;
 
+    ~ReaderWriterMutex();
+
     void lock_read();
 
     bool try_lock_read();
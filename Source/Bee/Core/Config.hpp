@@ -212,6 +212,22 @@ namespace bee {
     #define BEE_LITTLE_ENDIAN
 #endif // BEE_LITTLE_ENDIAN
 
+/*
+ * Address sanitizer - MSVC, GCC and Clang (with -fsanitize=address) all define __SANITIZE_ADDRESS__ except for older
+ * Clang versions which only expose it via __has_feature
+ */
+#if defined(__SANITIZE_ADDRESS__)
+    #define BEE_ASAN_ENABLED 1
+#elif defined(__has_feature)
+    #if __has_feature(address_sanitizer)
+        #define BEE_ASAN_ENABLED 1
+    #endif // __has_feature(address_sanitizer)
+#endif // defined(__SANITIZE_ADDRESS__)
+
+#ifndef BEE_ASAN_ENABLED
+    #define BEE_ASAN_ENABLED 0
+#endif // BEE_ASAN_ENABLED
+
 
 #ifndef BEE_EXPORT_SYMBOL
     #define BEE_EXPORT_SYMBOL
@@ -268,6 +284,11 @@ namespace bee {
     #define BEE_CONFIG_MOCK_TEST_DATA 0
 #endif // BEE_CONFIG_MOCK_TEST_DATA
 
+// Linux only: use a calibrated rdtsc for time::now() instead of clock_gettime if the CPU has an invariant TSC
+#if !defined(BEE_CONFIG_USE_RDTSC_TIMER)
+    #define BEE_CONFIG_USE_RDTSC_TIMER 0
+#endif // BEE_CONFIG_USE_RDTSC_TIMER
+
 
 #if BEE_CONFIG_FORCE_MEMORY_TRACKING == 1
     #define BEE_CONFIG_ENABLE_MEMORY_TRACKING 1
@@ -405,6 +405,496 @@ BEE_SERIALIZE_TYPE(SerializationBuilder* builder, ResourcePool<HandleType, Resou
 }
 
 
+/*
+ ********************************************************************************************************************
+ *
+ * # AtomicResourcePool
+ *
+ * A thread-safe variant of `ResourcePool` that can be allocated from and deallocated into by many threads
+ * concurrently without taking a lock. Each chunk owns a lock-free stack of free indices (ABA-guarded with a tag
+ * packed into the same 64-bit head) and every slot stores an atomic version that handles are checked against
+ * when deallocating or accessing a resource. The chunk directory is a fixed-size array of `MaxChunks` pointers
+ * allocated up-front so that, unlike `ResourcePool`, growing the pool never reallocates memory that another
+ * thread might be reading from.
+ *
+ * Accessing a resource via `operator[]` is safe while other threads allocate/deallocate *other* handles, however
+ * iterating the pool or calling `clear()` must be externally synchronized with any concurrent deallocations
+ *
+ ********************************************************************************************************************
+ */
+template <typename HandleType, typename ResourceType, u32 MaxChunks = 256>
+class AtomicResourcePool : public Noncopyable
+{
+public:
+    using id_t          = typename HandleType::generator_t::id_t;
+    using handle_t      = HandleType;
+    using resource_t    = ResourceType;
+
+    static constexpr u32 max_chunks = MaxChunks;
+
+    static_assert(sizeof(id_t) <= 8,
+        "Bee: AtomicResourcePool<HandleType, ResourceType>: HandleType must be declared using the BEE_VERSIONED_HANDLE() "
+        "macro and be smaller than 64 bits in size"
+    );
+
+private:
+    static constexpr u32 empty_slot_ = limits::max<u32>();
+
+    struct ResourceChunk
+    {
+        std::atomic<u64>    free_head { 0 };
+        u32                 index { 0 };
+        u32                 capacity { 0 };
+        std::atomic<id_t>*  versions { nullptr };
+        std::atomic<u32>*   next_free { nullptr };
+        std::atomic<bool>*  active_states { nullptr };
+        ResourceType*       data { nullptr };
+    };
+
+    // The free-list head packs the index of the top slot in the low 32 bits and an ABA tag in the high 32 bits
+    static constexpr u64 pack_head(const u32 slot, const u64 tag)
+    {
+        return (tag << 32u) | static_cast<u64>(slot);
+    }
+
+    static constexpr u32 head_slot(const u64 head)
+    {
+        return static_cast<u32>(head & 0xFFFFFFFFull);
+    }
+
+    static constexpr u64 head_tag(const u64 head)
+    {
+        return head >> 32u;
+    }
+
+public:
+    struct ResourcePair
+    {
+        ResourcePair(const HandleType& new_handle, ResourceType& new_resource)
+            : handle(new_handle),
+              resource(new_resource)
+        {}
+
+        HandleType      handle;
+        BEE_PAD(8 - (sizeof(HandleType) % 8));
+        ResourceType&   resource;
+    };
+
+    class iterator
+    {
+    public:
+        using value_type        = ResourcePair;
+        using difference_type   = ptrdiff_t;
+
+        iterator(AtomicResourcePool* pool, const u32 index_in_chunk, const u32 chunk)
+            : pool_(pool),
+              current_index_(index_in_chunk),
+              current_chunk_(chunk)
+        {
+            skip_inactive();
+        }
+
+        bool operator==(const iterator& other) const
+        {
+            return pool_ == other.pool_
+                && current_chunk_ == other.current_chunk_
+                && current_index_ == other.current_index_;
+        }
+
+        bool operator!=(const iterator& other) const
+        {
+            return !(*this == other);
+        }
+
+        ResourcePair operator*() const
+        {
+            auto* chunk = pool_->chunks_[current_chunk_].load(std::memory_order_acquire);
+            const id_t index = current_chunk_ * pool_->chunk_capacity_ + current_index_;
+            const id_t version = chunk->versions[current_index_].load(std::memory_order_relaxed);
+            return ResourcePair { HandleType(index, version), chunk->data[current_index_] };
+        }
+
+        iterator& operator++()
+        {
+            ++current_index_;
+            skip_inactive();
+            return *this;
+        }
+
+        const iterator operator++(int)
+        {
+            iterator result(*this);
+            ++*this;
+            return result;
+        }
+
+    private:
+        AtomicResourcePool* pool_ { nullptr };
+        u32                 current_index_ { 0 };
+        u32                 current_chunk_ { 0 };
+
+        void skip_inactive()
+        {
+            const auto chunk_count = pool_->chunk_count();
+
+            while (current_chunk_ < chunk_count)
+            {
+                auto* chunk = pool_->chunks_[current_chunk_].load(std::memory_order_acquire);
+
+                while (current_index_ < pool_->chunk_capacity_)
+                {
+                    if (chunk->active_states[current_index_].load(std::memory_order_acquire))
+                    {
+                        return;
+                    }
+                    ++current_index_;
+                }
+
+                ++current_chunk_;
+                current_index_ = 0;
+            }
+
+            // we're at the end
+            current_chunk_ = chunk_count;
+            current_index_ = 0;
+        }
+    };
+
+    explicit AtomicResourcePool(const size_t chunk_byte_size, Allocator* allocator = system_allocator())
+        : chunk_byte_size_(chunk_byte_size),
+          chunk_capacity_(static_cast<u32>(chunk_byte_size / sizeof(ResourceType))),
+          allocator_(allocator)
+    {
+        BEE_ASSERT_F(chunk_capacity_ > 0, "AtomicResourcePool: chunk_byte_size must be large enough to fit at least one resource");
+        BEE_ASSERT_F(
+            static_cast<u64>(chunk_capacity_) * MaxChunks < static_cast<u64>(HandleType::generator_t::low_mask),
+            "AtomicResourcePool: chunk capacity * MaxChunks exceeds the number of indices representable by HandleType"
+        );
+
+        for (auto& chunk : chunks_)
+        {
+            chunk.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~AtomicResourcePool()
+    {
+        const auto chunk_count = chunk_count_.load(std::memory_order_acquire);
+
+        for (u32 c = 0; c < chunk_count; ++c)
+        {
+            auto* chunk = chunks_[c].load(std::memory_order_acquire);
+            if (chunk != nullptr)
+            {
+                destroy_chunk(chunk);
+                chunks_[c].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        chunk_count_.store(0, std::memory_order_relaxed);
+        resource_count_.store(0, std::memory_order_relaxed);
+    }
+
+    template <typename... ConstructorArgs>
+    HandleType allocate(ConstructorArgs&&... args)
+    {
+        u32 slot = empty_slot_;
+        ResourceChunk* chunk = nullptr;
+
+        while (slot == empty_slot_)
+        {
+            const auto chunk_count = chunk_count_.load(std::memory_order_acquire);
+            const auto first_chunk = allocation_hint_.load(std::memory_order_relaxed);
+
+            // Start searching from the last chunk a thread successfully allocated from to avoid hammering the
+            // free lists of chunks that are known to be full
+            for (u32 i = 0; i < chunk_count; ++i)
+            {
+                const auto chunk_index = (first_chunk + i) % chunk_count;
+                chunk = chunks_[chunk_index].load(std::memory_order_acquire);
+                slot = pop_free_slot(chunk);
+
+                if (slot != empty_slot_)
+                {
+                    if (chunk_index != first_chunk)
+                    {
+                        allocation_hint_.store(chunk_index, std::memory_order_relaxed);
+                    }
+                    break;
+                }
+            }
+
+            if (slot == empty_slot_)
+            {
+                grow(chunk_count);
+            }
+        }
+
+        new (&chunk->data[slot]) ResourceType(BEE_FORWARD(args)...);
+        chunk->active_states[slot].store(true, std::memory_order_release);
+        resource_count_.fetch_add(1, std::memory_order_relaxed);
+
+        const id_t index = chunk->index * chunk_capacity_ + slot;
+        return HandleType(index, chunk->versions[slot].load(std::memory_order_relaxed));
+    }
+
+    void deallocate(const HandleType& handle)
+    {
+        const auto index = handle.index();
+        const auto chunk_index = static_cast<u32>(index / chunk_capacity_);
+        const auto slot = static_cast<u32>(index % chunk_capacity_);
+
+        BEE_ASSERT_F(chunk_index < chunk_count_.load(std::memory_order_acquire), "Handle had an invalid index");
+
+        auto* chunk = chunks_[chunk_index].load(std::memory_order_acquire);
+        auto expected_version = handle.version();
+        const auto next_version = (expected_version + 1) & HandleType::generator_t::high_mask;
+
+        // Bumping the version first means only one thread can ever win the right to free the slot
+        const bool version_matched = chunk->versions[slot].compare_exchange_strong(
+            expected_version,
+            next_version,
+            std::memory_order_acq_rel,
+            std::memory_order_relaxed
+        );
+
+        BEE_ASSERT_F(version_matched, "Attempted to free a resource using an outdated handle");
+
+        if (!version_matched)
+        {
+            return;
+        }
+
+        BEE_ASSERT_F(chunk->active_states[slot].load(std::memory_order_relaxed), "Handle referenced a deallocated resource");
+
+        chunk->active_states[slot].store(false, std::memory_order_relaxed);
+        destruct(&chunk->data[slot]);
+        resource_count_.fetch_sub(1, std::memory_order_relaxed);
+
+        push_free_slot(chunk, slot);
+    }
+
+    void reserve(const i32 count)
+    {
+        const auto required_chunks = static_cast<u32>(math::ceilf(static_cast<float>(count) / static_cast<float>(chunk_capacity_)));
+        auto chunk_count = chunk_count_.load(std::memory_order_acquire);
+
+        while (chunk_count < required_chunks)
+        {
+            grow(chunk_count);
+            chunk_count = chunk_count_.load(std::memory_order_acquire);
+        }
+    }
+
+    // Not thread-safe - must be externally synchronized with any concurrent calls to allocate/deallocate
+    void clear()
+    {
+        const auto chunk_count = chunk_count_.load(std::memory_order_acquire);
+
+        for (u32 c = 0; c < chunk_count; ++c)
+        {
+            reset_chunk(chunks_[c].load(std::memory_order_acquire));
+        }
+
+        resource_count_.store(0, std::memory_order_release);
+    }
+
+    bool is_active(const HandleType& handle) const
+    {
+        const auto index = handle.index();
+        const auto chunk_index = static_cast<u32>(index / chunk_capacity_);
+        const auto slot = static_cast<u32>(index % chunk_capacity_);
+
+        if (!handle.is_valid() || chunk_index >= chunk_count_.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        const auto* chunk = chunks_[chunk_index].load(std::memory_order_acquire);
+        return chunk->versions[slot].load(std::memory_order_acquire) == handle.version()
+            && chunk->active_states[slot].load(std::memory_order_acquire);
+    }
+
+    inline id_t size() const
+    {
+        return static_cast<id_t>(resource_count_.load(std::memory_order_relaxed));
+    }
+
+    inline u32 chunk_count() const
+    {
+        return chunk_count_.load(std::memory_order_acquire);
+    }
+
+    inline u32 chunk_capacity() const
+    {
+        return chunk_capacity_;
+    }
+
+    inline size_t allocated_size() const
+    {
+        return chunk_byte_size_ * chunk_count();
+    }
+
+    inline ResourceType& operator[](const HandleType& handle)
+    {
+        return const_cast<ResourceType&>(validate_resource(handle));
+    }
+
+    inline const ResourceType& operator[](const HandleType& handle) const
+    {
+        return validate_resource(handle);
+    }
+
+    inline iterator begin()
+    {
+        return iterator(this, 0, 0);
+    }
+
+    inline iterator end()
+    {
+        return iterator(this, 0, chunk_count());
+    }
+
+private:
+    size_t                          chunk_byte_size_ { 0 };
+    u32                             chunk_capacity_ { 0 };
+    std::atomic<u32>                chunk_count_ { 0 };
+    std::atomic<u32>                allocation_hint_ { 0 };
+    std::atomic<i64>                resource_count_ { 0 };
+    Allocator*                      allocator_ { nullptr };
+    std::atomic<ResourceChunk*>     chunks_[MaxChunks];
+
+    static u32 pop_free_slot(ResourceChunk* chunk)
+    {
+        auto old_head = chunk->free_head.load(std::memory_order_acquire);
+        u64 new_head = 0;
+
+        do
+        {
+            const auto slot = head_slot(old_head);
+            if (slot == empty_slot_)
+            {
+                return empty_slot_;
+            }
+
+            // This read may race with another thread popping `slot` and pushing it back again - if so, the tag
+            // will have changed and the CAS below will fail so the stale value is never published
+            const auto next = chunk->next_free[slot].load(std::memory_order_relaxed);
+            new_head = pack_head(next, head_tag(old_head) + 1);
+        } while (!chunk->free_head.compare_exchange_weak(old_head, new_head, std::memory_order_acq_rel, std::memory_order_acquire));
+
+        return head_slot(old_head);
+    }
+
+    static void push_free_slot(ResourceChunk* chunk, const u32 slot)
+    {
+        auto old_head = chunk->free_head.load(std::memory_order_relaxed);
+        u64 new_head = 0;
+
+        do
+        {
+            chunk->next_free[slot].store(head_slot(old_head), std::memory_order_relaxed);
+            new_head = pack_head(slot, head_tag(old_head) + 1);
+        } while (!chunk->free_head.compare_exchange_weak(old_head, new_head, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void grow(u32 expected_count)
+    {
+        BEE_ASSERT_F(expected_count < MaxChunks, "AtomicResourcePool: exceeded the maximum number of chunks (%u)", MaxChunks);
+
+        // Several threads may race to create the same chunk - only one of them will successfully publish it into
+        // the directory and the losers just free theirs and retry the allocation
+        if (chunks_[expected_count].load(std::memory_order_acquire) == nullptr)
+        {
+            auto* new_chunk = create_chunk(expected_count);
+            ResourceChunk* expected_chunk = nullptr;
+
+            if (!chunks_[expected_count].compare_exchange_strong(expected_chunk, new_chunk, std::memory_order_acq_rel))
+            {
+                destroy_chunk(new_chunk);
+            }
+        }
+
+        // Whoever publishes the chunk, make sure the count is bumped past it
+        chunk_count_.compare_exchange_strong(expected_count, expected_count + 1, std::memory_order_acq_rel);
+    }
+
+    ResourceChunk* create_chunk(const u32 index)
+    {
+        const auto capacity = static_cast<size_t>(chunk_capacity_);
+        const auto data_size = round_up(sizeof(ResourceType) * capacity, alignof(std::atomic<id_t>));
+        const auto versions_size = round_up(sizeof(std::atomic<id_t>) * capacity, alignof(std::atomic<u32>));
+        const auto next_free_size = sizeof(std::atomic<u32>) * capacity;
+        const auto active_states_size = sizeof(std::atomic<bool>) * capacity;
+        const auto alignment = math::max(alignof(ResourceType), alignof(ResourceChunk));
+        const auto chunk_header_size = round_up(sizeof(ResourceChunk), alignment);
+
+        auto* ptr = static_cast<u8*>(BEE_MALLOC_ALIGNED(
+            allocator_,
+            chunk_header_size + data_size + versions_size + next_free_size + active_states_size,
+            alignment
+        ));
+
+        BEE_ASSERT(ptr != nullptr);
+
+        auto* chunk = new (ptr) ResourceChunk{};
+        chunk->index = index;
+        chunk->capacity = chunk_capacity_;
+        chunk->data = reinterpret_cast<ResourceType*>(ptr + chunk_header_size);
+        chunk->versions = reinterpret_cast<std::atomic<id_t>*>(reinterpret_cast<u8*>(chunk->data) + data_size);
+        chunk->next_free = reinterpret_cast<std::atomic<u32>*>(reinterpret_cast<u8*>(chunk->versions) + versions_size);
+        chunk->active_states = reinterpret_cast<std::atomic<bool>*>(chunk->next_free + capacity);
+
+        for (u32 i = 0; i < chunk_capacity_; ++i)
+        {
+            new (&chunk->versions[i]) std::atomic<id_t>(HandleType::generator_t::min_high);
+            new (&chunk->next_free[i]) std::atomic<u32>(i + 1 < chunk_capacity_ ? i + 1 : empty_slot_);
+            new (&chunk->active_states[i]) std::atomic<bool>(false);
+        }
+
+        chunk->free_head.store(pack_head(0, 0), std::memory_order_release);
+        return chunk;
+    }
+
+    void destroy_chunk(ResourceChunk* chunk)
+    {
+        reset_chunk(chunk);
+        destruct(chunk);
+        BEE_FREE(allocator_, chunk);
+    }
+
+    void reset_chunk(ResourceChunk* chunk)
+    {
+        for (u32 i = 0; i < chunk->capacity; ++i)
+        {
+            if (chunk->active_states[i].load(std::memory_order_relaxed))
+            {
+                chunk->active_states[i].store(false, std::memory_order_relaxed);
+                destruct(chunk->data + i);
+            }
+
+            chunk->versions[i].store(HandleType::generator_t::min_high, std::memory_order_relaxed);
+            chunk->next_free[i].store(i + 1 < chunk->capacity ? i + 1 : empty_slot_, std::memory_order_relaxed);
+        }
+
+        chunk->free_head.store(pack_head(0, head_tag(chunk->free_head.load(std::memory_order_relaxed)) + 1), std::memory_order_release);
+    }
+
+    const ResourceType& validate_resource(const HandleType& handle) const
+    {
+        const auto index = handle.index();
+        const auto chunk_index = static_cast<u32>(index / chunk_capacity_);
+        const auto slot = static_cast<u32>(index % chunk_capacity_);
+        BEE_ASSERT_F(chunk_index < chunk_count_.load(std::memory_order_acquire), "Handle had an invalid index");
+
+        const auto* chunk = chunks_[chunk_index].load(std::memory_order_acquire);
+        BEE_ASSERT_F(chunk->versions[slot].load(std::memory_order_acquire) == handle.version(), "Handle was out of date with the version stored in the resource pool");
+        BEE_ASSERT_F(chunk->active_states[slot].load(std::memory_order_acquire), "Handle referenced a deallocated resource");
+        return chunk->data[slot];
+    }
+};
+
+
 } // namespace bee
 
 #ifdef BEE_ENABLE_REFLECTION
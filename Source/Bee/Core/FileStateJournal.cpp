@@ -0,0 +1,284 @@
+/*
+ *  FileStateJournal.cpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#include "Bee/Core/FileStateJournal.hpp"
+#include "Bee/Core/Logger.hpp"
+#include "Bee/Core/Math/Math.hpp"
+
+
+namespace bee {
+namespace fs {
+
+
+static constexpr u64 file_state_path_hash_seed = 0xF11E57A7E;
+
+static u64 get_path_hash(const PathView& path)
+{
+    const u64 hash = get_hash64(path.data(), static_cast<size_t>(path.size()), file_state_path_hash_seed);
+
+    // The empty and tombstone values are reserved for marking slots
+    if (hash == FileStateRecord::empty_hash || hash == FileStateRecord::tombstone_hash)
+    {
+        return 1;
+    }
+
+    return hash;
+}
+
+static bool is_metadata_equal(const FileStateRecord& record, const DirectoryEntryInfo& entry)
+{
+    return record.size == entry.size && record.last_modified == entry.last_modified && record.inode == entry.inode;
+}
+
+/*
+ * Linear probing over a power-of-two sized table. Returns the slot containing `path_hash` if it exists, otherwise the
+ * first empty or tombstone slot it can be inserted into
+ */
+static i32 probe_slot(const FileStateRecord* records, const i32 capacity, const u64 path_hash)
+{
+    const u64 mask = static_cast<u64>(capacity) - 1;
+    i32 insert_index = -1;
+
+    for (u64 i = 0; i < static_cast<u64>(capacity); ++i)
+    {
+        const auto index = static_cast<i32>((path_hash + i) & mask);
+        const auto slot_hash = records[index].path_hash;
+
+        if (slot_hash == path_hash)
+        {
+            return index;
+        }
+
+        if (slot_hash == FileStateRecord::tombstone_hash)
+        {
+            if (insert_index < 0)
+            {
+                insert_index = index;
+            }
+            continue;
+        }
+
+        if (slot_hash == FileStateRecord::empty_hash)
+        {
+            return insert_index >= 0 ? insert_index : index;
+        }
+    }
+
+    return insert_index;
+}
+
+FileStateJournal::~FileStateJournal()
+{
+    close();
+}
+
+bool FileStateJournal::open(const PathView& path, const i32 initial_capacity)
+{
+    close();
+
+    path_ = path;
+
+    if (path_.exists() && map_journal())
+    {
+        return true;
+    }
+
+    // The journal is missing or invalid - start from scratch
+    return rebuild(static_cast<i32>(math::to_next_pow2(static_cast<u32>(math::max(16, initial_capacity)))));
+}
+
+void FileStateJournal::close()
+{
+    if (mapped_.is_mapped())
+    {
+        mmap_file_unmap(&mapped_);
+    }
+
+    header_ = nullptr;
+    records_ = nullptr;
+}
+
+bool FileStateJournal::map_journal()
+{
+    if (!mmap_file_map(&mapped_, path_.view(), OpenMode::read | OpenMode::write))
+    {
+        return false;
+    }
+
+    auto* header = static_cast<FileStateJournalHeader*>(mapped_.data);
+    const auto is_valid = mapped_.size >= static_cast<i64>(sizeof(FileStateJournalHeader))
+        && header->magic == file_state_journal_magic
+        && header->version == file_state_journal_version
+        && header->capacity > 0
+        && math::is_power_of_two(static_cast<u32>(header->capacity))
+        && mapped_.size == static_cast<i64>(sizeof(FileStateJournalHeader) + sizeof(FileStateRecord) * header->capacity);
+
+    if (!is_valid)
+    {
+        log_warning("File state journal %s is invalid or out of date and will be rebuilt", path_.c_str());
+        mmap_file_unmap(&mapped_);
+        return false;
+    }
+
+    header_ = header;
+    records_ = reinterpret_cast<FileStateRecord*>(static_cast<u8*>(mapped_.data) + sizeof(FileStateJournalHeader));
+    return true;
+}
+
+bool FileStateJournal::rebuild(const i32 capacity)
+{
+    BEE_ASSERT(math::is_power_of_two(static_cast<u32>(capacity)));
+
+    // Build the new table in memory and write it out in one go rather than resizing the mapped file
+    const auto size = sizeof(FileStateJournalHeader) + sizeof(FileStateRecord) * capacity;
+    FixedArray<u8> buffer;
+    buffer.resize(static_cast<i32>(size));
+    memset(buffer.data(), 0, size);
+
+    auto* header = new (buffer.data()) FileStateJournalHeader{};
+    auto* records = reinterpret_cast<FileStateRecord*>(buffer.data() + sizeof(FileStateJournalHeader));
+    header->capacity = capacity;
+
+    if (header_ != nullptr)
+    {
+        for (int i = 0; i < header_->capacity; ++i)
+        {
+            const auto& record = records_[i];
+            if (record.path_hash == FileStateRecord::empty_hash || record.path_hash == FileStateRecord::tombstone_hash)
+            {
+                continue;
+            }
+
+            records[probe_slot(records, capacity, record.path_hash)] = record;
+            ++header->count;
+        }
+    }
+
+    close();
+
+    if (write_all(path_.view(), buffer.data(), buffer.size()) != buffer.size())
+    {
+        log_error("Failed to write file state journal %s", path_.c_str());
+        return false;
+    }
+
+    return map_journal();
+}
+
+i32 FileStateJournal::find_index(const u64 path_hash) const
+{
+    if (header_ == nullptr)
+    {
+        return -1;
+    }
+
+    const auto index = probe_slot(records_, header_->capacity, path_hash);
+    return index >= 0 && records_[index].path_hash == path_hash ? index : -1;
+}
+
+const FileStateRecord* FileStateJournal::find(const PathView& path) const
+{
+    const auto index = find_index(get_path_hash(path));
+    return index >= 0 ? &records_[index] : nullptr;
+}
+
+FileStateChange FileStateJournal::check(const DirectoryEntryInfo& entry, u128* content_hash)
+{
+    const auto index = find_index(get_path_hash(entry.path.view()));
+    if (index < 0)
+    {
+        return FileStateChange::added;
+    }
+
+    auto& record = records_[index];
+    if (is_metadata_equal(record, entry))
+    {
+        return FileStateChange::unchanged;
+    }
+
+    // Only hash the file now that its metadata has changed - it might have just been touched or copied over
+    u128 hash{};
+    if (!get_file_hash128(entry.path.view(), 0, &hash))
+    {
+        return FileStateChange::modified;
+    }
+
+    if (content_hash != nullptr)
+    {
+        *content_hash = hash;
+    }
+
+    if (record.content_hash != u128{} && record.content_hash == hash)
+    {
+        record.size = entry.size;
+        record.last_modified = entry.last_modified;
+        record.inode = entry.inode;
+        return FileStateChange::unchanged;
+    }
+
+    return FileStateChange::modified;
+}
+
+bool FileStateJournal::record(const DirectoryEntryInfo& entry, const u128& content_hash)
+{
+    if (BEE_FAIL_F(header_ != nullptr, "File state journal is not open"))
+    {
+        return false;
+    }
+
+    const auto path_hash = get_path_hash(entry.path.view());
+    auto index = probe_slot(records_, header_->capacity, path_hash);
+
+    if (index < 0 || records_[index].path_hash != path_hash)
+    {
+        // Keep the load factor under 75% - tombstones count towards it as they lengthen probe sequences too
+        if ((header_->count + header_->tombstone_count + 1) * 4 > header_->capacity * 3)
+        {
+            const auto new_capacity = (header_->count + 1) * 2 > header_->capacity ? header_->capacity * 2 : header_->capacity;
+            if (!rebuild(new_capacity))
+            {
+                return false;
+            }
+        }
+
+        index = probe_slot(records_, header_->capacity, path_hash);
+        if (records_[index].path_hash == FileStateRecord::tombstone_hash)
+        {
+            --header_->tombstone_count;
+        }
+
+        ++header_->count;
+    }
+
+    auto& record = records_[index];
+    record.path_hash = path_hash;
+    record.size = entry.size;
+    record.last_modified = entry.last_modified;
+    record.inode = entry.inode;
+    record.content_hash = content_hash;
+    return true;
+}
+
+bool FileStateJournal::remove(const PathView& path)
+{
+    const auto index = find_index(get_path_hash(path));
+    if (index < 0)
+    {
+        return false;
+    }
+
+    // The slot can't be emptied without breaking the probe sequence of any records inserted after it
+    new (&records_[index]) FileStateRecord{};
+    records_[index].path_hash = FileStateRecord::tombstone_hash;
+    --header_->count;
+    ++header_->tombstone_count;
+    return true;
+}
+
+
+} // namespace fs
+} // namespace bee
@@ -0,0 +1,124 @@
+/*
+ *  FileStateJournal.hpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#pragma once
+
+#include "Bee/Core/Filesystem.hpp"
+
+
+namespace bee {
+namespace fs {
+
+
+/*
+ ********************************************************************************************************************
+ *
+ * # FileStateJournal
+ *
+ * A persistent record of the size, modification time, inode and content hash of a set of files, used to tell
+ * whether a file has changed since it was last processed without having to open it. The journal is a memory mapped
+ * open-addressing hash table keyed on a 64 bit hash of each files path so opening it is a single mmap and every
+ * lookup touches one or two pages.
+ *
+ * Content hashes are computed lazily: files are only hashed once their metadata differs from the journal, and if the
+ * hash then matches the recorded one the file was only touched so its metadata is updated in-place and it's reported
+ * as unchanged.
+ *
+ * The journal isn't thread-safe and isn't version tolerant - journals written with a different version are discarded
+ *
+ ********************************************************************************************************************
+ */
+static constexpr u32 file_state_journal_magic = 0x4A534642; // 'BFSJ'
+static constexpr u32 file_state_journal_version = 1;
+
+struct FileStateJournalHeader
+{
+    u32 magic { file_state_journal_magic };
+    u32 version { file_state_journal_version };
+    i32 capacity { 0 };
+    i32 count { 0 };
+    i32 tombstone_count { 0 };
+    BEE_PAD(12);
+};
+
+struct FileStateRecord
+{
+    static constexpr u64 empty_hash = 0;
+    static constexpr u64 tombstone_hash = ~0ull;
+
+    u64     path_hash { empty_hash };
+    i64     size { 0 };
+    u64     last_modified { 0 };
+    u64     inode { 0 };
+    u128    content_hash;           // zero if the file hasn't been hashed yet
+};
+
+enum class FileStateChange
+{
+    unchanged,
+    modified,
+    added
+};
+
+class BEE_CORE_API FileStateJournal final : public Noncopyable
+{
+public:
+    static constexpr i32 default_capacity = 4096;
+
+    FileStateJournal() = default;
+
+    ~FileStateJournal();
+
+    // Opens the journal at `path`, creating it if it doesn't exist or is invalid
+    bool open(const PathView& path, const i32 initial_capacity = default_capacity);
+
+    void close();
+
+    /*
+     * Compares `entry` with its recorded state. If the metadata differs the file is hashed and `content_hash` (if not
+     * nullptr) receives the new hash so that it can be passed to `record` without hashing the file twice
+     */
+    FileStateChange check(const DirectoryEntryInfo& entry, u128* content_hash = nullptr);
+
+    // Records the current state of `entry` - a zero `content_hash` means the file will be hashed lazily later on
+    bool record(const DirectoryEntryInfo& entry, const u128& content_hash = u128{});
+
+    bool remove(const PathView& path);
+
+    const FileStateRecord* find(const PathView& path) const;
+
+    inline bool is_open() const
+    {
+        return header_ != nullptr;
+    }
+
+    inline i32 size() const
+    {
+        return header_ != nullptr ? header_->count : 0;
+    }
+
+    inline i32 capacity() const
+    {
+        return header_ != nullptr ? header_->capacity : 0;
+    }
+
+private:
+    Path                    path_;
+    MemoryMappedFile        mapped_;
+    FileStateJournalHeader* header_ { nullptr };
+    FileStateRecord*        records_ { nullptr };
+
+    bool map_journal();
+
+    bool rebuild(const i32 capacity);
+
+    i32 find_index(const u64 path_hash) const;
+};
+
+
+} // namespace fs
+} // namespace bee
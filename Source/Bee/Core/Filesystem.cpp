@@ -6,9 +6,16 @@
  */
 
 #include "Bee/Core/Filesystem.hpp"
+#include "Bee/Core/AsyncIO.hpp"
+#include "Bee/Core/Concurrency.hpp"
+#include "Bee/Core/Containers/HashMap.hpp"
 #include "Bee/Core/Error.hpp"
+#include "Bee/Core/Jobs/JobSystem.hpp"
 #include "Bee/Core/Logger.hpp"
+#include "Bee/Core/Math/Math.hpp"
+#include "Bee/Core/Memory/Memory.hpp"
 
+#include <inttypes.h>
 #include <stdio.h>
 
 
@@ -175,21 +182,59 @@ bool rmdir(const PathView& directory_path, const bool recursive)
         return native_rmdir_non_recursive(directory_path);
     }
 
-    bool rmdir_success = false;
-    for (const auto& path : read_dir(directory_path))
+    DirectoryScanInfo scan_info{};
+    scan_info.recursive = true;
+    scan_info.include_directories = true;
+
+    DynamicArray<DirectoryEntryInfo> entries;
+    if (!scan_dir(directory_path, scan_info, &entries))
+    {
+        return false;
+    }
+
+    struct DirectoryDepth
     {
-        if (is_dir(path))
+        i32 index { -1 };
+        i32 depth { 0 };
+    };
+
+    DynamicArray<DirectoryDepth> directories;
+    i32 max_depth = 0;
+
+    for (int i = 0; i < entries.size(); ++i)
+    {
+        if (entries[i].type == DirectoryEntryType::directory)
         {
-            rmdir_success = rmdir(path, true);
+            DirectoryDepth dir{};
+            dir.index = i;
+            for (const char c : entries[i].path.string_view())
+            {
+                if (c == Path::preferred_slash || c == Path::generic_slash)
+                {
+                    ++dir.depth;
+                }
+            }
+            max_depth = math::max(max_depth, dir.depth);
+            directories.push_back(dir);
+            continue;
         }
-        else
+
+        // symlinks are removed rather than followed so a link to a directory doesn't delete the directories contents
+        if (!remove(entries[i].path.view()))
         {
-            rmdir_success = remove(path);
+            return false;
         }
+    }
 
-        if (!rmdir_success)
+    // Directories have to be empty before they're removed so the deepest ones go first
+    for (int depth = max_depth; depth >= 0; --depth)
+    {
+        for (const auto& dir : directories)
         {
-            return false;
+            if (dir.depth == depth && !native_rmdir_non_recursive(entries[dir.index].path.view()))
+            {
+                return false;
+            }
         }
     }
 
@@ -211,6 +256,132 @@ DirectoryIterator end(const DirectoryIterator&)
     return DirectoryIterator();
 }
 
+/*
+ *****************************************
+ *
+ * Directory scanning - implementation
+ *
+ *****************************************
+ */
+// Implemented in the platform-specific Filesystem.cpp - appends the entries of `directory` that pass `is_scan_entry_included`
+bool native_scan_dir(const PathView& directory, const DirectoryScanInfo& info, DynamicArray<DirectoryEntryInfo>* entries);
+
+bool is_scan_entry_included(const DirectoryScanInfo& info, const PathView& path, const DirectoryEntryType type)
+{
+    const auto filename = path.filename();
+    for (const auto& name : info.exclude_names)
+    {
+        if (filename == name)
+        {
+            return false;
+        }
+    }
+
+    if (type != DirectoryEntryType::directory && !info.include_extensions.empty())
+    {
+        if (find_index(info.include_extensions, path.extension()) < 0)
+        {
+            return false;
+        }
+    }
+
+    return info.filter == nullptr || info.filter(path, type, info.filter_user_data);
+}
+
+struct DirectoryScan
+{
+    const DirectoryScanInfo*                        info { nullptr };
+    JobGroup                                        group;
+    FixedArray<DynamicArray<DirectoryEntryInfo>>    worker_entries;
+    DynamicArray<Path>                              pending_directories; // only used if the job system isn't running
+};
+
+static void scan_directory(DirectoryScan* scan, const Path& directory)
+{
+    DynamicArray<DirectoryEntryInfo> found;
+    native_scan_dir(directory.view(), *scan->info, &found);
+
+    const auto is_parallel = scan->worker_entries.size() > 1;
+    auto& results = scan->worker_entries[is_parallel ? job_worker_id() : 0];
+
+    for (auto& entry : found)
+    {
+        if (entry.type == DirectoryEntryType::directory)
+        {
+            if (scan->info->recursive)
+            {
+                if (is_parallel)
+                {
+                    auto* job = create_job(&scan_directory, scan, entry.path);
+                    job_schedule(&scan->group, job);
+                }
+                else
+                {
+                    scan->pending_directories.push_back(entry.path);
+                }
+            }
+
+            if (!scan->info->include_directories)
+            {
+                continue;
+            }
+        }
+
+        results.push_back(BEE_MOVE(entry));
+    }
+}
+
+bool scan_dir(const PathView& root, const DirectoryScanInfo& info, DynamicArray<DirectoryEntryInfo>* entries)
+{
+    if (!is_dir(root))
+    {
+        log_error("Failed to scan directory %" BEE_PRIsv ": not a directory", BEE_FMT_SV(root));
+        return false;
+    }
+
+    DirectoryScan scan;
+    scan.info = &info;
+
+    // job_wait has to be called from a worker or the main thread so scans on any other thread run serially
+    if (is_job_system_running() && job_worker_id() >= 0)
+    {
+        scan.worker_entries.resize(job_system_worker_count());
+        auto* job = create_job(&scan_directory, &scan, Path(root));
+        job_schedule(&scan.group, job);
+        job_wait(&scan.group);
+    }
+    else
+    {
+        scan.worker_entries.resize(1);
+        scan.pending_directories.emplace_back(root);
+
+        while (!scan.pending_directories.empty())
+        {
+            auto directory = BEE_MOVE(scan.pending_directories.back());
+            scan.pending_directories.pop_back();
+            scan_directory(&scan, directory);
+        }
+    }
+
+    int total_count = entries->size();
+    for (const auto& worker_entries : scan.worker_entries)
+    {
+        total_count += worker_entries.size();
+    }
+
+    entries->reserve(total_count);
+
+    for (auto& worker_entries : scan.worker_entries)
+    {
+        for (auto& entry : worker_entries)
+        {
+            entries->push_back(BEE_MOVE(entry));
+        }
+    }
+
+    return true;
+}
+
 File::File(File&& other) noexcept
 {
     if (is_valid())
@@ -289,6 +460,125 @@ FixedArray<u8> read_all_bytes(const PathView& path, Allocator* allocator)
     return read_all_bytes(file, allocator);
 }
 
+static bool is_chunk_read_complete(const i64 bytes_read, const i64 offset, const i64 chunk_size, const i64 file_size)
+{
+    const auto expected = math::min(chunk_size, file_size - offset);
+    if (bytes_read != expected)
+    {
+        log_error("Failed to read chunk at offset %" PRIi64 ": read %" PRIi64 " of %" PRIi64 " bytes", offset, bytes_read, expected);
+        return false;
+    }
+
+    return true;
+}
+
+i64 read_chunked(const File& file, const ChunkedReadInfo& info)
+{
+    BEE_ASSERT(file.is_valid());
+
+    if (BEE_FAIL_F(info.callback != nullptr, "ChunkedReadInfo::callback must not be null"))
+    {
+        return -1;
+    }
+
+    const auto alignment = unbuffered_io_alignment();
+    const auto chunk_size = static_cast<i64>(round_up(static_cast<size_t>(math::max(info.chunk_size, i64(1))), alignment));
+    const auto file_size = get_size(file);
+    const auto chunk_count = (file_size + chunk_size - 1) / chunk_size;
+
+    // Double buffer through async IO when it's available so the disk stays busy while the callback runs
+    const auto buffer_count = is_async_io_running() && chunk_count > 1 ? 2 : 1;
+    auto* buffers = static_cast<u8*>(BEE_MALLOC_ALIGNED(info.allocator, static_cast<size_t>(chunk_size * buffer_count), alignment));
+
+    i64 total_read = 0;
+    bool failed = false;
+
+    if (buffer_count == 1)
+    {
+        for (i64 chunk = 0; chunk < chunk_count; ++chunk)
+        {
+            const auto offset = chunk * chunk_size;
+            const auto bytes_read = read_at(file, offset, chunk_size, buffers);
+
+            if (!is_chunk_read_complete(bytes_read, offset, chunk_size, file_size))
+            {
+                failed = true;
+                break;
+            }
+
+            total_read += bytes_read;
+
+            if (!info.callback(buffers, bytes_read, offset, info.user_data))
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        AsyncIORequest requests[2];
+        i64 queued_count = 0;
+
+        for (; queued_count < buffer_count; ++queued_count)
+        {
+            async_read(&requests[queued_count], file, queued_count * chunk_size, chunk_size, buffers + queued_count * chunk_size);
+        }
+
+        for (i64 chunk = 0; chunk < chunk_count; ++chunk)
+        {
+            const auto buffer_index = chunk % buffer_count;
+            auto& request = requests[buffer_index];
+            auto* buffer = buffers + buffer_index * chunk_size;
+            const auto offset = chunk * chunk_size;
+
+            if (!async_io_wait(&request) || !is_chunk_read_complete(request.bytes_transferred(), offset, chunk_size, file_size))
+            {
+                failed = true;
+                break;
+            }
+
+            total_read += request.bytes_transferred();
+
+            if (!info.callback(buffer, request.bytes_transferred(), offset, info.user_data))
+            {
+                break;
+            }
+
+            // The callback is finished with the buffer so it can be reused for the chunk after the next one
+            if (queued_count < chunk_count)
+            {
+                async_read(&request, file, queued_count * chunk_size, chunk_size, buffer);
+                ++queued_count;
+            }
+        }
+
+        // Stopping early can leave a request in flight that still references the buffers
+        for (auto& request : requests)
+        {
+            if (request.is_pending())
+            {
+                async_io_wait(&request);
+            }
+        }
+    }
+
+    BEE_FREE(info.allocator, buffers);
+    return failed ? -1 : total_read;
+}
+
+i64 read_chunked(const PathView& path, const ChunkedReadInfo& info, const OpenMode mode)
+{
+    BEE_ASSERT_F((mode & OpenMode::read) != OpenMode::none, "read_chunked requires OpenMode::read");
+
+    auto file = open_file(path, mode);
+    if (!file)
+    {
+        return -1;
+    }
+
+    return read_chunked(file, info);
+}
+
 i64 write(const File& file, const StringView& string_to_write)
 {
     return write(file, string_to_write.data(), string_to_write.size());
@@ -322,6 +612,397 @@ i64 append_all(const PathView& path, const void* buffer, const i64 buffer_size)
     return size;
 }
 
+/*
+ *****************************************
+ *
+ * Atomic writes - implementation
+ *
+ *****************************************
+ */
+// Implemented in the platform-specific Filesystem.cpp - renames `src_path` over `dst_path`, replacing it if it exists
+bool native_replace_file(const PathView& src_path, const PathView& dst_path);
+
+// Flushes the contents of every file in `paths` to disk
+bool native_sync_file_data(const Path* const* paths, const i32 count);
+
+// Flushes the directory entries of every file in `paths` to disk, i.e. after they've been renamed
+bool native_sync_file_names(const Path* const* paths, const i32 count);
+
+static std::atomic<u64> g_temp_write_counter { 0 };
+static std::atomic<i32> g_write_batch_sync_count { 0 };
+
+i32 get_write_batch_sync_count()
+{
+    return g_write_batch_sync_count.load(std::memory_order_relaxed);
+}
+
+static void get_temp_write_path(const PathView& path, Path* dst)
+{
+    // The counter keeps names unique within this process and the timestamp keeps them unique between processes
+    const auto id = g_temp_write_counter.fetch_add(1, std::memory_order_relaxed);
+    *dst = path;
+    dst->append_extension(str::format("%" PRIx64 "-%" PRIx64, time::now(), id).view());
+    dst->append_extension("tmp");
+}
+
+static bool write_temp_file(const PathView& temp_path, const void* buffer, const i64 buffer_size)
+{
+    auto file = open_file(temp_path, OpenMode::write);
+    if (!file)
+    {
+        return false;
+    }
+
+    if (write(file, buffer, buffer_size) != buffer_size)
+    {
+        log_error("Failed to write temporary file %" BEE_PRIsv, BEE_FMT_SV(temp_path));
+        close_file(&file);
+        remove(temp_path);
+        return false;
+    }
+
+    return true;
+}
+
+i64 write_all_atomic(const PathView& path, const StringView& string_to_write)
+{
+    return write_all_atomic(path, string_to_write.data(), string_to_write.size());
+}
+
+i64 write_all_atomic(const PathView& path, const void* buffer, const i64 buffer_size)
+{
+    Path temp_path;
+    get_temp_write_path(path, &temp_path);
+
+    if (!write_temp_file(temp_path.view(), buffer, buffer_size))
+    {
+        return 0;
+    }
+
+    if (!native_replace_file(temp_path.view(), path))
+    {
+        remove(temp_path.view());
+        return 0;
+    }
+
+    return buffer_size;
+}
+
+FileWriteBatch::~FileWriteBatch()
+{
+    abort();
+}
+
+bool FileWriteBatch::write(const PathView& path, const StringView& string_to_write, u64* last_modified)
+{
+    return write(path, string_to_write.data(), string_to_write.size(), last_modified);
+}
+
+bool FileWriteBatch::write(const PathView& path, const void* buffer, const i64 buffer_size, u64* last_modified)
+{
+    Path temp_path;
+    get_temp_write_path(path, &temp_path);
+
+    if (!write_temp_file(temp_path.view(), buffer, buffer_size))
+    {
+        return false;
+    }
+
+    if (last_modified != nullptr)
+    {
+        *last_modified = fs::last_modified(temp_path.view());
+    }
+
+    add_write(Path(path), BEE_MOVE(temp_path));
+    return true;
+}
+
+void FileWriteBatch::add_write(Path&& path, Path&& temp_path)
+{
+    cancel_removal(path.view());
+
+    for (auto& pending : writes_)
+    {
+        if (pending.path == path)
+        {
+            fs::remove(pending.temp_path.view());
+            pending.temp_path = BEE_MOVE(temp_path);
+            return;
+        }
+    }
+
+    writes_.emplace_back();
+    writes_.back().path = BEE_MOVE(path);
+    writes_.back().temp_path = BEE_MOVE(temp_path);
+}
+
+bool FileWriteBatch::cancel_removal(const PathView& path)
+{
+    const auto index = find_index_if(removals_, [&](const Path& removal)
+    {
+        return removal == path;
+    });
+
+    if (index < 0)
+    {
+        return false;
+    }
+
+    removals_.erase(index);
+    return true;
+}
+
+void FileWriteBatch::remove(const PathView& path)
+{
+    const auto index = find_index_if(writes_, [&](const PendingWrite& pending)
+    {
+        return pending.path == path;
+    });
+
+    if (index >= 0)
+    {
+        fs::remove(writes_[index].temp_path.view());
+        writes_.erase(index);
+    }
+
+    if (!is_pending_removal(path))
+    {
+        removals_.emplace_back(path);
+    }
+}
+
+bool FileWriteBatch::is_pending_removal(const PathView& path) const
+{
+    return find_index_if(removals_, [&](const Path& removal)
+    {
+        return removal == path;
+    }) >= 0;
+}
+
+void FileWriteBatch::merge(FileWriteBatch* other)
+{
+    // `other` is newer than this batch so its removals are applied first in case it wrote a file this batch removed
+    for (auto& removal : other->removals_)
+    {
+        remove(removal.view());
+    }
+
+    for (auto& pending : other->writes_)
+    {
+        add_write(BEE_MOVE(pending.path), BEE_MOVE(pending.temp_path));
+    }
+
+    other->writes_.clear();
+    other->removals_.clear();
+}
+
+bool FileWriteBatch::commit()
+{
+    const bool success = commit_writes();
+    commit_removals();
+    return success;
+}
+
+bool FileWriteBatch::commit_writes()
+{
+    if (writes_.empty())
+    {
+        return true;
+    }
+
+    DynamicArray<const Path*> paths(temp_allocator());
+    paths.resize(writes_.size());
+
+    // Every temporary file has to be on disk before any of them replace the files they're for
+    for (int i = 0; i < writes_.size(); ++i)
+    {
+        paths[i] = &writes_[i].temp_path;
+    }
+
+    g_write_batch_sync_count.fetch_add(1, std::memory_order_relaxed);
+
+    if (!native_sync_file_data(paths.data(), paths.size()))
+    {
+        for (auto& pending : writes_)
+        {
+            fs::remove(pending.temp_path.view());
+        }
+
+        writes_.clear();
+        return false;
+    }
+
+    bool success = true;
+    int replaced_count = 0;
+
+    for (auto& pending : writes_)
+    {
+        if (native_replace_file(pending.temp_path.view(), pending.path.view()))
+        {
+            paths[replaced_count] = &pending.path;
+            ++replaced_count;
+        }
+        else
+        {
+            fs::remove(pending.temp_path.view());
+            success = false;
+        }
+    }
+
+    // `paths` points into the pending writes so they can't be cleared until the renames are synced
+    if (replaced_count > 0 && !native_sync_file_names(paths.data(), replaced_count))
+    {
+        success = false;
+    }
+
+    writes_.clear();
+    return success;
+}
+
+void FileWriteBatch::commit_removals()
+{
+    for (auto& removal : removals_)
+    {
+        if (removal.exists())
+        {
+            fs::remove(removal.view());
+        }
+    }
+
+    removals_.clear();
+}
+
+void FileWriteBatch::abort()
+{
+    for (auto& pending : writes_)
+    {
+        fs::remove(pending.temp_path.view());
+    }
+
+    writes_.clear();
+    removals_.clear();
+}
+
+bool get_file_hash128(const PathView& path, const u64 seed, u128* hash)
+{
+    i64 size = 0;
+    {
+        auto file = open_file(path, OpenMode::read);
+        if (!file.is_valid())
+        {
+            return false;
+        }
+        size = get_size(file);
+    }
+
+    // Empty files can't be mapped on all platforms
+    if (size <= 0)
+    {
+        *hash = get_hash128(nullptr, 0, seed);
+        return true;
+    }
+
+    MemoryMappedFile mapped{};
+    if (!mmap_file_map(&mapped, path, OpenMode::read))
+    {
+        return false;
+    }
+
+    *hash = get_parallel_hash128(mapped.data, static_cast<size_t>(size), seed);
+    return mmap_file_unmap(&mapped);
+}
+
+/*
+ ******************************************
+ *
+ * Memory mapped files - implementation
+ *
+ ******************************************
+ */
+struct SharedMemoryMappedFile
+{
+    MemoryMappedFile    mapped;
+    i32                 ref_count { 0 };
+    BEE_PAD(4);
+    Path                path;
+};
+
+struct SharedMemoryMappedFileCache
+{
+    Mutex                                               mutex;
+    DynamicHashMap<Path, SharedMemoryMappedFile*>       files;
+};
+
+static SharedMemoryMappedFileCache g_shared_mmaps;
+
+bool mmap_file_map(MemoryMappedFile* file, const PathView& path, const OpenMode open_mode)
+{
+    return mmap_file_map_range(file, path, open_mode, 0, -1);
+}
+
+const MemoryMappedFile* mmap_file_acquire_shared(const PathView& path)
+{
+    // The same file can be referred to by different relative paths so the cache is keyed on the normalized path
+    Path normalized(path);
+    normalized.normalize();
+
+    scoped_lock_t lock(g_shared_mmaps.mutex);
+
+    auto* existing = g_shared_mmaps.files.find(normalized);
+    if (existing != nullptr)
+    {
+        ++existing->value->ref_count;
+        return &existing->value->mapped;
+    }
+
+    auto* shared = BEE_NEW(system_allocator(), SharedMemoryMappedFile);
+    if (!mmap_file_map(&shared->mapped, normalized.view(), OpenMode::read))
+    {
+        BEE_DELETE(system_allocator(), shared);
+        return nullptr;
+    }
+
+    shared->ref_count = 1;
+    shared->path = normalized;
+    g_shared_mmaps.files.insert(BEE_MOVE(normalized), shared);
+    return &shared->mapped;
+}
+
+void mmap_file_release_shared(const MemoryMappedFile* file)
+{
+    if (file == nullptr)
+    {
+        return;
+    }
+
+    scoped_lock_t lock(g_shared_mmaps.mutex);
+
+    SharedMemoryMappedFile* shared = nullptr;
+    for (auto& entry : g_shared_mmaps.files)
+    {
+        if (&entry.value->mapped == file)
+        {
+            shared = entry.value;
+            break;
+        }
+    }
+
+    if (BEE_FAIL_F(shared != nullptr && shared->ref_count > 0, "Memory mapped file is not a shared mapping or was already released"))
+    {
+        return;
+    }
+
+    --shared->ref_count;
+    if (shared->ref_count > 0)
+    {
+        return;
+    }
+
+    g_shared_mmaps.files.erase(shared->path);
+    mmap_file_unmap(&shared->mapped);
+    BEE_DELETE(system_allocator(), shared);
+}
+
 /*
  ******************************************
  *
@@ -385,6 +1066,19 @@ void init_filesystem()
 
 void shutdown_filesystem()
 {
+    {
+        scoped_lock_t lock(g_shared_mmaps.mutex);
+
+        for (auto& shared : g_shared_mmaps.files)
+        {
+            log_warning("Shared memory mapped file %s was never released", shared.key.c_str());
+            mmap_file_unmap(&shared.value->mapped);
+            BEE_DELETE(system_allocator(), shared.value);
+        }
+
+        g_shared_mmaps.files.clear();
+    }
+
     destruct(&g_roots);
 }
 
@@ -33,7 +33,8 @@ BEE_FLAGS(OpenMode, u32)
     none    = 0u,
     read    = 1u << 0u,
     write   = 1u << 1u,
-    append  = 1u << 2u
+    append      = 1u << 2u,
+    unbuffered  = 1u << 3u  // bypasses the OS page cache - see `read_chunked`
 };
 
 
@@ -232,6 +233,14 @@ BEE_CORE_API i64 append_all(const PathView& path, const StringView& string_to_wr
 
 BEE_CORE_API i64 append_all(const PathView& path, const void* buffer, const i64 buffer_size);
 
+/*
+ * Positional reads and writes - these transfer data at `offset` rather than the files current offset so they can be
+ * used on the same file from multiple threads at once. The files current offset is unspecified afterwards
+ */
+BEE_CORE_API i64 read_at(const File& file, const i64 offset, const i64 size, void* buffer);
+
+BEE_CORE_API i64 write_at(const File& file, const i64 offset, const void* buffer, const i64 buffer_size);
+
 BEE_CORE_API bool remove(const PathView& filepath);
 
 BEE_CORE_API bool move(const PathView& current_path, const PathView& new_path);
@@ -248,6 +257,186 @@ BEE_CORE_API DirectoryIterator begin(const DirectoryIterator& iterator);
 
 BEE_CORE_API DirectoryIterator end(const DirectoryIterator&);
 
+/*
+ *********************************
+ *
+ * Unbuffered & chunked reads
+ *
+ * Files opened with `OpenMode::unbuffered` bypass the OS page cache (O_DIRECT on Linux, FILE_FLAG_NO_BUFFERING on
+ * Windows) so that streaming large artifacts that are only read once doesn't evict everything else from the cache or
+ * copy the data through it on the way to the caller. Every offset, size and buffer address used with an unbuffered
+ * file must be a multiple of `unbuffered_io_alignment()` - a read at the end of the file can request a full aligned
+ * size and returns only the bytes that exist. If the underlying filesystem doesn't support unbuffered IO the file is
+ * opened with regular buffering instead and `OpenMode::unbuffered` is cleared from the files mode.
+ *
+ * `read_chunked` reads a whole file in fixed-size chunks into aligned buffers allocated from `allocator` and passes
+ * each one to `callback` in order so that they can be copied straight into GPU staging memory or decompressed
+ * without first reading the entire file into memory. If async IO is running the next chunk is read while the
+ * callback consumes the current one
+ *
+ *********************************
+ */
+using read_chunk_callback_t = bool(*)(const void* chunk, const i64 chunk_size, const i64 offset, void* user_data);
+
+struct ChunkedReadInfo
+{
+    i64                     chunk_size { 4 * 1024 * 1024 }; // rounded up to a multiple of `unbuffered_io_alignment()`
+    Allocator*              allocator { system_allocator() };
+    read_chunk_callback_t   callback { nullptr };           // return false to stop reading
+    void*                   user_data { nullptr };
+};
+
+BEE_CORE_API size_t unbuffered_io_alignment();
+
+// Returns the number of bytes passed to `callback` or -1 if a read failed
+BEE_CORE_API i64 read_chunked(const File& file, const ChunkedReadInfo& info);
+
+BEE_CORE_API i64 read_chunked(const PathView& path, const ChunkedReadInfo& info, const OpenMode mode = OpenMode::read | OpenMode::unbuffered);
+
+/*
+ *********************************
+ *
+ * Atomic writes
+ *
+ * `write_all_atomic` writes to a temporary file next to `path` and renames it over the original so readers only
+ * ever see the old or new contents, never a partially written file. It doesn't flush anything to disk though so
+ * after a crash the rename may or may not have happened.
+ *
+ * `FileWriteBatch` stages many atomic writes and makes them durable all at once in `commit()` - rather than an
+ * fsync per file it syncs each filesystem the temporary files live on once (`syncfs` on Linux) before renaming them
+ * into place and again afterwards so the renames themselves are durable. Windows has no equivalent of `syncfs` that
+ * doesn't require admin rights so each temporary file is flushed instead and the renames are written through.
+ * Uncommitted writes are discarded when the batch is destroyed.
+ *
+ * Each write is atomic but the batch as a whole isn't - if a rename fails partway through `commit()` the files
+ * renamed before it stay in place. Callers that need the batch to line up with some other state (e.g. a database
+ * referencing the files) should only reference files by content or have readers tolerate the extra files.
+ * Removals are staged too and applied by `commit_removals()` so they can be held back until whatever referenced the
+ * files has committed. Batches can be merged into one another to sync many smaller units of work at once
+ *
+ *********************************
+ */
+BEE_CORE_API bool sync_file(const File& file);
+
+// Returns how many times a `FileWriteBatch` has synced its files since startup - useful for checking writes are batched
+BEE_CORE_API i32 get_write_batch_sync_count();
+
+BEE_CORE_API i64 write_all_atomic(const PathView& path, const StringView& string_to_write);
+
+BEE_CORE_API i64 write_all_atomic(const PathView& path, const void* buffer, const i64 buffer_size);
+
+class BEE_CORE_API FileWriteBatch final : public Noncopyable
+{
+public:
+    ~FileWriteBatch();
+
+    // Writing to a path that already has a pending write in the batch replaces it. Renames preserve the temporary
+    // files modification time so `last_modified` is the value `path` will have once the batch is committed
+    bool write(const PathView& path, const void* buffer, const i64 buffer_size, u64* last_modified = nullptr);
+
+    bool write(const PathView& path, const StringView& string_to_write, u64* last_modified = nullptr);
+
+    // Discards any pending write to `path` and stages it for removal - writing to it again cancels the removal
+    void remove(const PathView& path);
+
+    bool is_pending_removal(const PathView& path) const;
+
+    // Moves all of the writes and removals staged in `other` into this batch, replacing any for the same paths
+    void merge(FileWriteBatch* other);
+
+    // Syncs and renames the pending writes then applies the removals. Returns false if any of the writes couldn't be
+    // moved into place - the remaining ones are still committed
+    bool commit();
+
+    // Same as `commit()` but leaves the removals staged for `commit_removals()`
+    bool commit_writes();
+
+    // Removals aren't synced - losing one in a crash only leaves behind a file nothing references anymore
+    void commit_removals();
+
+    void abort();
+
+    inline i32 size() const
+    {
+        return writes_.size() + removals_.size();
+    }
+
+    inline bool empty() const
+    {
+        return writes_.empty() && removals_.empty();
+    }
+
+    inline Span<const Path> pending_removals() const
+    {
+        return removals_.const_span();
+    }
+
+private:
+    struct PendingWrite
+    {
+        Path    path;
+        Path    temp_path;
+    };
+
+    DynamicArray<PendingWrite>  writes_;
+    DynamicArray<Path>          removals_;
+
+    void add_write(Path&& path, Path&& temp_path);
+
+    bool cancel_removal(const PathView& path);
+};
+
+/*
+ *********************************
+ *
+ * Directory scanning
+ *
+ *********************************
+ */
+enum class DirectoryEntryType : u8
+{
+    unknown,
+    file,
+    directory,
+    symlink,
+    other
+};
+
+struct DirectoryEntryInfo
+{
+    Path                path;
+    u64                 last_modified { 0 };    // same units as `fs::last_modified` so the two can be compared
+    i64                 size { 0 };
+    u64                 inode { 0 };            // only available on Linux - 0 elsewhere
+    DirectoryEntryType  type { DirectoryEntryType::unknown };
+    BEE_PAD(7);
+};
+
+// Return false to skip the entry - skipped directories aren't descended into
+using directory_scan_filter_t = bool(*)(const PathView& path, const DirectoryEntryType type, void* user_data);
+
+struct DirectoryScanInfo
+{
+    bool                    recursive { true };
+    bool                    include_directories { false };  // add directories to the results as well as descending into them
+    BEE_PAD(6);
+    Span<const StringView>  include_extensions;             // i.e. ".png" - if empty, files with any extension are included
+    Span<const StringView>  exclude_names;                  // files and directories with these names are skipped, i.e. ".git"
+    directory_scan_filter_t filter { nullptr };
+    void*                   filter_user_data { nullptr };
+};
+
+/*
+ * Reads every entry under `root` along with its type, size and modification time in as few syscalls as possible
+ * (getdents64 + statx on Linux, FindFirstFileEx on Windows) so callers don't need an extra `is_dir`/`last_modified`
+ * per entry. If the job system is running each subdirectory is scanned in its own job. Symlinks are reported but
+ * never followed and the order of the results is unspecified. Returns false if `root` couldn't be read
+ */
+BEE_CORE_API bool scan_dir(const PathView& root, const DirectoryScanInfo& info, DynamicArray<DirectoryEntryInfo>* entries);
+
+// Gets the same info `scan_dir` returns for a single file or directory. Returns false if `path` doesn't exist
+BEE_CORE_API bool get_entry_info(const PathView& path, DirectoryEntryInfo* info);
+
 /*
  *********************************
  *
@@ -267,18 +456,75 @@ BEE_CORE_API Path user_local_appdata_path();
  *
  *********************************
  */
+enum class MemoryMappedAdvice
+{
+    normal,
+    sequential, // pages are read in order so the OS can read ahead more aggressively and drop pages behind the reader
+    random,     // disables read-ahead
+    will_need,  // starts reading the pages into the page cache without blocking
+    dont_need   // pages won't be needed any time soon and can be dropped from the page cache
+};
+
 struct MemoryMappedFile
 {
-    void*       data { nullptr };
+    void*       data { nullptr };       // start of the mapped range
+    i64         size { 0 };             // size of the mapped range in bytes
+    i64         offset { 0 };           // offset into the file that `data` starts at
+    i64         file_size { 0 };        // size of the whole file when it was mapped
+    void*       view { nullptr };       // start of the OS mapping - `data` rounded down to the mapping granularity
+    i64         view_size { 0 };
     void*       handles[2] { nullptr };
     OpenMode    mode { OpenMode::none };
     BEE_PAD(4);
+
+    inline bool is_mapped() const
+    {
+        return data != nullptr;
+    }
 };
 
 BEE_CORE_API bool mmap_file_map(MemoryMappedFile* file, const PathView& path, const OpenMode open_mode);
 
+/*
+ * Maps the `[offset, offset + size)` range of the file at `path`. `offset` doesn't need to be aligned to a page
+ * boundary - `data` will point at `offset` within the mapping. A negative `size` maps everything from `offset` to the
+ * end of the file
+ */
+BEE_CORE_API bool mmap_file_map_range(MemoryMappedFile* file, const PathView& path, const OpenMode open_mode, const i64 offset, const i64 size);
+
 BEE_CORE_API bool mmap_file_unmap(MemoryMappedFile* file);
 
+// Hints to the OS how the mapped range is about to be accessed. Unsupported hints are ignored
+BEE_CORE_API bool mmap_file_advise(const MemoryMappedFile& file, const MemoryMappedAdvice advice);
+
+// Starts reading `[offset, offset + size)` of the mapped range into memory in the background
+BEE_CORE_API bool mmap_file_prefetch(const MemoryMappedFile& file, const i64 offset, const i64 size);
+
+/*
+ * Shared mappings are read-only mappings of a whole file that are cached by path and reference counted so that
+ * several loaders reading the same file, i.e. an artifact with many streams, all share a single mapping. Every call
+ * to `mmap_file_acquire_shared` must be matched by a call to `mmap_file_release_shared` - the file is unmapped once
+ * the last reference is released. Returns nullptr if the file couldn't be mapped
+ */
+BEE_CORE_API const MemoryMappedFile* mmap_file_acquire_shared(const PathView& path);
+
+BEE_CORE_API void mmap_file_release_shared(const MemoryMappedFile* file);
+
+/*
+ *********************************
+ *
+ * File hashing
+ *
+ *********************************
+ */
+
+/**
+ * Hashes the contents of the file at `path` by memory mapping it and handing the mapped view to
+ * `get_parallel_hash128` so large files are hashed across the job system without being copied into memory.
+ * The resulting hash is identical to calling `get_parallel_hash128` on the files bytes
+ */
+BEE_CORE_API bool get_file_hash128(const PathView& path, const u64 seed, u128* hash);
+
 
 } // namespace fs
 
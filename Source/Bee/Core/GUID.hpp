@@ -120,7 +120,7 @@ struct Hash<GUID>
 {
     inline u32 operator()(const GUID& key) const
     {
-        return get_hash(key.data, sizeof(GUID), 0);
+        return get_fast_hash(key.data, sizeof(GUID), 0);
     }
 };
 
@@ -6,6 +6,9 @@
  */
 
 #include "Bee/Core/Hash.hpp"
+#include "Bee/Core/Jobs/JobSystem.hpp"
+#include "Bee/Core/Containers/Array.hpp"
+#include "Bee/Core/Math/Math.hpp"
 
 namespace bee {
 
@@ -26,6 +29,58 @@ u128 get_hash128(const void* input, const size_t length, const u64 seed)
     return u128(hash.low64, hash.high64);
 }
 
+u128 get_parallel_hash128(const void* input, const size_t length, const u64 seed, const size_t chunk_size)
+{
+    BEE_ASSERT(chunk_size > 0);
+
+    // Small inputs are hashed as a single leaf so they're identical to a regular XXH3-128 hash
+    if (length <= chunk_size)
+    {
+        return get_hash128(input, length, seed);
+    }
+
+    const auto chunk_count = sign_cast<i32>((length + chunk_size - 1) / chunk_size);
+    auto leaves = FixedArray<XXH128_hash_t>::with_size(chunk_count);
+    const auto* bytes = static_cast<const u8*>(input);
+
+    auto hash_leaf = [&](const i32 chunk)
+    {
+        const auto offset = static_cast<size_t>(chunk) * chunk_size;
+        const auto size = math::min(chunk_size, length - offset);
+        leaves[chunk] = XXH3_128bits_withSeed(bytes + offset, size, seed);
+    };
+
+    if (is_job_system_running() && chunk_count > 1)
+    {
+        JobGroup group{};
+        parallel_for(&group, chunk_count, 1, hash_leaf);
+        job_wait(&group);
+    }
+    else
+    {
+        for (int chunk = 0; chunk < chunk_count; ++chunk)
+        {
+            hash_leaf(chunk);
+        }
+    }
+
+    // The root also mixes in the total length and chunk size so trees with different shapes can't collide
+    XXH3_state_t root_state;
+    XXH3_128bits_reset_withSeed(&root_state, seed);
+    XXH3_128bits_update(&root_state, &length, sizeof(size_t));
+    XXH3_128bits_update(&root_state, &chunk_size, sizeof(size_t));
+
+    for (const auto& leaf : leaves)
+    {
+        XXH128_canonical_t canonical{};
+        XXH128_canonicalFromHash(&canonical, leaf);
+        XXH3_128bits_update(&root_state, &canonical, sizeof(XXH128_canonical_t));
+    }
+
+    const auto root = XXH3_128bits_digest(&root_state);
+    return u128(root.low64, root.high64);
+}
+
 HashState::HashState()
     : HashState(0xF00D)
 {}
@@ -33,6 +33,43 @@ BEE_CORE_API u64 get_hash64(const void* input, size_t length, u64 seed);
 
 BEE_CORE_API u128 get_hash128(const void* input, size_t length, u64 seed);
 
+/*
+ ******************************************************************************
+ *
+ * `get_fast_hash` - XXH3-64 folded down to 32 bits. XXH3 is significantly
+ * faster than XXH32 for both small keys and large buffers so this is what
+ * the `Hash<T>` functors use. The result isn't stable across xxHash versions
+ * so it should only be used for runtime hash tables and never persisted
+ *
+ ******************************************************************************
+ */
+BEE_FORCE_INLINE u64 get_fast_hash64(const void* input, const size_t length, const u64 seed)
+{
+    return XXH3_64bits_withSeed(input, length, seed);
+}
+
+BEE_FORCE_INLINE u32 get_fast_hash(const void* input, const size_t length, const u32 seed)
+{
+    const u64 hash = XXH3_64bits_withSeed(input, length, seed);
+    return static_cast<u32>(hash ^ (hash >> 32u));
+}
+
+/*
+ ******************************************************************************
+ *
+ * `get_parallel_hash128` - tree-hash of a large buffer. The input is split
+ * into `chunk_size` leaves that are hashed with XXH3-128 in parallel on the
+ * job system (or serially if it isn't running) and the root hash is computed
+ * over the leaf hashes. The result only depends on the input, seed and chunk
+ * size, never on the worker count. Inputs no larger than a single chunk
+ * produce exactly the same hash as `get_hash128`
+ *
+ ******************************************************************************
+ */
+static constexpr size_t parallel_hash_default_chunk_size = 4u * 1024u * 1024u;
+
+BEE_CORE_API u128 get_parallel_hash128(const void* input, size_t length, u64 seed, size_t chunk_size = parallel_hash_default_chunk_size);
+
 
 /*
  ***************************************************************************************
@@ -129,7 +166,7 @@ template <typename T>
 struct BEE_REFLECT() Hash {
     inline u32 operator()(const T& key) const
     {
-        return get_hash(&key, sizeof(T), 0xF00D);
+        return get_fast_hash(&key, sizeof(T), 0xF00D);
     }
 };
 
@@ -177,7 +214,7 @@ template <>
 struct Hash<i32> {
     inline u32 operator()(const i32 key) const
     {
-        return get_hash(&key, sizeof(i32), 0xF00D);
+        return get_fast_hash(&key, sizeof(i32), 0xF00D);
     }
 };
 
@@ -185,7 +222,7 @@ template <>
 struct Hash<u64> {
     inline u32 operator()(const u64 key) const
     {
-        return get_hash(&key, sizeof(u64), 0xF00D);
+        return get_fast_hash(&key, sizeof(u64), 0xF00D);
     }
 };
 
@@ -193,7 +230,7 @@ template <>
 struct Hash<i64> {
     inline u32 operator()(const i64 key) const
     {
-        return get_hash(&key, sizeof(i64), 0xF00D);
+        return get_fast_hash(&key, sizeof(i64), 0xF00D);
     }
 };
 
@@ -201,17 +238,17 @@ template <>
 struct Hash<String> {
     inline u32 operator()(const String& key) const
     {
-        return get_hash(key.data(), key.size(), 0xF00D);
+        return get_fast_hash(key.data(), key.size(), 0xF00D);
     }
 
     inline u32 operator()(const StringView& key) const
     {
-        return get_hash(key.data(), key.size(), 0xF00D);
+        return get_fast_hash(key.data(), key.size(), 0xF00D);
     }
 
     inline u32 operator()(const char* key) const
     {
-        return get_hash(key, str::length(key), 0xF00D);
+        return get_fast_hash(key, str::length(key), 0xF00D);
     }
 };
 
@@ -219,12 +256,12 @@ template <>
 struct Hash<StringView> {
     inline u32 operator()(const StringView& key) const
     {
-        return get_hash(key.data(), key.size(), 0xF00D);
+        return get_fast_hash(key.data(), key.size(), 0xF00D);
     }
 
     inline u32 operator()(const char* key) const
     {
-        return get_hash(key, str::length(key), 0xF00D);
+        return get_fast_hash(key, str::length(key), 0xF00D);
     }
 };
 
@@ -233,7 +270,7 @@ struct Hash<StaticString<Size>>
 {
     inline u32 operator()(const StaticString<Size>& key) const
     {
-        return get_hash(key.data(), key.size(), 0xF00D);
+        return get_fast_hash(key.data(), key.size(), 0xF00D);
     }
 };
 
@@ -241,7 +278,7 @@ template <>
 struct Hash<const char*> {
     inline u32 operator()(const char* key) const
     {
-        return get_hash(key, str::length(key), 0xF00D);
+        return get_fast_hash(key, str::length(key), 0xF00D);
     }
 };
 
@@ -249,7 +286,7 @@ template <>
 struct Hash<const char* const> {
     inline u32 operator()(const char* const key) const
     {
-        return get_hash(key, str::length(key), 0xF00D);
+        return get_fast_hash(key, str::length(key), 0xF00D);
     }
 };
 
@@ -258,7 +295,7 @@ struct Hash<u128>
 {
     inline u32 operator()(const u128& key) const
     {
-        return get_hash(&key, sizeof(u128), 0xF00D);
+        return get_fast_hash(&key, sizeof(u128), 0xF00D);
     }
 };
 
@@ -17,32 +17,37 @@ namespace io {
 
 void v_write(String* dst, const char* format, va_list args)
 {
-    const auto length = str::system_snprintf(nullptr, 0, format, args);
+    // vsnprintf consumes the va_list on SysV platforms so measuring the length needs its own copy
+    va_list length_args;
+    va_copy(length_args, args);
+    const auto length = str::system_snprintf(nullptr, 0, format, length_args);
+    va_end(length_args);
+
     const auto old_dst_size = dst->size();
     dst->insert(old_dst_size, length, '\0');
     // include null-terminator
     str::system_snprintf(dst->data() + old_dst_size, sign_cast<size_t>(length + 1), format, args);
 }
 
-i32 Stream::get_seek_position(const SeekOrigin origin, const i32 stream_size, const i32 current_offset, const i32 new_offset)
+i64 Stream::get_seek_position(const SeekOrigin origin, const i64 stream_size, const i64 current_offset, const i64 new_offset)
 {
     switch (origin)
     {
         case SeekOrigin::begin:
         {
-            return math::clamp(new_offset, 0, stream_size);
+            return math::clamp<i64>(new_offset, 0, stream_size);
             break;
         }
 
         case SeekOrigin::current:
         {
-            return math::clamp(current_offset + new_offset, 0, stream_size);
+            return math::clamp<i64>(current_offset + new_offset, 0, stream_size);
             break;
         }
 
         case SeekOrigin::end:
         {
-            return math::clamp(stream_size + new_offset, 0, stream_size);
+            return math::clamp<i64>(stream_size + new_offset, 0, stream_size);
             break;
         }
     }
@@ -58,7 +63,7 @@ i32 Stream::get_seek_position(const SeekOrigin origin, const i32 stream_size, co
  *
  *****************************************
  */
-i32 MemoryStream::read(void* dst_buffer, i32 dst_buffer_size)
+i64 MemoryStream::read(void* dst_buffer, i64 dst_buffer_size)
 {
     if (BEE_FAIL(can_read()))
     {
@@ -83,7 +88,7 @@ i32 MemoryStream::read(void* dst_buffer, i32 dst_buffer_size)
     return bytes_read;
 }
 
-i32 MemoryStream::write(const void* src_buffer, const i32 src_buffer_size)
+i64 MemoryStream::write(const void* src_buffer, const i64 src_buffer_size)
 {
     if (BEE_FAIL(can_write()))
     {
@@ -101,14 +106,14 @@ i32 MemoryStream::write(const void* src_buffer, const i32 src_buffer_size)
         write_size = capacity_ - current_offset_;
     }
 
-    write_size = math::max(write_size, 0);
+    write_size = math::max<i64>(write_size, 0);
     BEE_ASSERT(write_size >= 0);
 
     if (src_buffer != nullptr)
     {
         if (mode() == Mode::container && container_->size() < current_offset_ + write_size)
         {
-            container_->resize(current_offset_ + write_size);
+            container_->resize(sign_cast<i32>(current_offset_ + write_size));
             buffer_ = container_->data(); // fixup pointer to containers internal buffer
         }
 
@@ -120,7 +125,7 @@ i32 MemoryStream::write(const void* src_buffer, const i32 src_buffer_size)
     return write_size;
 }
 
-i32 MemoryStream::seek(const i32 offset, const SeekOrigin origin)
+i64 MemoryStream::seek(const i64 offset, const SeekOrigin origin)
 {
     current_offset_ = get_seek_position(origin, current_stream_size_, current_offset_, offset);
     return current_offset_;
@@ -152,14 +157,32 @@ static Stream::Mode open_mode_to_stream_mode(const fs::OpenMode access)
     return Stream::Mode::invalid;
 }
 
-FileStream::FileStream(fs::File* file)
+FileStream::FileStream(fs::File* file, const i32 buffer_size, Allocator* allocator)
     : Stream(open_mode_to_stream_mode(file->mode)),
       file_(file),
-      size_(sign_cast<i32>(fs::get_size(*file)))
-{}
+      size_(fs::get_size(*file)),
+      offset_(fs::tell(*file)),
+      file_offset_(offset_),
+      allocator_(allocator),
+      buffer_begin_(offset_),
+      buffer_capacity_(math::max(buffer_size, 0))
+{
+    if (buffer_capacity_ > 0)
+    {
+        buffer_ = static_cast<u8*>(BEE_MALLOC(allocator_, buffer_capacity_));
+    }
+}
 
 FileStream::~FileStream()
 {
+    flush();
+
+    if (buffer_ != nullptr)
+    {
+        BEE_FREE(allocator_, buffer_);
+        buffer_ = nullptr;
+    }
+
     file_ = nullptr;
 }
 
@@ -167,18 +190,63 @@ void FileStream::close()
 {
     if (file_ != nullptr)
     {
+        flush();
         fs::close_file(file_);
     }
 }
 
-i32 FileStream::read(void* dst_buffer, i32 dst_buffer_size)
+void FileStream::flush()
+{
+    if (!buffer_dirty_)
+    {
+        return;
+    }
+
+    buffer_dirty_ = false;
+
+    if (buffer_size_ > 0 && file_ != nullptr && file_->is_valid())
+    {
+        if (file_offset_ != buffer_begin_)
+        {
+            file_offset_ = fs::seek(*file_, buffer_begin_, SeekOrigin::begin);
+        }
+
+        const auto size_written = write_file(buffer_, buffer_size_);
+        BEE_ASSERT(size_written == buffer_size_);
+        BEE_UNUSED(size_written);
+    }
+
+    buffer_begin_ = offset_;
+    buffer_size_ = 0;
+}
+
+i64 FileStream::read_file(void* dst_buffer, const i64 size)
+{
+    const auto size_read = fs::read(*file_, size, dst_buffer);
+    file_offset_ += size_read;
+    return size_read;
+}
+
+i64 FileStream::write_file(const void* src_buffer, const i64 size)
+{
+    const auto size_written = fs::write(*file_, src_buffer, size);
+    file_offset_ += size_written;
+    return size_written;
+}
+
+i64 FileStream::read(void* dst_buffer, i64 dst_buffer_size)
 {
     if (BEE_FAIL(can_read()))
     {
         return 0;
     }
 
-    const auto size_read = sign_cast<i32>(fs::read(*file_, dst_buffer_size, dst_buffer));
+    if (is_buffered())
+    {
+        return read_buffered(dst_buffer, dst_buffer_size);
+    }
+
+    const auto size_read = fs::read(*file_, dst_buffer_size, dst_buffer);
     offset_ += size_read;
 
     BEE_ASSERT(size_read <= size_);
@@ -187,42 +255,159 @@ i32 FileStream::read(void* dst_buffer, i32 dst_buffer_size)
     return size_read;
 }
 
-i32 FileStream::write(const void* src_buffer, i32 src_buffer_size)
+i64 FileStream::read_buffered(void* dst_buffer, const i64 dst_buffer_size)
+{
+    // Pending writes need to hit the file before anything is read back
+    flush();
+
+    auto* dst = static_cast<u8*>(dst_buffer);
+    i64 total_read = 0;
+
+    while (total_read < dst_buffer_size && offset_ < size_)
+    {
+        const auto remaining = dst_buffer_size - total_read;
+
+        // Serve as much as possible from the read-ahead block
+        if (offset_ >= buffer_begin_ && offset_ < buffer_begin_ + buffer_size_)
+        {
+            const auto buffer_offset = offset_ - buffer_begin_;
+            const auto copy_size = math::min(remaining, buffer_size_ - buffer_offset);
+            memcpy(dst + total_read, buffer_ + buffer_offset, copy_size);
+            total_read += copy_size;
+            offset_ += copy_size;
+            continue;
+        }
+
+        if (file_offset_ != offset_)
+        {
+            file_offset_ = fs::seek(*file_, offset_, SeekOrigin::begin);
+        }
+
+        // Large reads skip the buffer entirely rather than copying through it
+        if (remaining >= buffer_capacity_)
+        {
+            const auto size_read = read_file(dst + total_read, remaining);
+            total_read += size_read;
+            offset_ += size_read;
+            break;
+        }
+
+        // Read ahead a whole block so the next small reads don't need to call into the OS
+        buffer_begin_ = offset_;
+        buffer_size_ = sign_cast<i32>(read_file(buffer_, buffer_capacity_));
+
+        if (buffer_size_ <= 0)
+        {
+            buffer_size_ = 0;
+            break;
+        }
+    }
+
+    return total_read;
+}
+
+i64 FileStream::write(const void* src_buffer, i64 src_buffer_size)
 {
     if (BEE_FAIL(can_write()))
     {
         return 0;
     }
 
-    const i32 size_written = sign_cast<i32>(fs::write(*file_, src_buffer, src_buffer_size));
+    if (is_buffered())
+    {
+        return write_buffered(src_buffer, src_buffer_size);
+    }
+
+    const auto size_written = fs::write(*file_, src_buffer, src_buffer_size);
     BEE_ASSERT(size_written == src_buffer_size);
 
-    size_ += size_written;
+    offset_ += size_written;
+    size_ = math::max(size_, offset_);
     return size_written;
 }
 
-i32 FileStream::write(const StringView& string)
+i64 FileStream::write_buffered(const void* src_buffer, const i64 src_buffer_size)
 {
-    if (BEE_FAIL(can_write()))
+    const auto* src = static_cast<const u8*>(src_buffer);
+    i64 total_written = 0;
+
+    if (!buffer_dirty_)
     {
-        return 0;
+        // drop any read-ahead data - it's cheaper to re-read it than to keep it coherent with the writes
+        buffer_begin_ = offset_;
+        buffer_size_ = 0;
+    }
+    else if (offset_ != buffer_begin_ + buffer_size_)
+    {
+        // the stream was seeked since the last write so the pending block isn't contiguous with this one
+        flush();
     }
 
-    const auto size_written = sign_cast<i32>(fs::write(*file_, string.data(), string.size()));
-    BEE_ASSERT(size_written == string.size());
+    while (total_written < src_buffer_size)
+    {
+        const auto remaining = src_buffer_size - total_written;
 
-    size_ += size_written;
-    return size_written;
+        if (buffer_size_ == 0 && remaining >= buffer_capacity_)
+        {
+            // Large writes skip the buffer entirely rather than copying through it
+            if (file_offset_ != offset_)
+            {
+                file_offset_ = fs::seek(*file_, offset_, SeekOrigin::begin);
+            }
+
+            const auto size_written = write_file(src + total_written, remaining);
+            BEE_ASSERT(size_written == remaining);
+
+            total_written += size_written;
+            offset_ += size_written;
+            buffer_begin_ = offset_;
+            break;
+        }
+
+        if (buffer_size_ == 0)
+        {
+            buffer_begin_ = offset_;
+        }
+
+        const auto copy_size = math::min(remaining, static_cast<i64>(buffer_capacity_ - buffer_size_));
+        memcpy(buffer_ + buffer_size_, src + total_written, copy_size);
+        buffer_size_ += sign_cast<i32>(copy_size);
+        buffer_dirty_ = true;
+        total_written += copy_size;
+        offset_ += copy_size;
+
+        if (buffer_size_ >= buffer_capacity_)
+        {
+            flush();
+        }
+    }
+
+    size_ = math::max(size_, offset_);
+    return total_written;
+}
+
+i64 FileStream::write(const StringView& string)
+{
+    return write(string.data(), string.size());
 }
 
-i32 FileStream::seek(const i32 offset, const SeekOrigin origin)
+i64 FileStream::seek(const i64 offset, const SeekOrigin origin)
 {
-    return sign_cast<i32>(fs::seek(*file_, offset, origin));
+    if (!is_buffered())
+    {
+        offset_ = fs::seek(*file_, offset, origin);
+        return offset_;
+    }
+
+    // Buffered streams just move the logical offset - the OS file pointer is only updated when the buffer next needs
+    // to read from or write to the file. Pending writes are flushed by the next write if it isn't contiguous
+    offset_ = get_seek_position(origin, size_, offset_, offset);
+    return offset_;
 }
 
-i32 FileStream::offset() const
+i64 FileStream::offset() const
 {
-    return sign_cast<i32>(fs::tell(*file_));
+    return offset_;
 }
 
 /*
@@ -262,7 +447,7 @@ StringStream::StringStream(String* read_write_string_container)
     string.container = read_write_string_container;
 }
 
-i32 StringStream::read(void* dst_buffer, i32 dst_buffer_size)
+i64 StringStream::read(void* dst_buffer, i64 dst_buffer_size)
 {
     if (BEE_FAIL(can_read()))
     {
@@ -283,29 +468,29 @@ i32 StringStream::read(void* dst_buffer, i32 dst_buffer_size)
     }
 
     memcpy(dst_buffer, data(), bytes_read);
-    current_offset_ = new_offset;
+    current_offset_ = sign_cast<i32>(new_offset);
     return bytes_read;
 }
 
 i32 StringStream::read(String* dst_string, const i32 dst_index, const i32 read_count)
 {
-    const auto total_read_size = math::min(read_count, size() - offset());
+    const auto total_read_size = math::min(read_count, sign_cast<i32>(size() - offset()));
     const auto read_end_pos = dst_index + total_read_size;
     if (read_end_pos > dst_string->size())
     {
         dst_string->insert(dst_string->size(), read_end_pos - dst_string->size(), '\0');
     }
-    return read(dst_string->data() + dst_index, total_read_size);
+    return sign_cast<i32>(read(dst_string->data() + dst_index, total_read_size));
 }
 
 i32 StringStream::read(String* dst_string)
 {
-    return read(dst_string, 0, size());
+    return read(dst_string, 0, sign_cast<i32>(size()));
 }
 
-i32 StringStream::write(const void* src_buffer, i32 src_buffer_size)
+i64 StringStream::write(const void* src_buffer, i64 src_buffer_size)
 {
-    int write_size = 0;
+    i64 write_size = 0;
 
     if (BEE_FAIL(can_write()))
     {
@@ -314,14 +499,14 @@ i32 StringStream::write(const void* src_buffer, i32 src_buffer_size)
 
     if (mode() == Mode::container && offset() + src_buffer_size > string.container->size())
     {
-        string.container->insert(offset(), src_buffer_size, '\0');
+        string.container->insert(current_offset_, sign_cast<i32>(src_buffer_size), '\0');
     }
 
     if (offset() < capacity())
     {
         write_size = math::min(capacity() - offset(), src_buffer_size);
         memcpy(data(), src_buffer, sizeof(char) * write_size);
-        current_offset_ += write_size;
+        current_offset_ += sign_cast<i32>(write_size);
 
         if (mode() != Mode::container)
         {
@@ -334,12 +519,12 @@ i32 StringStream::write(const void* src_buffer, i32 src_buffer_size)
 
 i32 StringStream::write(const char src)
 {
-    return write(&src, 1);
+    return sign_cast<i32>(write(&src, 1));
 }
 
 i32 StringStream::write(const StringView& src)
 {
-    return write(src.data(), src.size());
+    return sign_cast<i32>(write(src.data(), src.size()));
 }
 
 i32 StringStream::write_v(const char* fmt, va_list args)
@@ -354,21 +539,24 @@ i32 StringStream::write_v(const char* fmt, va_list args)
         return 0;
     }
 
-    const auto length_needed = str::system_snprintf(nullptr, 0, fmt, args);
+    va_list length_args;
+    va_copy(length_args, args);
+    const auto length_needed = str::system_snprintf(nullptr, 0, fmt, length_args);
+    va_end(length_args);
 
     if (mode() == Mode::container && offset() + length_needed > string.container->size())
     {
-        string.container->insert(offset(), length_needed, '\0');
+        string.container->insert(current_offset_, length_needed, '\0');
     }
 
-    const auto write_size = math::min(capacity() - offset(), length_needed);
-    str::system_snprintf(data(), capacity(), fmt, args);
+    const auto write_size = math::min(sign_cast<i32>(capacity() - offset()), length_needed);
+    str::system_snprintf(data(), sign_cast<size_t>(capacity()), fmt, args);
 
     current_offset_ += write_size;
 
     if (mode() != Mode::container)
     {
-        string.c_string.current_stream_size_ = math::max(offset(), string.c_string.current_stream_size_);
+        string.c_string.current_stream_size_ = math::max(current_offset_, string.c_string.current_stream_size_);
     }
 
     return write_size;
@@ -386,18 +574,18 @@ i32 StringStream::write_fmt(const char* format, ...)
     return write_size;
 }
 
-i32 StringStream::seek(i32 offset, const SeekOrigin origin)
+i64 StringStream::seek(i64 offset, const SeekOrigin origin)
 {
-    current_offset_ = get_seek_position(origin, size(), current_offset_, offset);
+    current_offset_ = sign_cast<i32>(get_seek_position(origin, size(), current_offset_, offset));
     return current_offset_;
 }
 
-i32 StringStream::offset() const
+i64 StringStream::offset() const
 {
     return current_offset_;
 }
 
-i32 StringStream::size() const
+i64 StringStream::size() const
 {
     return mode() == Mode::container ? string.container->size() : string.c_string.current_stream_size_;
 }
@@ -437,7 +625,7 @@ const char* StringStream::c_str() const
 
 StringView StringStream::view() const
 {
-    return StringView(c_str_buffer(), size());
+    return StringView(c_str_buffer(), sign_cast<i32>(size()));
 }
 
 String* StringStream::container() const
@@ -46,25 +46,25 @@ public:
 
     virtual ~Stream() = default;
 
-    virtual i32 write(const void* src_buffer, i32 src_buffer_size)
+    virtual i64 write(const void* src_buffer, i64 src_buffer_size)
     {
         // no-op
         return 0;
     }
 
-    virtual i32 read(void* dst_buffer, i32 dst_buffer_size)
+    virtual i64 read(void* dst_buffer, i64 dst_buffer_size)
     {
         // no-op
         return 0;
     }
 
-    virtual i32 seek(i32 offset, SeekOrigin origin) = 0;
+    virtual i64 seek(i64 offset, SeekOrigin origin) = 0;
 
-    virtual i32 offset() const = 0;
+    virtual i64 offset() const = 0;
 
-    virtual i32 size() const = 0;
+    virtual i64 size() const = 0;
 
-    virtual i32 capacity() const = 0;
+    virtual i64 capacity() const = 0;
 
     inline Mode mode() const
     {
@@ -84,7 +84,7 @@ protected:
     Mode stream_mode { Mode::invalid };
     BEE_PAD(4);
 
-    i32 get_seek_position(SeekOrigin origin, i32 stream_size, i32 current_offset, i32 new_offset);
+    i64 get_seek_position(SeekOrigin origin, i64 stream_size, i64 current_offset, i64 new_offset);
 };
 
 
@@ -104,14 +104,14 @@ public:
         : Stream(Mode::invalid)
     {}
 
-    MemoryStream(const void* read_only_buffer, const i32 buffer_capacity)
+    MemoryStream(const void* read_only_buffer, const i64 buffer_capacity)
         : Stream(Mode::read_only),
           capacity_(buffer_capacity),
           current_stream_size_(buffer_capacity),
           buffer_(const_cast<u8*>(static_cast<const u8*>(read_only_buffer)))
     {}
 
-    MemoryStream(void* read_write_buffer, const i32 buffer_capacity, const i32 initial_size)
+    MemoryStream(void* read_write_buffer, const i64 buffer_capacity, const i64 initial_size)
         : Stream(Mode::read_write),
           capacity_(buffer_capacity),
           current_stream_size_(initial_size),
@@ -126,19 +126,19 @@ public:
           container_(growable_buffer)
     {}
 
-    i32 read(void* dst_buffer, i32 dst_buffer_size) override;
+    i64 read(void* dst_buffer, i64 dst_buffer_size) override;
 
-    i32 write(const void* src_buffer, i32 src_buffer_size) override;
+    i64 write(const void* src_buffer, i64 src_buffer_size) override;
 
-    i32 seek(i32 offset, SeekOrigin origin) override;
+    i64 seek(i64 offset, SeekOrigin origin) override;
 
-    inline void set_stream_size(const i32 new_size)
+    inline void set_stream_size(const i64 new_size)
     {
         BEE_ASSERT(new_size >= 0 && new_size <= capacity_);
         current_stream_size_ = new_size;
     }
 
-    inline i32 offset() const override
+    inline i64 offset() const override
     {
         return current_offset_;
     }
@@ -153,20 +153,19 @@ public:
         return buffer_ + current_offset_;
     }
 
-    inline i32 size() const override
+    inline i64 size() const override
     {
         return current_stream_size_;
     }
 
-    inline i32 capacity() const override
+    inline i64 capacity() const override
     {
         return capacity_;
     }
 private:
-    i32                 current_offset_ { 0 };
-    i32                 capacity_ { 0 };
-    i32                 current_stream_size_ { 0 };
-    BEE_PAD(4);
+    i64                 current_offset_ { 0 };
+    i64                 capacity_ { 0 };
+    i64                 current_stream_size_ { 0 };
     u8*                 buffer_ { nullptr };
     DynamicArray<u8>*   container_ { nullptr };
 };
@@ -176,44 +175,84 @@ private:
  * # FileReader
  *
  * Reads data from a file into output buffers - can close the file automatically upon destruction if constructed with
- * this option
+ * this option.
+ *
+ * If constructed with a non-zero `buffer_size` the stream is buffered: writes are gathered into a block of
+ * `buffer_size` bytes and only written to the file once the block is full, the stream seeks somewhere else or is
+ * flushed/closed/destroyed, and reads fill the whole block from the file at once so subsequent small reads
+ * (i.e. a `StreamSerializer` reading one fundamental at a time) are served from memory. Reads and writes larger than
+ * the block go straight to the file
  */
 class BEE_CORE_API FileStream final : public Stream
 {
 public:
+    static constexpr i32 default_buffer_size = 64 * 1024;
+
     FileStream()
         : Stream(Mode::invalid)
     {}
 
-    FileStream(fs::File* file);
+    explicit FileStream(fs::File* file, const i32 buffer_size = 0, Allocator* allocator = system_allocator());
+
+    FileStream(const FileStream& other) = delete;
 
     ~FileStream() override;
 
+    FileStream& operator=(const FileStream& other) = delete;
+
     void close();
 
-    i32 read(void* dst_buffer, i32 dst_buffer_size) override;
+    void flush();
+
+    i64 read(void* dst_buffer, i64 dst_buffer_size) override;
 
-    i32 write(const void* src_buffer, i32 src_buffer_size) override;
+    i64 write(const void* src_buffer, i64 src_buffer_size) override;
 
-    i32 write(const StringView& string);
+    i64 write(const StringView& string);
 
-    i32 seek(i32 offset, SeekOrigin origin) override;
+    i64 seek(i64 offset, SeekOrigin origin) override;
 
-    i32 offset() const override;
+    i64 offset() const override;
 
-    inline i32 size() const override
+    inline i64 size() const override
     {
         return size_;
     }
 
-    inline i32 capacity() const override
+    inline i64 capacity() const override
+    {
+        return mode() == Mode::read_only ? size_ : limits::max<i64>();
+    }
+
+    inline bool is_buffered() const
+    {
+        return buffer_ != nullptr;
+    }
+
+    inline i32 buffer_size() const
     {
-        return mode() == Mode::read_only ? size_ : limits::max<i32>();
+        return buffer_capacity_;
     }
 private:
     fs::File*       file_ { nullptr };
-    i32             size_ { 0 };
-    i32             offset_ { 0 };
+    i64             size_ { 0 };
+    i64             offset_ { 0 };
+    i64             file_offset_ { 0 };     // the OS file pointer - only tracked for buffered streams
+    Allocator*      allocator_ { nullptr };
+    u8*             buffer_ { nullptr };
+    i64             buffer_begin_ { 0 };    // file offset of the first byte in the buffer
+    i32             buffer_capacity_ { 0 };
+    i32             buffer_size_ { 0 };     // bytes read into the buffer or pending writes if `buffer_dirty_` is set
+    bool            buffer_dirty_ { false };
+    BEE_PAD(7);
+
+    i64 read_buffered(void* dst_buffer, i64 dst_buffer_size);
+
+    i64 write_buffered(const void* src_buffer, i64 src_buffer_size);
+
+    i64 read_file(void* dst_buffer, i64 size);
+
+    i64 write_file(const void* src_buffer, i64 size);
 };
 
 
@@ -233,13 +272,13 @@ public:
 
     explicit StringStream(String* read_write_string_container);
 
-    i32 read(void* dst_buffer, i32 dst_buffer_size) override;
+    i64 read(void* dst_buffer, i64 dst_buffer_size) override;
 
     i32 read(String* dst_string, i32 dst_index, i32 read_count);
 
     i32 read(String* dst_string);
 
-    i32 write(const void* src_buffer, i32 src_buffer_size) override;
+    i64 write(const void* src_buffer, i64 src_buffer_size) override;
 
     i32 write(const char src);
 
@@ -249,13 +288,13 @@ public:
 
     i32 write_fmt(const char* format, ...) BEE_PRINTFLIKE(2, 3);
 
-    i32 seek(i32 offset, SeekOrigin origin) override;
+    i64 seek(i64 offset, SeekOrigin origin) override;
 
-    i32 offset() const override;
+    i64 offset() const override;
 
-    i32 size() const override;
+    i64 size() const override;
 
-    inline i32 capacity() const override
+    inline i64 capacity() const override
     {
         return mode() == Mode::container ? string.container->capacity() : string.c_string.capacity_;
     };
@@ -9,6 +9,10 @@
 #include "Bee/Core/Enum.hpp"
 #include "Bee/Core/JSON/JSON.hpp"
 #include "Bee/Core/IO.hpp"
+#include "Bee/Core/Bit.hpp"
+#include "Bee/Core/Hash.hpp"
+#include "Bee/Core/SIMD.hpp"
+#include "Bee/Core/Jobs/JobSystem.hpp"
 
 #include <string.h>
 #include <float.h> // for DBL_DECIMAL_DIG
@@ -26,91 +30,443 @@ BEE_TRANSLATION_TABLE_FUNC(get_type_name, ValueType, const char*, ValueType::unk
     "null"
 )
 
-const char* Cursor::operator++() noexcept
+/*
+ * Stage one - structural indexing
+ *
+ * The source is classified 64 bytes at a time into one bitmask per character class where bit N represents byte N of
+ * the block. Escaped quotes and string contents are resolved with bit operations on those masks, carrying state
+ * between blocks, so that the offsets of all structural characters, quotes and scalar starts can be extracted with a
+ * count-trailing-zeroes loop. Blocks that contain relaxed-syntax comments or multiline strings (or that start inside
+ * one) fall back to a byte-at-a-time scan that produces the exact same tokens and carried state
+ */
+static constexpr i32 structural_block_size = 64;
+
+struct BlockMasks
+{
+    u64 backslash { 0 };
+    u64 quote { 0 };
+    u64 single_quote { 0 };
+    u64 hash { 0 };
+    u64 op { 0 };
+    u64 whitespace { 0 };
+    u64 control { 0 };
+};
+
+struct StructuralScanState
+{
+    u64     in_string { 0 };            // all bits set if the previous block ended inside a string
+    u64     escape_carry { 0 };         // 1 if the previous block ended with an unescaped backslash
+    u64     scalar_carry { 0 };         // 1 if the previous block ended in the middle of a scalar
+    i32     multiline_skip { 0 };       // remaining bytes of a ''' sequence that started in the previous block
+    bool    in_comment { false };
+    bool    in_multiline_string { false };
+    BEE_PAD(2);
+};
+
+using classify_block_t = void(*)(const char* block, BlockMasks* masks);
+
+static bool is_structural_op(const char character)
 {
-    ++index;
-    if (index >= source_size)
+    switch (character)
     {
-        current = "\0";
-        index = source_size;
+        case '{': case '}': case '[': case ']': case ':': case ',': return true;
+        default: return false;
     }
-    else
+}
+
+static bool is_json_space(const char character)
+{
+    return character == ' ' || (character >= '\t' && character <= '\r');
+}
+
+static void classify_block_scalar(const char* block, BlockMasks* masks)
+{
+    *masks = BlockMasks{};
+
+    for (int i = 0; i < structural_block_size; ++i)
     {
-        ++current;
+        const auto bit = static_cast<u64>(1) << static_cast<u64>(i);
+        const auto character = block[i];
+
+        masks->backslash |= character == '\\' ? bit : 0;
+        masks->quote |= character == '"' ? bit : 0;
+        masks->single_quote |= character == '\'' ? bit : 0;
+        masks->hash |= character == '#' ? bit : 0;
+        masks->op |= is_structural_op(character) ? bit : 0;
+        masks->whitespace |= is_json_space(character) ? bit : 0;
+        masks->control |= static_cast<u8>(character) < 0x20 ? bit : 0;
     }
-    return current;
 }
 
-const char* Cursor::operator++(int) noexcept
+#if BEE_SIMD_X86 == 1
+
+static inline u64 movemask_sse2(const __m128i mask)
 {
-    const auto old_char = current;
-    ++*this;
-    return old_char;
+    return static_cast<u64>(static_cast<u32>(_mm_movemask_epi8(mask)));
 }
 
-const char* Cursor::operator--() noexcept
+static void classify_block_sse2(const char* block, BlockMasks* masks)
 {
-    --index;
-    if (index < 0)
-    {
-        index = 0;
-        current = source;
+    const auto backslash = _mm_set1_epi8('\\');
+    const auto quote = _mm_set1_epi8('"');
+    const auto single_quote = _mm_set1_epi8('\'');
+    const auto hash = _mm_set1_epi8('#');
+    const auto colon = _mm_set1_epi8(':');
+    const auto comma = _mm_set1_epi8(',');
+    const auto case_bit = _mm_set1_epi8(0x20);
+    const auto open_brace = _mm_set1_epi8('{');
+    const auto close_brace = _mm_set1_epi8('}');
+    const auto space = _mm_set1_epi8(' ');
+    const auto tab = _mm_set1_epi8('\t');
+    const auto carriage_return = _mm_set1_epi8('\r');
+    const auto max_control = _mm_set1_epi8(0x1F);
+
+    *masks = BlockMasks{};
+
+    for (int i = 0; i < structural_block_size; i += 16)
+    {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+
+        // '[' and ']' only differ from '{' and '}' by 0x20 so setting that bit matches both brackets with one compare
+        const auto folded = _mm_or_si128(chars, case_bit);
+        const auto op = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(folded, open_brace), _mm_cmpeq_epi8(folded, close_brace)),
+            _mm_or_si128(_mm_cmpeq_epi8(chars, colon), _mm_cmpeq_epi8(chars, comma))
+        );
+
+        // '\t', '\n', '\v', '\f' and '\r' are contiguous so can be tested with an unsigned range check
+        const auto whitespace = _mm_or_si128(
+            _mm_cmpeq_epi8(chars, space),
+            _mm_and_si128(
+                _mm_cmpeq_epi8(_mm_max_epu8(chars, tab), chars),
+                _mm_cmpeq_epi8(_mm_min_epu8(chars, carriage_return), chars)
+            )
+        );
+
+        const auto shift = static_cast<u64>(i);
+        masks->backslash |= movemask_sse2(_mm_cmpeq_epi8(chars, backslash)) << shift;
+        masks->quote |= movemask_sse2(_mm_cmpeq_epi8(chars, quote)) << shift;
+        masks->single_quote |= movemask_sse2(_mm_cmpeq_epi8(chars, single_quote)) << shift;
+        masks->hash |= movemask_sse2(_mm_cmpeq_epi8(chars, hash)) << shift;
+        masks->op |= movemask_sse2(op) << shift;
+        masks->whitespace |= movemask_sse2(whitespace) << shift;
+        masks->control |= movemask_sse2(_mm_cmpeq_epi8(_mm_min_epu8(chars, max_control), chars)) << shift;
     }
-    else
+}
+
+BEE_TARGET_AVX2 static inline u64 movemask_avx2(const __m256i mask)
+{
+    return static_cast<u64>(static_cast<u32>(_mm256_movemask_epi8(mask)));
+}
+
+BEE_TARGET_AVX2 static void classify_block_avx2(const char* block, BlockMasks* masks)
+{
+    const auto backslash = _mm256_set1_epi8('\\');
+    const auto quote = _mm256_set1_epi8('"');
+    const auto single_quote = _mm256_set1_epi8('\'');
+    const auto hash = _mm256_set1_epi8('#');
+    const auto colon = _mm256_set1_epi8(':');
+    const auto comma = _mm256_set1_epi8(',');
+    const auto case_bit = _mm256_set1_epi8(0x20);
+    const auto open_brace = _mm256_set1_epi8('{');
+    const auto close_brace = _mm256_set1_epi8('}');
+    const auto space = _mm256_set1_epi8(' ');
+    const auto tab = _mm256_set1_epi8('\t');
+    const auto carriage_return = _mm256_set1_epi8('\r');
+    const auto max_control = _mm256_set1_epi8(0x1F);
+
+    *masks = BlockMasks{};
+
+    for (int i = 0; i < structural_block_size; i += 32)
+    {
+        const auto chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+        const auto folded = _mm256_or_si256(chars, case_bit);
+        const auto op = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(folded, open_brace), _mm256_cmpeq_epi8(folded, close_brace)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chars, colon), _mm256_cmpeq_epi8(chars, comma))
+        );
+        const auto whitespace = _mm256_or_si256(
+            _mm256_cmpeq_epi8(chars, space),
+            _mm256_and_si256(
+                _mm256_cmpeq_epi8(_mm256_max_epu8(chars, tab), chars),
+                _mm256_cmpeq_epi8(_mm256_min_epu8(chars, carriage_return), chars)
+            )
+        );
+
+        const auto shift = static_cast<u64>(i);
+        masks->backslash |= movemask_avx2(_mm256_cmpeq_epi8(chars, backslash)) << shift;
+        masks->quote |= movemask_avx2(_mm256_cmpeq_epi8(chars, quote)) << shift;
+        masks->single_quote |= movemask_avx2(_mm256_cmpeq_epi8(chars, single_quote)) << shift;
+        masks->hash |= movemask_avx2(_mm256_cmpeq_epi8(chars, hash)) << shift;
+        masks->op |= movemask_avx2(op) << shift;
+        masks->whitespace |= movemask_avx2(whitespace) << shift;
+        masks->control |= movemask_avx2(_mm256_cmpeq_epi8(_mm256_min_epu8(chars, max_control), chars)) << shift;
+    }
+}
+
+#endif // BEE_SIMD_X86 == 1
+
+static classify_block_t select_classify_block()
+{
+#if BEE_SIMD_X86 == 1
+    return cpu_supports_avx2() ? classify_block_avx2 : classify_block_sse2;
+#else
+    return classify_block_scalar;
+#endif // BEE_SIMD_X86 == 1
+}
+
+/*
+ * Returns a mask of every byte that is preceded by an unescaped backslash. Backslashes are rare in practice so
+ * rather than the branchless odd-length-sequence trick this just walks each backslash and skips the byte it escapes
+ */
+static u64 find_escaped_bytes(u64 backslash, u64* escape_carry)
+{
+    auto escaped = *escape_carry;
+    backslash &= ~escaped;
+    *escape_carry = 0;
+
+    while (backslash != 0)
     {
-        --current;
+        const auto lowest = backslash & (~backslash + 1);
+        const auto next = lowest << 1u;
+
+        if (next == 0)
+        {
+            // a backslash in the last byte escapes the first byte of the next block
+            *escape_carry = 1;
+        }
+
+        escaped |= next;
+        backslash &= ~(lowest | next);
     }
-    return current;
+
+    return escaped;
 }
 
-const char* Cursor::operator--(int) noexcept
+/*
+ * Each bit of the result is the XOR of all the bits at or below it - for a mask of quotes this sets every bit from
+ * an opening quote up to but not including its closing quote
+ */
+static u64 prefix_xor(u64 bits)
 {
-    const auto old_char = current;
-    --*this;
-    return old_char;
+    bits ^= bits << 1u;
+    bits ^= bits << 2u;
+    bits ^= bits << 4u;
+    bits ^= bits << 8u;
+    bits ^= bits << 16u;
+    bits ^= bits << 32u;
+    return bits;
 }
 
-const char* Cursor::operator+=(const i32 value) noexcept
+static i32 index_block(
+    const BlockMasks&       masks,
+    const i32               block_offset,
+    StructuralScanState*    state,
+    i32*                    structurals,
+    i32                     count,
+    i32*                    string_control_char
+)
 {
-    index += value;
-    if (index >= source_size)
+    const auto quote = masks.quote & ~find_escaped_bytes(masks.backslash, &state->escape_carry);
+    const auto in_string = prefix_xor(quote) ^ state->in_string;
+    state->in_string = static_cast<u64>(static_cast<i64>(in_string) >> 63);
+
+    // unescaped control characters are invalid inside strings - remember the first one for stage two to report
+    const auto string_control = masks.control & in_string & ~quote;
+    if (string_control != 0 && *string_control_char < 0)
     {
-        index = source_size;
-        current = "\0";
+        *string_control_char = block_offset + sign_cast<i32>(count_trailing_zeroes_64(string_control));
     }
-    else
+
+    // scalars are runs of anything that isn't whitespace, structural or part of a string
+    const auto scalar = ~(masks.op | masks.whitespace | quote | in_string);
+    const auto scalar_start = scalar & ~((scalar << 1u) | state->scalar_carry);
+    state->scalar_carry = scalar >> 63u;
+
+    auto tokens = (masks.op & ~in_string) | quote | scalar_start;
+    while (tokens != 0)
     {
-        current += value;
+        structurals[count++] = block_offset + sign_cast<i32>(count_trailing_zeroes_64(tokens));
+        tokens &= tokens - 1;
     }
-    return current;
+
+    return count;
 }
 
-const char* Cursor::operator-=(const i32 value) noexcept
+static bool is_multiline_quote(const char* source, const i32 size, const i32 index)
 {
-    index -= value;
-    if (index < 0)
+    return index + 2 < size && source[index] == '\'' && source[index + 1] == '\'' && source[index + 2] == '\'';
+}
+
+static i32 index_block_scalar(
+    const char*             source,
+    const i32               size,
+    const i32               block_offset,
+    const ParseOptions&     options,
+    StructuralScanState*    state,
+    i32*                    structurals,
+    i32                     count,
+    i32*                    string_control_char
+)
+{
+    const auto block_end = math::min(block_offset + structural_block_size, size);
+
+    for (int index = block_offset; index < block_end; ++index)
     {
-        index = 0;
-        current = "\0";
+        const auto character = source[index];
+
+        if (state->multiline_skip > 0)
+        {
+            --state->multiline_skip;
+            continue;
+        }
+
+        if (state->in_comment)
+        {
+            state->in_comment = character != '\n';
+            continue;
+        }
+
+        if (state->in_multiline_string)
+        {
+            if (is_multiline_quote(source, size, index))
+            {
+                structurals[count++] = index;
+                state->in_multiline_string = false;
+                state->multiline_skip = 2;
+            }
+            continue;
+        }
+
+        const auto is_escaped = state->escape_carry != 0;
+        state->escape_carry = !is_escaped && character == '\\' ? 1 : 0;
+
+        if (state->in_string != 0)
+        {
+            if (!is_escaped && character == '"')
+            {
+                structurals[count++] = index;
+                state->in_string = 0;
+            }
+            else if (static_cast<u8>(character) < 0x20 && *string_control_char < 0)
+            {
+                *string_control_char = index;
+            }
+            continue;
+        }
+
+        if (!is_escaped && character == '"')
+        {
+            structurals[count++] = index;
+            state->in_string = ~static_cast<u64>(0);
+            state->scalar_carry = 0;
+            continue;
+        }
+
+        if (!is_escaped && options.allow_multiline_strings && is_multiline_quote(source, size, index))
+        {
+            structurals[count++] = index;
+            state->in_multiline_string = true;
+            state->multiline_skip = 2;
+            state->scalar_carry = 0;
+            continue;
+        }
+
+        if (!is_escaped && options.allow_comments && character == '#')
+        {
+            state->in_comment = true;
+            state->scalar_carry = 0;
+            continue;
+        }
+
+        if (is_structural_op(character))
+        {
+            structurals[count++] = index;
+            state->scalar_carry = 0;
+            continue;
+        }
+
+        if (is_json_space(character))
+        {
+            state->scalar_carry = 0;
+            continue;
+        }
+
+        if (state->scalar_carry == 0)
+        {
+            structurals[count++] = index;
+        }
+
+        state->scalar_carry = 1;
     }
-    else
+
+    return count;
+}
+
+/*
+ * Fills `structurals` with the offset of every token in `source` followed by the offset of its null terminator and
+ * returns the offset of the first control character found inside a string, or -1 if there isn't one
+ */
+static i32 build_structural_index(const char* source, const i32 size, const ParseOptions& options, DynamicArray<i32>* structurals)
+{
+    static const classify_block_t classify_block = select_classify_block();
+
+    // every byte is at most one token plus one for the null terminator
+    structurals->resize_no_raii(size + 1);
+
+    auto* tokens = structurals->data();
+    auto count = 0;
+    auto string_control_char = -1;
+    StructuralScanState state{};
+    BlockMasks masks{};
+    char last_block[structural_block_size];
+
+    for (int offset = 0; offset < size; offset += structural_block_size)
     {
-        current -= value;
+        const char* block = source + offset;
+
+        if (size - offset < structural_block_size)
+        {
+            // pad the last block with whitespace - it's never part of a token so produces nothing
+            memset(last_block, ' ', structural_block_size);
+            memcpy(last_block, block, sign_cast<size_t>(size - offset));
+            block = last_block;
+        }
+
+        classify_block(block, &masks);
+
+        const auto requires_scalar_scan = state.in_comment
+            || state.in_multiline_string
+            || state.multiline_skip > 0
+            || (options.allow_comments && masks.hash != 0)
+            || (options.allow_multiline_strings && masks.single_quote != 0);
+
+        if (requires_scalar_scan)
+        {
+            count = index_block_scalar(source, size, offset, options, &state, tokens, count, &string_control_char);
+        }
+        else
+        {
+            count = index_block(masks, offset, &state, tokens, count, &string_control_char);
+        }
     }
-    return current;
+
+    tokens[count++] = size;
+    structurals->resize_no_raii(count);
+    return string_control_char;
 }
 
-Document::Error::Error(const ErrorCode error_code, const Cursor* cursor, const char arg_char)
+Document::Error::Error(const ErrorCode error_code, const char* source, const i32 index, const char arg_char)
     : code(error_code),
-      current(*cursor->current),
+      current(source[index]),
       arg(arg_char)
 {
     column = 1;
     line = 1;
 
-    for (int i = 0; i < cursor->index; ++i)
+    for (int i = 0; i < index; ++i)
     {
-        if (cursor->source[i] == '\n')
+        if (source[i] == '\n')
         {
             column = 1;
             ++line;
@@ -121,7 +477,6 @@ Document::Error::Error(const ErrorCode error_code, const Cursor* cursor, const c
     }
 }
 
-
 Document::Document(const ParseOptions& parse_options)
     : options_(parse_options),
       allocator_(parse_options.allocation_mode, parse_options.initial_capacity)
@@ -130,10 +485,19 @@ Document::Document(const ParseOptions& parse_options)
 Document::Document(Document&& other) noexcept
     : options_(other.options_),
       parse_error_(other.parse_error_),
-      allocator_(BEE_MOVE(other.allocator_))
+      allocator_(BEE_MOVE(other.allocator_)),
+      structurals_(BEE_MOVE(other.structurals_)),
+      source_(other.source_),
+      source_size_(other.source_size_),
+      current_structural_(other.current_structural_),
+      string_control_char_(other.string_control_char_)
 {
     other.options_ = ParseOptions{};
     other.parse_error_ = Error{};
+    other.source_ = nullptr;
+    other.source_size_ = 0;
+    other.current_structural_ = 0;
+    other.string_control_char_ = -1;
 }
 
 Document& Document::operator=(Document&& other) noexcept
@@ -141,9 +505,18 @@ Document& Document::operator=(Document&& other) noexcept
     options_ = other.options_;
     parse_error_ = other.parse_error_;
     allocator_ = BEE_MOVE(other.allocator_);
+    structurals_ = BEE_MOVE(other.structurals_);
+    source_ = other.source_;
+    source_size_ = other.source_size_;
+    current_structural_ = other.current_structural_;
+    string_control_char_ = other.string_control_char_;
 
     other.options_ = ParseOptions{};
     other.parse_error_ = Error{};
+    other.source_ = nullptr;
+    other.source_size_ = 0;
+    other.current_structural_ = 0;
+    other.string_control_char_ = -1;
 
     return *this;
 }
@@ -223,6 +596,13 @@ String Document::get_error_string() const
 }
 
 
+u32 get_key_hash(const char* key, const i32 length)
+{
+    // must match `get_type_hash` in Reflection.cpp
+    return get_hash(key, sign_cast<size_t>(length), 0xb12e92e);
+}
+
+
 /*
  * Parsing functions
  */
@@ -231,65 +611,43 @@ bool Document::parse(char* source)
 {
     allocator_.reset();
 
-    Cursor cursor{};
-    cursor.index = 0;
-    cursor.source_size = sign_cast<i32>(str::length(source));
-    cursor.source = source;
-    cursor.current = source;
+    source_ = source;
+    source_size_ = sign_cast<i32>(str::length(source));
+    current_structural_ = 0;
+    string_control_char_ = build_structural_index(source_, source_size_, options_, &structurals_);
 
     if (options_.require_root_element)
     {
-        return parse_element(&cursor) && advance_on_char(&cursor, '\0');
+        return parse_value() && advance_on_char('\0');
     }
 
     // create an implicit root object
     const auto object_handle = allocator_.allocate(ValueType::object, nullptr, 0);
-    const auto old_size = allocator_.size();
 
-    if (!object_handle.is_valid())
+    if (!object_handle.is_valid() || allocator_.reserve(sizeof(ObjectMemberIndex)) == nullptr)
     {
-        parse_error_ = Error(ErrorCode::out_of_memory, &cursor);
+        set_error(ErrorCode::out_of_memory, current_position());
         return false;
     }
 
     // parse the members as if the root exists
-    if (!parse_members(&cursor, '\0'))
+    auto member_count = 0;
+    if (!parse_members('\0', &member_count))
     {
         return false;
     }
 
-    const auto object_data = allocator_.get(object_handle);
-    if (BEE_FAIL(object_data->is_valid()))
-    {
-        parse_error_ = Error(ErrorCode::invalid_allocation_data, &cursor);
-        return false;
-    }
-
-    // set object byte size
-    object_data->contents.integer_value = allocator_.size() - old_size;
-    return true;
+    return end_object(object_handle, member_count);
 }
 
-bool Document::is_whitespace(char character)
+void Document::set_error(const ErrorCode code, const i32 position, const char arg)
 {
-    return str::is_space(character) || (options_.allow_comments && character == '#');
+    parse_error_ = Error(code, source_, position, arg);
 }
 
-void Document::skip_whitespace(Cursor* cursor)
+bool Document::is_whitespace(char character)
 {
-    while (is_whitespace(*cursor->current))
-    {
-        if (*cursor->current == '#' && options_.allow_comments)
-        {
-            while (!cursor->is_newline_or_eof())
-            {
-                ++(*cursor);
-            }
-            continue;
-        }
-
-        ++(*cursor);
-    }
+    return str::is_space(character) || (options_.allow_comments && character == '#');
 }
 
 // valid as long as it matches [^,:[]{}\s]
@@ -307,142 +665,211 @@ bool Document::is_quote(char character)
     return character == '"' || character == '\'';
 }
 
-bool Document::advance_on_char(Cursor* cursor, char character)
+bool Document::advance_on_char(char character)
 {
-    if (*cursor->current == character)
+    if (current_char() == character)
     {
-        ++(*cursor);
+        ++current_structural_;
         return true;
     }
 
-    parse_error_ = Error(ErrorCode::expected_character, cursor, character);
+    set_error(ErrorCode::expected_character, current_position(), character);
     return false;
 }
 
-bool Document::advance_on_element_separator(Cursor* cursor)
+bool Document::advance_on_literal(const char* literal)
 {
-    if (options_.require_commas)
+    const auto position = current_position();
+    auto length = 0;
+
+    for (; literal[length] != '\0'; ++length)
     {
-        return advance_on_char(cursor, ',');
+        if (source_[position + length] != literal[length])
+        {
+            set_error(ErrorCode::expected_character, position + length, literal[length]);
+            return false;
+        }
     }
 
-    const auto previous_is_whitespace = cursor->index > 0 && is_whitespace(cursor->source[cursor->index - 1]);
-    const auto current_is_whitespace = is_whitespace(*cursor->current);
+    return advance_past_scalar(position + length);
+}
 
-    if (previous_is_whitespace || current_is_whitespace)
+// Numbers and literals have to be followed by whitespace or the next token (which may be the end of the source)
+bool Document::advance_past_scalar(const i32 scalar_end)
+{
+    if (!is_whitespace(source_[scalar_end]) && scalar_end != structurals_[current_structural_ + 1])
     {
-        skip_whitespace(cursor);
-        return true;
+        set_error(ErrorCode::unexpected_character, scalar_end);
+        return false;
     }
 
-    parse_error_ = Error(ErrorCode::expected_whitespace_separator, cursor);
-    return false;
+    ++current_structural_;
+    return true;
 }
 
-bool Document::parse_element(Cursor* cursor)
+bool Document::advance_on_element_separator()
 {
-    skip_whitespace(cursor);
-    if (!parse_value(cursor))
+    if (options_.require_commas)
     {
-        return false;
+        return advance_on_char(',');
     }
-    skip_whitespace(cursor);
-    return true;
+
+    // whitespace and comments are never indexed so check the byte right before the next token instead
+    const auto position = current_position();
+    if (position > 0 && is_whitespace(source_[position - 1]))
+    {
+        return true;
+    }
+
+    set_error(ErrorCode::expected_whitespace_separator, position);
+    return false;
 }
 
-bool Document::parse_value(Cursor* cursor)
+bool Document::parse_value()
 {
-    switch (*cursor->current)
+    switch (current_char())
     {
         case '{':
-            return parse_object(cursor);
+            return parse_object();
         case '[':
-            return parse_array(cursor);
+            return parse_array();
         case '"':
         case '\'':
-            return parse_string(cursor);
+            return parse_string();
         case '0': case '1': case '2': case '3': case '4':
         case '5': case '6': case '7': case '8': case '9':
         case '-':
-            return parse_number(cursor);
+            return parse_number();
         case 't':
-            return parse_true(cursor);
+            return parse_true();
         case 'f':
-            return parse_false(cursor);
+            return parse_false();
         case 'n':
-            return parse_null(cursor);
+            return parse_null();
         default:
             break;
     }
 
-    parse_error_ = Error(ErrorCode::unexpected_character, cursor);
+    set_error(ErrorCode::unexpected_character, current_position());
     return false;
 }
 
-bool Document::parse_object(Cursor* cursor)
+bool Document::parse_object()
 {
-    if (!advance_on_char(cursor, '{'))
+    if (!advance_on_char('{'))
     {
         return false;
     }
 
-    skip_whitespace(cursor);
-
     const auto object_handle = allocator_.allocate(ValueType::object, nullptr, 0);
-    const auto old_size = allocator_.size();
 
-    if (!object_handle.is_valid())
+    if (!object_handle.is_valid() || allocator_.reserve(sizeof(ObjectMemberIndex)) == nullptr)
     {
-        parse_error_ = Error(ErrorCode::out_of_memory, cursor);
+        set_error(ErrorCode::out_of_memory, current_position());
         return false;
     }
 
     auto valid = true;
-    if (*cursor->current != '}')
+    auto member_count = 0;
+    if (current_char() != '}')
     {
         // non-empty object
-        valid = parse_members(cursor, '}');
+        valid = parse_members('}', &member_count);
     }
 
-    if (!valid)
+    if (!valid || !advance_on_char('}'))
     {
         return false;
     }
 
-    const auto object_data = allocator_.get(object_handle);
-    if (BEE_FAIL(object_data->is_valid()))
+    return end_object(object_handle, member_count);
+}
+
+/*
+ * Objects are stored as an object header followed by the member index header, all the key/value pairs and finally
+ * the member index hash table if the object is large enough to have one:
+ *
+ * | object header | index header | key 0 | value 0 | ... | key N | value N | index slot 0 | ... | index slot M |
+ *
+ * The index is a power-of-two sized, linearly-probed table with a load factor of at most 0.5. Slots store the key
+ * hash and the keys offset from the object header so the table stays valid if the buffer is reallocated.
+ * Duplicate keys hash to the same chain in member order so lookups find the first one, same as a linear search
+ */
+bool Document::end_object(const ValueHandle& object, const i32 member_count)
+{
+    if (BEE_FAIL(allocator_.get(object)->is_valid()))
     {
-        parse_error_ = Error(ErrorCode::invalid_allocation_data, cursor);
+        set_error(ErrorCode::invalid_allocation_data, current_position());
         return false;
     }
 
-    if (!advance_on_char(cursor, '}'))
+    const auto members_begin = get_object_members_begin(object);
+    const auto members_size = allocator_.size() - members_begin;
+    auto slot_count = 0;
+
+    if (options_.build_member_index && member_count >= member_index_min_count)
     {
-        return false;
+        slot_count = sign_cast<i32>(math::to_next_pow2(sign_cast<u32>(member_count * 2)));
+
+        // Reserve the slots **before** getting pointers to the internals as the memory could move
+        if (allocator_.reserve(slot_count * sizeof(ObjectMemberIndexSlot)) == nullptr)
+        {
+            set_error(ErrorCode::out_of_memory, current_position());
+            return false;
+        }
+
+        auto slots = reinterpret_cast<ObjectMemberIndexSlot*>(allocator_.data() + members_begin + members_size);
+        memset(slots, 0, slot_count * sizeof(ObjectMemberIndexSlot));
+
+        const auto mask = sign_cast<u32>(slot_count - 1);
+        auto key_offset = members_begin;
+
+        for (int member = 0; member < member_count; ++member)
+        {
+            const auto key = allocator_.get({ key_offset })->as_string();
+            const auto hash = get_key_hash(key, sign_cast<i32>(str::length(key)));
+            auto slot = hash & mask;
+
+            while (slots[slot].key_offset != 0)
+            {
+                slot = (slot + 1) & mask;
+            }
+
+            slots[slot].hash = hash;
+            slots[slot].key_offset = key_offset - object.id;
+
+            // skip the key then skip the value and all of its children
+            const auto value = allocator_.get({ key_offset + sign_cast<i32>(sizeof(ValueData)) });
+            key_offset += 2 * sign_cast<i32>(sizeof(ValueData)) + (value->has_children() ? value->as_size() : 0);
+        }
     }
 
+    auto index = reinterpret_cast<ObjectMemberIndex*>(allocator_.data() + get_object_member_index(object));
+    index->members_size = members_size;
+    index->slot_count = slot_count;
+
     // set object byte size
-    object_data->contents.integer_value = allocator_.size() - old_size;
+    allocator_.get(object)->contents.integer_value = allocator_.size() - get_object_member_index(object);
     return true;
 }
 
-bool Document::parse_members(Cursor* cursor, const char end_char)
+bool Document::parse_members(const char end_char, i32* member_count)
 {
-    while (cursor->index < cursor->source_size)
+    while (current_position() < source_size_)
     {
-        if (!parse_member(cursor))
+        if (!parse_member())
         {
             return false;
         }
 
-        if (*cursor->current == end_char)
+        ++*member_count;
+
+        if (current_char() == end_char)
         {
             break;
         }
 
-        // TODO(Jacob): might need to double-check here that there's valid whitespace separating
-        //  elements
-        if (!advance_on_element_separator(cursor))
+        if (!advance_on_element_separator())
         {
             return false;
         }
@@ -451,194 +878,184 @@ bool Document::parse_members(Cursor* cursor, const char end_char)
     return true;
 }
 
-bool Document::parse_member(Cursor* cursor)
+bool Document::parse_member()
 {
-    skip_whitespace(cursor);
-
     // ProcessHandle quoted keys normally even if `require_string_keys` is on
-    if (options_.require_string_keys || (!options_.require_string_keys && is_quote(*cursor->current)))
+    if (options_.require_string_keys || is_quote(current_char()))
     {
-        // parse member key as string ws ':'
-        if (!parse_string(cursor))
+        // parse member key as string ':'
+        if (!parse_string())
         {
             return false;
         }
 
-        skip_whitespace(cursor);
-        if (!advance_on_char(cursor, ':'))
+        if (!advance_on_char(':'))
         {
             return false;
         }
     }
     else
     {
-        // parse member key as valid_unquoted_char+ ws ':'
-        const auto str_ptr = cursor->current;
-        while (is_valid_unquoted_char(*cursor->current))
+        // parse member key as valid_unquoted_char+ ':' - the key is a single scalar token in the index
+        char* str_ptr = source_ + current_position();
+        auto key_end = current_position();
+
+        while (is_valid_unquoted_char(source_[key_end]))
         {
-            ++(*cursor);
+            ++key_end;
         }
 
-        skip_whitespace(cursor);
+        if (key_end > current_position())
+        {
+            ++current_structural_;
+        }
 
-        if (*cursor->current != ':')
+        if (current_char() != ':')
         {
-            parse_error_ = Error(ErrorCode::expected_character, cursor, ':');
+            set_error(ErrorCode::expected_character, current_position(), ':');
             return false;
         }
 
-        cursor->source[cursor->index] = '\0';
-        ++(*cursor);
+        ++current_structural_;
+        source_[key_end] = '\0';
 
         if (!allocator_.allocate(ValueType::string, &str_ptr, sizeof(char*)).is_valid())
         {
-            parse_error_ = Error(ErrorCode::out_of_memory, cursor);
+            set_error(ErrorCode::out_of_memory, key_end);
             return false;
         }
     }
 
-    return parse_element(cursor);
+    return parse_value();
 }
 
-bool Document::parse_string(Cursor* cursor)
+bool Document::parse_string()
 {
-    if (*cursor->current != '"' && *cursor->current != '\'')
+    const auto begin = current_position();
+
+    if (source_[begin] == '\'')
+    {
+        return parse_multiline_string();
+    }
+
+    if (!advance_on_char('"'))
     {
         return false;
     }
 
-    if (*cursor->current == '\'')
+    // the closing quote is always the next token - unless the string is unterminated and it's the end of the source
+    const auto end = current_position();
+
+    // Ensure that any literal newlines, line feeds etc. control characters are parsed as an error in a string (must
+    // be in a single line). Stage one records the first of these so only the string containing it can fail
+    if (string_control_char_ > begin && string_control_char_ < end)
     {
-        return parse_multiline_string(cursor);
+        set_error(ErrorCode::unexpected_character, string_control_char_);
+        return false;
     }
 
-    if (!advance_on_char(cursor, '"'))
+    if (!advance_on_char('"'))
     {
         return false;
     }
 
-    auto str_begin_ptr = cursor->current;
-    auto str_end_ptr = cursor->source + cursor->index;
+    char* str_begin_ptr = source_ + begin + 1;
+    char* str_end_ptr = source_ + end;
+    auto escape_ptr = static_cast<char*>(memchr(str_begin_ptr, '\\', sign_cast<size_t>(end - begin - 1)));
 
-    while (cursor->index < cursor->source_size)
+    if (escape_ptr != nullptr)
     {
-        // Ensure that any literal newlines, line feeds etc. control characters
-        // are parsed as an error in a string (must be in a single line)
-        if (*cursor->current < 0x20)
-        {
-            parse_error_ = Error(ErrorCode::unexpected_character, cursor);
-            return false;
-        }
+        // TODO(Jacob): handle unicode sequences
 
-        // end of string
-        if (*cursor->current == '"')
+        // escaped char sequences - unescape in-place from the first backslash onwards, moving the rest of the
+        // string left over each removed backslash
+        auto dst_ptr = escape_ptr;
+        while (escape_ptr < str_end_ptr)
         {
-            // null-terminate the string sequence
-            *str_end_ptr = '\0';
-            ++(*cursor);
-            break;
-        }
-
-        ++(*cursor);
+            if (*escape_ptr != '\\')
+            {
+                *dst_ptr++ = *escape_ptr++;
+                continue;
+            }
 
-        // normal string content - add to current string
-        if (cursor->source[cursor->index - 1] != '\\')
-        {
-            *str_end_ptr++ = cursor->source[cursor->index - 1];
-            continue;
-        }
+            ++escape_ptr;
 
-        // TODO(Jacob): handle unicode sequences
+            char unescaped_char;
+            switch (*escape_ptr)
+            {
+                case '"': unescaped_char = '"'; break;
+                case '\\': unescaped_char = '\\'; break;
+                case '/': unescaped_char = '/'; break;
+                case 'n': unescaped_char = '\n'; break;
+                case 'b': unescaped_char = '\b'; break;
+                case 'f': unescaped_char = '\f'; break;
+                case 'r': unescaped_char = '\r'; break;
+                case 't': unescaped_char = '\t'; break;
+                case 'u':
+                default:
+                    set_error(ErrorCode::invalid_escape_sequence, sign_cast<i32>(escape_ptr - source_), *escape_ptr);
+                    return false;
+            }
 
-        // escaped char sequence - advance offset but retain current string position to move in-place and replace with
-        // unescaped character
-        char unescaped_char;
-        switch (*cursor->current)
-        {
-            case '"': unescaped_char = '"'; break;
-            case '\\': unescaped_char = '\\'; break;
-            case '/': unescaped_char = '/'; break;
-            case 'n': unescaped_char = '\n'; break;
-            case 'b': unescaped_char = '\b'; break;
-            case 'f': unescaped_char = '\f'; break;
-            case 'r': unescaped_char = '\r'; break;
-            case 't': unescaped_char = '\t'; break;
-            case 'u':
-            default:
-                parse_error_ = Error(ErrorCode::invalid_escape_sequence, cursor, *cursor->current);
-                return false;
+            // advance past the escaped char
+            ++escape_ptr;
+            *dst_ptr++ = unescaped_char;
         }
 
-        // advance past the escaped char
-        ++(*cursor);
-        *str_end_ptr++ = unescaped_char;
+        str_end_ptr = dst_ptr;
     }
 
-    // allow for null-terminated part
+    // null-terminate the string sequence
+    *str_end_ptr = '\0';
+
     if (!allocator_.allocate(ValueType::string, &str_begin_ptr, sizeof(char*)).is_valid())
     {
-        parse_error_ = Error(ErrorCode::out_of_memory, cursor);
+        set_error(ErrorCode::out_of_memory, end);
         return false;
     }
 
     return true;
 }
 
-bool Document::parse_multiline_string(Cursor* cursor)
+bool Document::parse_multiline_string()
 {
+    const auto begin = current_position();
+
     if (!options_.allow_multiline_strings)
     {
-        parse_error_ = Error(ErrorCode::unexpected_character, cursor);
+        set_error(ErrorCode::unexpected_character, begin);
         return false;
     }
 
     for (int i = 0; i < 3; ++i)
     {
-        if (!advance_on_char(cursor, '\''))
+        if (source_[begin + i] != '\'')
         {
+            set_error(ErrorCode::expected_character, begin + i, '\'');
             return false;
         }
     }
 
-    const auto begin = cursor->current;
-    bool is_multiline_end = false;
+    // stage one indexes the opening and closing ''' and skips everything in between
+    ++current_structural_;
 
-    while (cursor->index < cursor->source_size && *cursor->current != '\0')
+    const auto end = current_position();
+    if (end >= source_size_)
     {
-        if (*cursor->current == '\'')
-        {
-            /*
-             * try advance 3 quotes to find end of multiline and break
-             * out of while loop if we find this sequence
-             */
-            is_multiline_end = cursor->index < cursor->source_size - 2
-                && cursor->source[cursor->index + 1] == '\''
-                && cursor->source[cursor->index + 2] == '\'';
-
-            if (is_multiline_end)
-            {
-                break;
-            }
-        }
-
-        ++(*cursor);
-    }
-
-    if (!is_multiline_end)
-    {
-        parse_error_ = Error(ErrorCode::expected_multiline_end, cursor);
+        set_error(ErrorCode::expected_multiline_end, end);
         return false;
     }
 
-    cursor->source[cursor->index] = '\0';
+    ++current_structural_;
+    source_[end] = '\0';
 
-    if (!allocator_.allocate(ValueType::string, &begin, sizeof(char*)).is_valid())
+    char* str_begin_ptr = source_ + begin + 3;
+    if (!allocator_.allocate(ValueType::string, &str_begin_ptr, sizeof(char*)).is_valid())
     {
-        parse_error_ = Error(ErrorCode::out_of_memory, cursor);
+        set_error(ErrorCode::out_of_memory, end);
         return false;
     }
 
-    (*cursor) += 3; // advance past the '''
     return true;
 }
 
@@ -656,9 +1073,9 @@ bool Document::parse_multiline_string(Cursor* cursor)
  *
  * | array header | byte offset 0 | byte offset 1 | ... | byte offset N | child 0 | child 1 | ... | child N |
  */
-bool Document::parse_array(Cursor* cursor)
+bool Document::parse_array()
 {
-    if (!advance_on_char(cursor, '['))
+    if (!advance_on_char('['))
     {
         return false;
     }
@@ -668,44 +1085,43 @@ bool Document::parse_array(Cursor* cursor)
 
     if (!array_handle.is_valid())
     {
-        parse_error_ = Error(ErrorCode::out_of_memory, cursor);
+        set_error(ErrorCode::out_of_memory, current_position());
         return false;
     }
 
     auto element_count = 0;
-    if (*cursor->current != ']')
+    if (current_char() != ']')
     {
         // non-empty array, parse elements
-        while (cursor->index < cursor->source_size)
+        while (current_position() < source_size_)
         {
-            if (!parse_element(cursor))
+            if (!parse_value())
             {
                 return false;
             }
 
             ++element_count;
-            if (*cursor->current == ']')
+            if (current_char() == ']')
             {
                 break;
             }
 
-            if (!advance_on_element_separator(cursor))
+            if (!advance_on_element_separator())
             {
                 return false;
             }
         }
     }
 
-    if (!advance_on_char(cursor, ']'))
+    if (!advance_on_char(']'))
     {
-        parse_error_ = Error(ErrorCode::expected_character, cursor, ']');
         return false;
     }
 
     auto array_data = allocator_.get(array_handle);
     if (BEE_FAIL(array_data->is_valid()))
     {
-        parse_error_ = Error(ErrorCode::invalid_allocation_data, cursor);
+        set_error(ErrorCode::invalid_allocation_data, current_position());
         return false;
     }
 
@@ -720,13 +1136,10 @@ bool Document::parse_array(Cursor* cursor)
     // total array size - sizeof all element value's + the size needed to hold the element count & offsets buffer
     array_data->contents.integer_value = sign_cast<i64>(elements_size + offsets_size);
 
-    // test for empty array
-    if (elements_size <= 0)
-    {
-        return true;
-    }
-
     /*
+     * Empty arrays still get an offsets buffer holding a zero element count so that their size is accurate when
+     * walking over them as the child of another node.
+     *
      * Reserve offsets **before** getting pointers to the internals as the memory could have moved if parsing
      * in dynamic allocation mode and an allocation has happened
      */
@@ -758,122 +1171,128 @@ bool Document::parse_array(Cursor* cursor)
     return true;
 }
 
-bool Document::parse_number(Cursor* cursor)
+bool Document::parse_number()
 {
+    const auto begin = current_position();
+    const char* current = source_ + begin;
+
     // parse either sign or zero
     auto sign = 1.0;
 
-    if (*cursor->current == '-')
+    if (*current == '-')
     {
         sign = -1.0;
-        ++(*cursor);
+        ++current;
     }
 
     // parse the int part
-    auto int_part = 0;
-    if (*cursor->current != '0')
+    i64 int_part = 0;
+    if (*current != '0')
     {
-        while (*cursor->current >= '0' && *cursor->current <= '9')
+        while (*current >= '0' && *current <= '9')
         {
-            int_part = 10 * int_part + (*cursor->current - '0');
-            ++(*cursor);
+            int_part = 10 * int_part + (*current - '0');
+            ++current;
         }
     }
     else
     {
-        ++(*cursor);
+        ++current;
     }
 
     i64 frac_part = 0;
     i64 frac_denom = 1;
 
     // parse the fractional part
-    if (*cursor->current == '.')
+    if (*current == '.')
     {
-        ++(*cursor);
+        ++current;
 
-        if (*cursor->current < '0' || *cursor->current > '9')
+        if (*current < '0' || *current > '9')
         {
-            parse_error_ = Error(ErrorCode::number_missing_decimal, cursor);
+            set_error(ErrorCode::number_missing_decimal, sign_cast<i32>(current - source_));
             return false;
         }
 
         frac_part = 0;
-        while (*cursor->current >= '0' && *cursor->current <= '9')
+        while (*current >= '0' && *current <= '9')
         {
-            frac_part = 10 * frac_part + (*cursor->current - '0');
+            frac_part = 10 * frac_part + (*current - '0');
             frac_denom *= 10;
-            ++(*cursor);
+            ++current;
         }
     }
 
     // parse the exponent part
     int exp_sign = 1;
     int exp_part = 0;
-    if (*cursor->current == 'e' || *cursor->current == 'E')
+    if (*current == 'e' || *current == 'E')
     {
-        ++(*cursor);
-        if (*cursor->current == '-')
+        ++current;
+        if (*current == '-')
         {
             exp_sign = -1;
-            ++(*cursor);
+            ++current;
         }
-        else if (*cursor->current == '+')
+        else if (*current == '+')
         {
-            ++(*cursor);
+            ++current;
         }
 
-        if (*cursor->current < '0' || *cursor->current > '9')
+        if (*current < '0' || *current > '9')
         {
-            parse_error_ = Error(ErrorCode::numer_invalid_exponent, cursor);
+            set_error(ErrorCode::numer_invalid_exponent, sign_cast<i32>(current - source_));
             return false;
         }
 
         exp_part = 0;
-        while (*cursor->current >= '0' && *cursor->current <= '9')
+        while (*current >= '0' && *current <= '9')
         {
-            exp_part = 10 * exp_part + (*cursor->current - '0');
-            ++(*cursor);
+            exp_part = 10 * exp_part + (*current - '0');
+            ++current;
         }
     }
 
+    if (!advance_past_scalar(sign_cast<i32>(current - source_)))
+    {
+        return false;
+    }
+
     const auto coefficient_numer = static_cast<double>(frac_part);
     const auto coefficient = static_cast<double>(int_part) + coefficient_numer / static_cast<double>(frac_denom);
     // TODO(Jacob): possible optimization here with table lookup for pow10 instead of generic pow()
     const auto exp = math::pow(10.0, static_cast<double>(exp_sign * exp_part));
     const auto val = sign * coefficient * exp;
 
-    return allocator_.allocate(ValueType::number, &val, sizeof(double)).is_valid();
+    if (!allocator_.allocate(ValueType::number, &val, sizeof(double)).is_valid())
+    {
+        set_error(ErrorCode::out_of_memory, begin);
+        return false;
+    }
+
+    return true;
 }
 
-bool Document::parse_true(Cursor* cursor)
+bool Document::parse_true()
 {
-    const auto is_valid = advance_on_char(cursor, 't')
-                       && advance_on_char(cursor, 'r')
-                       && advance_on_char(cursor, 'u')
-                       && advance_on_char(cursor, 'e');
-    if (!is_valid) {
+    if (!advance_on_literal("true"))
+    {
         return false;
     }
 
     bool alloc_data = true;
-    if (!allocator_.allocate(ValueType::boolean, &alloc_data, sizeof(bool)).is_valid()) {
-        parse_error_ = Error(ErrorCode::out_of_memory, cursor);
+    if (!allocator_.allocate(ValueType::boolean, &alloc_data, sizeof(bool)).is_valid())
+    {
+        set_error(ErrorCode::out_of_memory, current_position());
         return false;
     }
 
     return true;
 }
 
-bool Document::parse_false(Cursor* cursor)
+bool Document::parse_false()
 {
-    const auto is_valid = advance_on_char(cursor, 'f')
-                       && advance_on_char(cursor, 'a')
-                       && advance_on_char(cursor, 'l')
-                       && advance_on_char(cursor, 's')
-                       && advance_on_char(cursor, 'e');
-
-    if (!is_valid)
+    if (!advance_on_literal("false"))
     {
         return false;
     }
@@ -881,20 +1300,16 @@ bool Document::parse_false(Cursor* cursor)
     bool alloc_data = false;
     if (!allocator_.allocate(ValueType::boolean, &alloc_data, sizeof(bool)).is_valid())
     {
-        parse_error_ = Error(ErrorCode::out_of_memory, cursor);
+        set_error(ErrorCode::out_of_memory, current_position());
         return false;
     }
 
     return true;
 }
 
-bool Document::parse_null(Cursor* cursor)
+bool Document::parse_null()
 {
-    const auto is_valid = advance_on_char(cursor, 'n')
-                       && advance_on_char(cursor, 'u')
-                       && advance_on_char(cursor, 'l')
-                       && advance_on_char(cursor, 'l');
-    if (!is_valid)
+    if (!advance_on_literal("null"))
     {
         return false;
     }
@@ -922,58 +1337,79 @@ bool Document::has_member(const ValueHandle& root, const char* key) const
     return get_member(root, key).is_valid();
 }
 
+bool Document::has_member(const ValueHandle& root, const char* key, const u32 key_hash) const
+{
+    return get_member(root, key, key_hash).is_valid();
+}
+
 ValueHandle Document::get_member(const ValueHandle& root, const char* key) const
 {
-    auto root_data = allocator_.get(root);
+    const auto root_data = allocator_.get(root);
     if (root_data == nullptr || !root_data->is_valid() || root_data->type != ValueType::object)
     {
         return ValueHandle{};
     }
 
-    // go to first member in object
-    const auto sizeof_value = sign_cast<i32>(sizeof(ValueData));
-    const auto root_size = root_data->as_size();
+    // only hash the key if the object actually has an index to look it up in
+    const auto index = reinterpret_cast<const ObjectMemberIndex*>(allocator_.data() + get_object_member_index(root));
+    const auto key_hash = index->slot_count > 0 ? get_key_hash(key, sign_cast<i32>(str::length(key))) : 0u;
+    return get_member(root, key, key_hash);
+}
+
+ValueHandle Document::get_member(const ValueHandle& root, const char* key, const u32 key_hash) const
+{
+    const auto root_data = allocator_.get(root);
+    if (root_data == nullptr || !root_data->is_valid() || root_data->type != ValueType::object)
+    {
+        return ValueHandle{};
+    }
 
-    ValueHandle cur_member_handle { root.id + sizeof_value };
-    auto cur_member = allocator_.get(cur_member_handle);
+    const auto sizeof_value = sign_cast<i32>(sizeof(ValueData));
+    const auto index = reinterpret_cast<const ObjectMemberIndex*>(allocator_.data() + get_object_member_index(root));
+    const auto members_begin = get_object_members_begin(root);
 
-    ValueHandle result{};
-    for (int cur_offset = 0; cur_offset < root_size; ++cur_offset)
+    if (index->slot_count > 0)
     {
-        if (strcmp(cur_member->as_string(), key) == 0)
-        {
-            // make sure we return the members value rather than the key
-            result.id = cur_member_handle.id + sizeof_value;
-            break;
-        }
+        // probe the member index until hitting an empty slot - the table is never more than half full
+        const auto slots = reinterpret_cast<const ObjectMemberIndexSlot*>(allocator_.data() + members_begin + index->members_size);
+        const auto mask = sign_cast<u32>(index->slot_count - 1);
 
-        // move past key to value to get size to advance
-        cur_member_handle.id += sizeof_value;
-        cur_member = allocator_.get(cur_member_handle);
-        if (cur_member == nullptr || !cur_member->is_valid())
+        for (auto slot = key_hash & mask; slots[slot].key_offset != 0; slot = (slot + 1) & mask)
         {
-            break;
-        }
+            if (slots[slot].hash != key_hash)
+            {
+                continue;
+            }
 
-        // advance past all children of the element if it has any, otherwise advance past the element
-        if (cur_member->has_children())
-        {
-            cur_member_handle.id += cur_member->as_size() + sizeof_value;
-        }
-        else
-        {
-            cur_member_handle.id += sizeof_value;
+            const auto key_id = root.id + slots[slot].key_offset;
+            if (strcmp(allocator_.get({ key_id })->as_string(), key) == 0)
+            {
+                // make sure we return the members value rather than the key
+                return ValueHandle { key_id + sizeof_value };
+            }
         }
 
-        // advance past the value
-        cur_member = allocator_.get(cur_member_handle);
-        if (cur_member == nullptr || !cur_member->is_valid())
+        return ValueHandle{};
+    }
+
+    // small or unindexed object - iterate all the members to find the key
+    const auto members_end = members_begin + index->members_size;
+
+    for (auto key_id = members_begin; key_id < members_end;)
+    {
+        const auto value_id = key_id + sizeof_value;
+
+        if (strcmp(allocator_.get({ key_id })->as_string(), key) == 0)
         {
-            break;
+            return ValueHandle { value_id };
         }
+
+        // advance past the value and all of its children if it has any
+        const auto value = allocator_.get({ value_id });
+        key_id = value_id + sizeof_value + (value->has_children() ? value->as_size() : 0);
     }
 
-    return result;
+    return ValueHandle{};
 }
 
 ValueType Document::get_member_type(const ValueHandle& root, const char* key) const
@@ -1087,14 +1523,92 @@ ArrayIterator Document::get_elements_iterator(const ValueHandle& root) const
  */
 void visit(const ValueHandle& handle, String* dst, const Document& src_doc, const i32 indent, const i32 depth);
 
-void write_to_string(String* dst, const Document& src_doc, const i32 indent)
+void write_indent(String* dst, const i32 indent_size, const i32 indent_count)
 {
-    visit(src_doc.root(), dst, src_doc, indent, 1);
+    str::format(dst, "%*s", indent_size * indent_count, "");
 }
 
-void write_indent(String* dst, const i32 indent_size, const i32 indent_count)
+// Roots with fewer children than this aren't worth the overhead of scheduling jobs
+static constexpr i32 parallel_write_min_children = 64;
+
+static void write_to_string_parallel(String* dst, const Document& src_doc, const i32 indent, JobGroup* group, const ValueType root_type)
 {
-    str::format(dst, "%*s", indent_size * indent_count, "");
+    const auto root = src_doc.root();
+
+    // Gather the roots children up front so they can be split into chunks - object members can only be iterated
+    DynamicArray<KeyValueIterItem> children;
+
+    if (root_type == ValueType::object)
+    {
+        for (auto& member : src_doc.get_members_range(root))
+        {
+            children.push_back(member);
+        }
+    }
+    else
+    {
+        for (auto elem : src_doc.get_elements_range(root))
+        {
+            children.push_back(KeyValueIterItem { nullptr, elem });
+        }
+    }
+
+    if (children.size() < parallel_write_min_children)
+    {
+        visit(root, dst, src_doc, indent, 1);
+        return;
+    }
+
+    // Several chunks per worker so one chunk of large children doesn't hold up the rest
+    const i32 chunk_count = math::max(1, math::min(children.size() / (parallel_write_min_children / 4), job_system_worker_count() * 4));
+    DynamicArray<String> chunks;
+    chunks.resize(chunk_count);
+
+    // Each chunk writes its children exactly as `visit` does for a depth of 1, including the trailing separator
+    parallel_for(group, chunk_count, 1, [&](const i32 chunk_index)
+    {
+        const i32 begin = (children.size() * chunk_index) / chunk_count;
+        const i32 end = (children.size() * (chunk_index + 1)) / chunk_count;
+        auto* chunk = &chunks[chunk_index];
+
+        for (int i = begin; i < end; ++i)
+        {
+            write_indent(chunk, indent, 1);
+            if (children[i].key != nullptr)
+            {
+                str::format(chunk, "\"%s\"", children[i].key);
+                str::format(chunk, ": ");
+            }
+            visit(children[i].value, chunk, src_doc, indent, 2);
+            chunk->append(",\n");
+        }
+    });
+
+    job_wait(group);
+
+    str::format(dst, root_type == ValueType::object ? "{\n" : "[\n");
+    for (const auto& chunk : chunks)
+    {
+        dst->append(chunk.view());
+    }
+
+    // remove the last comma
+    dst->remove(dst->size() - 2);
+    str::format(dst, "\n");
+    str::format(dst, root_type == ValueType::object ? "}" : "]");
+}
+
+void write_to_string(String* dst, const Document& src_doc, const i32 indent, JobGroup* group)
+{
+    const auto root_type = src_doc.get_data(src_doc.root()).type;
+
+    if (group != nullptr && is_job_system_running() && (root_type == ValueType::object || root_type == ValueType::array))
+    {
+        write_to_string_parallel(dst, src_doc, indent, group, root_type);
+        return;
+    }
+
+    visit(src_doc.root(), dst, src_doc, indent, 1);
 }
 
 void visit(const ValueHandle& handle, String* dst, const Document& src_doc, const i32 indent, const i32 depth)
@@ -19,9 +19,19 @@
  *
  * The parser is destructive - modifying the source string in-place to save copies. The AST is stored
  * as a linear buffer for cache locality as the major use of this API is iteration of nodes.
+ *
+ * Parsing happens in two stages. Stage one classifies the source 64 bytes at a time with SSE2/AVX2
+ * into bitmasks of quotes, backslashes, whitespace and structural characters, resolves escaped quotes
+ * and which bytes are inside strings using bit operations, and records the byte offset of every
+ * structural character, string quote and the first byte of every number/literal/unquoted key into a
+ * flat index. Blocks containing relaxed-syntax comments or multiline strings fall back to a scalar
+ * scan for that block only. Stage two walks the index to build the AST so it never has to look at
+ * whitespace, comments or string contents that don't contain escape sequences.
  * Memory is allocated using a stack allocator and can be a fixed size or dynamically growing. Object
- * member access is not constant time as it has to iterate over all members to find the right key. Array
- * access via `get_element` is constant time - Array's are stored alongside an 'offsets buffer' that
+ * member access is constant time on average - each object with more than a handful of members is
+ * followed by a small open-addressed hash table of its keys (see `ParseOptions::build_member_index`)
+ * and smaller objects are just iterated to find the right key. Array access via `get_element` is
+ * constant time - Array's are stored alongside an 'offsets buffer' that
  * stores the byte offset of each array element AST node, as well as an element count, which means that
  * accessing an element consists of one array lookup to find the elements AST byte offset and another to
  * index into the AST and retrieve the node.
@@ -41,6 +51,11 @@
 //  - optimizations
 
 namespace bee {
+
+
+class JobGroup;
+
+
 namespace json {
 
 
@@ -124,7 +139,16 @@ struct ParseOptions {
      */
     bool            allow_multiline_strings { false };
 
-    BEE_PAD(3);
+    /*
+     * If set to true, a hash table of member keys is built for each object while parsing so that
+     * `get_member` and `has_member` are constant time rather than iterating over all the members of the
+     * object. Objects with fewer than `Document::member_index_min_count` members are never indexed.
+     * This costs a little parse time and 8 bytes per member of memory so can be disabled for documents
+     * that are only ever iterated
+     */
+    bool            build_member_index { true };
+
+    BEE_PAD(2);
 
     // required to be set if `allocation_mode` is set to fixed
     i32             initial_capacity { 0 };
@@ -139,25 +163,6 @@ struct ParseOptions {
 };
 
 
-struct Cursor {
-    i32             index { 0 };
-    i32             source_size { 0 };
-    const char*     current { nullptr };
-    char*           source { nullptr };
-
-    const char* operator++() noexcept;
-    const char* operator++(int) noexcept;
-    const char* operator--() noexcept;
-    const char* operator--(int) noexcept;
-    const char* operator+=(i32 value) noexcept;
-    const char* operator-=(i32 value) noexcept;
-
-    inline bool is_newline_or_eof()
-    {
-        return *current == '\n' || *current == '\0';
-    }
-};
-
 enum class ErrorCode : i32 {
     none = 0,
     unexpected_character,
@@ -172,8 +177,18 @@ enum class ErrorCode : i32 {
 };
 
 
+/*
+ * Hash used for object member keys. This uses the same seed as `get_type_hash` so the `hash` of a reflected `Field`
+ * can be passed straight to `Document::get_member` without hashing the fields name again
+ */
+BEE_CORE_API u32 get_key_hash(const char* key, i32 length);
+
+
 class BEE_CORE_API Document {
 public:
+    // objects with fewer members than this are faster to search linearly than to hash the key
+    static constexpr i32 member_index_min_count = 8;
+
     explicit Document(const ParseOptions& parse_options);
     Document(Document&& other) noexcept;
     Document& operator=(Document&& other) noexcept;
@@ -195,9 +210,11 @@ public:
     ValueType get_type(const ValueHandle& value) const;
     ValueData get_data(const ValueHandle& handle) const;
 
-    /// Gets a handle to a member for a given key - has linear lookup time
+    /// Gets a handle to a member for a given key - has constant lookup time if the object has a member index
     bool has_member(const ValueHandle& root, const char* key) const;
+    bool has_member(const ValueHandle& root, const char* key, u32 key_hash) const;
     ValueHandle get_member(const ValueHandle& root, const char* key) const;
+    ValueHandle get_member(const ValueHandle& root, const char* key, u32 key_hash) const;
     ValueType get_member_type(const ValueHandle& root, const char* key) const;
     ValueData get_member_data(const ValueHandle& root, const char* key) const;
 
@@ -238,36 +255,62 @@ private:
         BEE_PAD(2);
 
         Error() = default;
-        Error(ErrorCode error_code, const Cursor* cursor, char arg_char = '\0');
+        Error(ErrorCode error_code, const char* source, i32 index, char arg_char = '\0');
     };
 
-    ParseOptions    options_;
-    Error           parse_error_;
-    ValueAllocator  allocator_;
+    ParseOptions        options_;
+    Error               parse_error_;
+    ValueAllocator      allocator_;
+
+    // stage one output - byte offset of each token in the source, terminated by the offset of the null terminator
+    DynamicArray<i32>   structurals_;
+    char*               source_ { nullptr };
+    i32                 source_size_ { 0 };
+    i32                 current_structural_ { 0 };
+    i32                 string_control_char_ { -1 };
+    BEE_PAD(4);
+
+    inline i32 current_position() const
+    {
+        return structurals_[current_structural_];
+    }
+
+    inline char current_char() const
+    {
+        return source_[structurals_[current_structural_]];
+    }
+
+    void set_error(ErrorCode code, i32 position, char arg = '\0');
 
     bool is_whitespace(char character);
-    void skip_whitespace(Cursor* cursor);
     bool is_valid_unquoted_char(char character);
     bool is_quote(char character);
-    bool advance_on_element_separator(Cursor* cursor);
-    bool advance_on_char(Cursor* cursor, char character);
-
-    bool parse_element(Cursor* cursor);
-    bool parse_value(Cursor* cursor);
-    bool parse_object(Cursor* cursor);
-    bool parse_members(Cursor* cursor, char end_char);
-    bool parse_member(Cursor* cursor);
-    bool parse_array(Cursor* cursor);
-    bool parse_string(Cursor* cursor);
-    bool parse_multiline_string(Cursor* cursor);
-    bool parse_number(Cursor* cursor);
-    bool parse_true(Cursor* cursor);
-    bool parse_false(Cursor* cursor);
-    bool parse_null(Cursor* cursor);
+    bool advance_on_element_separator();
+    bool advance_on_char(char character);
+    bool advance_on_literal(const char* literal);
+    bool advance_past_scalar(i32 scalar_end);
+
+    bool parse_value();
+    bool parse_object();
+    bool parse_members(char end_char, i32* member_count);
+    bool end_object(const ValueHandle& object, i32 member_count);
+    bool parse_member();
+    bool parse_array();
+    bool parse_string();
+    bool parse_multiline_string();
+    bool parse_number();
+    bool parse_true();
+    bool parse_false();
+    bool parse_null();
 };
 
 
-void BEE_CORE_API write_to_string(String* dst, const Document& src_doc, i32 indent);
+/*
+ * Pretty-prints the document. If `group` is not null and the job system is running, the members or elements of a
+ * large root object or array are printed in parallel chunks and spliced together in order - the output is identical
+ * to printing serially
+ */
+void BEE_CORE_API write_to_string(String* dst, const Document& src_doc, i32 indent, JobGroup* group = nullptr);
 
 
 } // namespace json
@@ -125,6 +125,41 @@ private:
     const ValueData* get_internal(const ValueHandle& handle) const;
 };
 
+/*
+ * Objects are stored as:
+ *
+ * | object header | member index header | key 0 | value 0 | ... | key N | value N | index slot 0 | ... | index slot M |
+ *
+ * The index slots form an open-addressed hash table of the objects keys so members can be found without walking
+ * the object. `slot_count` is zero if the object was too small to be worth indexing or if indexing was disabled in
+ * the documents `ParseOptions` in which case lookups fall back to iterating the members
+ */
+struct ObjectMemberIndex {
+    i32 members_size { 0 };
+    i32 slot_count { 0 };
+};
+
+struct ObjectMemberIndexSlot {
+    u32 hash { 0 };
+    i32 key_offset { 0 }; // byte offset of the members key from the object header - zero if the slot is empty
+};
+
+inline constexpr i32 get_object_member_index(const ValueHandle& object)
+{
+    return object.id + static_cast<i32>(sizeof(ValueData));
+}
+
+inline constexpr i32 get_object_members_begin(const ValueHandle& object)
+{
+    return object.id + static_cast<i32>(sizeof(ValueData)) + static_cast<i32>(sizeof(ObjectMemberIndex));
+}
+
+inline i32 get_object_members_end(const ValueAllocator* allocator, const ValueHandle& object)
+{
+    const auto index = reinterpret_cast<const ObjectMemberIndex*>(allocator->data() + get_object_member_index(object));
+    return get_object_members_begin(object) + index->members_size;
+}
+
 inline constexpr i32 get_offset_buffer_element_count(const ValueHandle& array)
 {
     return array.id + static_cast<i32>(sizeof(ValueData));
@@ -179,11 +214,16 @@ public:
 
     MaybeConstObjectIterator() = default;
 
+    // Skips past the object and its member index to the first child member
     MaybeConstObjectIterator(allocator_t* allocator, const ValueHandle& root)
+        : MaybeConstObjectIterator(allocator, ValueHandle { get_object_members_begin(root) }, 0)
+    {}
+
+    // Starts iterating at the member whose key is at `key` - the unused int disambiguates from the root constructor
+    MaybeConstObjectIterator(allocator_t* allocator, const ValueHandle& key, const i32 /* unused */)
         : allocator_(allocator)
     {
-        // Skip past object to first child member
-        current_member_.value.id = root.id + value_size_;
+        current_member_.value.id = key.id;
         move_past_key();
     }
 
@@ -269,7 +309,7 @@ public:
     ObjectRangeAdapter(allocator_t* allocator, const ValueHandle& root)
         : allocator_(allocator),
           root_(root),
-          end_({root.id + allocator->get(root)->as_size()})
+          end_({ get_object_members_end(allocator, root) })
     {}
 
     iterator_t begin()
@@ -279,7 +319,7 @@ public:
 
     iterator_t end()
     {
-        return iterator_t(allocator_, end_);
+        return iterator_t(allocator_, end_, 0);
     }
 
 private:
@@ -118,6 +118,24 @@ NullJob* create_null_job()
     return job;
 }
 
+Job* job_add_external(JobGroup* group)
+{
+    BEE_ASSERT(group != nullptr);
+
+    auto* job = create_null_job();
+    group->add_job(job);
+    return job;
+}
+
+void job_complete_external(Job* job)
+{
+    // signals the jobs group - the job is owned by the pool rather than whoever is waiting so it's safe to return it
+    // to the pool after the waiter has woken up
+    job->complete();
+    destruct(job);
+    g_job_system.free_jobs.push(cast_job_to_node(job));
+}
+
 void worker_execute_one_job(Worker* local_worker)
 {
     // check the thread local queue for a node
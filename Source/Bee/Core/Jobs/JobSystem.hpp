@@ -62,6 +62,15 @@ BEE_CORE_API Job* allocate_job();
 
 BEE_CORE_API NullJob* create_null_job();
 
+/*
+ * External jobs are added to a group like any other job but are never executed by a worker - instead they're completed
+ * by calling `job_complete_external` from any thread, i.e. when an async IO request finishes. Waiting on the group
+ * helps execute other jobs until all of its external jobs are completed
+ */
+BEE_CORE_API Job* job_add_external(JobGroup* group);
+
+BEE_CORE_API void job_complete_external(Job* job);
+
 BEE_FORCE_INLINE AtomicNode* cast_job_to_node(Job* job)
 {
     return reinterpret_cast<AtomicNode*>(reinterpret_cast<u8*>(job) - sizeof(AtomicNode));
@@ -0,0 +1,459 @@
+/*
+ *  Linux_AsyncIO.cpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#include "Bee/Core/AsyncIO.hpp"
+#include "Bee/Core/Linux/Linux_Filesystem.hpp"
+#include "Bee/Core/Logger.hpp"
+#include "Bee/Core/Math/Math.hpp"
+#include "Bee/Core/Thread.hpp"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+
+namespace bee {
+namespace fs {
+
+
+// Implemented in AsyncIO.cpp
+void complete_async_request(AsyncIORequest* request, const i64 result, const i32 error);
+
+
+/*
+ * io_uring is driven directly through its syscalls rather than liburing to avoid adding a dependency - the kernel
+ * shares two rings with us: the submission queue that we write requests to and the completion queue that the kernel
+ * writes results to. Submissions are serialized by a mutex and a single thread sleeps in `io_uring_enter` waiting
+ * for completions and completes each request as its result arrives
+ */
+struct IoUringContext
+{
+    int                 ring_fd { -1 };
+    u32                 sq_entries { 0 };
+
+    // submission queue ring
+    void*               sq_ring { nullptr };
+    size_t              sq_ring_size { 0 };
+    u32*                sq_head { nullptr };
+    u32*                sq_tail { nullptr };
+    u32*                sq_mask { nullptr };
+    u32*                sq_array { nullptr };
+    io_uring_sqe*       sqes { nullptr };
+    size_t              sqes_size { 0 };
+
+    // completion queue ring
+    void*               cq_ring { nullptr };
+    size_t              cq_ring_size { 0 };
+    u32*                cq_head { nullptr };
+    u32*                cq_tail { nullptr };
+    u32*                cq_mask { nullptr };
+    io_uring_cqe*       cqes { nullptr };
+
+    Mutex               submit_mutex;
+    std::atomic_int32_t in_flight { 0 };
+    std::atomic_bool    is_shutting_down { false };
+    BEE_PAD(3);
+    Thread              completion_thread;
+
+    // signalled by the completion thread when a submitter is waiting for requests to complete
+    Mutex               completion_mutex;
+    ConditionVariable   completion_cv;
+    std::atomic_int32_t completion_waiters { 0 };
+};
+
+static IoUringContext g_uring;
+
+
+static int io_uring_setup(const u32 entries, io_uring_params* params)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int io_uring_enter(const int fd, const u32 to_submit, const u32 min_complete, const u32 flags)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+static int io_uring_register(const int fd, const u32 opcode, const void* arg, const u32 arg_count)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, arg_count));
+}
+
+static inline u32 load_acquire(const u32* ptr)
+{
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+static inline void store_release(u32* ptr, const u32 value)
+{
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+template <typename T>
+static inline T* ring_offset(void* ring, const u32 offset)
+{
+    return reinterpret_cast<T*>(static_cast<u8*>(ring) + offset);
+}
+
+static void unmap_rings()
+{
+    if (g_uring.sqes != nullptr)
+    {
+        ::munmap(g_uring.sqes, g_uring.sqes_size);
+    }
+
+    if (g_uring.cq_ring != nullptr && g_uring.cq_ring != g_uring.sq_ring)
+    {
+        ::munmap(g_uring.cq_ring, g_uring.cq_ring_size);
+    }
+
+    if (g_uring.sq_ring != nullptr)
+    {
+        ::munmap(g_uring.sq_ring, g_uring.sq_ring_size);
+    }
+
+    if (g_uring.ring_fd >= 0)
+    {
+        ::close(g_uring.ring_fd);
+    }
+
+    g_uring.ring_fd = -1;
+    g_uring.sq_ring = nullptr;
+    g_uring.cq_ring = nullptr;
+    g_uring.sqes = nullptr;
+}
+
+static bool is_opcode_supported(const u8 opcode)
+{
+    static constexpr u32 probe_op_count = 256;
+
+    const size_t probe_size = sizeof(io_uring_probe) + probe_op_count * sizeof(io_uring_probe_op);
+    auto* probe = static_cast<io_uring_probe*>(BEE_MALLOC(system_allocator(), probe_size));
+    memset(probe, 0, probe_size);
+
+    bool is_supported = false;
+    if (io_uring_register(g_uring.ring_fd, IORING_REGISTER_PROBE, probe, probe_op_count) == 0 && opcode <= probe->last_op)
+    {
+        is_supported = (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED) != 0;
+    }
+
+    BEE_FREE(system_allocator(), probe);
+    return is_supported;
+}
+
+// Submits the first `count` entries added to the submission queue since the last call and waits until the kernel has
+// consumed all of them
+static void enter_submissions(u32 count)
+{
+    while (count > 0)
+    {
+        const auto submitted = io_uring_enter(g_uring.ring_fd, count, 0, 0);
+        if (submitted < 0)
+        {
+            // the completion queue is full - the completion thread will make room
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+            {
+                continue;
+            }
+
+            log_error("io_uring: failed to submit requests: %s", strerror(errno));
+            return;
+        }
+
+        count -= static_cast<u32>(submitted);
+    }
+}
+
+static io_uring_sqe* get_sqe(u32* pending_count)
+{
+    while (true)
+    {
+        const auto tail = *g_uring.sq_tail;
+        const auto head = load_acquire(g_uring.sq_head);
+
+        if (tail - head < g_uring.sq_entries)
+        {
+            auto* sqe = &g_uring.sqes[tail & *g_uring.sq_mask];
+            memset(sqe, 0, sizeof(io_uring_sqe));
+            g_uring.sq_array[tail & *g_uring.sq_mask] = tail & *g_uring.sq_mask;
+            return sqe;
+        }
+
+        // The submission queue is full so flush what's been added so far before adding any more
+        enter_submissions(*pending_count);
+        *pending_count = 0;
+    }
+}
+
+static bool has_free_slot()
+{
+    return g_uring.in_flight.load(std::memory_order_seq_cst) < static_cast<i32>(g_uring.sq_entries);
+}
+
+// Blocks until there's room for another request in the completion queue
+static void wait_for_free_slot()
+{
+    g_uring.completion_waiters.fetch_add(1, std::memory_order_seq_cst);
+    {
+        scoped_lock_t lock(g_uring.completion_mutex);
+        g_uring.completion_cv.wait(lock, has_free_slot);
+    }
+    g_uring.completion_waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+static void completion_loop()
+{
+    while (true)
+    {
+        auto head = *g_uring.cq_head;
+        const auto tail = load_acquire(g_uring.cq_tail);
+
+        if (head == tail)
+        {
+            if (g_uring.is_shutting_down.load(std::memory_order_acquire) && g_uring.in_flight.load(std::memory_order_acquire) <= 0)
+            {
+                break;
+            }
+
+            // Sleep until at least one request completes
+            if (io_uring_enter(g_uring.ring_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+            {
+                log_error("io_uring: failed to wait for completions: %s", strerror(errno));
+            }
+            continue;
+        }
+
+        while (head != tail)
+        {
+            const auto& cqe = g_uring.cqes[head & *g_uring.cq_mask];
+            auto* request = reinterpret_cast<AsyncIORequest*>(static_cast<uintptr_t>(cqe.user_data));
+            const auto res = cqe.res;
+            ++head;
+
+            // release the entry back to the kernel before completing the request so the queue never backs up
+            store_release(g_uring.cq_head, head);
+
+            // null requests are the no-op used to wake this thread at shutdown
+            if (request == nullptr)
+            {
+                continue;
+            }
+
+            g_uring.in_flight.fetch_sub(1, std::memory_order_seq_cst);
+            complete_async_request(request, res >= 0 ? res : 0, res >= 0 ? 0 : -res);
+        }
+
+        if (g_uring.completion_waiters.load(std::memory_order_seq_cst) > 0)
+        {
+            {
+                scoped_lock_t lock(g_uring.completion_mutex);
+            }
+            g_uring.completion_cv.notify_all();
+        }
+    }
+}
+
+bool native_async_io_init(const AsyncIOInitInfo& info)
+{
+    io_uring_params params{};
+    g_uring.ring_fd = io_uring_setup(static_cast<u32>(info.queue_depth), &params);
+
+    if (g_uring.ring_fd < 0)
+    {
+        // io_uring is commonly disabled in containers and sandboxes
+        log_warning("io_uring is unavailable (%s) - falling back to thread pool async IO", strerror(errno));
+        return false;
+    }
+
+    g_uring.sq_entries = params.sq_entries;
+    g_uring.sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(u32);
+    g_uring.cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    const auto is_single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (is_single_mmap)
+    {
+        g_uring.sq_ring_size = math::max(g_uring.sq_ring_size, g_uring.cq_ring_size);
+        g_uring.cq_ring_size = g_uring.sq_ring_size;
+    }
+
+    g_uring.sq_ring = ::mmap(nullptr, g_uring.sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, g_uring.ring_fd, IORING_OFF_SQ_RING);
+    if (g_uring.sq_ring == MAP_FAILED)
+    {
+        g_uring.sq_ring = nullptr;
+        log_error("io_uring: failed to map the submission queue: %s", strerror(errno));
+        unmap_rings();
+        return false;
+    }
+
+    if (is_single_mmap)
+    {
+        g_uring.cq_ring = g_uring.sq_ring;
+    }
+    else
+    {
+        g_uring.cq_ring = ::mmap(nullptr, g_uring.cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, g_uring.ring_fd, IORING_OFF_CQ_RING);
+        if (g_uring.cq_ring == MAP_FAILED)
+        {
+            g_uring.cq_ring = nullptr;
+            log_error("io_uring: failed to map the completion queue: %s", strerror(errno));
+            unmap_rings();
+            return false;
+        }
+    }
+
+    g_uring.sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    g_uring.sqes = static_cast<io_uring_sqe*>(::mmap(nullptr, g_uring.sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, g_uring.ring_fd, IORING_OFF_SQES));
+    if (g_uring.sqes == MAP_FAILED)
+    {
+        g_uring.sqes = nullptr;
+        log_error("io_uring: failed to map the submission entries: %s", strerror(errno));
+        unmap_rings();
+        return false;
+    }
+
+    g_uring.sq_head = ring_offset<u32>(g_uring.sq_ring, params.sq_off.head);
+    g_uring.sq_tail = ring_offset<u32>(g_uring.sq_ring, params.sq_off.tail);
+    g_uring.sq_mask = ring_offset<u32>(g_uring.sq_ring, params.sq_off.ring_mask);
+    g_uring.sq_array = ring_offset<u32>(g_uring.sq_ring, params.sq_off.array);
+    g_uring.cq_head = ring_offset<u32>(g_uring.cq_ring, params.cq_off.head);
+    g_uring.cq_tail = ring_offset<u32>(g_uring.cq_ring, params.cq_off.tail);
+    g_uring.cq_mask = ring_offset<u32>(g_uring.cq_ring, params.cq_off.ring_mask);
+    g_uring.cqes = ring_offset<io_uring_cqe>(g_uring.cq_ring, params.cq_off.cqes);
+
+    // IORING_OP_READ/WRITE were added in 5.6 - older kernels only support the vectored versions
+    if (!is_opcode_supported(IORING_OP_READ) || !is_opcode_supported(IORING_OP_WRITE))
+    {
+        log_warning("io_uring doesn't support IORING_OP_READ on this kernel - falling back to thread pool async IO");
+        unmap_rings();
+        return false;
+    }
+
+    g_uring.in_flight.store(0, std::memory_order_relaxed);
+    g_uring.is_shutting_down.store(false, std::memory_order_relaxed);
+
+    ThreadCreateInfo thread_info{};
+    thread_info.name = "Bee.AsyncIO";
+    g_uring.completion_thread = Thread(thread_info, &completion_loop);
+    return true;
+}
+
+void native_async_io_shutdown()
+{
+    {
+        scoped_lock_t lock(g_uring.submit_mutex);
+        g_uring.is_shutting_down.store(true, std::memory_order_release);
+
+        // wake the completion thread with a no-op in case nothing else is in flight
+        u32 pending_count = 0;
+        auto* sqe = get_sqe(&pending_count);
+        sqe->opcode = IORING_OP_NOP;
+        sqe->user_data = 0;
+        store_release(g_uring.sq_tail, *g_uring.sq_tail + 1);
+        enter_submissions(pending_count + 1);
+    }
+
+    g_uring.completion_thread.join();
+    unmap_rings();
+}
+
+void native_async_io_submit(AsyncIORequest* requests, const i32 count)
+{
+    BEE_UNUSED(count);
+
+    scoped_lock_t lock(g_uring.submit_mutex);
+
+    u32 pending_count = 0;
+    auto* request = requests;
+
+    while (request != nullptr)
+    {
+        // The request can complete and be reused as soon as it's submitted so the link has to be read first
+        auto* next = request->next;
+
+        if (request->size > limits::max<i32>())
+        {
+            complete_async_request(request, 0, EINVAL);
+            request = next;
+            continue;
+        }
+
+        // Don't allow more requests in flight than the completion queue can hold - anything added so far has to be
+        // submitted first or there may be nothing in flight to complete
+        if (!has_free_slot())
+        {
+            enter_submissions(pending_count);
+            pending_count = 0;
+            wait_for_free_slot();
+        }
+
+        auto* sqe = get_sqe(&pending_count);
+        const auto is_fixed = request->buffer_index >= 0;
+
+        if (request->operation == AsyncIOOperation::read)
+        {
+            sqe->opcode = is_fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        }
+        else
+        {
+            sqe->opcode = is_fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        }
+
+        sqe->fd = get_fd(*request->file);
+        sqe->off = static_cast<u64>(request->offset);
+        sqe->addr = reinterpret_cast<u64>(request->buffer);
+        sqe->len = static_cast<u32>(request->size);
+        sqe->buf_index = static_cast<u16>(is_fixed ? request->buffer_index : 0);
+        sqe->user_data = reinterpret_cast<u64>(request);
+
+        store_release(g_uring.sq_tail, *g_uring.sq_tail + 1);
+        g_uring.in_flight.fetch_add(1, std::memory_order_release);
+        ++pending_count;
+        request = next;
+    }
+
+    // The whole batch is submitted with a single syscall unless the queue filled up
+    enter_submissions(pending_count);
+}
+
+bool native_async_io_register_buffers(const AsyncIOBuffer* buffers, const i32 count)
+{
+    auto* iovecs = static_cast<iovec*>(BEE_MALLOC(system_allocator(), sizeof(iovec) * count));
+
+    for (int i = 0; i < count; ++i)
+    {
+        iovecs[i].iov_base = buffers[i].data;
+        iovecs[i].iov_len = static_cast<size_t>(buffers[i].size);
+    }
+
+    const auto result = io_uring_register(g_uring.ring_fd, IORING_REGISTER_BUFFERS, iovecs, static_cast<u32>(count));
+    BEE_FREE(system_allocator(), iovecs);
+
+    // registered buffers are pinned so this fails if they're larger than RLIMIT_MEMLOCK
+    if (result < 0)
+    {
+        log_error("io_uring: failed to register %d buffers: %s", count, strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+void native_async_io_unregister_buffers()
+{
+    if (io_uring_register(g_uring.ring_fd, IORING_UNREGISTER_BUFFERS, nullptr, 0) < 0)
+    {
+        log_error("io_uring: failed to unregister buffers: %s", strerror(errno));
+    }
+}
+
+
+} // namespace fs
+} // namespace bee
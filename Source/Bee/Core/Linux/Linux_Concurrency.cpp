@@ -0,0 +1,392 @@
+/*
+ *  Linux_Concurrency.cpp
+ *  Bee
+ *
+ *  Copyright (c) 2020 Jacob Milligan. All rights reserved.
+ */
+
+#include "Bee/Core/Concurrency.hpp"
+#include "Bee/Core/Error.hpp"
+#include "Bee/Core/Math/Math.hpp"
+
+#include <errno.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace bee {
+
+
+/*
+ * Mutexes spin for a short while before sleeping so that short critical sections don't pay for a syscall - this
+ * is roughly what a Win32 CRITICAL_SECTION does by default
+ */
+static constexpr i32 mutex_spin_count = 128;
+static constexpr i32 barrier_default_spin_count = 2048;
+
+
+// Spinning on a single CPU only burns the time slice the thread we're waiting on needs to make progress
+static bool is_multiprocessor()
+{
+    static const bool result = sysconf(_SC_NPROCESSORS_ONLN) > 1;
+    return result;
+}
+
+
+static inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif // arch
+}
+
+static long futex(futex_word_t* word, const int op, const u32 value, const timespec* timeout)
+{
+    // all of the primitives are process-local so the private flag lets the kernel skip the shared-mapping lookup
+    return syscall(SYS_futex, reinterpret_cast<u32*>(word), op | FUTEX_PRIVATE_FLAG, value, timeout, nullptr, 0);
+}
+
+// Returns false only if the wait timed out - spurious wakeups and value mismatches are left to the caller to retry
+static bool futex_wait(futex_word_t* word, const u32 expected, const timespec* timeout = nullptr)
+{
+    return futex(word, FUTEX_WAIT, expected, timeout) == 0 || errno != ETIMEDOUT;
+}
+
+static void futex_wake(futex_word_t* word, const i32 count)
+{
+    futex(word, FUTEX_WAKE, static_cast<u32>(count), nullptr);
+}
+
+static timespec ticks_to_timespec(const u64 ticks)
+{
+    const auto frequency = time::ticks_per_second();
+
+    timespec result{};
+    result.tv_sec = static_cast<time_t>(ticks / frequency);
+    result.tv_nsec = static_cast<long>(((ticks % frequency) * 1000000000ull) / frequency);
+    return result;
+}
+
+
+/*
+ * Futex mutex - see 'Futexes Are Tricky' (Ulrich Drepper) for the three-state design used here
+ */
+static bool mutex_try_lock(LinuxMutex* mutex)
+{
+    u32 expected = 0;
+    return mutex->state.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed);
+}
+
+static void mutex_lock_contended(LinuxMutex* mutex)
+{
+    // Always mark the mutex as contended from here on so whoever unlocks it next knows to wake another waiter
+    while (mutex->state.exchange(2, std::memory_order_acquire) != 0)
+    {
+        futex_wait(&mutex->state, 2);
+    }
+}
+
+static void mutex_lock(LinuxMutex* mutex)
+{
+    const auto spin_count = is_multiprocessor() ? mutex_spin_count : 1;
+
+    for (int i = 0; i < spin_count; ++i)
+    {
+        if (mutex_try_lock(mutex))
+        {
+            return;
+        }
+        cpu_relax();
+    }
+
+    mutex_lock_contended(mutex);
+}
+
+static void mutex_unlock(LinuxMutex* mutex)
+{
+    if (mutex->state.exchange(0, std::memory_order_release) == 2)
+    {
+        futex_wake(&mutex->state, 1);
+    }
+}
+
+
+Semaphore::Semaphore(const i32 initial_count, const i32 max_count) noexcept
+{
+    BEE_ASSERT_F(initial_count >= 0 && initial_count <= max_count, "Semaphore: invalid initial count");
+    native_handle.count.store(static_cast<u32>(initial_count), std::memory_order_relaxed);
+    native_handle.max_count = max_count;
+}
+
+Semaphore::Semaphore(const i32 initial_count, const i32 max_count, const char* name) noexcept
+    : Semaphore(initial_count, max_count)
+{
+    // Semaphores are process-local on Linux so there's nothing to attach the name to
+    BEE_UNUSED(name);
+}
+
+Semaphore::~Semaphore() = default;
+
+bool Semaphore::try_acquire()
+{
+    auto count = native_handle.count.load(std::memory_order_relaxed);
+    while (count > 0)
+    {
+        if (native_handle.count.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Semaphore::acquire()
+{
+    while (!try_acquire())
+    {
+        // the waiter count must be visible before sleeping so that release() knows it has to wake someone
+        native_handle.waiters.fetch_add(1, std::memory_order_seq_cst);
+        futex_wait(&native_handle.count, 0);
+        native_handle.waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+void Semaphore::release()
+{
+    release(1);
+}
+
+void Semaphore::release(const i32 count)
+{
+    const auto max_count = static_cast<u32>(native_handle.max_count);
+    auto old_count = native_handle.count.load(std::memory_order_relaxed);
+    u32 new_count = 0;
+
+    do
+    {
+        new_count = math::min(old_count + static_cast<u32>(count), max_count);
+    } while (!native_handle.count.compare_exchange_weak(old_count, new_count, std::memory_order_seq_cst, std::memory_order_relaxed));
+
+    if (new_count > old_count && native_handle.waiters.load(std::memory_order_seq_cst) > 0)
+    {
+        futex_wake(&native_handle.count, static_cast<i32>(new_count - old_count));
+    }
+}
+
+
+Barrier::Barrier(const i32 thread_count) noexcept
+    : Barrier(thread_count, -1)
+{}
+
+Barrier::Barrier(const i32 thread_count, const i32 spin_count) noexcept
+{
+    native_handle.remaining.store(thread_count, std::memory_order_relaxed);
+    native_handle.thread_count = thread_count;
+    // -1 lets the platform decide the spin count, same as InitializeSynchronizationBarrier
+    native_handle.spin_count = spin_count < 0 ? barrier_default_spin_count : spin_count;
+
+    if (!is_multiprocessor())
+    {
+        native_handle.spin_count = 0;
+    }
+}
+
+Barrier::~Barrier() = default;
+
+void Barrier::wait()
+{
+    const auto generation = native_handle.generation.load(std::memory_order_acquire);
+
+    if (native_handle.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        // last thread in: reset for the next phase before releasing everyone waiting on this one
+        native_handle.remaining.store(native_handle.thread_count, std::memory_order_relaxed);
+        native_handle.generation.fetch_add(1, std::memory_order_release);
+        futex_wake(&native_handle.generation, INT_MAX);
+        return;
+    }
+
+    for (int i = 0; i < native_handle.spin_count; ++i)
+    {
+        if (native_handle.generation.load(std::memory_order_acquire) != generation)
+        {
+            return;
+        }
+        cpu_relax();
+    }
+
+    while (native_handle.generation.load(std::memory_order_acquire) == generation)
+    {
+        futex_wait(&native_handle.generation, generation);
+    }
+}
+
+
+ReaderWriterMutex::ReaderWriterMutex() noexcept
+{
+    // Prefer writers to match SRWLOCK - the glibc default lets a steady stream of readers starve writers forever
+    pthread_rwlockattr_t attr;
+    pthread_rwlockattr_init(&attr);
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+    pthread_rwlock_init(&native_handle, &attr);
+    pthread_rwlockattr_destroy(&attr);
+}
+
+ReaderWriterMutex::~ReaderWriterMutex()
+{
+    pthread_rwlock_destroy(&native_handle);
+}
+
+void ReaderWriterMutex::lock_read()
+{
+    pthread_rwlock_rdlock(&native_handle);
+}
+
+bool ReaderWriterMutex::try_lock_read()
+{
+    return pthread_rwlock_tryrdlock(&native_handle) == 0;
+}
+
+void ReaderWriterMutex::unlock_read()
+{
+    pthread_rwlock_unlock(&native_handle);
+}
+
+void ReaderWriterMutex::lock_write()
+{
+    pthread_rwlock_wrlock(&native_handle);
+}
+
+bool ReaderWriterMutex::try_lock_write()
+{
+    return pthread_rwlock_trywrlock(&native_handle) == 0;
+}
+
+void ReaderWriterMutex::unlock_write()
+{
+    pthread_rwlock_unlock(&native_handle);
+}
+
+
+Mutex::Mutex() noexcept = default;
+
+Mutex::~Mutex() = default;
+
+void Mutex::lock()
+{
+    mutex_lock(&native_handle);
+}
+
+void Mutex::unlock()
+{
+    mutex_unlock(&native_handle);
+}
+
+bool Mutex::try_lock()
+{
+    return mutex_try_lock(&native_handle);
+}
+
+
+RecursiveMutex::RecursiveMutex() noexcept = default;
+
+RecursiveMutex::~RecursiveMutex() = default;
+
+void RecursiveMutex::lock()
+{
+    const auto thread_id = current_thread::id();
+
+    // only the owning thread can ever observe its own id here so a relaxed load is enough
+    if (native_handle.owner.load(std::memory_order_relaxed) == thread_id)
+    {
+        ++native_handle.lock_count;
+        return;
+    }
+
+    mutex_lock(&native_handle.mutex);
+    native_handle.owner.store(thread_id, std::memory_order_relaxed);
+    native_handle.lock_count = 1;
+}
+
+void RecursiveMutex::unlock()
+{
+    BEE_ASSERT_F(native_handle.owner.load(std::memory_order_relaxed) == current_thread::id(), "RecursiveMutex: unlocked by a thread that doesn't own it");
+
+    if (--native_handle.lock_count == 0)
+    {
+        native_handle.owner.store(0, std::memory_order_relaxed);
+        mutex_unlock(&native_handle.mutex);
+    }
+}
+
+bool RecursiveMutex::try_lock()
+{
+    const auto thread_id = current_thread::id();
+
+    if (native_handle.owner.load(std::memory_order_relaxed) == thread_id)
+    {
+        ++native_handle.lock_count;
+        return true;
+    }
+
+    if (!mutex_try_lock(&native_handle.mutex))
+    {
+        return false;
+    }
+
+    native_handle.owner.store(thread_id, std::memory_order_relaxed);
+    native_handle.lock_count = 1;
+    return true;
+}
+
+
+ConditionVariable::ConditionVariable() noexcept = default;
+
+void ConditionVariable::notify_one() noexcept
+{
+    native_handle.sequence.fetch_add(1, std::memory_order_release);
+    futex_wake(&native_handle.sequence, 1);
+}
+
+void ConditionVariable::notify_all() noexcept
+{
+    native_handle.sequence.fetch_add(1, std::memory_order_release);
+    futex_wake(&native_handle.sequence, INT_MAX);
+}
+
+static bool condition_variable_wait(LinuxConditionVariable* cv, LinuxMutex* mutex, const timespec* timeout)
+{
+    // read the sequence while still holding the lock - any notify after this point changes it and the wait returns immediately
+    const auto sequence = cv->sequence.load(std::memory_order_relaxed);
+
+    mutex_unlock(mutex);
+    const auto signaled = futex_wait(&cv->sequence, sequence, timeout);
+    mutex_lock_contended(mutex);
+
+    return signaled;
+}
+
+void ConditionVariable::wait(ScopedLock<Mutex>& lock)
+{
+    condition_variable_wait(&native_handle, &lock.mutex()->native_handle, nullptr);
+}
+
+bool ConditionVariable::wait_for(ScopedLock<Mutex>& lock, const TimePoint& duration)
+{
+    const auto timeout = ticks_to_timespec(duration.ticks());
+    return condition_variable_wait(&native_handle, &lock.mutex()->native_handle, &timeout);
+}
+
+bool ConditionVariable::wait_until(ScopedLock<Mutex>& lock, const TimePoint& abs_time)
+{
+    const TimePoint now(time::now());
+    const auto relative_time = abs_time - now;
+    return now < abs_time ? wait_for(lock, relative_time) : false;
+}
+
+
+} // namespace bee
@@ -0,0 +1,71 @@
+/*
+ *  Linux_Concurrency.hpp
+ *  Bee
+ *
+ *  Copyright (c) 2020 Jacob Milligan. All rights reserved.
+ */
+
+#pragma once
+
+#include "Bee/Core/NumericTypes.hpp"
+#include "Bee/Core/Thread.hpp"
+
+#include <atomic>
+#include <pthread.h>
+
+namespace bee {
+
+
+/*
+ * All of the futex-based primitives below wait on a single 32-bit word which must be the same size as a raw u32
+ * so its address can be handed straight to the kernel
+ */
+using futex_word_t = std::atomic<u32>;
+
+static_assert(sizeof(futex_word_t) == sizeof(u32), "futex words must be 32 bits wide");
+
+
+// 0: unlocked, 1: locked with no waiters, 2: locked with waiters
+struct LinuxMutex
+{
+    futex_word_t state { 0 };
+};
+
+struct LinuxRecursiveMutex
+{
+    LinuxMutex                  mutex;
+    std::atomic<thread_id_t>    owner { 0 };
+    u32                         lock_count { 0 };
+};
+
+struct LinuxSemaphore
+{
+    futex_word_t        count { 0 };
+    std::atomic<u32>    waiters { 0 };
+    i32                 max_count { 0 };
+};
+
+struct LinuxBarrier
+{
+    futex_word_t        generation { 0 };
+    std::atomic<i32>    remaining { 0 };
+    i32                 thread_count { 0 };
+    i32                 spin_count { 0 };
+};
+
+// Incremented on every notify so waiters can tell if they missed a wakeup between unlocking and sleeping
+struct LinuxConditionVariable
+{
+    futex_word_t sequence { 0 };
+};
+
+
+using native_rw_mutex_t = pthread_rwlock_t;
+using native_mutex_t = LinuxMutex;
+using native_recursive_mutex_t = LinuxRecursiveMutex;
+using native_semaphore_t = LinuxSemaphore;
+using native_barrier_t = LinuxBarrier;
+using native_condition_variable_t = LinuxConditionVariable;
+
+
+} // namespace bee
@@ -0,0 +1,1489 @@
+/*
+ *  Linux_Filesystem.cpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#include "Bee/Core/Linux/Linux_Filesystem.hpp"
+#include "Bee/Core/Containers/HandleTable.hpp"
+#include "Bee/Core/Containers/HashMap.hpp"
+#include "Bee/Core/Thread.hpp"
+#include "Bee/Core/Concurrency.hpp"
+#include "Bee/Core/Logger.hpp"
+
+#include <dirent.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pwd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+
+namespace bee {
+namespace fs {
+
+
+/*
+ * PathView isn't guaranteed to be null-terminated so paths are copied into a stack buffer before being passed to
+ * the kernel
+ */
+using native_path_t = StaticString<PATH_MAX>;
+
+static native_path_t to_native_path(const PathView& path)
+{
+    BEE_ASSERT_F(path.size() < PATH_MAX, "Path is too long: %" BEE_PRIsv, BEE_FMT_SV(path));
+    return native_path_t(path.string_view());
+}
+
+/*
+ *****************************************
+ *
+ * DirectoryIterator - implementation
+ *
+ *****************************************
+ */
+
+// glibc only exposes getdents64 from 2.30 onwards so the kernels record layout is declared here instead
+struct LinuxDirent64
+{
+    u64             d_ino;
+    i64             d_off;
+    unsigned short  d_reclen;
+    unsigned char   d_type;
+    char            d_name[1];
+};
+
+struct DirectoryEntry
+{
+    static constexpr i32 dirent_buffer_capacity = 2048;
+
+    int                 fd { -1 };
+    i32                 dirent_size { 0 };
+    i32                 dirent_offset { 0 };
+    BEE_PAD(4);
+    StaticString<4096>  buffer;
+    PathView            root;
+    alignas(8) u8       dirent_buffer[dirent_buffer_capacity];
+};
+
+// Each open iterator holds one entry so this limits how deeply a thread can recursively iterate directories
+thread_local static HandleTable<32, DirectoryEntryHandle, DirectoryEntry> thread_local_entries;
+
+DirectoryIterator::DirectoryIterator(const PathView& directory_path)
+{
+    if (directory_path.empty())
+    {
+        return;
+    }
+
+    BEE_ASSERT(!current_handle_.is_valid());
+
+    DirectoryEntry* entry = nullptr;
+    current_handle_ = thread_local_entries.emplace(&entry);
+
+    if (!current_handle_.is_valid())
+    {
+        return;
+    }
+
+    const auto native_path = to_native_path(directory_path);
+    entry->fd = ::openat(AT_FDCWD, native_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    if (entry->fd < 0)
+    {
+        log_error("Failed to open directory %" BEE_PRIsv ": %s", BEE_FMT_SV(directory_path), strerror(errno));
+        destroy();
+        return;
+    }
+
+    entry->root = directory_path;
+
+    next();
+}
+
+void DirectoryIterator::destroy()
+{
+    if (thread_local_entries.contains(current_handle_))
+    {
+        const auto fd = thread_local_entries[current_handle_]->fd;
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+        thread_local_entries.destroy(current_handle_);
+    }
+
+    current_handle_ = DirectoryEntryHandle{};
+}
+
+void DirectoryIterator::next()
+{
+    if (!thread_local_entries.contains(current_handle_))
+    {
+        return;
+    }
+
+    auto* entry = thread_local_entries[current_handle_];
+    StringView next_filename{};
+    do
+    {
+        // Refill the buffer with as many records as fit - this is a single syscall for most directories
+        if (entry->dirent_offset >= entry->dirent_size)
+        {
+            const auto size = ::syscall(SYS_getdents64, entry->fd, entry->dirent_buffer, DirectoryEntry::dirent_buffer_capacity);
+            if (size <= 0)
+            {
+                if (size < 0)
+                {
+                    log_error("Failed to read directory %" BEE_PRIsv ": %s", BEE_FMT_SV(entry->root), strerror(errno));
+                }
+                destroy();
+                return;
+            }
+
+            entry->dirent_size = static_cast<i32>(size);
+            entry->dirent_offset = 0;
+        }
+
+        const auto* dirent = reinterpret_cast<const LinuxDirent64*>(entry->dirent_buffer + entry->dirent_offset);
+        entry->dirent_offset += dirent->d_reclen;
+        next_filename = StringView(dirent->d_name);
+    } while (next_filename == "." || next_filename == "..");
+
+    entry->buffer = entry->root.string_view();
+
+    const char last_char = entry->buffer[entry->buffer.size() - 1];
+    if (last_char != Path::preferred_slash)
+    {
+        entry->buffer.append(Path::preferred_slash);
+    }
+
+    entry->buffer.append(next_filename);
+
+    path_ = entry->buffer.view();
+}
+
+/*
+ *****************************************
+ *
+ * Directory scanning - implementation
+ *
+ *****************************************
+ */
+bool is_scan_entry_included(const DirectoryScanInfo& info, const PathView& path, const DirectoryEntryType type);
+
+static DirectoryEntryType dirent_type_to_entry_type(const unsigned char d_type)
+{
+    switch (d_type)
+    {
+        case DT_REG:
+        {
+            return DirectoryEntryType::file;
+        }
+        case DT_DIR:
+        {
+            return DirectoryEntryType::directory;
+        }
+        case DT_LNK:
+        {
+            return DirectoryEntryType::symlink;
+        }
+        case DT_UNKNOWN:
+        {
+            return DirectoryEntryType::unknown;
+        }
+        default:
+        {
+            return DirectoryEntryType::other;
+        }
+    }
+}
+
+static DirectoryEntryType mode_to_entry_type(const u32 mode)
+{
+    if (S_ISREG(mode))
+    {
+        return DirectoryEntryType::file;
+    }
+    if (S_ISDIR(mode))
+    {
+        return DirectoryEntryType::directory;
+    }
+    if (S_ISLNK(mode))
+    {
+        return DirectoryEntryType::symlink;
+    }
+    return DirectoryEntryType::other;
+}
+
+static void statx_to_entry_info(const struct statx& stx, DirectoryEntryInfo* info)
+{
+    info->size = static_cast<i64>(stx.stx_size);
+    info->inode = stx.stx_ino;
+    info->last_modified = static_cast<u64>(stx.stx_mtime.tv_sec) * 1000000000ull + static_cast<u64>(stx.stx_mtime.tv_nsec);
+}
+
+bool native_scan_dir(const PathView& directory, const DirectoryScanInfo& info, DynamicArray<DirectoryEntryInfo>* entries)
+{
+    const auto native_path = to_native_path(directory);
+    const auto fd = ::openat(AT_FDCWD, native_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    if (fd < 0)
+    {
+        log_error("Failed to open directory %" BEE_PRIsv ": %s", BEE_FMT_SV(directory), strerror(errno));
+        return false;
+    }
+
+    native_path_t entry_path(native_path);
+    if (entry_path[entry_path.size() - 1] != Path::preferred_slash)
+    {
+        entry_path.append(Path::preferred_slash);
+    }
+
+    const auto root_size = entry_path.size();
+    alignas(8) u8 dirent_buffer[8192];
+    bool success = true;
+
+    while (true)
+    {
+        const auto size = ::syscall(SYS_getdents64, fd, dirent_buffer, sizeof(dirent_buffer));
+        if (size <= 0)
+        {
+            if (size < 0)
+            {
+                log_error("Failed to read directory %" BEE_PRIsv ": %s", BEE_FMT_SV(directory), strerror(errno));
+                success = false;
+            }
+            break;
+        }
+
+        for (i64 offset = 0; offset < size;)
+        {
+            const auto* dirent = reinterpret_cast<const LinuxDirent64*>(dirent_buffer + offset);
+            offset += dirent->d_reclen;
+
+            const StringView name(dirent->d_name);
+            if (name == "." || name == "..")
+            {
+                continue;
+            }
+
+            entry_path.resize(root_size);
+            entry_path.append(name);
+
+            // Filter on the type from the dirent where possible so excluded entries never pay for a statx
+            auto type = dirent_type_to_entry_type(dirent->d_type);
+            if (type != DirectoryEntryType::unknown && !is_scan_entry_included(info, entry_path.view(), type))
+            {
+                continue;
+            }
+
+            // statx relative to the directory fd skips resolving the full path for every entry
+            struct statx stx{};
+            const auto stat_result = ::statx(
+                fd,
+                dirent->d_name,
+                AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT | AT_STATX_DONT_SYNC,
+                STATX_TYPE | STATX_SIZE | STATX_MTIME | STATX_INO,
+                &stx
+            );
+
+            if (stat_result != 0)
+            {
+                // the entry might have been removed since the directory was read
+                if (errno != ENOENT)
+                {
+                    log_error("Failed to stat %s: %s", entry_path.c_str(), strerror(errno));
+                }
+                continue;
+            }
+
+            if (type == DirectoryEntryType::unknown)
+            {
+                type = mode_to_entry_type(stx.stx_mode);
+                if (!is_scan_entry_included(info, entry_path.view(), type))
+                {
+                    continue;
+                }
+            }
+
+            DirectoryEntryInfo entry{};
+            entry.path = entry_path.view();
+            entry.type = type;
+            statx_to_entry_info(stx, &entry);
+            entries->push_back(BEE_MOVE(entry));
+        }
+    }
+
+    ::close(fd);
+    return success;
+}
+
+bool get_entry_info(const PathView& path, DirectoryEntryInfo* info)
+{
+    const auto native_path = to_native_path(path);
+
+    struct statx stx{};
+    if (::statx(AT_FDCWD, native_path.c_str(), AT_SYMLINK_NOFOLLOW, STATX_TYPE | STATX_SIZE | STATX_MTIME | STATX_INO, &stx) != 0)
+    {
+        return false;
+    }
+
+    info->path = path;
+    info->type = mode_to_entry_type(stx.stx_mode);
+    statx_to_entry_info(stx, info);
+    return true;
+}
+
+/*
+ *************************************
+ *
+ * DirectoryWatcher - implementation
+ *
+ *************************************
+ */
+struct WatchedDirectory
+{
+    i32                 index { -1 };
+    BEE_PAD(4);
+    DynamicArray<i32>   watch_descriptors;
+};
+
+/*
+ * inotify only watches a single directory so each subdirectory of a recursively watched directory gets its own watch
+ * descriptor. All of them are added to a single inotify instance which is waited on with epoll alongside an eventfd
+ * used to wake the watch thread when the watcher is stopped - the thread sleeps in `epoll_wait` when nothing is
+ * happening so watching large trees has no idle cost
+ */
+struct InotifyWatch
+{
+    WatchedDirectory*   entry { nullptr };
+    Path                relative_path;
+};
+
+struct NativeDirectoryWatcher
+{
+    int                                 inotify_fd { -1 };
+    int                                 epoll_fd { -1 };
+    int                                 wake_fd { -1 };
+    BEE_PAD(4);
+    DynamicHashMap<i32, InotifyWatch>   watches;
+};
+
+static constexpr u32 inotify_flags = IN_CREATE
+    | IN_DELETE
+    | IN_MODIFY
+    | IN_CLOSE_WRITE
+    | IN_MOVED_FROM
+    | IN_MOVED_TO
+    | IN_ONLYDIR;
+
+
+static bool add_watch(NativeDirectoryWatcher* native, WatchedDirectory* entry, const PathView& root, const PathView& relative_path)
+{
+    const auto full_path = Path(root).join(relative_path);
+    const auto wd = ::inotify_add_watch(native->inotify_fd, full_path.c_str(), inotify_flags);
+
+    if (wd < 0)
+    {
+        log_error("Failed to watch directory %s: %s", full_path.c_str(), strerror(errno));
+        return false;
+    }
+
+    // inotify returns the existing descriptor if the directory is already watched, i.e. when it's moved within the tree
+    auto* existing = native->watches.find(wd);
+    if (existing != nullptr)
+    {
+        if (existing->value.entry == entry)
+        {
+            existing->value.relative_path = relative_path;
+        }
+        return true;
+    }
+
+    auto* watch = native->watches.insert(wd, InotifyWatch{});
+    watch->value.entry = entry;
+    watch->value.relative_path = relative_path;
+    entry->watch_descriptors.push_back(wd);
+    return true;
+}
+
+/*
+ * Watches every subdirectory of `relative_path`. If `discovered` is not null the relative path of everything found is
+ * appended to it - directories created inside a watched tree can have files added to them before their watch exists
+ * so these are reported as new files by the watch thread
+ */
+static void add_watches_recursive(NativeDirectoryWatcher* native, WatchedDirectory* entry, const PathView& root, const PathView& relative_path, DynamicArray<Path>* discovered)
+{
+    const auto full_path = Path(root).join(relative_path);
+
+    for (const auto& child : read_dir(full_path.view()))
+    {
+        auto child_relative_path = Path(relative_path).join(child.filename());
+        const auto child_is_dir = is_dir(child);
+
+        if (child_is_dir && add_watch(native, entry, root, child_relative_path.view()))
+        {
+            add_watches_recursive(native, entry, root, child_relative_path.view(), discovered);
+        }
+
+        if (discovered != nullptr)
+        {
+            discovered->emplace_back(BEE_MOVE(child_relative_path));
+        }
+    }
+}
+
+static void remove_watch(NativeDirectoryWatcher* native, const i32 wd)
+{
+    auto* watch = native->watches.find(wd);
+    if (watch == nullptr)
+    {
+        return;
+    }
+
+    auto& descriptors = watch->value.entry->watch_descriptors;
+    const auto index = find_index(descriptors, wd);
+    if (index >= 0)
+    {
+        descriptors.erase(index);
+    }
+
+    native->watches.erase(wd);
+}
+
+// Removes the watches for a directory that was moved out from under a watched directory, including its subdirectories
+static void remove_watches_under(NativeDirectoryWatcher* native, WatchedDirectory* entry, const PathView& relative_path)
+{
+    DynamicArray<i32> to_remove;
+
+    for (const auto& watch : native->watches)
+    {
+        if (watch.value.entry != entry)
+        {
+            continue;
+        }
+
+        const auto path = watch.value.relative_path.string_view();
+        const auto is_match = path == relative_path.string_view()
+            || (path.size() > relative_path.size()
+                && path[relative_path.size()] == Path::preferred_slash
+                && memcmp(path.data(), relative_path.data(), relative_path.size()) == 0);
+
+        if (is_match)
+        {
+            to_remove.push_back(watch.key);
+        }
+    }
+
+    for (const auto wd : to_remove)
+    {
+        ::inotify_rm_watch(native->inotify_fd, wd);
+        remove_watch(native, wd);
+    }
+}
+
+
+// ctr/dtr Must be in this TU to ensure opaque struct WatchedDirectory can be compiled
+DirectoryWatcher::DirectoryWatcher(const bool recursive)
+    : recursive_(recursive)
+{
+    auto* native = BEE_NEW(system_allocator(), NativeDirectoryWatcher);
+    native->inotify_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    native->epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    native->wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    BEE_ASSERT_F(native->inotify_fd >= 0, "Failed to initialize inotify: %s", strerror(errno));
+    BEE_ASSERT_F(native->epoll_fd >= 0, "Failed to create epoll instance: %s", strerror(errno));
+    BEE_ASSERT_F(native->wake_fd >= 0, "Failed to create eventfd: %s", strerror(errno));
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = native->inotify_fd;
+    ::epoll_ctl(native->epoll_fd, EPOLL_CTL_ADD, native->inotify_fd, &event);
+
+    event.data.fd = native->wake_fd;
+    ::epoll_ctl(native->epoll_fd, EPOLL_CTL_ADD, native->wake_fd, &event);
+
+    native_ = native;
+}
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+    if (is_running_.load(std::memory_order_relaxed))
+    {
+        stop();
+    }
+
+    auto* native = static_cast<NativeDirectoryWatcher*>(native_);
+    ::close(native->wake_fd);
+    ::close(native->epoll_fd);
+    ::close(native->inotify_fd);
+    BEE_DELETE(system_allocator(), native);
+    native_ = nullptr;
+}
+
+void DirectoryWatcher::init(const ThreadCreateInfo &thread_info)
+{
+    thread_ = Thread(thread_info, watch_loop, this);
+}
+
+void DirectoryWatcher::remove_directory(const PathView& path)
+{
+    scoped_lock_t lock(mutex_);
+
+    const auto index = find_entry(path);
+
+    if (index < 0)
+    {
+        log_error("Directory at path %" BEE_PRIsv " is not being watched", BEE_FMT_SV(path));
+        return;
+    }
+
+    // inotify watches can be removed from any thread so there's no need to wait for the watch thread to wake up.
+    // The index is only valid while the lock is held so the removal has to happen under the same lock as the lookup
+    finalize_removal(index);
+}
+
+// Must be called with `mutex_` held
+void DirectoryWatcher::finalize_removal(const i32 index)
+{
+    auto* native = static_cast<NativeDirectoryWatcher*>(native_);
+    auto& entry = entries_[index];
+
+    while (!entry->watch_descriptors.empty())
+    {
+        const auto wd = entry->watch_descriptors.back();
+        ::inotify_rm_watch(native->inotify_fd, wd);
+        remove_watch(native, wd);
+    }
+
+    entries_.erase(index);
+    watched_paths_.erase(index);
+
+    for (int i = index; i < entries_.size(); ++i)
+    {
+        entries_[i]->index = i;
+    }
+}
+
+void DirectoryWatcher::stop()
+{
+    if (!is_running_.load(std::memory_order_relaxed))
+    {
+        log_warning("DirectoryWatcher is already stopped");
+        return;
+    }
+
+    auto* native = static_cast<NativeDirectoryWatcher*>(native_);
+
+    is_running_.store(false);
+
+    const u64 wake_value = 1;
+    if (::write(native->wake_fd, &wake_value, sizeof(u64)) < 0)
+    {
+        log_error("Failed to wake DirectoryWatcher thread: %s", strerror(errno));
+    }
+
+    thread_.join();
+
+    for (const auto& watch : native->watches)
+    {
+        ::inotify_rm_watch(native->inotify_fd, watch.key);
+    }
+
+    native->watches.clear();
+    entries_.clear();
+    watched_paths_.clear();
+}
+
+bool DirectoryWatcher::add_directory(const PathView& path)
+{
+    if (!is_dir(path))
+    {
+        log_error("%" BEE_PRIsv " is not a directory", BEE_FMT_SV(path));
+        return false;
+    }
+
+    scoped_lock_t lock(mutex_);
+
+    const auto existing_index = find_entry(path);
+
+    if (existing_index >= 0)
+    {
+        return true;
+    }
+
+    auto* native = static_cast<NativeDirectoryWatcher*>(native_);
+    auto entry = make_unique<WatchedDirectory>(system_allocator());
+
+    if (!add_watch(native, entry.get(), path, PathView{}))
+    {
+        return false;
+    }
+
+    if (recursive_)
+    {
+        add_watches_recursive(native, entry.get(), path, PathView{}, nullptr);
+    }
+
+    entry->index = entries_.size();
+    entries_.emplace_back(BEE_MOVE(entry));
+    watched_paths_.emplace_back(path);
+    start_thread_cv_.notify_all();
+
+    return true;
+}
+
+void DirectoryWatcher::watch_loop(DirectoryWatcher* watcher)
+{
+    static constexpr i32 notify_buffer_capacity = 16 * 1024;
+
+    alignas(inotify_event) u8 notify_buffer[notify_buffer_capacity];
+    epoll_event epoll_events[2];
+    DynamicArray<Path> discovered;
+    FileAction action = FileAction::none;
+
+    auto* native = static_cast<NativeDirectoryWatcher*>(watcher->native_);
+
+    while (watcher->is_running_.load(std::memory_order_relaxed))
+    {
+        // Sleeps until either inotify has events or `stop()` signals the eventfd
+        const auto ready_count = ::epoll_wait(native->epoll_fd, epoll_events, static_array_length(epoll_events), -1);
+
+        if (ready_count < 0)
+        {
+            if (errno != EINTR)
+            {
+                log_error("DirectoryWatcher: epoll_wait failed: %s", strerror(errno));
+            }
+            continue;
+        }
+
+        if (!watcher->is_running_.load(std::memory_order_relaxed))
+        {
+            break;
+        }
+
+        scoped_lock_t lock(watcher->mutex_);
+
+        const auto is_suspended = watcher->is_suspended_.load(std::memory_order_relaxed);
+
+        // The inotify fd is non-blocking so this drains every queued event before going back to sleep
+        while (true)
+        {
+            const auto bytes_read = ::read(native->inotify_fd, notify_buffer, notify_buffer_capacity);
+
+            if (bytes_read <= 0)
+            {
+                if (bytes_read < 0 && errno != EAGAIN && errno != EINTR)
+                {
+                    log_error("DirectoryWatcher: failed to read inotify events: %s", strerror(errno));
+                }
+                break;
+            }
+
+            for (isize offset = 0; offset < bytes_read;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(notify_buffer + offset);
+                offset += sizeof(inotify_event) + event->len;
+
+                if ((event->mask & IN_Q_OVERFLOW) != 0)
+                {
+                    log_warning("DirectoryWatcher: inotify event queue overflowed - some file events were lost");
+                    continue;
+                }
+
+                auto* watch = native->watches.find(event->wd);
+
+                // Events can still be queued for watches that were removed since they were read
+                if (watch == nullptr)
+                {
+                    continue;
+                }
+
+                // The kernel removed the watch, i.e. the directory was deleted or unmounted
+                if ((event->mask & IN_IGNORED) != 0)
+                {
+                    remove_watch(native, event->wd);
+                    continue;
+                }
+
+                // Events for the watched directory itself have no name
+                if (event->len == 0)
+                {
+                    continue;
+                }
+
+                auto* entry = watch->value.entry;
+                auto relative_path = watch->value.relative_path.join(StringView(event->name));
+                const auto is_dir_event = (event->mask & IN_ISDIR) != 0;
+
+                /*
+                 * Like on Windows, renames are counted as added/removed events. Old name is counted as removing a file
+                 * and new name is counted as adding a file
+                 */
+                if ((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0)
+                {
+                    action = FileAction::added;
+                }
+                else if ((event->mask & (IN_DELETE | IN_MOVED_FROM)) != 0)
+                {
+                    action = FileAction::removed;
+                }
+                else if ((event->mask & (IN_MODIFY | IN_CLOSE_WRITE)) != 0)
+                {
+                    action = FileAction::modified;
+                }
+                else
+                {
+                    action = FileAction::none;
+                }
+
+                discovered.clear();
+
+                if (watcher->recursive_ && is_dir_event)
+                {
+                    const auto& root = watcher->watched_paths_[entry->index];
+
+                    if (action == FileAction::added && add_watch(native, entry, root.view(), relative_path.view()))
+                    {
+                        add_watches_recursive(native, entry, root.view(), relative_path.view(), &discovered);
+                    }
+                    else if ((event->mask & IN_MOVED_FROM) != 0)
+                    {
+                        remove_watches_under(native, entry, relative_path.view());
+                    }
+                }
+
+                // Only add the event if we support it
+                if (action != FileAction::none && !is_suspended)
+                {
+                    watcher->add_event(action, relative_path.view(), entry->index);
+
+                    for (const auto& path : discovered)
+                    {
+                        watcher->add_event(FileAction::added, path.view(), entry->index);
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+/*
+ *****************************************
+ *
+ * Filesystem functions - implementation
+ *
+ *****************************************
+ */
+File open_file(const PathView& path, const OpenMode mode)
+{
+    const auto is_read = (mode & OpenMode::read) != OpenMode::none;
+    const auto is_write = (mode & OpenMode::write) != OpenMode::none;
+    int flags = O_CLOEXEC;
+
+    if ((mode & OpenMode::append) != OpenMode::none)
+    {
+        flags |= O_RDWR | O_CREAT | O_APPEND;
+    }
+    else if (is_write)
+    {
+        flags |= (is_read ? O_RDWR : O_WRONLY) | O_CREAT | O_TRUNC;
+    }
+    else
+    {
+        flags |= O_RDONLY;
+    }
+
+    if ((mode & OpenMode::unbuffered) != OpenMode::none)
+    {
+        flags |= O_DIRECT;
+    }
+
+    const auto native_path = to_native_path(path);
+    auto fd = ::openat(AT_FDCWD, native_path.c_str(), flags, 0666);
+    auto opened_mode = mode;
+
+    // Some filesystems (i.e. tmpfs) don't support O_DIRECT so fall back to buffered IO rather than failing
+    if (fd < 0 && errno == EINVAL && (flags & O_DIRECT) != 0)
+    {
+        fd = ::openat(AT_FDCWD, native_path.c_str(), flags & ~O_DIRECT, 0666);
+        opened_mode &= ~OpenMode::unbuffered;
+    }
+
+    if (BEE_FAIL_F(fd >= 0, "Failed to open file %" BEE_PRIsv ": %s", BEE_FMT_SV(path), strerror(errno)))
+    {
+        return File{};
+    }
+
+    return { fd_to_handle(fd), opened_mode };
+}
+
+void close_file(File* file)
+{
+    BEE_ASSERT(file->is_valid());
+
+    ::close(get_fd(*file));
+    file->handle = nullptr;
+    file->mode = OpenMode::none;
+}
+
+i64 get_size(const File& file)
+{
+    BEE_ASSERT(file.is_valid());
+
+    struct stat st{};
+    if (BEE_FAIL_F(::fstat(get_fd(file), &st) == 0, "Failed to get file size: %s", strerror(errno)))
+    {
+        return 0;
+    }
+
+    return static_cast<i64>(st.st_size);
+}
+
+i64 tell(const File& file)
+{
+    const auto offset = ::lseek(get_fd(file), 0, SEEK_CUR);
+    if (BEE_FAIL_F(offset >= 0, "Failed to tell file: %s", strerror(errno)))
+    {
+        return 0;
+    }
+
+    return static_cast<i64>(offset);
+}
+
+BEE_TRANSLATION_TABLE_FUNC(seek_origin_to_whence, io::SeekOrigin, int, 3,
+    SEEK_SET,   // begin
+    SEEK_CUR,   // current
+    SEEK_END    // end
+);
+
+i64 seek(const File& file, const i64 offset, const io::SeekOrigin origin)
+{
+    const auto new_pos = ::lseek(get_fd(file), static_cast<off_t>(offset), seek_origin_to_whence(origin));
+    if (BEE_FAIL_F(new_pos >= 0, "Failed to seek file: %s", strerror(errno)))
+    {
+        return 0;
+    }
+
+    return static_cast<i64>(new_pos);
+}
+
+/*
+ * read/write can transfer fewer bytes than requested for large buffers or if interrupted by a signal so these loop
+ * until everything is transferred to match ReadFile/WriteFile on synchronous handles
+ */
+i64 read(const File& file, const i64 size, void* buffer)
+{
+    auto* dst = static_cast<u8*>(buffer);
+    const auto is_unbuffered = (file.mode & OpenMode::unbuffered) != OpenMode::none;
+    i64 total_read = 0;
+
+    while (total_read < size)
+    {
+        const auto bytes_read = ::read(get_fd(file), dst + total_read, static_cast<size_t>(size - total_read));
+        if (bytes_read < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            log_error("Failed to read file: %s", strerror(errno));
+            break;
+        }
+
+        total_read += bytes_read;
+
+        // EOF - unbuffered reads only come up short at the end of the file and retrying would use an unaligned offset
+        if (bytes_read == 0 || (is_unbuffered && total_read < size))
+        {
+            break;
+        }
+    }
+
+    return total_read;
+}
+
+i64 write(const File& file, const void* buffer, const i64 buffer_size)
+{
+    const auto* src = static_cast<const u8*>(buffer);
+    i64 total_written = 0;
+
+    while (total_written < buffer_size)
+    {
+        const auto bytes_written = ::write(get_fd(file), src + total_written, static_cast<size_t>(buffer_size - total_written));
+        if (bytes_written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            log_error("Error writing to file: %s", strerror(errno));
+            break;
+        }
+
+        total_written += bytes_written;
+    }
+
+    return total_written;
+}
+
+size_t unbuffered_io_alignment()
+{
+    // O_DIRECT needs the logical block size of the device which is never larger than a page
+    static const auto page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return page_size;
+}
+
+i64 read_at(const File& file, const i64 offset, const i64 size, void* buffer)
+{
+    auto* dst = static_cast<u8*>(buffer);
+    const auto is_unbuffered = (file.mode & OpenMode::unbuffered) != OpenMode::none;
+    i64 total_read = 0;
+
+    while (total_read < size)
+    {
+        const auto bytes_read = ::pread(
+            get_fd(file),
+            dst + total_read,
+            static_cast<size_t>(size - total_read),
+            static_cast<off_t>(offset + total_read)
+        );
+
+        if (bytes_read < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            log_error("Failed to read file at offset %" PRIi64 ": %s", offset + total_read, strerror(errno));
+            break;
+        }
+
+        total_read += bytes_read;
+
+        if (bytes_read == 0 || (is_unbuffered && total_read < size))
+        {
+            break;
+        }
+    }
+
+    return total_read;
+}
+
+i64 write_at(const File& file, const i64 offset, const void* buffer, const i64 buffer_size)
+{
+    const auto* src = static_cast<const u8*>(buffer);
+    i64 total_written = 0;
+
+    while (total_written < buffer_size)
+    {
+        const auto bytes_written = ::pwrite(
+            get_fd(file),
+            src + total_written,
+            static_cast<size_t>(buffer_size - total_written),
+            static_cast<off_t>(offset + total_written)
+        );
+
+        if (bytes_written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            log_error("Error writing to file at offset %" PRIi64 ": %s", offset + total_written, strerror(errno));
+            break;
+        }
+
+        total_written += bytes_written;
+    }
+
+    return total_written;
+}
+
+static bool native_stat(const PathView& path, struct stat* st)
+{
+    const auto native_path = to_native_path(path);
+    return ::stat(native_path.c_str(), st) == 0;
+}
+
+bool is_dir(const PathView& path)
+{
+    struct stat st{};
+    return native_stat(path, &st) && S_ISDIR(st.st_mode);
+}
+
+bool is_file(const PathView& path)
+{
+    struct stat st{};
+    return native_stat(path, &st) && S_ISREG(st.st_mode);
+}
+
+u64 last_modified(const PathView& path)
+{
+    struct stat st{};
+    if (!native_stat(path, &st))
+    {
+        log_error("Failed to get last modified time: %s", strerror(errno));
+        return 0;
+    }
+
+    // nanoseconds since the unix epoch - only meant to be compared with other `last_modified` values
+    return static_cast<u64>(st.st_mtim.tv_sec) * 1000000000ull + static_cast<u64>(st.st_mtim.tv_nsec);
+}
+
+bool mkdir(const PathView& directory_path, const bool recursive)
+{
+    if (recursive)
+    {
+        const auto parent = directory_path.parent();
+        if (!parent.empty() && !is_dir(parent))
+        {
+            mkdir(parent, recursive);
+        }
+    }
+
+    const auto native_path = to_native_path(directory_path);
+
+    if (::mkdir(native_path.c_str(), 0777) == 0)
+    {
+        return true;
+    }
+
+    log_error("Unable to make directory at path: %" BEE_PRIsv ": %s", BEE_FMT_SV(directory_path), strerror(errno));
+    return false;
+}
+
+bool native_rmdir_non_recursive(const PathView& directory_path)
+{
+    const auto native_path = to_native_path(directory_path);
+
+    if (::rmdir(native_path.c_str()) == 0)
+    {
+        return true;
+    }
+
+    log_error("Unable to remove directory at path: %" BEE_PRIsv ": %s", BEE_FMT_SV(directory_path), strerror(errno));
+    return false;
+}
+
+bool remove(const PathView& filepath)
+{
+    const auto native_path = to_native_path(filepath);
+
+    if (::unlink(native_path.c_str()) == 0)
+    {
+        return true;
+    }
+
+    log_error("Unable to remove file at path: %" BEE_PRIsv ": %s", BEE_FMT_SV(filepath), strerror(errno));
+    return false;
+}
+
+bool move(const PathView& current_path, const PathView& new_path)
+{
+    const auto current_native = to_native_path(current_path);
+    const auto new_native = to_native_path(new_path);
+
+    if (::rename(current_native.c_str(), new_native.c_str()) == 0)
+    {
+        return true;
+    }
+
+    // rename can't move across filesystems but MoveFile on Windows can, so fall back to copying files
+    if (errno == EXDEV && is_file(current_path))
+    {
+        return copy(current_path, new_path, false) && remove(current_path);
+    }
+
+    log_error("Unable to move file from %" BEE_PRIsv " to %" BEE_PRIsv ": %s", BEE_FMT_SV(current_path), BEE_FMT_SV(new_path), strerror(errno));
+    return false;
+}
+
+bool native_replace_file(const PathView& src_path, const PathView& dst_path)
+{
+    const auto src_native = to_native_path(src_path);
+    const auto dst_native = to_native_path(dst_path);
+
+    // rename atomically replaces `dst_path` if it exists - there's no copy fallback here as that wouldn't be atomic
+    if (::rename(src_native.c_str(), dst_native.c_str()) == 0)
+    {
+        return true;
+    }
+
+    log_error("Unable to replace %" BEE_PRIsv " with %" BEE_PRIsv ": %s", BEE_FMT_SV(dst_path), BEE_FMT_SV(src_path), strerror(errno));
+    return false;
+}
+
+bool sync_file(const File& file)
+{
+    if (::fsync(get_fd(file)) != 0)
+    {
+        log_error("Failed to sync file to disk: %s", strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * syncfs flushes all the data and metadata of the filesystem containing a file so it only needs to be called once
+ * for each device `paths` live on instead of once per file. It also covers the directory entries of renamed files so
+ * the same function is used for both `native_sync_file_data` and `native_sync_file_names`
+ */
+static bool syncfs_paths(const Path* const* paths, const i32 count)
+{
+    DynamicArray<dev_t> synced_devices(temp_allocator());
+
+    for (int i = 0; i < count; ++i)
+    {
+        const auto native_path = to_native_path(paths[i]->view());
+        const auto fd = ::openat(AT_FDCWD, native_path.c_str(), O_RDONLY | O_CLOEXEC);
+
+        if (fd < 0)
+        {
+            log_error("Failed to open %s for syncing: %s", native_path.c_str(), strerror(errno));
+            return false;
+        }
+
+        struct stat st{};
+        const bool already_synced = ::fstat(fd, &st) == 0 && find_index(synced_devices, st.st_dev) >= 0;
+        const bool success = already_synced || ::syncfs(fd) == 0;
+
+        if (!success)
+        {
+            log_error("Failed to sync filesystem containing %s: %s", native_path.c_str(), strerror(errno));
+        }
+
+        ::close(fd);
+
+        if (!success)
+        {
+            return false;
+        }
+
+        if (!already_synced)
+        {
+            synced_devices.push_back(st.st_dev);
+        }
+    }
+
+    return true;
+}
+
+bool native_sync_file_data(const Path* const* paths, const i32 count)
+{
+    return syncfs_paths(paths, count);
+}
+
+bool native_sync_file_names(const Path* const* paths, const i32 count)
+{
+    return syncfs_paths(paths, count);
+}
+
+static bool copy_fd_contents(const int src_fd, const int dst_fd, const i64 size)
+{
+    // copy_file_range does the copy in the kernel (or as a reflink on filesystems that support it)
+    i64 remaining = size;
+    while (remaining > 0)
+    {
+        const auto copied = ::copy_file_range(src_fd, nullptr, dst_fd, nullptr, static_cast<size_t>(remaining), 0);
+        if (copied < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            // not supported for these files or this kernel - fall back to copying via userspace
+            if (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP)
+            {
+                break;
+            }
+
+            return false;
+        }
+
+        if (copied == 0)
+        {
+            return true;
+        }
+
+        remaining -= copied;
+    }
+
+    u8 buffer[64 * 1024];
+    while (remaining > 0)
+    {
+        const auto bytes_read = ::read(src_fd, buffer, sizeof(buffer));
+        if (bytes_read < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (bytes_read <= 0)
+        {
+            return bytes_read == 0;
+        }
+
+        for (isize offset = 0; offset < bytes_read;)
+        {
+            const auto bytes_written = ::write(dst_fd, buffer + offset, static_cast<size_t>(bytes_read - offset));
+            if (bytes_written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+
+            offset += bytes_written;
+        }
+
+        remaining -= bytes_read;
+    }
+
+    return true;
+}
+
+bool copy(const PathView& src_filepath, const PathView& dst_filepath, bool overwrite)
+{
+    const auto src_native = to_native_path(src_filepath);
+    const auto dst_native = to_native_path(dst_filepath);
+
+    const auto src_fd = ::openat(AT_FDCWD, src_native.c_str(), O_RDONLY | O_CLOEXEC);
+    if (src_fd < 0)
+    {
+        log_error("Unable to copy file from %" BEE_PRIsv " to %" BEE_PRIsv ": %s", BEE_FMT_SV(src_filepath), BEE_FMT_SV(dst_filepath), strerror(errno));
+        return false;
+    }
+
+    struct stat st{};
+    ::fstat(src_fd, &st);
+
+    const auto dst_flags = O_WRONLY | O_CREAT | O_CLOEXEC | (overwrite ? O_TRUNC : O_EXCL);
+    const auto dst_fd = ::openat(AT_FDCWD, dst_native.c_str(), dst_flags, st.st_mode & 0777);
+    if (dst_fd < 0)
+    {
+        log_error("Unable to copy file from %" BEE_PRIsv " to %" BEE_PRIsv ": %s", BEE_FMT_SV(src_filepath), BEE_FMT_SV(dst_filepath), strerror(errno));
+        ::close(src_fd);
+        return false;
+    }
+
+    const auto result = copy_fd_contents(src_fd, dst_fd, static_cast<i64>(st.st_size));
+    if (!result)
+    {
+        log_error("Unable to copy file from %" BEE_PRIsv " to %" BEE_PRIsv ": %s", BEE_FMT_SV(src_filepath), BEE_FMT_SV(dst_filepath), strerror(errno));
+    }
+
+    ::close(src_fd);
+    ::close(dst_fd);
+    return result;
+}
+
+/*
+ *********************************
+ *
+ * Local data - implementation
+ *
+ *********************************
+ */
+Path user_local_appdata_path()
+{
+    // see: https://specifications.freedesktop.org/basedir-spec/basedir-spec-latest.html
+    const char* xdg_data_home = ::getenv("XDG_DATA_HOME");
+    if (xdg_data_home != nullptr && xdg_data_home[0] != '\0')
+    {
+        return Path(xdg_data_home);
+    }
+
+    const char* home = ::getenv("HOME");
+    if (home == nullptr || home[0] == '\0')
+    {
+        const auto* pw = ::getpwuid(::getuid());
+        home = pw != nullptr ? pw->pw_dir : nullptr;
+    }
+
+    if (BEE_FAIL_F(home != nullptr, "Couldn't retrieve local app data folder"))
+    {
+        return Path();
+    }
+
+    Path appdata(home);
+    appdata.append(".local").append("share");
+    return BEE_MOVE(appdata);
+}
+
+/*
+ ******************************************
+ *
+ * Memory mapped files - implementation
+ *
+ ******************************************
+ */
+bool mmap_file_map_range(MemoryMappedFile* file, const PathView& path, const OpenMode open_mode, const i64 offset, const i64 size)
+{
+    if (BEE_FAIL_F(offset >= 0, "Invalid memory mapped file offset: %" PRIi64, offset))
+    {
+        return false;
+    }
+
+    const auto is_write = (open_mode & OpenMode::write) != OpenMode::none;
+    const auto native_path = to_native_path(path);
+    const auto fd = ::openat(AT_FDCWD, native_path.c_str(), (is_write ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+
+    if (fd < 0)
+    {
+        log_error("Failed to create memory mapped file %" BEE_PRIsv ": %s", BEE_FMT_SV(path), strerror(errno));
+        return false;
+    }
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        log_error("Failed to memory map file %" BEE_PRIsv ": file is empty or can't be read", BEE_FMT_SV(path));
+        ::close(fd);
+        return false;
+    }
+
+    const i64 file_size = st.st_size;
+    const i64 range_size = size < 0 ? file_size - offset : size;
+
+    if (offset + range_size > file_size || range_size <= 0)
+    {
+        log_error("Failed to memory map file %" BEE_PRIsv ": range [%" PRIi64 ", %" PRIi64 ") is outside the file", BEE_FMT_SV(path), offset, offset + range_size);
+        ::close(fd);
+        return false;
+    }
+
+    // mmap offsets have to be page-aligned so the view starts at the page containing `offset`
+    const i64 page_size = ::sysconf(_SC_PAGESIZE);
+    const i64 view_offset = offset - offset % page_size;
+    const i64 view_size = range_size + (offset - view_offset);
+    const int protect = PROT_READ | (is_write ? PROT_WRITE : 0);
+    auto* view = ::mmap(nullptr, static_cast<size_t>(view_size), protect, MAP_SHARED, fd, view_offset);
+
+    // the mapping keeps its own reference to the file so the fd isn't needed after this
+    ::close(fd);
+
+    if (view == MAP_FAILED)
+    {
+        log_error("Failed to map file view %" BEE_PRIsv ": %s", BEE_FMT_SV(path), strerror(errno));
+        return false;
+    }
+
+    file->view = view;
+    file->view_size = view_size;
+    file->data = static_cast<u8*>(view) + (offset - view_offset);
+    file->size = range_size;
+    file->offset = offset;
+    file->file_size = file_size;
+    file->handles[0] = nullptr;
+    file->handles[1] = nullptr;
+    file->mode = open_mode;
+    return true;
+}
+
+bool mmap_file_unmap(MemoryMappedFile* file)
+{
+    if (::munmap(file->view, static_cast<size_t>(file->view_size)) != 0)
+    {
+        log_error("Failed to unmap file view: %s", strerror(errno));
+        return false;
+    }
+
+    new (file) MemoryMappedFile{};
+    return true;
+}
+
+static int madvise_range(const MemoryMappedFile& file, const i64 offset, const i64 size, const int advice)
+{
+    // madvise needs a page-aligned address so the range is expanded to the page containing `offset`
+    const i64 begin = (static_cast<u8*>(file.data) - static_cast<u8*>(file.view)) + offset;
+    const i64 page_size = ::sysconf(_SC_PAGESIZE);
+    const i64 aligned_begin = begin - begin % page_size;
+    return ::madvise(static_cast<u8*>(file.view) + aligned_begin, static_cast<size_t>(size + (begin - aligned_begin)), advice);
+}
+
+bool mmap_file_advise(const MemoryMappedFile& file, const MemoryMappedAdvice advice)
+{
+    int native_advice = MADV_NORMAL;
+    switch (advice)
+    {
+        case MemoryMappedAdvice::sequential:
+        {
+            native_advice = MADV_SEQUENTIAL;
+            break;
+        }
+        case MemoryMappedAdvice::random:
+        {
+            native_advice = MADV_RANDOM;
+            break;
+        }
+        case MemoryMappedAdvice::will_need:
+        {
+            native_advice = MADV_WILLNEED;
+            break;
+        }
+        case MemoryMappedAdvice::dont_need:
+        {
+            native_advice = MADV_DONTNEED;
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+
+    if (madvise_range(file, 0, file.size, native_advice) != 0)
+    {
+        log_error("Failed to advise memory mapped file: %s", strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+bool mmap_file_prefetch(const MemoryMappedFile& file, const i64 offset, const i64 size)
+{
+    if (BEE_FAIL_F(offset >= 0 && size >= 0 && offset + size <= file.size, "Prefetch range is outside the mapped range"))
+    {
+        return false;
+    }
+
+    if (size == 0)
+    {
+        return true;
+    }
+
+    if (madvise_range(file, offset, size, MADV_WILLNEED) != 0)
+    {
+        log_error("Failed to prefetch memory mapped file: %s", strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+
+} // namespace fs
+} // namespace bee
@@ -0,0 +1,38 @@
+/*
+ *  Linux_Filesystem.hpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#pragma once
+
+#include "Bee/Core/Filesystem.hpp"
+
+
+namespace bee {
+namespace fs {
+
+
+/*
+ * `File::handle` is null for invalid files so file descriptors are stored offset by one - otherwise a valid fd of 0
+ * would look like an invalid file
+ */
+inline void* fd_to_handle(const int fd)
+{
+    return reinterpret_cast<void*>(static_cast<intptr_t>(fd) + 1);
+}
+
+inline int handle_to_fd(const void* handle)
+{
+    return static_cast<int>(reinterpret_cast<intptr_t>(handle) - 1);
+}
+
+inline int get_fd(const File& file)
+{
+    return handle_to_fd(file.handle);
+}
+
+
+} // namespace fs
+} // namespace bee
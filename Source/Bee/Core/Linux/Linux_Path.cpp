@@ -0,0 +1,128 @@
+/*
+ *  Linux_Path.cpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#include "Bee/Core/Path.hpp"
+#include "Bee/Core/Filesystem.hpp"
+#include "Bee/Core/Containers/StaticArray.hpp"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+
+namespace bee {
+
+
+PathView executable_path()
+{
+    static thread_local StaticArray<char, PATH_MAX> exe_path;
+
+    if (exe_path.empty())
+    {
+        const auto size = ::readlink("/proc/self/exe", exe_path.data, exe_path.capacity);
+        BEE_ASSERT_F(size > 0, "Failed to get executable path: %s", strerror(errno));
+        exe_path.size = static_cast<i32>(size);
+    }
+
+    return StringView(exe_path.data, exe_path.size);
+}
+
+PathView current_working_directory()
+{
+    static thread_local StaticArray<char, PATH_MAX> path;
+
+    if (BEE_FAIL_F(::getcwd(path.data, path.capacity) != nullptr, "Failed to get current working directory: %s", strerror(errno)))
+    {
+        return PathView{};
+    }
+
+    path.size = static_cast<i32>(::strlen(path.data));
+    return StringView(path.data, path.size);
+}
+
+Path& Path::normalize()
+{
+    char buf[PATH_MAX];
+
+    // realpath resolves symlinks but fails for paths that don't exist yet - those are just made absolute to match
+    // GetFullPathName on Windows
+    if (::realpath(data_.c_str(), buf) != nullptr)
+    {
+        data_ = buf;
+    }
+    else if (!data_.empty() && data_[0] != preferred_slash)
+    {
+        data_.insert(0, 1, preferred_slash);
+        data_.insert(0, current_working_directory().string_view());
+    }
+    return *this;
+}
+
+Path Path::get_normalized(Allocator* allocator) const
+{
+    Path normalized_path(view(), allocator);
+    normalized_path.normalize();
+    return BEE_MOVE(normalized_path);
+}
+
+bool PathView::exists() const
+{
+    // stat can't find anything at a path this long anyway and it wouldn't fit in the stack copy below
+    if (size() >= PATH_MAX)
+    {
+        return false;
+    }
+
+    // stat needs a null-terminated path - copy it to the stack rather than allocating one
+    const StaticPath<PATH_MAX> path(*this);
+    struct stat st{};
+    if (::stat(path.c_str(), &st) == 0)
+    {
+        return true;
+    }
+
+    switch (errno)
+    {
+        case ENOENT:
+        case ENOTDIR:
+        case ENAMETOOLONG:
+        {
+            return false;
+        }
+        default:
+        {
+            break;
+        }
+    }
+
+    return BEE_CHECK_F(
+        false,
+        "Path::exists failed for path at '%" BEE_PRIsv "` with error: %s", BEE_FMT_SV(data_), strerror(errno)
+    );
+}
+
+bool PathView::has_root_name() const
+{
+    // POSIX paths have no drive or device name - the root is just the root directory
+    return false;
+}
+
+PathView PathView::root_name() const
+{
+    return StringView{};
+}
+
+bool PathView::is_absolute() const
+{
+    return !data_.empty() && data_[0] == Path::preferred_slash;
+}
+
+
+} // namespace bee
@@ -0,0 +1,197 @@
+/*
+ *  Linux_Thread.cpp
+ *  Bee
+ *
+ *  Copyright (c) 2020 Jacob Milligan. All rights reserved.
+ */
+
+#include "Bee/Core/Thread.hpp"
+#include "Bee/Core/Time.hpp"
+#include "Bee/Core/String.hpp"
+#include "Bee/Core/Enum.hpp"
+#include "Bee/Core/Logger.hpp"
+#include "Bee/Core/Math/Math.hpp"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+
+namespace bee {
+
+
+void set_native_thread_name(pthread_t native_thread, const StringView& name)
+{
+    // pthread names are limited to 16 bytes including the null terminator
+    StaticString<BEE_THREAD_MAX_NAME> truncated(StringView(name.data(), math::min(name.size(), BEE_THREAD_MAX_NAME - 1)));
+    const auto result = pthread_setname_np(native_thread, truncated.c_str());
+    BEE_ASSERT_F(result == 0, "Thread: couldn't set thread name to '%" BEE_PRIsv "': %s", BEE_FMT_SV(name), strerror(result));
+}
+
+void set_native_thread_affinity(pthread_t native_thread, const i32 cpu)
+{
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+
+    const auto result = pthread_setaffinity_np(native_thread, sizeof(cpu_set_t), &cpu_set);
+    BEE_ASSERT_F(result == 0, "Thread: failed to set CPU affinity: %s", strerror(result));
+}
+
+/*
+ * SCHED_OTHER ignores the static priority so the lower priorities map onto the idle/batch policies instead and the
+ * higher ones onto the realtime policy, which needs CAP_SYS_NICE
+ */
+BEE_TRANSLATION_TABLE_FUNC(translate_thread_policy, ThreadPriority, int, ThreadPriority::unknown,
+    SCHED_IDLE, // idle,
+    SCHED_BATCH, // lowest,
+    SCHED_BATCH, // below_normal,
+    SCHED_OTHER, // normal,
+    SCHED_RR, // above_normal,
+    SCHED_RR, // highest,
+    SCHED_FIFO, // time_critical,
+)
+
+BEE_TRANSLATION_TABLE_FUNC(translate_thread_priority, ThreadPriority, int, ThreadPriority::unknown,
+    0, // idle,
+    0, // lowest,
+    0, // below_normal,
+    0, // normal,
+    1, // above_normal,
+    50, // highest,
+    99, // time_critical,
+)
+
+void set_native_thread_priority(pthread_t native_thread, const ThreadPriority priority)
+{
+    sched_param param{};
+    param.sched_priority = translate_thread_priority(priority);
+
+    const auto result = pthread_setschedparam(native_thread, translate_thread_policy(priority), &param);
+
+    // Unprivileged processes can't raise their priority so leave the thread as-is rather than asserting
+    if (result == EPERM)
+    {
+        log_warning("Thread: insufficient privileges to set thread priority to %d", static_cast<int>(priority));
+        return;
+    }
+
+    BEE_ASSERT_F(result == 0, "Failed to set thread priority: %s", strerror(result));
+}
+
+
+namespace current_thread {
+
+
+thread_id_t id()
+{
+    return static_cast<thread_id_t>(pthread_self());
+}
+
+void sleep(const u64 ticks_to_sleep)
+{
+    const auto frequency = time::ticks_per_second();
+
+    timespec remaining{};
+    remaining.tv_sec = static_cast<time_t>(ticks_to_sleep / frequency);
+    remaining.tv_nsec = static_cast<long>(((ticks_to_sleep % frequency) * 1000000000ull) / frequency);
+
+    // nanosleep has nanosecond precision already so unlike Win32 there's no need to spin for the remainder
+    while (clock_nanosleep(CLOCK_MONOTONIC, 0, &remaining, &remaining) == EINTR) {}
+}
+
+void set_affinity(const i32 cpu)
+{
+    set_native_thread_affinity(pthread_self(), cpu);
+}
+
+void set_name(const char* name)
+{
+    set_native_thread_name(pthread_self(), name);
+}
+
+void set_priority(ThreadPriority priority)
+{
+    set_native_thread_priority(pthread_self(), priority);
+}
+
+
+} // current_thread
+
+
+void Thread::join()
+{
+    const auto join_result = pthread_join(native_thread_, nullptr);
+    BEE_ASSERT_F(join_result == 0, "Thread: failed to join thread: %s", strerror(join_result));
+    native_thread_ = native_thread_t{};
+    name_.clear();
+}
+
+void Thread::detach()
+{
+    const auto detach_result = pthread_detach(native_thread_);
+    BEE_ASSERT_F(detach_result == 0, "Thread: failed to detach thread: %s", strerror(detach_result));
+    // a detached pthread can't be joined so the destructor mustn't try to
+    native_thread_ = native_thread_t{};
+}
+
+void Thread::set_affinity(const i32 cpu)
+{
+    BEE_ASSERT_F(joinable(), "Thread: cannot set affinity for invalid thread");
+    set_native_thread_affinity(native_thread_, cpu);
+}
+
+void Thread::set_priority(const ThreadPriority priority)
+{
+    BEE_ASSERT_F(joinable(), "Thread: cannot set priority for invalid thread");
+    set_native_thread_priority(native_thread_, priority);
+}
+
+thread_id_t Thread::id() const
+{
+    BEE_ASSERT(joinable());
+    return static_cast<thread_id_t>(native_thread_);
+}
+
+void Thread::create_native_thread(ExecuteParams* params) noexcept
+{
+    const auto create_result = pthread_create(&native_thread_, nullptr, execute_cb, params);
+    BEE_ASSERT_F(create_result == 0, "Thread: unable to create native thread: %s", strerror(create_result));
+
+    set_native_thread_name(native_thread_, name_.view());
+}
+
+Thread::execute_cb_return_t Thread::execute_cb(void* params)
+{
+    if (BEE_FAIL_F(params != nullptr, "Thread: invalid config given to callback"))
+    {
+        return nullptr;
+    }
+
+    auto* data = static_cast<Thread::ExecuteParams*>(params);
+    if (BEE_FAIL_F(data->invoker != nullptr, "Invalid thread function given"))
+    {
+        return nullptr;
+    }
+
+    // register with temp allocator if needed
+    const auto register_with_temp_allocator = data->register_with_temp_allocator;
+    if (register_with_temp_allocator)
+    {
+        temp_allocator_register_thread();
+    }
+
+    // run the threads function
+    data->invoker(data->function, data->arg);
+    data->destructor(data->function, data->arg);
+
+    if (register_with_temp_allocator)
+    {
+        temp_allocator_unregister_thread();
+    }
+    return nullptr;
+}
+
+
+} // namespace bee
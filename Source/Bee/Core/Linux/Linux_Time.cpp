@@ -0,0 +1,110 @@
+/*
+ *  Linux_Time.cpp
+ *  Bee
+ *
+ *  Copyright (c) 2020 Jacob Milligan. All rights reserved.
+ */
+
+#include "Bee/Core/Time.hpp"
+#include "Bee/Core/Error.hpp"
+#include "Bee/Core/Logger.hpp"
+
+#include <time.h>
+
+#if BEE_CONFIG_USE_RDTSC_TIMER == 1 && (defined(__x86_64__) || defined(__i386__))
+    #include <cpuid.h>
+    #include <x86intrin.h>
+
+    #define BEE_LINUX_RDTSC_AVAILABLE 1
+#else
+    #define BEE_LINUX_RDTSC_AVAILABLE 0
+#endif // BEE_CONFIG_USE_RDTSC_TIMER == 1
+
+namespace bee {
+namespace time {
+
+
+static constexpr u64 nanoseconds_per_second = 1000000000ull;
+
+// CLOCK_MONOTONIC_RAW isn't slewed by NTP so intervals measured with it are never stretched or squashed
+static u64 monotonic_raw_now() noexcept
+{
+    timespec now{};
+    const auto result = clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+
+    if (!BEE_CHECK(result == 0))
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    }
+
+    // ticks
+    return static_cast<u64>(now.tv_sec) * nanoseconds_per_second + static_cast<u64>(now.tv_nsec);
+}
+
+#if BEE_LINUX_RDTSC_AVAILABLE == 1
+
+static constexpr u64 tsc_calibration_nanoseconds = 10000000ull; // 10ms
+
+/*
+ * Returns the TSC frequency if it can be used as the system timer, otherwise 0. The TSC is only safe to use if it's
+ * invariant, i.e. it ticks at a constant rate across all cores regardless of frequency scaling and sleep states
+ */
+static u64 calibrate_tsc() noexcept
+{
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0 || (edx & (1u << 8u)) == 0)
+    {
+        log_warning("Invariant TSC is not supported on this CPU - falling back to CLOCK_MONOTONIC_RAW");
+        return 0;
+    }
+
+    const auto begin_ns = monotonic_raw_now();
+    const auto begin_tsc = __rdtsc();
+    auto end_ns = begin_ns;
+
+    while (end_ns - begin_ns < tsc_calibration_nanoseconds)
+    {
+        end_ns = monotonic_raw_now();
+    }
+
+    const auto end_tsc = __rdtsc();
+    const auto elapsed_seconds = static_cast<double>(end_ns - begin_ns) / static_cast<double>(nanoseconds_per_second);
+    return static_cast<u64>(static_cast<double>(end_tsc - begin_tsc) / elapsed_seconds);
+}
+
+static u64 tsc_frequency() noexcept
+{
+    static const auto frequency = calibrate_tsc();
+    return frequency;
+}
+
+#endif // BEE_LINUX_RDTSC_AVAILABLE == 1
+
+
+u64 now() noexcept
+{
+#if BEE_LINUX_RDTSC_AVAILABLE == 1
+    if (tsc_frequency() > 0)
+    {
+        return __rdtsc();
+    }
+#endif // BEE_LINUX_RDTSC_AVAILABLE == 1
+
+    return monotonic_raw_now();
+}
+
+u64 ticks_per_second() noexcept
+{
+#if BEE_LINUX_RDTSC_AVAILABLE == 1
+    if (tsc_frequency() > 0)
+    {
+        return tsc_frequency();
+    }
+#endif // BEE_LINUX_RDTSC_AVAILABLE == 1
+
+    return nanoseconds_per_second;
+}
+
+
+} // namespace time
+} // namespace bee
@@ -195,7 +195,7 @@ void default_logger_callback(const LogVerbosity verbosity, const char* fmt, va_l
 
     stream.write_v(fmt, va_args);
     stream.write("\n");
-    win32_write_console(verbosity, stream.c_str_buffer(), stream.size());
+    win32_write_console(verbosity, stream.c_str_buffer(), sign_cast<i32>(stream.size()));
 #else
     vfprintf(file, fmt, va_args);
 #endif // BEE_OS_WINDOWS == 1
@@ -644,6 +644,12 @@ bool Path::is_absolute() const
     return view().is_absolute();
 }
 
+Path& Path::normalize_lexically()
+{
+    data_.resize(detail::path_normalize_lexically(data_.data(), data_.size()));
+    return *this;
+}
+
 i32 Path::size() const
 {
     return sign_cast<i32>(data_.size());
@@ -772,6 +778,208 @@ i32 path_compare(const PathView& lhs, const PathView& rhs)
 //    return lhs_index - rhs_index;
 }
 
+u64 get_path_hash64(const PathView& path, const u64 seed)
+{
+    // Chaining the hash through each component means `A/BC` and `AB/C` hash differently without hashing the slashes
+    u64 hash = seed;
+    for (const auto component : path)
+    {
+        hash = get_hash64(component.data(), sign_cast<size_t>(component.size()), hash);
+    }
+    return hash;
+}
+
+/*
+ ***************************************
+ *
+ * StaticPath - implementation
+ *
+ ***************************************
+ */
+namespace detail {
+
+
+i32 path_append(char* buffer, const i32 size, const i32 capacity, const PathView& src)
+{
+    if (src.empty())
+    {
+        return size;
+    }
+
+    // Replace the current path with the entirety of src if it's absolute
+    if (src.is_absolute())
+    {
+        if (src.size() >= capacity)
+        {
+            return -1;
+        }
+
+        memmove(buffer, src.data(), src.size());
+        return src.size();
+    }
+
+    const bool needs_slash = size > 0 && buffer[size - 1] != Path::preferred_slash;
+    const i32 new_size = size + (needs_slash ? 1 : 0) + src.size();
+
+    if (new_size >= capacity)
+    {
+        return -1;
+    }
+
+    // move src first in case it points into `buffer` after `size`
+    memmove(buffer + new_size - src.size(), src.data(), src.size());
+
+    if (needs_slash)
+    {
+        buffer[size] = Path::preferred_slash;
+    }
+
+    return new_size;
+}
+
+i32 path_append_extension(char* buffer, const i32 size, const i32 capacity, const StringView& ext)
+{
+    if (ext.empty())
+    {
+        return size;
+    }
+
+    const bool needs_dot = size <= 0 || buffer[size - 1] != '.';
+    const auto ext_without_dot = ext[0] == '.' ? str::substring(ext, 1) : ext;
+    const i32 new_size = size + (needs_dot ? 1 : 0) + ext_without_dot.size();
+
+    if (new_size >= capacity)
+    {
+        return -1;
+    }
+
+    if (needs_dot)
+    {
+        buffer[size] = '.';
+    }
+
+    memcpy(buffer + new_size - ext_without_dot.size(), ext_without_dot.data(), ext_without_dot.size());
+    return new_size;
+}
+
+i32 path_set_extension(char* buffer, const i32 size, const i32 capacity, const StringView& ext)
+{
+    // Follows the same rules as `Path::set_extension`
+    const StringView path(buffer, size);
+    auto dotpos = str::last_index_of(path, '.');
+    const auto is_dot_slash = dotpos + 1 < size && is_slash(buffer + dotpos + 1);
+    const auto is_dot_dot = dotpos >= 0 && dotpos + 1 < size && buffer[dotpos + 1] == '.';
+    const auto empty_dot = ext.empty() || (ext[0] == '.' && ext.size() < 2);
+
+    if (is_dot_dot || is_dot_slash)
+    {
+        dotpos = -1;
+    }
+
+    // If it's an empty extension we just want to end the string at the last dot position
+    if (empty_dot)
+    {
+        return dotpos != -1 ? dotpos : size;
+    }
+
+    const auto ext_without_dot = ext[0] == '.' ? str::substring(ext, 1) : ext;
+    const i32 dot_size = dotpos == -1 ? size : dotpos;
+    const i32 new_size = dot_size + 1 + ext_without_dot.size();
+
+    if (new_size >= capacity)
+    {
+        return -1;
+    }
+
+    buffer[dot_size] = '.';
+    memcpy(buffer + dot_size + 1, ext_without_dot.data(), ext_without_dot.size());
+    return new_size;
+}
+
+i32 path_remove_filename(const char* buffer, const i32 size)
+{
+    return size > 0 ? get_filename_index(StringView(buffer, size)) : 0;
+}
+
+i32 path_normalize_lexically(char* buffer, const i32 size)
+{
+    const i32 root_name_size = PathView(StringView(buffer, size)).root_name().size();
+    const bool has_root_directory = root_name_size < size && is_slash(buffer + root_name_size);
+
+    // The output never gets ahead of the input so the path can be rewritten in-place
+    i32 out = root_name_size;
+    i32 in = root_name_size;
+
+    if (has_root_directory)
+    {
+        buffer[out++] = Path::preferred_slash;
+    }
+
+    const i32 root_size = out;
+
+    while (in < size)
+    {
+        while (in < size && is_slash(buffer + in))
+        {
+            ++in;
+        }
+
+        i32 component_end = in;
+        while (component_end < size && !is_slash(buffer + component_end))
+        {
+            ++component_end;
+        }
+
+        const i32 component_size = component_end - in;
+
+        if (component_size == 0 || (component_size == 1 && buffer[in] == '.'))
+        {
+            in = component_end;
+            continue;
+        }
+
+        if (component_size == 2 && buffer[in] == '.' && buffer[in + 1] == '.')
+        {
+            i32 last_component = out;
+            while (last_component > root_size && !is_slash(buffer + last_component - 1))
+            {
+                --last_component;
+            }
+
+            const i32 last_size = out - last_component;
+            const bool is_last_dot_dot = last_size == 2 && buffer[last_component] == '.' && buffer[last_component + 1] == '.';
+
+            // `..` removes the previous component, or is dropped if it would go above the root directory
+            if ((last_size > 0 && !is_last_dot_dot) || (last_size == 0 && has_root_directory))
+            {
+                out = last_component > root_size ? last_component - 1 : last_component;
+                in = component_end;
+                continue;
+            }
+        }
+
+        if (out > root_size)
+        {
+            buffer[out++] = Path::preferred_slash;
+        }
+
+        memmove(buffer + out, buffer + in, component_size);
+        out += component_size;
+        in = component_end;
+    }
+
+    // An empty relative path refers to the current directory
+    if (out == 0 && size > 0)
+    {
+        buffer[out++] = '.';
+    }
+
+    return out;
+}
+
+
+} // namespace detail
+
 /*
  ***************************************
  *
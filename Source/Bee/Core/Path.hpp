@@ -241,6 +241,12 @@ public:
 
     Path get_normalized(Allocator* allocator = system_allocator()) const;
 
+    /**
+     * Normalizes the path in-place without touching the filesystem or allocating - repeated slashes are collapsed and
+     * converted to `preferred_slash`, `.` components are removed and `..` components remove the component before them
+     */
+    Path& normalize_lexically();
+
     /// @brief Gets the character size of the path string
     /// @return
     i32 size() const;
@@ -270,6 +276,242 @@ private:
     String data_;
 };
 
+/*
+ ***************************************
+ *
+ * # StaticPath
+ *
+ * A path stored in a fixed-size inline buffer. It supports the same manipulation functions as `Path` but never
+ * allocates so it's meant for building temporary paths in hot loops, i.e. the source and .meta paths of every file
+ * the asset pipeline imports. Growing a path past `Capacity - 1` characters asserts and leaves it unchanged
+ *
+ ***************************************
+ */
+namespace detail {
+
+/*
+ * Path manipulation used by `StaticPath` that works directly on a character buffer. Each function returns the new
+ * size of the path or -1 if the result and its null-terminator wouldn't fit in `capacity`
+ */
+BEE_CORE_API i32 path_append(char* buffer, const i32 size, const i32 capacity, const PathView& src);
+
+BEE_CORE_API i32 path_append_extension(char* buffer, const i32 size, const i32 capacity, const StringView& ext);
+
+BEE_CORE_API i32 path_set_extension(char* buffer, const i32 size, const i32 capacity, const StringView& ext);
+
+BEE_CORE_API i32 path_remove_filename(const char* buffer, const i32 size);
+
+// Never grows the path so it can't fail
+BEE_CORE_API i32 path_normalize_lexically(char* buffer, const i32 size);
+
+} // namespace detail
+
+
+template <i32 Capacity = 4096>
+class StaticPath
+{
+public:
+    static_assert(Capacity > 1, "StaticPath capacity must fit at least one character and a null-terminator");
+
+    StaticPath() noexcept
+    {
+        buffer_[0] = '\0';
+    }
+
+    StaticPath(const PathView& src) noexcept // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+    {
+        assign(src);
+    }
+
+    StaticPath(const char* src) noexcept // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+        : StaticPath(PathView(src))
+    {}
+
+    StaticPath(const StaticPath& other) noexcept
+    {
+        assign(other.view());
+    }
+
+    StaticPath& operator=(const StaticPath& other) noexcept
+    {
+        if (this != &other)
+        {
+            assign(other.view());
+        }
+        return *this;
+    }
+
+    StaticPath& operator=(const PathView& src) noexcept
+    {
+        return assign(src);
+    }
+
+    StaticPath& operator=(const char* src) noexcept
+    {
+        return assign(PathView(src));
+    }
+
+    StaticPath& assign(const PathView& src)
+    {
+        if (BEE_FAIL_F(src.size() < Capacity, "Path is too long for StaticPath<%d>: %" BEE_PRIsv, Capacity, BEE_FMT_SV(src)))
+        {
+            return *this;
+        }
+
+        // `src` might point into this paths buffer
+        memmove(buffer_, src.data(), src.size());
+        set_size(src.size());
+        return *this;
+    }
+
+    StaticPath& append(const PathView& src)
+    {
+        return set_size_checked(detail::path_append(buffer_, size_, Capacity, src));
+    }
+
+    StaticPath& append_extension(const StringView& ext)
+    {
+        return set_size_checked(detail::path_append_extension(buffer_, size_, Capacity, ext));
+    }
+
+    StaticPath& set_extension(const StringView& ext)
+    {
+        return set_size_checked(detail::path_set_extension(buffer_, size_, Capacity, ext));
+    }
+
+    StaticPath& remove_filename()
+    {
+        return set_size_checked(detail::path_remove_filename(buffer_, size_));
+    }
+
+    StaticPath& replace_filename(const StringView& replacement)
+    {
+        remove_filename();
+        return replacement.empty() ? *this : append(replacement);
+    }
+
+    StaticPath& normalize_lexically()
+    {
+        return set_size_checked(detail::path_normalize_lexically(buffer_, size_));
+    }
+
+    StaticPath& make_preferred()
+    {
+        replace_slashes(Path::generic_slash, Path::preferred_slash);
+        return *this;
+    }
+
+    StaticPath& make_generic()
+    {
+        replace_slashes(Path::preferred_slash, Path::generic_slash);
+        return *this;
+    }
+
+    inline void clear()
+    {
+        set_size(0);
+    }
+
+    inline PathView view() const
+    {
+        return StringView(buffer_, size_);
+    }
+
+    inline StringView string_view() const
+    {
+        return StringView(buffer_, size_);
+    }
+
+    inline const char* c_str() const
+    {
+        return buffer_;
+    }
+
+    inline const char* data() const
+    {
+        return buffer_;
+    }
+
+    inline i32 size() const
+    {
+        return size_;
+    }
+
+    inline constexpr i32 capacity() const
+    {
+        return Capacity;
+    }
+
+    inline bool empty() const
+    {
+        return size_ <= 0;
+    }
+
+    inline StringView extension() const
+    {
+        return view().extension();
+    }
+
+    inline StringView filename() const
+    {
+        return view().filename();
+    }
+
+    inline StringView stem() const
+    {
+        return view().stem();
+    }
+
+    inline PathView parent() const
+    {
+        return view().parent();
+    }
+
+    inline bool exists() const
+    {
+        return view().exists();
+    }
+
+    inline bool is_absolute() const
+    {
+        return view().is_absolute();
+    }
+
+    inline PathIterator begin() const;
+
+    inline PathIterator end() const;
+
+private:
+    i32     size_ { 0 };
+    char    buffer_[Capacity];
+
+    inline void set_size(const i32 size)
+    {
+        size_ = size;
+        buffer_[size_] = '\0';
+    }
+
+    inline StaticPath& set_size_checked(const i32 size)
+    {
+        if (BEE_CHECK_F(size >= 0, "Path is too long for StaticPath<%d>: %s", Capacity, buffer_))
+        {
+            set_size(size);
+        }
+        return *this;
+    }
+
+    inline void replace_slashes(const char from, const char to)
+    {
+        for (int i = 0; i < size_; ++i)
+        {
+            if (buffer_[i] == from)
+            {
+                buffer_[i] = to;
+            }
+        }
+    }
+};
+
 /// @brief Gets the absolute path to the application binary's directory
 /// @return
 BEE_CORE_API PathView executable_path();
@@ -469,7 +711,7 @@ struct Hash<PathView>
 {
     inline u32 operator()(const PathView& key) const
     {
-        return get_hash(key.data(), key.size(), 0xF00D);
+        return get_fast_hash(key.data(), key.size(), 0xF00D);
     }
 
     inline u32 operator()(const String& key) const
@@ -484,7 +726,7 @@ struct Hash<PathView>
 
     inline u32 operator()(const char* key) const
     {
-        return get_hash(key, str::length(key), 0xF00D);
+        return get_fast_hash(key, str::length(key), 0xF00D);
     }
 };
 
@@ -509,7 +751,52 @@ struct Hash<Path>
 
     inline u32 operator()(const char* key) const
     {
-        return get_hash(key, str::length(key), 0xF00D);
+        return get_fast_hash(key, str::length(key), 0xF00D);
+    }
+};
+
+/*
+ ***************************************
+ *
+ * # Path hashing
+ *
+ * `get_path_hash64` hashes a paths components rather than its raw characters so paths that compare equal with
+ * `path_compare` (i.e. with repeated slashes) always hash equal. `HashedPathView` stores the hash alongside the path
+ * so it's only calculated once when used as a key - comparisons check the hashes before comparing any characters
+ *
+ ***************************************
+ */
+BEE_CORE_API u64 get_path_hash64(const PathView& path, const u64 seed = 0);
+
+struct HashedPathView
+{
+    PathView    path;
+    u64         hash { 0 };
+
+    HashedPathView() = default;
+
+    explicit HashedPathView(const PathView& path_to_hash)
+        : path(path_to_hash),
+          hash(get_path_hash64(path_to_hash))
+    {}
+};
+
+inline bool operator==(const HashedPathView& lhs, const HashedPathView& rhs)
+{
+    return lhs.hash == rhs.hash && path_compare(lhs.path, rhs.path) == 0;
+}
+
+inline bool operator!=(const HashedPathView& lhs, const HashedPathView& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <>
+struct Hash<HashedPathView>
+{
+    inline u32 operator()(const HashedPathView& key) const
+    {
+        return static_cast<u32>(key.hash ^ (key.hash >> 32u));
     }
 };
 
@@ -556,6 +843,18 @@ private:
     void next();
 };
 
+template <i32 Capacity>
+inline PathIterator StaticPath<Capacity>::begin() const
+{
+    return view().begin();
+}
+
+template <i32 Capacity>
+inline PathIterator StaticPath<Capacity>::end() const
+{
+    return view().end();
+}
+
 
 } // namespace bee
 
@@ -9,6 +9,7 @@
 #include "Bee/Core/Containers/Array.hpp"
 #include "Bee/Core/DynamicLibrary.hpp"
 #include "Bee/Core/Filesystem.hpp"
+#include "Bee/Core/StringTable.hpp"
 #include "Bee/Core/Serialization/JSONSerializer.hpp"
 
 #include <algorithm>
@@ -73,10 +74,10 @@ struct Plugin
 struct PluginRegistry
 {
     DynamicArray<Plugin>                        plugins;
-    DynamicArray<u32>                           plugin_hashes;
+    DynamicArray<InternedString>                plugin_names;
 
     DynamicArray<UniquePtr<ModuleHeader>>       modules;
-    DynamicArray<u32>                           module_hashes;
+    DynamicArray<InternedString>                module_names;
 
     fs::DirectoryWatcher                        directory_watcher;
     DynamicArray<fs::FileNotifyInfo>            file_events;
@@ -182,16 +183,21 @@ void shutdown_plugins()
     BEE_DELETE(system_allocator(), g_registry);
 }
 
+/*
+ * Plugin and module names are interned so a lookup is a pointer compare per entry and two different names can't
+ * alias each other the way their hashes could. A name that was never interned can't be registered so there's no
+ * need to intern it just to look it up
+ */
 static i32 find_plugin(const StringView& name)
 {
-    const u32 hash = get_hash(name);
-    return find_index(g_registry->plugin_hashes, hash);
+    const auto interned = find_interned_string(name);
+    return interned.is_valid() ? find_index(g_registry->plugin_names, interned) : -1;
 }
 
 static i32 find_module(const StringView& name)
 {
-    const u32 hash = get_hash(name);
-    return find_index(g_registry->module_hashes, hash);
+    const auto interned = find_interned_string(name);
+    return interned.is_valid() ? find_index(g_registry->module_names, interned) : -1;
 }
 
 static bool load_plugin_dependency(const StringView& name, const PluginVersion& minimum_version);
@@ -466,7 +472,7 @@ static void register_plugin(const PathView& lib_path)
     plugin.library_path = lib_path;
 
     g_registry->plugins.push_back(plugin);
-    g_registry->plugin_hashes.push_back(get_hash(name));
+    g_registry->plugin_names.push_back(intern_string(name));
 }
 
 static void unregister_plugin(const PathView& lib_path)
@@ -481,7 +487,7 @@ static void unregister_plugin(const PathView& lib_path)
 
     // unregister from the whole registry
     g_registry->plugins.erase(index);
-    g_registry->plugin_hashes.erase(index);
+    g_registry->plugin_names.erase(index);
 }
 
 void refresh_plugins()
@@ -717,7 +723,7 @@ void PluginLoader::add_module_interface(const StringView& name, const void* modu
         header->references = 0;
         header->name = name;
         g_registry->modules.emplace_back(header, system_allocator());
-        g_registry->module_hashes.push_back(get_hash(name));
+        g_registry->module_names.push_back(intern_string(name));
 
         index = g_registry->modules.size() - 1;
     }
@@ -743,6 +749,7 @@ void PluginLoader::remove_module_interface(const void* module)
     if (references < 0)
     {
         g_registry->modules.erase(index);
+        g_registry->module_names.erase(index);
     }
 }
 
@@ -7,6 +7,7 @@
 
 #include "Bee/Core/Reflection.hpp"
 #include "Bee/Core/Containers/HashMap.hpp"
+#include "Bee/Core/Concurrency.hpp"
 
 
 namespace bee {
@@ -306,15 +307,111 @@ bool SpecializedType<T>::is_unknown() const
  */
 struct ReflectionModule
 {
-    u32                         hash { 0 };
-    i32                         type_count { 0 };
-    const char*                 name { nullptr };
-    const get_type_callback_t*  types { nullptr };
-    u32*                        type_hashes { nullptr };
+    u32                 hash { 0 };
+    i32                 type_count { 0 };
+    const char*         name { nullptr };
+    const TypeInfo**    types { nullptr };
+    u32*                type_hashes { nullptr };
 };
 
-static DynamicHashMap<u32, get_type_callback_t> g_type_map;
-static DynamicHashMap<u32, ReflectionModule*>   g_modules;
+/*
+ * Immutable open-addressed table of every registered type. `get_type(hash)` is called constantly from job workers
+ * so lookups never take a lock - instead each create/destroy of a reflection module builds a new snapshot and
+ * publishes it atomically. Type hashes are already well distributed so the hash itself is used as the probe start
+ */
+struct TypeRegistrySnapshot
+{
+    i32                 capacity { 0 }; // always a power of two and at most half full
+    i32                 count { 0 };
+    u32*                hashes { nullptr };
+    const TypeInfo**    types { nullptr };
+};
+
+struct TypeRegistry
+{
+    Mutex                                       mutex;
+    DynamicHashMap<u32, const TypeInfo*>        types;
+    DynamicHashMap<u32, ReflectionModule*>      modules;
+    std::atomic<const TypeRegistrySnapshot*>    snapshot { nullptr };
+
+    /*
+     * Readers may still be probing a snapshot after it's replaced so retired snapshots are kept until a publish sees
+     * no lookups in flight. `active_readers` is bumped around every lookup - a reader that loaded a retired snapshot
+     * always incremented it before the snapshot was swapped out so the writer can't observe zero until it's done
+     */
+    std::atomic<i32>                            active_readers { 0 };
+    DynamicArray<TypeRegistrySnapshot*>         retired;
+
+    ~TypeRegistry()
+    {
+        retired.push_back(const_cast<TypeRegistrySnapshot*>(snapshot.exchange(nullptr, std::memory_order_acq_rel)));
+
+        for (auto* old : retired)
+        {
+            if (old != nullptr)
+            {
+                BEE_FREE(system_allocator(), old);
+            }
+        }
+    }
+};
+
+static TypeRegistry g_registry;
+
+// Must be called with the registry mutex held
+static void publish_type_registry()
+{
+    const i32 count = g_registry.types.size();
+    i32 capacity = 16;
+    while (capacity < count * 2)
+    {
+        capacity *= 2;
+    }
+
+    const size_t hashes_bytecount = sizeof(u32) * capacity;
+    const size_t types_bytecount = sizeof(const TypeInfo*) * capacity;
+
+    auto* mem = static_cast<u8*>(BEE_MALLOC(system_allocator(), sizeof(TypeRegistrySnapshot) + types_bytecount + hashes_bytecount));
+    auto* snapshot = reinterpret_cast<TypeRegistrySnapshot*>(mem);
+    new (snapshot) TypeRegistrySnapshot{};
+
+    snapshot->capacity = capacity;
+    snapshot->count = count;
+    snapshot->types = reinterpret_cast<const TypeInfo**>(mem + sizeof(TypeRegistrySnapshot));
+    snapshot->hashes = reinterpret_cast<u32*>(mem + sizeof(TypeRegistrySnapshot) + types_bytecount);
+    memset(snapshot->types, 0, types_bytecount);
+    memset(snapshot->hashes, 0, hashes_bytecount);
+
+    const u32 mask = static_cast<u32>(capacity - 1);
+
+    for (const auto& type : g_registry.types)
+    {
+        u32 index = type.key & mask;
+        while (snapshot->types[index] != nullptr)
+        {
+            index = (index + 1) & mask;
+        }
+
+        snapshot->hashes[index] = type.key;
+        snapshot->types[index] = type.value;
+    }
+
+    auto* old = g_registry.snapshot.exchange(snapshot, std::memory_order_seq_cst);
+    if (old != nullptr)
+    {
+        g_registry.retired.push_back(const_cast<TypeRegistrySnapshot*>(old));
+    }
+
+    // Any reader that starts after the exchange can only see the new snapshot so it's safe to free the rest
+    if (g_registry.active_readers.load(std::memory_order_seq_cst) == 0)
+    {
+        for (auto* retired_snapshot : g_registry.retired)
+        {
+            BEE_FREE(system_allocator(), retired_snapshot);
+        }
+        g_registry.retired.clear();
+    }
+}
 
 void register_type(const Type& type)
 {
@@ -336,13 +433,15 @@ const ReflectionModule* create_reflection_module(const StringView& name, const i
 {
     const u32 hash = get_hash(name);
 
-    if (BEE_FAIL_F(g_modules.find(hash) == nullptr, "Reflection module %" BEE_PRIsv " already exists", BEE_FMT_SV(name)))
+    scoped_lock_t lock(g_registry.mutex);
+
+    if (BEE_FAIL_F(g_registry.modules.find(hash) == nullptr, "Reflection module %" BEE_PRIsv " already exists", BEE_FMT_SV(name)))
     {
         return nullptr;
     }
 
     const size_t name_bytecount = name.size() * sizeof(char) + 1;
-    const size_t types_bytecount = sizeof(get_type_callback_t) * (type_count + 1); // for null terminator
+    const size_t types_bytecount = sizeof(const TypeInfo*) * (type_count + 1); // for null terminator
     const size_t type_hash_bytecount = sizeof(u32) * type_count;
 
     auto* mem = BEE_MALLOC(system_allocator(), sizeof(ReflectionModule) + name_bytecount + types_bytecount + type_hash_bytecount);
@@ -351,10 +450,15 @@ const ReflectionModule* create_reflection_module(const StringView& name, const i
 
     auto* name_ptr = reinterpret_cast<char*>(static_cast<u8*>(mem) + sizeof(ReflectionModule));
     str::copy(name_ptr, name_bytecount, name);
-    name_ptr[name_bytecount] = '\0';
+    name_ptr[name_bytecount - 1] = '\0';
 
-    auto* types_ptr = reinterpret_cast<get_type_callback_t*>(static_cast<u8*>(mem) + sizeof(ReflectionModule) + name_bytecount);
-    memcpy(types_ptr, callbacks, type_count * sizeof(get_type_callback_t));
+    // Resolve each type once up front so lookups don't have to call back into the module
+    auto* types_ptr = reinterpret_cast<const TypeInfo**>(static_cast<u8*>(mem) + sizeof(ReflectionModule) + name_bytecount);
+    for (int i = 0; i < type_count; ++i)
+    {
+        types_ptr[i] = callbacks[i]().get();
+    }
+    types_ptr[type_count] = nullptr;
 
     auto* type_hashes_ptr = reinterpret_cast<u32*>(static_cast<u8*>(mem) + sizeof(ReflectionModule) + name_bytecount + types_bytecount);
     memcpy(type_hashes_ptr, hashes, type_count * sizeof(u32));
@@ -365,20 +469,25 @@ const ReflectionModule* create_reflection_module(const StringView& name, const i
     module->types = types_ptr;
     module->type_hashes = type_hashes_ptr;
 
-    g_modules.insert(module->hash, module);
+    g_registry.modules.insert(module->hash, module);
 
     for (int i = 0; i < type_count; ++i)
     {
-        g_type_map.insert(hashes[i], callbacks[i]);
+        g_registry.types.insert(hashes[i], types_ptr[i]);
     }
 
+    publish_type_registry();
+
     return module;
 }
 
 void destroy_reflection_module(const ReflectionModule* module)
 {
     const u32 hash = module->hash;
-    auto* stored_module = g_modules.find(hash);
+
+    scoped_lock_t lock(g_registry.mutex);
+
+    auto* stored_module = g_registry.modules.find(hash);
 
     if (BEE_FAIL_F(stored_module != nullptr, "Reflection module %s was destroyed twice", module->name))
     {
@@ -387,16 +496,20 @@ void destroy_reflection_module(const ReflectionModule* module)
 
     for (int i = 0; i < module->type_count; ++i)
     {
-        g_type_map.erase(module->type_hashes[i]);
+        g_registry.types.erase(module->type_hashes[i]);
     }
 
+    publish_type_registry();
+
     BEE_FREE(system_allocator(), stored_module->value);
-    g_modules.erase(hash);
+    g_registry.modules.erase(hash);
 }
 
 const ReflectionModule* get_reflection_module(const StringView& name)
 {
-    auto* stored_module = g_modules.find(get_hash(name));
+    scoped_lock_t lock(g_registry.mutex);
+
+    auto* stored_module = g_registry.modules.find(get_hash(name));
     BEE_ASSERT(stored_module != nullptr);
     return stored_module ? stored_module->value : nullptr;
 }
@@ -408,13 +521,35 @@ u32 get_type_hash(const StringView& type_name)
 
 Type get_type(const u32 hash)
 {
-    auto* type = g_type_map.find(hash);
-    if (type != nullptr)
+    g_registry.active_readers.fetch_add(1, std::memory_order_seq_cst);
+
+    const auto* snapshot = g_registry.snapshot.load(std::memory_order_seq_cst);
+    const TypeInfo* result = nullptr;
+
+    if (snapshot != nullptr)
     {
-        return type->value();
+        const u32 mask = static_cast<u32>(snapshot->capacity - 1);
+
+        for (u32 index = hash & mask; snapshot->types[index] != nullptr; index = (index + 1) & mask)
+        {
+            if (snapshot->hashes[index] == hash)
+            {
+                result = snapshot->types[index];
+                break;
+            }
+        }
     }
 
-    return get_type<UnknownTypeInfo>();
+    // release so that the probes above happen-before a writer that sees the count drop to zero frees the snapshot
+    g_registry.active_readers.fetch_sub(1, std::memory_order_release);
+
+    return result != nullptr ? Type(result) : get_type<UnknownTypeInfo>();
+}
+
+i32 get_retired_type_registry_count()
+{
+    scoped_lock_t lock(g_registry.mutex);
+    return g_registry.retired.size();
 }
 
 Type get_type(const ReflectionModule* module, const i32 index)
@@ -424,7 +559,7 @@ Type get_type(const ReflectionModule* module, const i32 index)
         return Type(&g_unknown_type);
     }
 
-    return module->types[index]();
+    return Type(module->types[index]);
 }
 
 BEE_CORE_API void reflection_register_builtin_types()
@@ -436,10 +571,14 @@ BEE_PUSH_WARNING
     static GetTypeParams builtin_types[] { BEE_BUILTIN_TYPES };
 BEE_POP_WARNING
 
+    scoped_lock_t lock(g_registry.mutex);
+
     for (auto& type : builtin_types)
     {
-        g_type_map.insert(type.hash, type.callback);
+        g_registry.types.insert(type.hash, type.callback().get());
     }
+
+    publish_type_registry();
 }
 
 
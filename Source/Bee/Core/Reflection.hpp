@@ -382,6 +382,8 @@ struct TemplateParameter
 };
 
 class SerializationBuilder;
+struct Serializer;
+struct SerializeTypeParams;
 
 struct Field
 {
@@ -1017,12 +1019,19 @@ using FunctionType = SpecializedType<FunctionTypeInfo>;
 
 struct RecordTypeInfo final : public TypeSpec<TypeKind::record>
 {
+    /*
+     * Generated by bee-reflect for `packed_format` records - serializes the records fields at their current version
+     * for binary serializers with contiguous runs of fundamentals and enums read/written as a single block
+     */
+    using binary_serialization_function_t = void(*)(Serializer*, const SerializeTypeParams&);
+
     Span<Field>                             fields;
     Span<FunctionTypeInfo>                  functions;
     Span<Attribute>                         attributes;
     Span<EnumType>                          enums;
     Span<SpecializedType<RecordTypeInfo>>   records;
     Span<Type>                              base_records;
+    binary_serialization_function_t         binary_serializer_function { nullptr };
 
     using TypeSpec::TypeSpec;
 
@@ -1042,14 +1051,16 @@ struct RecordTypeInfo final : public TypeSpec<TypeKind::record>
         const Span<Attribute> new_attributes,
         const Span<EnumType> nested_enums,
         const Span<SpecializedType<RecordTypeInfo>> nested_records,
-        const Span<Type> bases
+        const Span<Type> bases,
+        binary_serialization_function_t new_binary_serializer_function = nullptr
     ) noexcept : TypeSpec(new_hash, new_size, new_alignment, new_kind, new_name, new_serialized_version, new_serialization_flags, create_instance_function),
         fields(new_fields),
         functions(new_functions),
         attributes(new_attributes),
         enums(nested_enums),
         records(nested_records),
-        base_records(bases)
+        base_records(bases),
+        binary_serializer_function(new_binary_serializer_function)
     {}
 
     RecordTypeInfo(
@@ -1067,14 +1078,16 @@ struct RecordTypeInfo final : public TypeSpec<TypeKind::record>
         const Span<Attribute> new_attributes,
         const Span<EnumType> nested_enums,
         const Span<SpecializedType<RecordTypeInfo>> nested_records,
-        const Span<Type> bases
+        const Span<Type> bases,
+        binary_serialization_function_t new_binary_serializer_function = nullptr
     ) noexcept : TypeSpec(new_hash, new_size, new_alignment, new_kind, new_name, new_serialized_version, new_serialization_flags, create_instance_function, new_template_parameters),
         fields(new_fields),
         functions(new_functions),
         attributes(new_attributes),
         enums(nested_enums),
         records(nested_records),
-        base_records(bases)
+        base_records(bases),
+        binary_serializer_function(new_binary_serializer_function)
     {}
 };
 
@@ -1184,10 +1197,10 @@ BEE_FORCE_INLINE Type get_type()
 
 BEE_CORE_API u32 get_type_hash(const StringView& type_name);
 
-// Thread-safe as long as nothing is calling `register_type`
+// Lock-free and safe to call from any thread, including while reflection modules are created or destroyed
 BEE_CORE_API Type get_type(const u32 hash);
 
-// Thread-safe as long as nothing is calling `register_type` or any of the reflection module create/destroy functions
+// Thread-safe as long as `module` isn't being destroyed
 BEE_CORE_API Type get_type(const ReflectionModule* module, const i32 index);
 
 template <typename ReflectedType, typename T>
@@ -1204,10 +1217,17 @@ BEE_CORE_API void unregister_type(const Type& type);
 
 using get_type_callback_t = Type(*)();
 
+/*
+ * Creating or destroying a module resolves all of its types and atomically publishes a new immutable type table for
+ * `get_type(hash)` - these are thread-safe but relatively expensive so should only happen when plugins are loaded
+ */
 BEE_CORE_API const ReflectionModule* create_reflection_module(const StringView& name, const i32 type_count, const u32* hashes, const get_type_callback_t* callbacks);
 BEE_CORE_API void destroy_reflection_module(const ReflectionModule* module);
 BEE_CORE_API const ReflectionModule* get_reflection_module(const StringView& name);
 
+// Number of replaced type tables that are waiting for in-flight `get_type(hash)` calls to finish before being freed
+BEE_CORE_API i32 get_retired_type_registry_count();
+
 BEE_CORE_API const Attribute* find_attribute(const Type& type, const char* attribute_name);
 
 BEE_CORE_API const Attribute* find_attribute(const Field& field, const char* attribute_name);
@@ -0,0 +1,73 @@
+/*
+ *  SIMD.hpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#pragma once
+
+#include "Bee/Core/Config.hpp"
+
+/*
+ * SSE2 is part of the x86-64 baseline so it can always be used directly. Anything newer (i.e. AVX2) has to be
+ * compiled into separate functions marked with `BEE_TARGET_AVX2` and only called after checking
+ * `cpu_supports_avx2()` at runtime
+ */
+#if defined(__x86_64__) || defined(_M_X64)
+    #define BEE_SIMD_X86 1
+
+    BEE_PUSH_WARNING
+        BEE_DISABLE_PADDING_WARNINGS
+        #include <immintrin.h>
+
+        #if defined(_MSC_VER)
+            #include <intrin.h>
+        #endif // defined(_MSC_VER)
+    BEE_POP_WARNING
+
+    #if BEE_COMPILER_MSVC == 1
+        // MSVC allows AVX2 intrinsics in any function without changing the target architecture
+        #define BEE_TARGET_AVX2
+    #else
+        #define BEE_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif // BEE_COMPILER_MSVC == 1
+#else
+    #define BEE_SIMD_X86 0
+#endif // x86-64
+
+
+namespace bee {
+
+
+#if BEE_SIMD_X86 == 1
+
+inline bool cpu_supports_avx2()
+{
+#if defined(_MSC_VER)
+    int info[4] { 0 };
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+
+    // AVX + OSXSAVE - then check that the OS actually saves the YMM registers on context switches
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 0x6) != 0x6)
+    {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif // defined(_MSC_VER)
+}
+
+#endif // BEE_SIMD_X86 == 1
+
+
+} // namespace bee
@@ -191,5 +191,18 @@ void BinarySerializer::serialize_fundamental(u128* data)
     serialize_buffer(this, data, sizeof(u128));
 }
 
+void BinarySerializer::serialize_fundamental_array(const FundamentalKind kind, u8* data, const i32 count)
+{
+    // Fundamentals are stored as raw bytes so the whole array can be copied at once
+    const auto size = get_bulk_serialized_size(kind) * count;
+
+    if (mode == SerializerMode::reading && BEE_FAIL_F(size <= array->size() - read_offset, "BinarySerializer: array is larger than the remaining data"))
+    {
+        return;
+    }
+
+    serialize_buffer(this, data, size);
+}
+
 
 } // namespace bee
\ No newline at end of file
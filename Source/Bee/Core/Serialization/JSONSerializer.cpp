@@ -9,6 +9,7 @@
 #include "Bee/Core/Math/Math.hpp"
 #include "Bee/Core/IO.hpp"
 #include "Bee/Core/Base64.hpp"
+#include "Bee/Core/Jobs/JobSystem.hpp"
 
 #define BEE_RAPIDJSON_ERROR_H
 #include "Bee/Core/Serialization/JSONSerializer.hpp"
@@ -585,4 +586,227 @@ void JSONSerializer::serialize_fundamental(u128* data)
 }
 
 
+/*
+ *****************************************
+ *
+ * Batched numeric arrays - these write and
+ * read exactly the same values as the
+ * equivalent `serialize_fundamental` call
+ * for each element
+ *
+ *****************************************
+ */
+template <typename WriterType> BEE_FORCE_INLINE void json_write_number(WriterType* writer, const bool value) { writer->Bool(value); }
+template <typename WriterType> BEE_FORCE_INLINE void json_write_number(WriterType* writer, const i8 value) { writer->Int(value); }
+template <typename WriterType> BEE_FORCE_INLINE void json_write_number(WriterType* writer, const i16 value) { writer->Int(value); }
+template <typename WriterType> BEE_FORCE_INLINE void json_write_number(WriterType* writer, const i32 value) { writer->Int(value); }
+template <typename WriterType> BEE_FORCE_INLINE void json_write_number(WriterType* writer, const i64 value) { writer->Int64(value); }
+template <typename WriterType> BEE_FORCE_INLINE void json_write_number(WriterType* writer, const u8 value) { writer->Uint(value); }
+template <typename WriterType> BEE_FORCE_INLINE void json_write_number(WriterType* writer, const u16 value) { writer->Uint(value); }
+template <typename WriterType> BEE_FORCE_INLINE void json_write_number(WriterType* writer, const u32 value) { writer->Uint(value); }
+template <typename WriterType> BEE_FORCE_INLINE void json_write_number(WriterType* writer, const u64 value) { writer->Uint64(value); }
+template <typename WriterType> BEE_FORCE_INLINE void json_write_number(WriterType* writer, const float value) { writer->Double(value); }
+template <typename WriterType> BEE_FORCE_INLINE void json_write_number(WriterType* writer, const double value) { writer->Double(value); }
+
+BEE_FORCE_INLINE bool json_read_number(const rapidjson::Value& value, bool* data)
+{
+    if (!json_validate_type<bool>(&value))
+    {
+        return false;
+    }
+    *data = value.GetBool();
+    return true;
+}
+
+#define BEE_JSON_READ_NUMBER(type, validated_type, getter)                  \
+    BEE_FORCE_INLINE bool json_read_number(const rapidjson::Value& value, type* data)  \
+    {                                                                       \
+        if (!json_validate_type<validated_type>(&value))                    \
+        {                                                                   \
+            return false;                                                   \
+        }                                                                   \
+        *data = static_cast<type>(value.getter());                          \
+        return true;                                                        \
+    }
+
+BEE_JSON_READ_NUMBER(i8, int, GetInt)
+BEE_JSON_READ_NUMBER(i16, int, GetInt)
+BEE_JSON_READ_NUMBER(i32, int, GetInt)
+BEE_JSON_READ_NUMBER(i64, int64_t, GetInt64)
+BEE_JSON_READ_NUMBER(u8, unsigned, GetUint)
+BEE_JSON_READ_NUMBER(u16, unsigned, GetUint)
+BEE_JSON_READ_NUMBER(u32, uint32_t, GetUint)
+BEE_JSON_READ_NUMBER(u64, uint64_t, GetUint64)
+BEE_JSON_READ_NUMBER(float, float, GetDouble)
+BEE_JSON_READ_NUMBER(double, double, GetDouble)
+
+#undef BEE_JSON_READ_NUMBER
+
+template <typename T>
+static void json_write_numbers(JSONPrettyWriter* writer, const T* data, const i32 count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        json_write_number(writer, data[i]);
+    }
+}
+
+// Minimal RapidJSON output stream that appends to a `String` so that each job can format its own chunk
+struct JSONStringOutputStream
+{
+    using Ch = char;
+
+    String* dst { nullptr };
+
+    inline void Put(const char c)
+    {
+        dst->append(c);
+    }
+
+    inline void Flush() {}
+};
+
+// Arrays with fewer elements than this aren't worth the overhead of scheduling jobs
+static constexpr i32 json_parallel_write_min_count = 4096;
+
+/*
+ * Formats elements [1, count) in parallel chunks and splices them into the writers buffer in order. Each element is
+ * written with the same separator, newline and indent the pretty writer would have written before it, and the numbers
+ * themselves are formatted by a plain `rapidjson::Writer` which shares the same number formatting
+ */
+template <typename T>
+static void json_write_numbers_parallel(JSONPrettyWriter* writer, rapidjson::StringBuffer* dst, JobGroup* group, const T* data, const i32 count)
+{
+    // The first element goes through the pretty writer so it writes the arrays prefix and knows the array isn't empty
+    json_write_number(writer, data[0]);
+
+    if (!writer->is_in_nonempty_array() || writer->is_single_line_array())
+    {
+        json_write_numbers(writer, data + 1, count - 1);
+        return;
+    }
+
+    const auto indent_char = writer->indent_char();
+    const auto indent_count = writer->indent_count();
+    const i32 remaining = count - 1;
+    const i32 chunk_count = math::max(1, math::min(remaining / (json_parallel_write_min_count / 4), job_system_worker_count() * 4));
+
+    DynamicArray<String> chunks;
+    chunks.resize(chunk_count);
+
+    parallel_for(group, chunk_count, 1, [&](const i32 chunk_index)
+    {
+        const i32 begin = 1 + static_cast<i32>((static_cast<i64>(remaining) * chunk_index) / chunk_count);
+        const i32 end = 1 + static_cast<i32>((static_cast<i64>(remaining) * (chunk_index + 1)) / chunk_count);
+
+        JSONStringOutputStream stream { &chunks[chunk_index] };
+        rapidjson::Writer<JSONStringOutputStream> element_writer;
+
+        for (int i = begin; i < end; ++i)
+        {
+            stream.Put(',');
+            stream.Put('\n');
+            for (size_t c = 0; c < indent_count; ++c)
+            {
+                stream.Put(indent_char);
+            }
+
+            element_writer.Reset(stream);
+            json_write_number(&element_writer, data[i]);
+        }
+    });
+
+    job_wait(group);
+
+    for (const auto& chunk : chunks)
+    {
+        memcpy(dst->Push(static_cast<size_t>(chunk.size())), chunk.data(), chunk.size());
+    }
+}
+
+template <typename T>
+static void json_read_numbers(const rapidjson::Value& array, const i32 first, T* data, const i32 count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (!json_read_number(array[static_cast<rapidjson::SizeType>(first + i)], data + i))
+        {
+            return;
+        }
+    }
+}
+
+void JSONSerializer::serialize_fundamental_array(const FundamentalKind kind, u8* data, const i32 count)
+{
+    const rapidjson::Value* array = nullptr;
+    i32 first = 0;
+
+    const bool use_parallel_write = parallel_write_group_ != nullptr
+        && count >= json_parallel_write_min_count
+        && is_job_system_running();
+
+    if (mode == SerializerMode::reading)
+    {
+        array = stack_.back();
+        first = current_element();
+
+        if (!json_validate_type(rapidjson::kArrayType, array))
+        {
+            return;
+        }
+
+        if (BEE_FAIL_F(first + count <= static_cast<i32>(array->Size()), "JSONSerializer: expected %d array elements but got %u", first + count, array->Size()))
+        {
+            return;
+        }
+    }
+
+#define BEE_JSON_NUMBER_ARRAY(kind_name, serialized_type)                                               \
+    case FundamentalKind::kind_name:                                                                    \
+    {                                                                                                   \
+        if (mode == SerializerMode::writing && use_parallel_write)                                      \
+        {                                                                                               \
+            json_write_numbers_parallel(&writer_, &string_buffer_, parallel_write_group_, reinterpret_cast<const serialized_type*>(data), count); \
+        }                                                                                               \
+        else if (mode == SerializerMode::writing)                                                       \
+        {                                                                                               \
+            json_write_numbers(&writer_, reinterpret_cast<const serialized_type*>(data), count);        \
+        }                                                                                               \
+        else                                                                                            \
+        {                                                                                               \
+            json_read_numbers(*array, first, reinterpret_cast<serialized_type*>(data), count);          \
+        }                                                                                               \
+        break;                                                                                          \
+    }
+
+    switch (kind)
+    {
+        BEE_JSON_NUMBER_ARRAY(bool_kind, bool)
+        BEE_JSON_NUMBER_ARRAY(signed_char_kind, i8)
+        BEE_JSON_NUMBER_ARRAY(unsigned_char_kind, u8)
+        BEE_JSON_NUMBER_ARRAY(short_kind, i16)
+        BEE_JSON_NUMBER_ARRAY(unsigned_short_kind, u16)
+        BEE_JSON_NUMBER_ARRAY(int_kind, i32)
+        BEE_JSON_NUMBER_ARRAY(unsigned_int_kind, u32)
+        BEE_JSON_NUMBER_ARRAY(long_long_kind, i64)
+        BEE_JSON_NUMBER_ARRAY(unsigned_long_long_kind, u64)
+        BEE_JSON_NUMBER_ARRAY(float_kind, float)
+        BEE_JSON_NUMBER_ARRAY(double_kind, double)
+        default:
+        {
+            // chars and u128 are serialized as strings
+            Serializer::serialize_fundamental_array(kind, data, count);
+            return;
+        }
+    }
+
+#undef BEE_JSON_NUMBER_ARRAY
+
+    if (mode == SerializerMode::reading)
+    {
+        element_iter_stack_.back() += count;
+    }
+}
+
+
 } // namespace bee
\ No newline at end of file
@@ -19,6 +19,9 @@
 namespace bee {
 
 
+class JobGroup;
+
+
 BEE_FLAGS(JSONSerializeFlags, u32)
 {
     none                = 0u,
@@ -26,6 +29,45 @@ BEE_FLAGS(JSONSerializeFlags, u32)
 };
 
 
+/*
+ * Exposes the pretty writers current indentation and scope so that values formatted separately (i.e. on another
+ * thread) can be spliced into its output exactly as it would have written them
+ */
+class JSONPrettyWriter final : public rapidjson::PrettyWriter<rapidjson::StringBuffer>
+{
+public:
+    using rapidjson::PrettyWriter<rapidjson::StringBuffer>::PrettyWriter;
+
+    // Returns true if the innermost scope is an array that already has at least one element
+    inline bool is_in_nonempty_array() const
+    {
+        if (level_stack_.Empty())
+        {
+            return false;
+        }
+
+        const auto* level = level_stack_.template Top<Level>();
+        return level->inArray && level->valueCount > 0;
+    }
+
+    inline bool is_single_line_array() const
+    {
+        return (formatOptions_ & rapidjson::kFormatSingleLineArray) != 0;
+    }
+
+    inline char indent_char() const
+    {
+        return indentChar_;
+    }
+
+    // Number of indent chars written before each value in the current scope
+    inline size_t indent_count() const
+    {
+        return (level_stack_.GetSize() / sizeof(Level)) * indentCharCount_;
+    }
+};
+
+
 class BEE_CORE_API JSONSerializer final : public Serializer
 {
 public:
@@ -55,6 +97,15 @@ public:
         return reader_doc_;
     }
 
+    /*
+     * If `group` is not null and the job system is running, large fundamental arrays are formatted in parallel chunks
+     * when writing and spliced into the output in order - the output is identical to writing serially
+     */
+    inline void set_parallel_write_group(JobGroup* group)
+    {
+        parallel_write_group_ = group;
+    }
+
     size_t offset() override;
     size_t capacity() override;
 
@@ -86,15 +137,17 @@ public:
     void serialize_fundamental(i32* data) override;
     void serialize_fundamental(i64* data) override;
     void serialize_fundamental(u128* data) override;
+    void serialize_fundamental_array(const FundamentalKind kind, u8* data, const i32 count) override;
 
 private:
     rapidjson::StringBuffer                             string_buffer_;
-    rapidjson::PrettyWriter<rapidjson::StringBuffer>    writer_;
+    JSONPrettyWriter                                    writer_;
     rapidjson::Document                                 reader_doc_;
     DynamicArray<rapidjson::Value*>                     stack_;
     DynamicArray<rapidjson::Value::MemberIterator>      member_iter_stack_;
     DynamicArray<i32>                                   element_iter_stack_;
     String                                              base64_encode_buffer_;
+    JobGroup*                                           parallel_write_group_ { nullptr };
     const char*                                         src_ { nullptr };
     JSONSerializeFlags                                  parse_flags_;
     BEE_PAD(4);
@@ -0,0 +1,420 @@
+/*
+ *  PackedArchive.cpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#include "Bee/Core/Serialization/PackedArchive.hpp"
+#include "Bee/Core/Logger.hpp"
+
+
+namespace bee {
+
+
+static_assert(sizeof(void*) == sizeof(u64), "Packed archives store raw pointers as 64 bit payload offsets");
+
+
+/*
+ ****************************************
+ *
+ * PackedArchiveWriter - implementation
+ *
+ ****************************************
+ */
+PackedArchiveWriter::PackedArchiveWriter(Allocator* allocator)
+    : payload_(allocator),
+      fixups_(allocator)
+{
+    reset();
+}
+
+void PackedArchiveWriter::reset()
+{
+    payload_.clear();
+    fixups_.clear();
+
+    // Reserve the start of the payload so that no allocation has an offset of zero - this lets zero mean null for
+    // raw pointers before they're fixed up, the same as it does for relative pointers
+    allocate_bytes(packed_archive_max_alignment, packed_archive_max_alignment);
+}
+
+u64 PackedArchiveWriter::allocate_bytes(const size_t size, const size_t alignment)
+{
+    const auto offset = round_up(sign_cast<size_t>(payload_.size()), alignment);
+    const auto new_size = offset + size;
+
+    BEE_ASSERT_F(new_size <= static_cast<size_t>(limits::max<i32>()), "PackedArchiveWriter: payload is too large");
+
+    const auto old_size = payload_.size();
+    payload_.resize_no_raii(sign_cast<i32>(new_size));
+    memset(payload_.data() + old_size, 0, new_size - old_size);
+    return offset;
+}
+
+u64 PackedArchiveWriter::get_payload_offset(const void* ptr) const
+{
+    const auto* bytes = static_cast<const u8*>(ptr);
+    BEE_ASSERT_F(
+        bytes >= payload_.data() && bytes < payload_.data() + payload_.size(),
+        "PackedArchiveWriter: pointer is not inside the archive payload - use `get()` to get a pointer to an allocation"
+    );
+    return static_cast<u64>(bytes - payload_.data());
+}
+
+void PackedArchiveWriter::link_absolute(u64* ptr, const u64 target)
+{
+    const auto ptr_offset = get_payload_offset(ptr);
+    BEE_ASSERT_F(ptr_offset % alignof(u64) == 0, "PackedArchiveWriter: pointers must be naturally aligned");
+    BEE_ASSERT_F(*ptr == 0, "PackedArchiveWriter: raw pointers can only be linked once");
+
+    // null pointers are left as zero and don't need a fixup
+    if (target != 0)
+    {
+        *ptr = target;
+        fixups_.push_back(ptr_offset);
+    }
+}
+
+/*
+ * Checks that a type can be moved to another address with a memcpy and still be valid, i.e. it only contains
+ * fundamentals, enums, fixed arrays, raw pointers (which are fixed up on load) and other `packed_format` records.
+ * Records that aren't packed (String, DynamicArray etc.) may own memory outside of the archive so are rejected.
+ * Field types that aren't reflected (RelativePtr, RelativeArray) can't be checked here and are trusted - the
+ * templated `finish` static_asserts that the root type is trivially copyable which covers them
+ */
+static bool is_trivially_relocatable(const Type& type)
+{
+    if (type->is(TypeKind::fundamental) || type->is(TypeKind::enum_decl))
+    {
+        return true;
+    }
+
+    if (type->is(TypeKind::array))
+    {
+        return is_trivially_relocatable(type->as<ArrayTypeInfo>()->element_type);
+    }
+
+    if (!type->is(TypeKind::record) || (type->serialization_flags & SerializationFlags::packed_format) == SerializationFlags::none)
+    {
+        return false;
+    }
+
+    const auto record = type->as<RecordTypeInfo>();
+
+    for (const Type& base : record->base_records)
+    {
+        if (!is_trivially_relocatable(base))
+        {
+            return false;
+        }
+    }
+
+    for (const Field& field : record->fields)
+    {
+        if ((field.qualifier & (Qualifier::lvalue_ref | Qualifier::rvalue_ref)) != Qualifier::none)
+        {
+            return false;
+        }
+
+        if ((field.qualifier & Qualifier::pointer) != Qualifier::none || field.type->is(TypeKind::unknown))
+        {
+            continue;
+        }
+
+        if (!is_trivially_relocatable(field.type))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool PackedArchiveWriter::finish(const Type& root_type, const u64 root_offset, DynamicArray<u8>* dst)
+{
+    if (BEE_FAIL_F(root_type->is(TypeKind::record), "PackedArchiveWriter: the root type must be a reflected record"))
+    {
+        return false;
+    }
+
+    if (BEE_FAIL_F((root_type->serialization_flags & SerializationFlags::packed_format) != SerializationFlags::none, "PackedArchiveWriter: the root type `%s` must be marked `format = packed`", root_type->name))
+    {
+        return false;
+    }
+
+    if (BEE_FAIL_F(is_trivially_relocatable(root_type), "PackedArchiveWriter: the root type `%s` contains fields that can't be relocated with a memcpy", root_type->name))
+    {
+        return false;
+    }
+
+    if (BEE_FAIL_F(root_offset + root_type->size <= static_cast<u64>(payload_.size()), "PackedArchiveWriter: invalid root offset"))
+    {
+        return false;
+    }
+
+    PackedArchiveHeader header{};
+    header.type_hash = root_type->hash;
+    header.type_version = root_type->serialized_version;
+    header.fixup_count = fixups_.size();
+    header.fixup_offset = sizeof(PackedArchiveHeader);
+    header.payload_offset = round_up(header.fixup_offset + fixups_.size() * sizeof(u64), packed_archive_payload_alignment);
+    header.payload_size = static_cast<u64>(payload_.size());
+    header.root_offset = root_offset;
+
+    const auto archive_size = header.payload_offset + header.payload_size;
+    dst->resize_no_raii(sign_cast<i32>(archive_size));
+    memset(dst->data(), 0, archive_size);
+
+    memcpy(dst->data(), &header, sizeof(PackedArchiveHeader));
+    if (!fixups_.empty())
+    {
+        memcpy(dst->data() + header.fixup_offset, fixups_.data(), fixups_.size() * sizeof(u64));
+    }
+    memcpy(dst->data() + header.payload_offset, payload_.data(), payload_.size());
+    return true;
+}
+
+
+/*
+ ****************************************
+ *
+ * Loading archives - implementation
+ *
+ ****************************************
+ */
+const PackedArchiveHeader* validate_packed_archive(const void* data, const size_t size, const Type& root_type)
+{
+    if (size < sizeof(PackedArchiveHeader))
+    {
+        log_error("Invalid packed archive: archive is smaller than the header");
+        return nullptr;
+    }
+
+    if (!is_aligned(data, packed_archive_max_alignment))
+    {
+        log_error("Invalid packed archive: archive data must be aligned to %zu bytes", packed_archive_max_alignment);
+        return nullptr;
+    }
+
+    const auto* header = static_cast<const PackedArchiveHeader*>(data);
+
+    if (header->magic != packed_archive_magic || header->version != packed_archive_version)
+    {
+        log_error("Invalid packed archive: unrecognized header or version (%u)", header->version);
+        return nullptr;
+    }
+
+    if (header->type_hash != root_type->hash || header->type_version != root_type->serialized_version)
+    {
+        log_error(
+            "Invalid packed archive: expected root type %s (version %d) but the archive was written for type hash 0x%08x (version %d)",
+            root_type->name, root_type->serialized_version, header->type_hash, header->type_version
+        );
+        return nullptr;
+    }
+
+    const auto fixups_size = static_cast<u64>(header->fixup_count) * sizeof(u64);
+    const auto is_valid_layout = header->fixup_count >= 0
+        && header->fixup_offset >= sizeof(PackedArchiveHeader)
+        && header->fixup_offset % alignof(u64) == 0
+        && header->fixup_offset + fixups_size <= header->payload_offset
+        && header->payload_offset % packed_archive_payload_alignment == 0
+        && header->payload_offset <= size
+        && header->payload_size <= size - header->payload_offset
+        && header->root_offset <= header->payload_size
+        && root_type->size <= header->payload_size - header->root_offset;
+
+    if (!is_valid_layout)
+    {
+        log_error("Invalid packed archive: archive is truncated or has an invalid layout");
+        return nullptr;
+    }
+
+    return header;
+}
+
+void* load_packed_archive_in_place(void* data, const size_t size, const Type& root_type)
+{
+    const auto* header = validate_packed_archive(data, size, root_type);
+    if (header == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto* archive = static_cast<u8*>(data);
+    auto* payload = archive + header->payload_offset;
+
+    if ((header->flags & PackedArchiveFlags::fixups_applied) == PackedArchiveFlags::none)
+    {
+        const auto* fixups = reinterpret_cast<const u64*>(archive + header->fixup_offset);
+
+        // Validate everything before patching anything so a corrupt archive isn't left half fixed-up
+        for (int i = 0; i < header->fixup_count; ++i)
+        {
+            const auto ptr_offset = fixups[i];
+            const auto is_valid_fixup = ptr_offset % alignof(u64) == 0
+                && header->payload_size >= sizeof(u64)
+                && ptr_offset <= header->payload_size - sizeof(u64)
+                && *reinterpret_cast<const u64*>(payload + ptr_offset) > 0
+                && *reinterpret_cast<const u64*>(payload + ptr_offset) < header->payload_size;
+
+            if (!is_valid_fixup)
+            {
+                log_error("Invalid packed archive: fixup %d is out of range", i);
+                return nullptr;
+            }
+        }
+
+        for (int i = 0; i < header->fixup_count; ++i)
+        {
+            auto* ptr = reinterpret_cast<u64*>(payload + fixups[i]);
+            *ptr = reinterpret_cast<u64>(payload + *ptr);
+        }
+
+        const_cast<PackedArchiveHeader*>(header)->flags |= PackedArchiveFlags::fixups_applied;
+    }
+
+    return payload + header->root_offset;
+}
+
+const void* get_packed_archive_root(const void* data, const size_t size, const Type& root_type)
+{
+    const auto* header = validate_packed_archive(data, size, root_type);
+    if (header == nullptr)
+    {
+        return nullptr;
+    }
+
+    const auto is_fixed_up = (header->flags & PackedArchiveFlags::fixups_applied) != PackedArchiveFlags::none;
+    if (header->fixup_count > 0 && !is_fixed_up)
+    {
+        log_error("Packed archive has %d pointers that need fixing up - it must be loaded into writable memory", header->fixup_count);
+        return nullptr;
+    }
+
+    return static_cast<const u8*>(data) + header->payload_offset + header->root_offset;
+}
+
+
+/*
+ ****************************************
+ *
+ * PackedArchiveFile - implementation
+ *
+ ****************************************
+ */
+PackedArchiveFile::PackedArchiveFile(PackedArchiveFile&& other) noexcept
+{
+    move_construct(other);
+}
+
+PackedArchiveFile::~PackedArchiveFile()
+{
+    close();
+}
+
+PackedArchiveFile& PackedArchiveFile::operator=(PackedArchiveFile&& other) noexcept
+{
+    close();
+    move_construct(other);
+    return *this;
+}
+
+void PackedArchiveFile::move_construct(PackedArchiveFile& other) noexcept
+{
+    mapped_ = other.mapped_;
+    allocator_ = other.allocator_;
+    copy_ = other.copy_;
+    root_ = other.root_;
+    size_ = other.size_;
+
+    new (&other) PackedArchiveFile{};
+}
+
+bool PackedArchiveFile::open(const PathView& path, const Type& root_type, Allocator* allocator)
+{
+    close();
+
+    i64 file_size = 0;
+    {
+        auto file = fs::open_file(path, fs::OpenMode::read);
+        if (!file.is_valid())
+        {
+            return false;
+        }
+        file_size = fs::get_size(file);
+    }
+
+    // Empty files can't be mapped on all platforms and aren't valid archives anyway
+    if (file_size < static_cast<i64>(sizeof(PackedArchiveHeader)))
+    {
+        log_error("Invalid packed archive %" BEE_PRIsv ": file is too small", BEE_FMT_SV(path));
+        return false;
+    }
+
+    if (!fs::mmap_file_map(&mapped_, path, fs::OpenMode::read))
+    {
+        return false;
+    }
+
+    size_ = static_cast<size_t>(file_size);
+
+    const auto* header = validate_packed_archive(mapped_.data, size_, root_type);
+    if (header == nullptr)
+    {
+        close();
+        return false;
+    }
+
+    // Archives are only ever fixed up in memory - if this flag is set on disk the pointers are stale addresses
+    if ((header->flags & PackedArchiveFlags::fixups_applied) != PackedArchiveFlags::none)
+    {
+        log_error("Invalid packed archive %" BEE_PRIsv ": archive was saved after being fixed up", BEE_FMT_SV(path));
+        close();
+        return false;
+    }
+
+    if (header->fixup_count == 0)
+    {
+        // Zero-copy - the payload is used directly from the read-only mapping
+        root_ = get_packed_archive_root(mapped_.data, size_, root_type);
+        return root_ != nullptr;
+    }
+
+    // Raw pointers need patching so the archive has to be copied into writable memory
+    allocator_ = allocator;
+    copy_ = BEE_MALLOC_ALIGNED(allocator_, size_, packed_archive_payload_alignment);
+    memcpy(copy_, mapped_.data, size_);
+    fs::mmap_file_unmap(&mapped_);
+
+    root_ = load_packed_archive_in_place(copy_, size_, root_type);
+    if (root_ == nullptr)
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void PackedArchiveFile::close()
+{
+    if (mapped_.data != nullptr)
+    {
+        fs::mmap_file_unmap(&mapped_);
+    }
+
+    if (copy_ != nullptr)
+    {
+        BEE_FREE(allocator_, copy_);
+    }
+
+    allocator_ = nullptr;
+    copy_ = nullptr;
+    root_ = nullptr;
+    size_ = 0;
+}
+
+
+} // namespace bee
@@ -0,0 +1,395 @@
+/*
+ *  PackedArchive.hpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#pragma once
+
+#include "Bee/Core/Reflection.hpp"
+#include "Bee/Core/Filesystem.hpp"
+#include "Bee/Core/Memory/Memory.hpp"
+
+BEE_PUSH_WARNING
+    BEE_DISABLE_PADDING_WARNINGS
+    #include <type_traits>
+BEE_POP_WARNING
+
+
+namespace bee {
+
+
+/*
+ ********************************************************************************************************************
+ *
+ * # Packed archives
+ *
+ * A zero-copy binary format for large cooked data (shaders, meshes etc.) stored as trivially copyable reflected
+ * types, i.e. ones marked `format = packed` that are only ever used as the in-memory representation of an artifact.
+ * Unlike `BinarySerializer` nothing is deserialized field by field - the file is laid out exactly as the data is in
+ * memory and can be mapped and used in place:
+ *
+ * | header | fixup table | padding | payload (root object, arrays etc. each aligned to their type) |
+ *
+ * Pointers inside the payload can be stored two ways:
+ *  - `RelativePtr<T>`/`RelativeArray<T>` store an offset from themselves to the data they point at and are resolved
+ *    on every access. Archives that only use relative pointers need no fixups so can be used directly from a
+ *    read-only memory mapped file
+ *  - raw `T*` pointers are stored as a payload offset with an entry in the fixup table. These are patched into real
+ *    pointers when the archive is loaded so the archive needs to be in writable memory
+ *
+ * The header stores the root types hash and serialized version so that stale or mismatched archives are rejected
+ * rather than reinterpreted. Like `packed_format`, archives are not version tolerant in any way - the data layout must
+ * match the types current memory layout exactly.
+ *
+ ********************************************************************************************************************
+ */
+static constexpr u32    packed_archive_magic = 0x4B504542; // 'BEPK'
+static constexpr u32    packed_archive_version = 1;
+static constexpr size_t packed_archive_max_alignment = 16;
+static constexpr size_t packed_archive_payload_alignment = 64;
+
+BEE_FLAGS(PackedArchiveFlags, u32)
+{
+    none            = 0u,
+    fixups_applied  = 1u << 0u
+};
+
+struct PackedArchiveHeader
+{
+    u32                 magic { packed_archive_magic };
+    u32                 version { packed_archive_version };
+    u32                 type_hash { 0 };
+    i32                 type_version { 0 };
+    PackedArchiveFlags  flags { PackedArchiveFlags::none };
+    i32                 fixup_count { 0 };
+    u64                 fixup_offset { 0 };     // byte offset from the start of the archive to the fixup table
+    u64                 payload_offset { 0 };   // byte offset from the start of the archive to the payload
+    u64                 payload_size { 0 };
+    u64                 root_offset { 0 };      // byte offset of the root object within the payload
+};
+
+
+/*
+ * Pointer stored as a signed byte offset from the address of the `RelativePtr` itself so that it stays valid
+ * wherever the archive is loaded or mapped. An offset of zero is a null pointer
+ */
+template <typename T>
+struct RelativePtr
+{
+    i64 offset { 0 };
+
+    inline T* get()
+    {
+        return offset == 0 ? nullptr : reinterpret_cast<T*>(reinterpret_cast<u8*>(this) + offset);
+    }
+
+    inline const T* get() const
+    {
+        return offset == 0 ? nullptr : reinterpret_cast<const T*>(reinterpret_cast<const u8*>(this) + offset);
+    }
+
+    inline T* operator->()
+    {
+        return get();
+    }
+
+    inline const T* operator->() const
+    {
+        return get();
+    }
+
+    inline T& operator*()
+    {
+        return *get();
+    }
+
+    inline const T& operator*() const
+    {
+        return *get();
+    }
+
+    inline bool is_valid() const
+    {
+        return offset != 0;
+    }
+};
+
+template <typename T>
+struct RelativeArray
+{
+    RelativePtr<T>  ptr;
+    i32             count { 0 };
+    BEE_PAD(4);
+
+    inline i32 size() const
+    {
+        return count;
+    }
+
+    inline bool empty() const
+    {
+        return count <= 0;
+    }
+
+    inline T* data()
+    {
+        return ptr.get();
+    }
+
+    inline const T* data() const
+    {
+        return ptr.get();
+    }
+
+    inline T* begin()
+    {
+        return data();
+    }
+
+    inline T* end()
+    {
+        return data() + count;
+    }
+
+    inline const T* begin() const
+    {
+        return data();
+    }
+
+    inline const T* end() const
+    {
+        return data() + count;
+    }
+
+    inline T& operator[](const i32 index)
+    {
+        BEE_ASSERT(index < count);
+        return data()[index];
+    }
+
+    inline const T& operator[](const i32 index) const
+    {
+        BEE_ASSERT(index < count);
+        return data()[index];
+    }
+
+    inline Span<T> span()
+    {
+        return Span<T>(data(), count);
+    }
+
+    inline Span<const T> const_span() const
+    {
+        return Span<const T>(data(), count);
+    }
+};
+
+
+/*
+ * Typed byte offset into a `PackedArchiveWriter`s payload. Pointers into the writers buffer are invalidated whenever
+ * it grows so these are used to refer to allocations until the archive is finished
+ */
+template <typename T>
+struct PackedArchiveOffset
+{
+    u64 value { limits::max<u64>() };
+    i32 count { 0 };
+    BEE_PAD(4);
+
+    inline bool is_valid() const
+    {
+        return value != limits::max<u64>();
+    }
+};
+
+
+class BEE_CORE_API PackedArchiveWriter final : public Noncopyable
+{
+public:
+    explicit PackedArchiveWriter(Allocator* allocator = system_allocator());
+
+    // Allocates `count` zeroed instances of `T` in the payload
+    template <typename T>
+    PackedArchiveOffset<T> allocate(const i32 count = 1)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "PackedArchiveWriter: T must be trivially copyable");
+        static_assert(alignof(T) <= packed_archive_max_alignment, "PackedArchiveWriter: T is over-aligned");
+
+        PackedArchiveOffset<T> result{};
+        result.value = allocate_bytes(sizeof(T) * count, alignof(T));
+        result.count = count;
+        return result;
+    }
+
+    // Copies `count` instances of `T` into the payload
+    template <typename T>
+    PackedArchiveOffset<T> write(const T* data, const i32 count = 1)
+    {
+        auto result = allocate<T>(count);
+        memcpy(payload_.data() + result.value, data, sizeof(T) * count);
+        return result;
+    }
+
+    // Gets a pointer to a previous allocation - this is invalidated by the next call to `allocate` or `write`
+    template <typename T>
+    T* get(const PackedArchiveOffset<T>& offset)
+    {
+        BEE_ASSERT(offset.is_valid() && offset.value < static_cast<u64>(payload_.size()));
+        return reinterpret_cast<T*>(payload_.data() + offset.value);
+    }
+
+    // Links a relative pointer located inside the payload to a previous allocation
+    template <typename T>
+    void link(RelativePtr<T>* ptr, const PackedArchiveOffset<T>& target)
+    {
+        const auto ptr_offset = get_payload_offset(ptr);
+        ptr->offset = target.is_valid() ? static_cast<i64>(target.value) - static_cast<i64>(ptr_offset) : 0;
+    }
+
+    template <typename T>
+    void link(RelativeArray<T>* array, const PackedArchiveOffset<T>& target)
+    {
+        link(&array->ptr, target);
+        array->count = target.count;
+    }
+
+    // Links a raw pointer located inside the payload to a previous allocation and adds a fixup for it. Each raw
+    // pointer can only be linked once
+    template <typename T, typename TargetType>
+    void link(T** ptr, const PackedArchiveOffset<TargetType>& target)
+    {
+        static_assert(std::is_convertible<TargetType*, T*>::value, "PackedArchiveWriter: invalid pointer target type");
+        link_absolute(reinterpret_cast<u64*>(ptr), target.is_valid() ? target.value : 0);
+    }
+
+    template <typename T>
+    bool finish(const PackedArchiveOffset<T>& root, DynamicArray<u8>* dst)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "PackedArchiveWriter: T must be trivially copyable");
+        return finish(get_type<T>(), root.value, dst);
+    }
+
+    bool finish(const Type& root_type, u64 root_offset, DynamicArray<u8>* dst);
+
+    void reset();
+
+    inline i32 size() const
+    {
+        return payload_.size();
+    }
+
+    inline i32 fixup_count() const
+    {
+        return fixups_.size();
+    }
+
+private:
+    DynamicArray<u8>    payload_;
+    DynamicArray<u64>   fixups_;
+
+    u64 allocate_bytes(size_t size, size_t alignment);
+
+    u64 get_payload_offset(const void* ptr) const;
+
+    void link_absolute(u64* ptr, u64 target);
+};
+
+
+/*
+ * Validates the archive header for the given root type and returns it, logging an error and returning nullptr if
+ * the archive is corrupt, truncated or was written for a different type or version
+ */
+BEE_CORE_API const PackedArchiveHeader* validate_packed_archive(const void* data, size_t size, const Type& root_type);
+
+/*
+ * Applies all pointer fixups in place and returns the root object. Loading an already fixed-up archive is a no-op so
+ * this can be called multiple times on the same buffer. `data` must be aligned to `packed_archive_max_alignment`
+ */
+BEE_CORE_API void* load_packed_archive_in_place(void* data, size_t size, const Type& root_type);
+
+/*
+ * Returns the root object of an archive in read-only memory - fails if the archive has pointers that need fixing up
+ */
+BEE_CORE_API const void* get_packed_archive_root(const void* data, size_t size, const Type& root_type);
+
+template <typename T>
+inline T* load_packed_archive_in_place(void* data, const size_t size)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable to be loaded in place");
+    return static_cast<T*>(load_packed_archive_in_place(data, size, get_type<T>()));
+}
+
+template <typename T>
+inline const T* get_packed_archive_root(const void* data, const size_t size)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable to be loaded in place");
+    return static_cast<const T*>(get_packed_archive_root(data, size, get_type<T>()));
+}
+
+
+/*
+ * Opens an archive from disk. Archives without fixups are memory mapped read-only and used in place - archives with
+ * fixups are copied into an aligned buffer from `allocator` and fixed up
+ */
+class BEE_CORE_API PackedArchiveFile final : public Noncopyable
+{
+public:
+    PackedArchiveFile() = default;
+
+    PackedArchiveFile(PackedArchiveFile&& other) noexcept;
+
+    ~PackedArchiveFile();
+
+    PackedArchiveFile& operator=(PackedArchiveFile&& other) noexcept;
+
+    bool open(const PathView& path, const Type& root_type, Allocator* allocator = system_allocator());
+
+    template <typename T>
+    inline const T* open(const PathView& path, Allocator* allocator = system_allocator())
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable to be loaded in place");
+        return open(path, get_type<T>(), allocator) ? static_cast<const T*>(root_) : nullptr;
+    }
+
+    void close();
+
+    inline bool is_open() const
+    {
+        return root_ != nullptr;
+    }
+
+    inline bool is_mapped() const
+    {
+        return mapped_.data != nullptr;
+    }
+
+    inline const void* root() const
+    {
+        return root_;
+    }
+
+    template <typename T>
+    inline const T* root() const
+    {
+        return static_cast<const T*>(root_);
+    }
+
+    inline size_t size() const
+    {
+        return size_;
+    }
+
+private:
+    fs::MemoryMappedFile    mapped_;
+    Allocator*              allocator_ { nullptr };
+    void*                   copy_ { nullptr };
+    const void*             root_ { nullptr };
+    size_t                  size_ { 0 };
+
+    void move_construct(PackedArchiveFile& other) noexcept;
+};
+
+
+} // namespace bee
@@ -21,6 +21,42 @@ Serializer::Serializer(const bee::SerializerFormat serialized_format)
     : format(serialized_format)
 {}
 
+void Serializer::serialize_fundamental_array(const FundamentalKind kind, u8* data, const i32 count)
+{
+#define BEE_SERIALIZE_FUNDAMENTALS(kind_name, serialized_type)                  \
+    case FundamentalKind::kind_name:                                            \
+    {                                                                           \
+        auto* elements = reinterpret_cast<serialized_type*>(data);              \
+        for (int i = 0; i < count; ++i)                                         \
+        {                                                                       \
+            serialize_fundamental(elements + i);                                \
+        }                                                                       \
+        break;                                                                  \
+    }
+
+    switch (kind)
+    {
+        BEE_SERIALIZE_FUNDAMENTALS(bool_kind, bool)
+        BEE_SERIALIZE_FUNDAMENTALS(char_kind, char)
+        BEE_SERIALIZE_FUNDAMENTALS(signed_char_kind, i8)
+        BEE_SERIALIZE_FUNDAMENTALS(unsigned_char_kind, u8)
+        BEE_SERIALIZE_FUNDAMENTALS(short_kind, i16)
+        BEE_SERIALIZE_FUNDAMENTALS(unsigned_short_kind, u16)
+        BEE_SERIALIZE_FUNDAMENTALS(int_kind, i32)
+        BEE_SERIALIZE_FUNDAMENTALS(unsigned_int_kind, u32)
+        BEE_SERIALIZE_FUNDAMENTALS(long_long_kind, i64)
+        BEE_SERIALIZE_FUNDAMENTALS(unsigned_long_long_kind, u64)
+        BEE_SERIALIZE_FUNDAMENTALS(float_kind, float)
+        BEE_SERIALIZE_FUNDAMENTALS(double_kind, double)
+        BEE_SERIALIZE_FUNDAMENTALS(u128_kind, u128)
+        default:
+        {
+            BEE_UNREACHABLE("Fundamental kind %d can't be serialized as an array", static_cast<i32>(kind));
+        }
+    }
+#undef BEE_SERIALIZE_FUNDAMENTALS
+}
+
 
 SerializationBuilder::SerializationBuilder(Serializer* new_serializer, const SerializeTypeParams* params)
     : serializer_(new_serializer),
@@ -213,12 +249,81 @@ static void serialize_packed_record(const i32 version, Serializer* serializer, c
     }
 }
 
-static void serialize_field_header(FieldHeader* dst, Serializer* serializer)
+// Headers are always the same size so they're written as their two hashes rather than a size-prefixed blob of bytes
+static void serialize_field_header(FieldHeader* header, Serializer* serializer)
+{
+    serializer->serialize_fundamental(&header->type_hash);
+    serializer->serialize_fundamental(&header->field_hash);
+}
+
+static bool is_serialized_field(const Field& field, const i32 version)
+{
+    return field.version_added > 0 && field.version_added <= version && version < field.version_removed;
+}
+
+/*
+ * Table records written by a given version of a type always list their fields in the same order so the field index
+ * each header maps to is cached per (type, version) the first time it's read rather than searching the records fields
+ * for every field of every object. Cached indices are always checked against the header before they're used so a
+ * stale plan (i.e. after a hot reload) just falls back to searching and updates itself. Plans are cached per-thread so
+ * reading doesn't need to take any locks
+ */
+struct FieldRemapPlan
+{
+    DynamicArray<i32> field_indices;
+};
+
+struct FieldRemapCache
+{
+    DynamicHashMap<u64, FieldRemapPlan*> plans;
+
+    ~FieldRemapCache()
+    {
+        for (auto& plan : plans)
+        {
+            BEE_DELETE(system_allocator(), plan.value);
+        }
+    }
+
+    // Plans are heap-allocated so they stay valid while nested records add new plans to the cache
+    FieldRemapPlan* get(const u32 type_hash, const i32 version)
+    {
+        const auto key = (static_cast<u64>(type_hash) << 32u) | static_cast<u32>(version);
+        auto* plan = plans.find(key);
+        if (plan != nullptr)
+        {
+            return plan->value;
+        }
+        return plans.insert(key, BEE_NEW(system_allocator(), FieldRemapPlan))->value;
+    }
+};
+
+static thread_local FieldRemapCache g_field_remap_cache;
+
+static i32 remap_field(FieldRemapPlan* plan, const i32 serialized_index, const RecordTypeInfo& record_type, const FieldHeader& header)
 {
-    int size = sizeof(FieldHeader);
-    FieldHeader header{};
-    serializer->begin_bytes(&size);
-    serializer->end_bytes(reinterpret_cast<u8*>(&header), size);
+    if (serialized_index < plan->field_indices.size())
+    {
+        const auto cached_index = plan->field_indices[serialized_index];
+        if (cached_index >= 0 && FieldHeader(record_type.fields[cached_index]) == header)
+        {
+            return cached_index;
+        }
+    }
+
+    // Lookup the field using the header hashes and remember it for the next record of the same version
+    const auto field_index = find_index_if(record_type.fields, [&](const Field& f)
+    {
+        return f.type->hash == header.type_hash && f.hash == header.field_hash;
+    });
+
+    while (plan->field_indices.size() <= serialized_index)
+    {
+        plan->field_indices.push_back(-1);
+    }
+
+    plan->field_indices[serialized_index] = field_index;
+    return field_index;
 }
 
 void serialize_table_record(const i32 version, Serializer* serializer, const SerializeTypeParams& params)
@@ -231,7 +336,7 @@ void serialize_table_record(const i32 version, Serializer* serializer, const Ser
     {
         for (const Field& field : record_type->fields)
         {
-            if (field.version_added <= 0 || field.version_removed <= version)
+            if (!is_serialized_field(field, version))
             {
                 --field_count;
             }
@@ -242,16 +347,14 @@ void serialize_table_record(const i32 version, Serializer* serializer, const Ser
 
     if (serializer->mode == SerializerMode::reading)
     {
+        auto* plan = g_field_remap_cache.get(record_type->hash, version);
+
         for (int f = 0; f < field_count; ++f)
         {
             FieldHeader header{};
             serialize_field_header(&header, serializer);
 
-            // Lookup the type using the header hashes
-            const auto field_index = find_index_if(record_type->fields, [&](const Field& f)
-            {
-                return f.type->hash == header.type_hash && f.hash == header.field_hash;
-            });
+            const auto field_index = remap_field(plan, f, *record_type, header);
 
             if (BEE_FAIL_F(field_index >= 0, "serialization of record type `%s` failed: detected missing field. The fields may have been renamed or it's type changed", record_type->name))
             {
@@ -267,7 +370,12 @@ void serialize_table_record(const i32 version, Serializer* serializer, const Ser
         // We have to iterate all the fields to skip the ones we don't want to write
         for (const Field& field : record_type->fields)
         {
-            FieldHeader header{};
+            if (!is_serialized_field(field, version))
+            {
+                continue;
+            }
+
+            FieldHeader header(field);
             serialize_field_header(&header, serializer);
             serialize_field(version, serializer, field, params);
         }
@@ -357,10 +465,20 @@ void serialize_type(const SerializeTypeMode serialize_type_mode, Serializer* ser
         if (serializer->format == SerializerFormat::text || (serialization_flags & SerializationFlags::packed_format) == SerializationFlags::packed_format)
         {
             BEE_ASSERT_F(version <= params.type->serialized_version, "serialization error for type `%s`: structures serialized using `packed_format` are not forward-compatible with versions from the future", params.type->name);
-            serialize_packed_record(version, serializer, params);
+
+            // Use the generated serializer if there is one - older versions still need the reflected fields to skip
+            // any that have since been added or removed
+            if (serializer->format == SerializerFormat::binary && version == params.type->serialized_version && record_type->binary_serializer_function != nullptr)
+            {
+                record_type->binary_serializer_function(serializer, params);
+            }
+            else
+            {
+                serialize_packed_record(version, serializer, params);
+            }
         }
 
-        if ((serialization_flags & SerializationFlags::table_format) == SerializationFlags::table_format)
+        else if ((serialization_flags & SerializationFlags::table_format) == SerializationFlags::table_format)
         {
             serialize_table_record(version, serializer, params);
         }
@@ -384,7 +502,7 @@ void serialize_type(const SerializeTypeMode serialize_type_mode, Serializer* ser
             serializer->begin_bytes(&bytes_size);
             serializer->end_bytes(params.data, bytes_size);
         }
-        else
+        else if (array_type->serializer_function != nullptr || !serialize_array_bulk(serializer, element_type, params.data, element_count))
         {
             SerializeTypeParams element_params(
                 element_type,
@@ -395,7 +513,7 @@ void serialize_type(const SerializeTypeMode serialize_type_mode, Serializer* ser
             );
             for (int element = 0; element < element_count; ++element)
             {
-                element_params.data += element_type->size * element;
+                element_params.data = params.data + element_type->size * element;
                 serialize_type(serializer, element_params);
             }
         }
@@ -503,9 +621,9 @@ void serialize_type(const SerializeTypeMode serialize_type_mode, Serializer* ser
                         }
                     }
 
-                    int size = stream.size();
+                    int size = sign_cast<i32>(stream.size());
                     serializer->begin_text(&size);
-                    serializer->end_text(enum_constant_buffer, size, stream.capacity());
+                    serializer->end_text(enum_constant_buffer, size, sign_cast<i32>(stream.capacity()));
                 }
                 else
                 {
@@ -605,5 +723,153 @@ void serialize_type_append(Serializer* serializer, const SerializeTypeParams& pa
     serialize_type(SerializeTypeMode::append_scope, serializer, params);
 }
 
+void serialize_record_field(Serializer* serializer, const Field& field, const SerializeTypeParams& params)
+{
+    serialize_field(params.type->serialized_version, serializer, field, params);
+}
+
+
+/*
+ **********************************
+ *
+ * Bulk array serialization
+ *
+ **********************************
+ */
+i32 get_bulk_serialized_size(const FundamentalKind kind)
+{
+    switch (kind)
+    {
+        case FundamentalKind::bool_kind: return sizeof(bool);
+        case FundamentalKind::char_kind: return sizeof(char);
+        case FundamentalKind::signed_char_kind: return sizeof(i8);
+        case FundamentalKind::unsigned_char_kind: return sizeof(u8);
+        case FundamentalKind::short_kind: return sizeof(i16);
+        case FundamentalKind::unsigned_short_kind: return sizeof(u16);
+        case FundamentalKind::int_kind: return sizeof(i32);
+        case FundamentalKind::unsigned_int_kind: return sizeof(u32);
+        case FundamentalKind::long_long_kind: return sizeof(i64);
+        case FundamentalKind::unsigned_long_long_kind: return sizeof(u64);
+        case FundamentalKind::float_kind: return sizeof(float);
+        case FundamentalKind::double_kind: return sizeof(double);
+        case FundamentalKind::u128_kind: return sizeof(u128);
+        default: break;
+    }
+
+    return 0;
+}
+
+static FundamentalKind get_bulk_fundamental_kind(const Type& type)
+{
+    if (!type->is(TypeKind::fundamental))
+    {
+        return FundamentalKind::count;
+    }
+
+    const auto kind = type->as<FundamentalTypeInfo>()->fundamental_kind;
+    return get_bulk_serialized_size(kind) == static_cast<i32>(type->size) ? kind : FundamentalKind::count;
+}
+
+/*
+ * Checks if serializing a type with a binary serializer produces exactly the same bytes as the type has in memory,
+ * i.e. a fundamental, an enum, or a record made only of those types with no padding, base types or custom serializers
+ */
+static bool is_serialized_as_memory_layout(const Serializer* serializer, const Type& type)
+{
+    if (type->serialized_version <= 0 || (type->serialization_flags & (SerializationFlags::bytes | SerializationFlags::uses_builder)) != SerializationFlags::none)
+    {
+        return false;
+    }
+
+    if (type->is(TypeKind::enum_decl))
+    {
+        return get_bulk_fundamental_kind(type->as<EnumTypeInfo>()->underlying_type) != FundamentalKind::count;
+    }
+
+    if (!type->is(TypeKind::record))
+    {
+        return get_bulk_fundamental_kind(type) != FundamentalKind::count;
+    }
+
+    // Records are prefixed with their version and flags unless the source is unversioned
+    if ((serializer->source_flags & SerializerSourceFlags::all) != SerializerSourceFlags::all)
+    {
+        return false;
+    }
+
+    const auto record = type->as<RecordTypeInfo>();
+    if ((record->serialization_flags & SerializationFlags::packed_format) == SerializationFlags::none || !record->base_records.empty())
+    {
+        return false;
+    }
+
+    size_t serialized_size = 0;
+
+    for (const Field& field : record->fields)
+    {
+        const auto is_serialized = field.version_added > 0
+            && record->serialized_version >= field.version_added
+            && record->serialized_version < field.version_removed
+            && (field.qualifier & (Qualifier::lvalue_ref | Qualifier::rvalue_ref | Qualifier::pointer)) == Qualifier::none;
+
+        // Fields that aren't serialized leave a gap in the layout which is caught by the offset check
+        if (!is_serialized)
+        {
+            continue;
+        }
+
+        if (field.serializer_function != nullptr || field.template_argument_in_parent >= 0 || (field.serialization_flags & SerializationFlags::bytes) != SerializationFlags::none)
+        {
+            return false;
+        }
+
+        if (field.offset != serialized_size || !is_serialized_as_memory_layout(serializer, field.type))
+        {
+            return false;
+        }
+
+        serialized_size += field.type->size;
+    }
+
+    return serialized_size == record->size;
+}
+
+bool serialize_array_bulk(Serializer* serializer, const Type& element_type, u8* data, const i32 count)
+{
+    if (count <= 0)
+    {
+        return count == 0;
+    }
+
+    // Fundamentals are handled by the serializer so text formats can still batch their output
+    const auto fundamental_kind = get_bulk_fundamental_kind(element_type);
+    const auto is_binary_layout = fundamental_kind == FundamentalKind::count
+        && serializer->format == SerializerFormat::binary
+        && is_serialized_as_memory_layout(serializer, element_type);
+
+    if (fundamental_kind == FundamentalKind::count && !is_binary_layout)
+    {
+        return false;
+    }
+
+    // Fall back to serializing each element if the array is too large to be sized with an i32
+    const auto size = static_cast<size_t>(element_type->size) * count;
+    if (size > static_cast<size_t>(limits::max<i32>()))
+    {
+        return false;
+    }
+
+    if (is_binary_layout)
+    {
+        serialize_binary_run(serializer, data, static_cast<i32>(size));
+    }
+    else
+    {
+        serializer->serialize_fundamental_array(fundamental_kind, data, count);
+    }
+
+    return true;
+}
+
 
 } // namespace bee
\ No newline at end of file
@@ -91,6 +91,13 @@ struct BEE_CORE_API Serializer
     virtual void serialize_fundamental(i32* data) = 0;
     virtual void serialize_fundamental(i64* data) = 0;
     virtual void serialize_fundamental(u128* data) = 0;
+
+    /*
+     * Serializes `count` contiguous fundamentals of the same kind between `begin_array` and `end_array`. The default
+     * implementation serializes each element individually - serializers should override this to handle the whole
+     * array in one call. Only called with kinds that have a non-zero `get_bulk_serialized_size`
+     */
+    virtual void serialize_fundamental_array(const FundamentalKind kind, u8* data, const i32 count);
 };
 
 struct SerializeTypeParams final : public Noncopyable
@@ -141,6 +148,36 @@ BEE_CORE_API void serialize_type(Serializer* serializer, const SerializeTypePara
 
 BEE_CORE_API void serialize_type_append(Serializer* serializer, const SerializeTypeParams& params);
 
+/*
+ * Serializes a single field of the record in `params` at the records current version - used by the binary serializer
+ * functions generated by bee-reflect for any fields that can't be copied as part of a contiguous run
+ */
+BEE_CORE_API void serialize_record_field(Serializer* serializer, const Field& field, const SerializeTypeParams& params);
+
+/*
+ * Gets the size of a fundamental kind when serialized as part of an array, or zero if it can't be serialized in bulk,
+ * i.e. long types which are always serialized as 32 bit values regardless of their size on the target platform
+ */
+BEE_CORE_API i32 get_bulk_serialized_size(const FundamentalKind kind);
+
+/*
+ * Serializes `count` contiguous elements between `begin_array` and `end_array` in a single call if possible. This
+ * covers fundamentals for all serializers plus enums and trivially copyable `packed_format` records for binary
+ * serializers when their serialized layout is identical to their layout in memory. Returns false without
+ * serializing anything if the elements need to be serialized individually
+ */
+BEE_CORE_API bool serialize_array_bulk(Serializer* serializer, const Type& element_type, u8* data, const i32 count);
+
+/*
+ * Reads or writes `size` bytes exactly as they're laid out in memory with no size prefix. Binary serializers store
+ * fundamentals as raw bytes so this is equivalent to serializing each fundamental in the run individually
+ */
+inline void serialize_binary_run(Serializer* serializer, u8* data, const i32 size)
+{
+    BEE_ASSERT(serializer->format == SerializerFormat::binary);
+    serializer->end_bytes(data, size);
+}
+
 
 template <typename T>
 void custom_serialize_type(bee::SerializationBuilder* builder, T* data) {}
@@ -266,6 +303,23 @@ public:
 
     SerializationBuilder& key(String* data);
 
+    // Serializes a contiguous array of elements - in bulk if the element type allows it, otherwise one at a time
+    template <typename T>
+    inline SerializationBuilder& elements(T* data, const i32 count)
+    {
+        BEE_ASSERT_F(container_kind_ == SerializedContainerKind::sequential, "serialization builder is not configured to build a sequential container");
+
+        if (!std::is_trivially_copyable<T>::value || !serialize_array_bulk(serializer_, get_type<T>(), reinterpret_cast<u8*>(data), count))
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                element(data + i);
+            }
+        }
+
+        return *this;
+    }
+
     template <typename T>
     inline SerializationBuilder& element(T* data)
     {
@@ -485,10 +539,7 @@ BEE_SERIALIZE_TYPE(SerializationBuilder* builder, Array<T, Mode>* array)
     }
     else
     {
-        for (auto& element : *array)
-        {
-            builder->element(&element);
-        }
+        builder->elements(array->data(), array->size());
     }
 }
 
@@ -28,7 +28,7 @@ size_t StreamSerializer::offset()
 
 size_t StreamSerializer::capacity()
 {
-    return stream->capacity();
+    return sign_cast<size_t>(stream->capacity());
 }
 
 void StreamSerializer::begin_object(i32* member_count)
@@ -130,5 +130,20 @@ IMPLEMENT_BUILTIN(i32)
 IMPLEMENT_BUILTIN(i64)
 IMPLEMENT_BUILTIN(u128)
 
+void StreamSerializer::serialize_fundamental_array(const FundamentalKind kind, u8* data, const i32 count)
+{
+    // Fundamentals are stored as raw bytes so the whole array can be read/written at once
+    const auto size = get_bulk_serialized_size(kind) * count;
+
+    if (mode == SerializerMode::reading)
+    {
+        stream->read(data, size);
+    }
+    else
+    {
+        stream->write(data, size);
+    }
+}
+
 
 } // namespace bee
\ No newline at end of file
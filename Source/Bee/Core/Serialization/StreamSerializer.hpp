@@ -53,6 +53,7 @@ struct BEE_CORE_API StreamSerializer final : public Serializer
     void serialize_fundamental(i32* data) override;
     void serialize_fundamental(i64* data) override;
     void serialize_fundamental(u128* data) override;
+    void serialize_fundamental_array(const FundamentalKind kind, u8* data, const i32 count) override;
 };
 
 
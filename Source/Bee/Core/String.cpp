@@ -10,6 +10,8 @@
 #include "Bee/Core/Math/Math.hpp"
 #include "Bee/Core/Containers/HashMap.hpp"
 #include "Bee/Core/Concurrency.hpp"
+#include "Bee/Core/Bit.hpp"
+#include "Bee/Core/SIMD.hpp"
 
 BEE_PUSH_WARNING
     BEE_DISABLE_PADDING_WARNINGS
@@ -32,19 +34,27 @@ namespace bee {
 /*
  * `String` implementation
  */
+#if !defined(BEE_LITTLE_ENDIAN)
+    #error String's small buffer tag must overlap the most significant byte of HeapData::capacity
+#endif // !defined(BEE_LITTLE_ENDIAN)
+
+static_assert(sizeof(String) == sizeof(Allocator*) + String::small_buffer_capacity, "String must not grow past a pointer, allocator, size and capacity");
 
 String::String(Allocator* allocator) noexcept
     : allocator_(allocator)
-{}
+{
+    reset_small_buffer();
+}
 
 String::String(const i32 count, const char fill_char, Allocator* allocator)
     : allocator_(allocator)
 {
+    reset_small_buffer();
     grow(count);
 
-    for (int char_idx = 0; char_idx < size_; ++char_idx)
+    if (count > 0)
     {
-        data_[char_idx] = fill_char;
+        memset(data(), fill_char, count);
     }
 }
 
@@ -55,11 +65,12 @@ String::String(const char* c_str, Allocator* allocator)
 String::String(const StringView& string_view, Allocator* allocator)
     : allocator_(allocator)
 {
+    reset_small_buffer();
     grow(string_view.size());
 
-    if (size_ > 0)
+    if (string_view.size() > 0)
     {
-        memcpy(data_, string_view.c_str(), string_view.size());
+        memcpy(data(), string_view.c_str(), string_view.size());
     }
 }
 
@@ -109,7 +120,7 @@ void String::copy_construct(const String& other)
         return;
     }
 
-    c_string_construct(other.data_, other.size_, other.allocator_);
+    c_string_construct(other.data(), other.size(), other.allocator_);
 }
 
 void String::move_construct(String& other)
@@ -121,14 +132,12 @@ void String::move_construct(String& other)
 
     destroy();
 
+    // Both representations live in the same storage so copying it moves either the inline chars or the heap pointer
     allocator_ = other.allocator_;
-    size_ = other.size_;
-    capacity_ = other.capacity_;
-    data_ = other.data_;
+    memcpy(small_buffer_, other.small_buffer_, small_buffer_capacity);
 
     other.allocator_ = nullptr;
-    other.size_ = 0;
-    other.capacity_ = 0;
+    other.reset_small_buffer();
 }
 
 void String::c_string_construct(const char* c_string, const i32 string_length, Allocator* allocator)
@@ -139,26 +148,41 @@ void String::c_string_construct(const char* c_string, const i32 string_length, A
     if (string_length > 0)
     {
         grow(string_length);
-        memcpy(data_, c_string, string_length);
-    }
-    else
-    {
-        data_ = const_cast<char*>(&empty_string_);
+        memcpy(data(), c_string, string_length);
     }
 }
 
 void String::destroy()
 {
-    // capacity_ will be < small_data_size if no allocations from the allocator have occurred
-    if (size_ >= 0 && allocator_ != nullptr && data_ != nullptr && data_ != &empty_string_)
+    // The string is still small if no allocations from the allocator have occurred
+    if (!is_small() && allocator_ != nullptr && heap_.data != nullptr)
     {
-        BEE_FREE(allocator_, data_);
+        BEE_FREE(allocator_, heap_.data);
     }
 
     allocator_ = nullptr;
-    size_ = 0;
-    capacity_ = 0;
-    data_ = const_cast<char*>(&empty_string_);
+    reset_small_buffer();
+}
+
+void String::reset_small_buffer()
+{
+    memset(small_buffer_, 0, small_buffer_capacity);
+    small_buffer_[small_tag_index] = static_cast<char>(small_tag_index);
+}
+
+void String::set_size(const i32 new_size)
+{
+    if (is_small())
+    {
+        // the tag is the remaining capacity so it's also the null-terminator once the small buffer is full
+        small_buffer_[small_tag_index] = static_cast<char>(small_tag_index - new_size);
+        small_buffer_[new_size] = '\0';
+    }
+    else
+    {
+        heap_.size = new_size;
+        heap_.data[new_size] = '\0';
+    }
 }
 
 void String::grow(const i32 new_size)
@@ -170,50 +194,62 @@ void String::grow(const i32 new_size)
         return;
     }
 
-    if (new_size > capacity_ - 1)
-    {
-        const auto new_capacity = math::max(capacity_ * growth_factor_, new_size + 1);
+    const auto old_size = size();
+    const auto old_capacity = capacity();
 
+    if (new_size > old_capacity - 1)
+    {
         char* new_data = nullptr;
+        i32 new_capacity = 0;
 
-        if (data_ == nullptr || data_ == &empty_string_)
+        if (is_small())
         {
+            /*
+             * Moving out of the small buffer - strings that were empty get an exact-fit allocation as they're most
+             * likely being constructed from another string
+             */
+            new_capacity = old_size > 0 ? math::max(old_capacity * growth_factor_, new_size + 1) : new_size + 1;
             new_data = static_cast<char*>(BEE_MALLOC_ALIGNED(allocator_, sign_cast<size_t>(new_capacity), sizeof(void*)));
+
+            if (new_data != nullptr)
+            {
+                memcpy(new_data, small_buffer_, old_size);
+            }
         }
         else
         {
-            new_data = static_cast<char*>(BEE_REALLOC(allocator_, data_, sign_cast<size_t>(capacity_), sign_cast<size_t>(new_capacity), sizeof(void*)));
+            new_capacity = math::max(old_capacity * growth_factor_, new_size + 1);
+            new_data = static_cast<char*>(BEE_REALLOC(allocator_, heap_.data, sign_cast<size_t>(old_capacity), sign_cast<size_t>(new_capacity), sizeof(void*)));
         }
 
-
         if (BEE_FAIL_F(new_data != nullptr, "Failed to reallocate string data"))
         {
             return;
         }
 
-        data_ = new_data;
-        capacity_ = new_capacity;
+        // overwrites the small buffer tag so the string is now on the heap
+        heap_.data = new_data;
+        heap_.capacity = sign_cast<u32>(new_capacity) | heap_capacity_flag;
     }
 
-    BEE_ASSERT(new_size <= capacity_);
+    BEE_ASSERT(new_size < capacity());
 
-    size_ = new_size;
-    data_[new_size] = '\0';
+    set_size(new_size);
 }
 
 String& String::append(char character)
 {
-    const auto old_size = size_;
-    grow(size_ + 1);
-    data_[old_size] = character;
+    const auto old_size = size();
+    grow(old_size + 1);
+    data()[old_size] = character;
     return *this;
 }
 
 String& String::append(const StringView& string_view)
 {
-    const auto old_size = size_;
-    grow(size_ + string_view.size());
-    memcpy(data_ + old_size, string_view.c_str(), string_view.size());
+    const auto old_size = size();
+    grow(old_size + string_view.size());
+    memcpy(data() + old_size, string_view.c_str(), string_view.size());
     return *this;
 }
 
@@ -251,25 +287,22 @@ String& String::assign(const StringView& string_view)
 String& String::insert(const i32 index, const i32 count, const char character)
 {
     BEE_ASSERT_F(index >= 0, "String::insert: `index` must be >= 0");
-    BEE_ASSERT_F(index <= size_, "String::insert: `index` must be <= size()");
+    BEE_ASSERT_F(index <= size(), "String::insert: `index` must be <= size()");
 
     if (count <= 0)
     {
         return *this;
     }
 
-    const auto old_size = size_;
+    const auto old_size = size();
     const auto new_size = math::max(old_size + count, index + count);
     grow(new_size);
 
-    BEE_ASSERT(index + count <= size_);
+    BEE_ASSERT(index + count <= size());
 
-    memmove(data_ + index + count, data_ + index, old_size - index);
+    memmove(data() + index + count, data() + index, old_size - index);
 
-    for (int char_idx = 0; char_idx < count; ++char_idx)
-    {
-        data_[index + char_idx] = character;
-    }
+    memset(data() + index, character, count);
 
     return *this;
 }
@@ -293,14 +326,14 @@ String& String::insert(i32 index, const StringView& str)
         return *this;
     }
 
-    const auto old_size = size_;
+    const auto old_size = size();
     const auto new_size = math::max(old_size + str.size(), index + str.size());
     grow(new_size);
 
-    BEE_ASSERT(index + str.size() <= size_);
+    BEE_ASSERT(index + str.size() <= size());
 
-    memmove(data_ + index + str.size(), data_ + index, old_size - index);
-    memcpy(data_ + index, str.c_str(), str.size());
+    memmove(data() + index + str.size(), data() + index, old_size - index);
+    memcpy(data() + index, str.c_str(), str.size());
     return *this;
 }
 
@@ -313,18 +346,18 @@ String& String::remove(const i32 index, const i32 count)
         return *this;
     }
 
-    BEE_ASSERT(index + count <= size_);
+    const auto old_size = size();
+    BEE_ASSERT(index + count <= old_size);
 
-    memmove(data_ + index, data_ + index + count, size_ - (index + count));
-    size_ -= count;
-    data_[size_] = '\0';
+    memmove(data() + index, data() + index + count, old_size - (index + count));
+    set_size(old_size - count);
 
     return *this;
 }
 
 String& String::remove(const i32 index)
 {
-    return remove(index, size_ - index);
+    return remove(index, size() - index);
 }
 
 void String::resize(const i32 size)
@@ -332,30 +365,31 @@ void String::resize(const i32 size)
     resize(size, '\0');
 }
 
-void String::resize(const i32 size, const char c)
+void String::resize(const i32 new_size, const char c)
 {
-    if (size == size_)
+    const auto old_size = size();
+
+    if (new_size == old_size)
     {
         return;
     }
 
-    if (size > size_)
+    if (new_size > old_size)
     {
-        const auto old_size = size_;
-        grow(size);
-        memset(data_ + old_size, c, size - old_size);
+        grow(new_size);
+        memset(data() + old_size, c, new_size - old_size);
     }
     else
     {
-        size_ = size;
-        data_[size] = '\0';
+        set_size(new_size);
     }
 }
 
 void String::clear()
 {
-    memset(data_, 0, sizeof(char) * capacity_);
-    size_ = 0;
+    // leave the small buffer tag alone - set_size writes it
+    memset(data(), 0, sizeof(char) * (capacity() - 1));
+    set_size(0);
 }
 
 
@@ -422,30 +456,491 @@ i32 system_snprintf(char* buffer, size_t buffer_size, const char* format, va_lis
 #endif // BEE_MSVC_REQUIRE_REPLACEMENT_SNPRINTF
 
 /*
- * `compare` implementation
+ **************************************************************
+ *
+ * SIMD string kernels.
+ *
+ * SSE2 is part of the x86-64 baseline so the SSE2 kernels are always available on x64. The AVX2 kernels are selected
+ * at runtime the first time a string function is called, if both the CPU and the OS support them. Other
+ * architectures use the scalar kernels.
+ *
+ **************************************************************
  */
-i32 compare_n(const char* lhs, const i32 lhs_compare_count, const char* rhs, const i32 rhs_compare_count)
+using find_char_kernel_t = i32(*)(const char* src, const i32 size, const char character);
+using find_substring_kernel_t = i32(*)(const char* src, const i32 size, const char* substring, const i32 substring_size);
+using mismatch_kernel_t = i32(*)(const char* lhs, const char* rhs, const i32 size);
+
+struct StringKernels
 {
-    if (lhs_compare_count == 0 || rhs_compare_count == 0)
+    find_char_kernel_t          first_index_of_char { nullptr };
+    find_char_kernel_t          last_index_of_char { nullptr };
+    find_substring_kernel_t     first_index_of_substring { nullptr };
+    find_substring_kernel_t     last_index_of_substring { nullptr };
+    mismatch_kernel_t           mismatch { nullptr };
+};
+
+/*
+ * Scalar kernels - used on non-x86 architectures and for the tail of the vectorized kernels
+ */
+static i32 first_index_of_char_scalar(const char* src, const i32 size, const char character)
+{
+    for (int index = 0; index < size; ++index)
     {
-        return lhs_compare_count - rhs_compare_count;
+        if (src[index] == character)
+        {
+            return index;
+        }
     }
 
-    int char_idx = 0;
-    for (; char_idx < rhs_compare_count; ++char_idx)
+    return -1;
+}
+
+static i32 last_index_of_char_scalar(const char* src, const i32 size, const char character)
+{
+    for (int index = size - 1; index >= 0; --index)
     {
-        if (char_idx > lhs_compare_count || char_idx > rhs_compare_count)
+        if (src[index] == character)
         {
-            break;
+            return index;
         }
+    }
+
+    return -1;
+}
 
-        if (lhs[char_idx] != rhs[char_idx] || lhs[char_idx] == '\0' || rhs[char_idx] == '\0')
+static i32 first_index_of_substring_scalar(const char* src, const i32 size, const char* substring, const i32 substring_size)
+{
+    for (int index = 0; index + substring_size <= size; ++index)
+    {
+        if (src[index] == substring[0] && memcmp(src + index, substring, substring_size) == 0)
+        {
+            return index;
+        }
+    }
+
+    return -1;
+}
+
+static i32 last_index_of_substring_scalar(const char* src, const i32 size, const char* substring, const i32 substring_size)
+{
+    for (int index = size - substring_size; index >= 0; --index)
+    {
+        if (src[index] == substring[0] && memcmp(src + index, substring, substring_size) == 0)
+        {
+            return index;
+        }
+    }
+
+    return -1;
+}
+
+// Returns the index of the first character that differs between `lhs` and `rhs` or is a null-terminator in `lhs`
+static i32 mismatch_scalar(const char* lhs, const char* rhs, const i32 size)
+{
+    int index = 0;
+    for (; index < size; ++index)
+    {
+        if (lhs[index] != rhs[index] || lhs[index] == '\0')
         {
             break;
         }
     }
+    return index;
+}
+
+#if BEE_SIMD_X86 == 1
+
+/*
+ * `mismatch` is the only kernel that can read past the end of one of its inputs - `compare_n` may be given a count
+ * larger than a null-terminated `rhs`. Reading past the terminator is harmless as long as the load doesn't cross into
+ * a page that may not be mapped so blocks that straddle a page boundary are compared with the scalar kernel. The
+ * over-read is still outside the allocation as far as ASan is concerned so ASan builds use `mismatch_scalar` instead
+ * (see `select_string_kernels`)
+ */
+static constexpr uintptr_t string_kernel_page_size = 4096;
+
+BEE_FORCE_INLINE bool load_crosses_page(const char* ptr, const uintptr_t load_size)
+{
+    return (reinterpret_cast<uintptr_t>(ptr) & (string_kernel_page_size - 1)) > string_kernel_page_size - load_size;
+}
+
+// Index of the highest set bit in a non-zero mask
+BEE_FORCE_INLINE i32 highest_set_bit(const u32 mask)
+{
+    return 31 - static_cast<i32>(count_leading_zeroes(mask));
+}
+
+/*
+ * SSE2 kernels
+ */
+static i32 first_index_of_char_sse2(const char* src, const i32 size, const char character)
+{
+    const __m128i needle = _mm_set1_epi8(character);
+
+    int index = 0;
+    for (; index + 16 <= size; index += 16)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + index));
+        const auto mask = static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+
+        if (mask != 0)
+        {
+            return index + static_cast<i32>(count_trailing_zeroes(mask));
+        }
+    }
+
+    const auto tail = first_index_of_char_scalar(src + index, size - index, character);
+    return tail >= 0 ? index + tail : -1;
+}
 
-    if (char_idx == math::min(lhs_compare_count, rhs_compare_count))
+static i32 last_index_of_char_sse2(const char* src, const i32 size, const char character)
+{
+    const __m128i needle = _mm_set1_epi8(character);
+
+    int end = size;
+    for (; end >= 16; end -= 16)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + end - 16));
+        const auto mask = static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+
+        if (mask != 0)
+        {
+            return end - 16 + highest_set_bit(mask);
+        }
+    }
+
+    return last_index_of_char_scalar(src, end, character);
+}
+
+/*
+ * Substring search uses the first and last characters of the substring as a filter: for each candidate position the
+ * block starting at that position is compared against the first char and the block `substring_size - 1` chars
+ * later is compared against the last char. Only the candidates where both match are verified with a memcmp.
+ * see: http://0x80.pl/articles/simd-strfind.html
+ */
+static i32 first_index_of_substring_sse2(const char* src, const i32 size, const char* substring, const i32 substring_size)
+{
+    const __m128i first = _mm_set1_epi8(substring[0]);
+    const __m128i last = _mm_set1_epi8(substring[substring_size - 1]);
+    const auto last_offset = substring_size - 1;
+    const auto candidate_count = size - last_offset;
+
+    int index = 0;
+    for (; index + 16 <= candidate_count; index += 16)
+    {
+        const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + index));
+        const __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + index + last_offset));
+        auto mask = static_cast<u32>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last))
+        ));
+
+        while (mask != 0)
+        {
+            const auto candidate = index + static_cast<i32>(count_trailing_zeroes(mask));
+            if (memcmp(src + candidate + 1, substring + 1, substring_size - 2) == 0)
+            {
+                return candidate;
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    const auto tail = first_index_of_substring_scalar(src + index, size - index, substring, substring_size);
+    return tail >= 0 ? index + tail : -1;
+}
+
+static i32 last_index_of_substring_sse2(const char* src, const i32 size, const char* substring, const i32 substring_size)
+{
+    const __m128i first = _mm_set1_epi8(substring[0]);
+    const __m128i last = _mm_set1_epi8(substring[substring_size - 1]);
+    const auto last_offset = substring_size - 1;
+
+    int candidate_end = size - last_offset;
+    for (; candidate_end >= 16; candidate_end -= 16)
+    {
+        const auto index = candidate_end - 16;
+        const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + index));
+        const __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + index + last_offset));
+        auto mask = static_cast<u32>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last))
+        ));
+
+        while (mask != 0)
+        {
+            const auto bit = highest_set_bit(mask);
+            if (memcmp(src + index + bit + 1, substring + 1, substring_size - 2) == 0)
+            {
+                return index + bit;
+            }
+            mask &= ~(1u << static_cast<u32>(bit));
+        }
+    }
+
+    return last_index_of_substring_scalar(src, candidate_end + last_offset, substring, substring_size);
+}
+
+static i32 mismatch_sse2(const char* lhs, const char* rhs, const i32 size)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    int index = 0;
+    for (; index + 16 <= size; index += 16)
+    {
+        if (load_crosses_page(lhs + index, 16) || load_crosses_page(rhs + index, 16))
+        {
+            const auto block_index = mismatch_scalar(lhs + index, rhs + index, 16);
+            if (block_index < 16)
+            {
+                return index + block_index;
+            }
+            continue;
+        }
+
+        const __m128i lhs_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + index));
+        const __m128i rhs_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + index));
+        const auto equal = static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(lhs_block, rhs_block)));
+        const auto terminators = static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(lhs_block, zero)));
+        const auto stop = (~equal | terminators) & 0xFFFFu;
+
+        if (stop != 0)
+        {
+            return index + static_cast<i32>(count_trailing_zeroes(stop));
+        }
+    }
+
+    return index + mismatch_scalar(lhs + index, rhs + index, size - index);
+}
+
+/*
+ * AVX2 kernels - identical to the SSE2 kernels but processing 32 chars at a time. The tails are handed off to the
+ * SSE2 kernels
+ */
+BEE_TARGET_AVX2 static i32 first_index_of_char_avx2(const char* src, const i32 size, const char character)
+{
+    const __m256i needle = _mm256_set1_epi8(character);
+
+    int index = 0;
+    for (; index + 32 <= size; index += 32)
+    {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + index));
+        const auto mask = static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+
+        if (mask != 0)
+        {
+            return index + static_cast<i32>(count_trailing_zeroes(mask));
+        }
+    }
+
+    const auto tail = first_index_of_char_sse2(src + index, size - index, character);
+    return tail >= 0 ? index + tail : -1;
+}
+
+BEE_TARGET_AVX2 static i32 last_index_of_char_avx2(const char* src, const i32 size, const char character)
+{
+    const __m256i needle = _mm256_set1_epi8(character);
+
+    int end = size;
+    for (; end >= 32; end -= 32)
+    {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + end - 32));
+        const auto mask = static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+
+        if (mask != 0)
+        {
+            return end - 32 + highest_set_bit(mask);
+        }
+    }
+
+    return last_index_of_char_sse2(src, end, character);
+}
+
+BEE_TARGET_AVX2 static i32 first_index_of_substring_avx2(const char* src, const i32 size, const char* substring, const i32 substring_size)
+{
+    const __m256i first = _mm256_set1_epi8(substring[0]);
+    const __m256i last = _mm256_set1_epi8(substring[substring_size - 1]);
+    const auto last_offset = substring_size - 1;
+    const auto candidate_count = size - last_offset;
+
+    int index = 0;
+    for (; index + 32 <= candidate_count; index += 32)
+    {
+        const __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + index));
+        const __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + index + last_offset));
+        auto mask = static_cast<u32>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first), _mm256_cmpeq_epi8(block_last, last))
+        ));
+
+        while (mask != 0)
+        {
+            const auto candidate = index + static_cast<i32>(count_trailing_zeroes(mask));
+            if (memcmp(src + candidate + 1, substring + 1, substring_size - 2) == 0)
+            {
+                return candidate;
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    const auto tail = first_index_of_substring_sse2(src + index, size - index, substring, substring_size);
+    return tail >= 0 ? index + tail : -1;
+}
+
+BEE_TARGET_AVX2 static i32 last_index_of_substring_avx2(const char* src, const i32 size, const char* substring, const i32 substring_size)
+{
+    const __m256i first = _mm256_set1_epi8(substring[0]);
+    const __m256i last = _mm256_set1_epi8(substring[substring_size - 1]);
+    const auto last_offset = substring_size - 1;
+
+    int candidate_end = size - last_offset;
+    for (; candidate_end >= 32; candidate_end -= 32)
+    {
+        const auto index = candidate_end - 32;
+        const __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + index));
+        const __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + index + last_offset));
+        auto mask = static_cast<u32>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first), _mm256_cmpeq_epi8(block_last, last))
+        ));
+
+        while (mask != 0)
+        {
+            const auto bit = highest_set_bit(mask);
+            if (memcmp(src + index + bit + 1, substring + 1, substring_size - 2) == 0)
+            {
+                return index + bit;
+            }
+            mask &= ~(1u << static_cast<u32>(bit));
+        }
+    }
+
+    return last_index_of_substring_sse2(src, candidate_end + last_offset, substring, substring_size);
+}
+
+BEE_TARGET_AVX2 static i32 mismatch_avx2(const char* lhs, const char* rhs, const i32 size)
+{
+    const __m256i zero = _mm256_setzero_si256();
+
+    int index = 0;
+    for (; index + 32 <= size; index += 32)
+    {
+        if (load_crosses_page(lhs + index, 32) || load_crosses_page(rhs + index, 32))
+        {
+            const auto block_index = mismatch_scalar(lhs + index, rhs + index, 32);
+            if (block_index < 32)
+            {
+                return index + block_index;
+            }
+            continue;
+        }
+
+        const __m256i lhs_block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + index));
+        const __m256i rhs_block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + index));
+        const auto equal = static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lhs_block, rhs_block)));
+        const auto terminators = static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lhs_block, zero)));
+        const auto stop = ~equal | terminators;
+
+        if (stop != 0)
+        {
+            return index + static_cast<i32>(count_trailing_zeroes(stop));
+        }
+    }
+
+    return index + mismatch_sse2(lhs + index, rhs + index, size - index);
+}
+
+#endif // BEE_SIMD_X86 == 1
+
+static StringKernels select_string_kernels()
+{
+    StringKernels kernels{};
+
+#if BEE_SIMD_X86 == 1
+    if (cpu_supports_avx2())
+    {
+        kernels.first_index_of_char = first_index_of_char_avx2;
+        kernels.last_index_of_char = last_index_of_char_avx2;
+        kernels.first_index_of_substring = first_index_of_substring_avx2;
+        kernels.last_index_of_substring = last_index_of_substring_avx2;
+        kernels.mismatch = mismatch_avx2;
+    }
+    else
+    {
+        kernels.first_index_of_char = first_index_of_char_sse2;
+        kernels.last_index_of_char = last_index_of_char_sse2;
+        kernels.first_index_of_substring = first_index_of_substring_sse2;
+        kernels.last_index_of_substring = last_index_of_substring_sse2;
+        kernels.mismatch = mismatch_sse2;
+    }
+
+    #if BEE_ASAN_ENABLED == 1
+    kernels.mismatch = mismatch_scalar;
+    #endif // BEE_ASAN_ENABLED == 1
+#else
+    kernels.first_index_of_char = first_index_of_char_scalar;
+    kernels.last_index_of_char = last_index_of_char_scalar;
+    kernels.first_index_of_substring = first_index_of_substring_scalar;
+    kernels.last_index_of_substring = last_index_of_substring_scalar;
+    kernels.mismatch = mismatch_scalar;
+#endif // BEE_SIMD_X86 == 1
+
+    return kernels;
+}
+
+/*
+ * Kernels are selected on first use rather than during static initialization so string functions called from other
+ * translation units static initializers are always safe to use
+ */
+static const StringKernels& string_kernels()
+{
+    static const StringKernels kernels = select_string_kernels();
+    return kernels;
+}
+
+// All the substring searches go through here - single-char substrings use the faster character search
+static i32 first_index_of_substring(const char* src, const i32 size, const char* substring, const i32 substring_size)
+{
+    if (substring_size > size)
+    {
+        return -1;
+    }
+
+    if (substring_size == 1)
+    {
+        return string_kernels().first_index_of_char(src, size, substring[0]);
+    }
+
+    return string_kernels().first_index_of_substring(src, size, substring, substring_size);
+}
+
+static i32 last_index_of_substring(const char* src, const i32 size, const char* substring, const i32 substring_size)
+{
+    if (substring_size > size)
+    {
+        return -1;
+    }
+
+    if (substring_size == 1)
+    {
+        return string_kernels().last_index_of_char(src, size, substring[0]);
+    }
+
+    return string_kernels().last_index_of_substring(src, size, substring, substring_size);
+}
+
+
+/*
+ * `compare` implementation
+ */
+i32 compare_n(const char* lhs, const i32 lhs_compare_count, const char* rhs, const i32 rhs_compare_count)
+{
+    if (lhs_compare_count == 0 || rhs_compare_count == 0)
+    {
+        return lhs_compare_count - rhs_compare_count;
+    }
+
+    const auto compare_count = math::min(lhs_compare_count, rhs_compare_count);
+    const auto char_idx = string_kernels().mismatch(lhs, rhs, compare_count);
+
+    if (char_idx >= compare_count)
     {
         return lhs_compare_count - rhs_compare_count;
     }
@@ -545,7 +1040,12 @@ i32 copy(char* dst, i32 dst_size, const StringView& src)
 
 String v_format(Allocator* allocator, const char* format, va_list args)
 {
-    const auto length = system_snprintf(nullptr, 0, format, args);
+    // vsnprintf consumes the va_list on SysV platforms so measuring the length needs its own copy
+    va_list length_args;
+    va_copy(length_args, args);
+    const auto length = system_snprintf(nullptr, 0, format, length_args);
+    va_end(length_args);
+
     String result(length, '\0', allocator);
     // include null-terminator
     system_snprintf(result.data(), sign_cast<size_t>(length + 1), format, args);
@@ -581,7 +1081,11 @@ i32 format(String* string, const char* format, ...)
     va_list args;
     va_start(args, format);
 
-    const auto length = str::system_snprintf(nullptr, 0, format, args);
+    va_list length_args;
+    va_copy(length_args, args);
+    const auto length = str::system_snprintf(nullptr, 0, format, length_args);
+    va_end(length_args);
+
     const auto old_dst_size = string->size();
     string->resize(old_dst_size + length);
     // include null-terminator
@@ -609,54 +1113,19 @@ i32 last_index_of_n(const StringView& src, const char* substring, i32 substring_
 {
     BEE_ASSERT(substring != nullptr);
 
-    // Empty string - no matches
-    if (src.empty())
-    {
-        return -1;
-    }
-
-    // size == 1 - can only match first char
-    if (src.size() == 1)
+    // substring is assumed to be the empty string "" which matches at the very end of `src`
+    if (substring_size <= 0)
     {
-        return str::length(substring) == 1 && src[0] == substring[0] ? 0 : -1;
+        return src.size();
     }
 
-    // case where substring is larger than the src string
-    if (substring_size > src.size())
+    // Empty string - no matches
+    if (src.empty())
     {
         return -1;
     }
 
-    const auto substr_end = substring + substring_size;
-    auto search_iter = src.end();
-    const char* src_iter = nullptr;
-    const char* substr_iter = nullptr;
-
-    /*
-     * Iterate in reverse until we come to a char == to start of the substring, then iterate forward comparing src
-     * and substring chars one-by-one
-     */
-    while (search_iter != src.begin())
-    {
-        if (*search_iter == *substring)
-        {
-            substr_iter = substring;
-            src_iter = search_iter;
-
-            // Compare chars
-            while (*src_iter++ == *substr_iter++)
-            {
-                if (substr_iter == substr_end)
-                {
-                    return sign_cast<i32>(search_iter - src.data());
-                }
-            }
-        }
-
-        --search_iter;
-    }
-
-    return -1;
+    return last_index_of_substring(src.data(), src.size(), substring, substring_size);
 }
 
 i32 last_index_of_n(const String& src, const char* substring, const i32 substring_size)
@@ -672,21 +1141,7 @@ i32 last_index_of(const StringView& src, char character)
         return -1;
     }
 
-    // size == 1 - can only match first char
-    if (src.size() == 1)
-    {
-        return src[0] == character ? 0 : -1;
-    }
-
-    for (int char_idx = src.size() - 1; char_idx > 0; --char_idx)
-    {
-        if (src[char_idx] == character)
-        {
-            return char_idx;
-        }
-    }
-
-    return -1;
+    return string_kernels().last_index_of_char(src.data(), src.size(), character);
 }
 
 i32 last_index_of(const String& src, char character)
@@ -738,48 +1193,7 @@ i32 first_index_of_n(const StringView& src, const char* substring, const i32 sub
         return -1;
     }
 
-    // size == 1 - can only match first char
-    if (src.size() == 1)
-    {
-        return str::length(substring) == 1 && src[0] == substring[0] ? 0 : -1;
-    }
-
-    // case where substring is larger than the src string
-    if (substring_size > src.size())
-    {
-        return -1;
-    }
-
-    const auto substr_end = substring + substring_size;
-    auto search_iter = src.begin();
-    const char* src_iter = nullptr;
-    const char* substr_iter = nullptr;
-
-    /*
-     * Iterate in forward until we hit the first char in the substring and then check that all subsequent characters
-     * match in both strings
-     */
-    while (search_iter != src.end())
-    {
-        if (*search_iter == *substring)
-        {
-            substr_iter = substring;
-            src_iter = search_iter;
-
-            // Compare chars
-            while (*src_iter++ == *substr_iter++)
-            {
-                if (substr_iter == substr_end)
-                {
-                    return sign_cast<i32>(search_iter - src.data());
-                }
-            }
-        }
-
-        ++search_iter;
-    }
-
-    return -1;
+    return first_index_of_substring(src.data(), src.size(), substring, substring_size);
 }
 
 i32 first_index_of_n(const String& src, const char* substring, i32 substring_size)
@@ -795,21 +1209,7 @@ i32 first_index_of(const StringView& src, char character)
         return -1;
     }
 
-    // size == 1 - can only match first char
-    if (src.size() == 1)
-    {
-        return src[0] == character ? 0 : -1;
-    }
-
-    for (int char_idx = 0; char_idx < src.size(); ++char_idx)
-    {
-        if (src[char_idx] == character)
-        {
-            return char_idx;
-        }
-    }
-
-    return -1;
+    return string_kernels().first_index_of_char(src.data(), src.size(), character);
 }
 
 i32 first_index_of(const String& src, char character)
@@ -880,20 +1280,22 @@ String& replace_n(String* dst, char old_char, char new_char, i32 count)
         return *dst;
     }
 
+    const auto& kernels = string_kernels();
     auto replacements_remaining = count;
+    int index = 0;
 
-    for (auto& cur_char : *dst)
+    while (replacements_remaining > 0)
     {
-        if (cur_char == old_char)
-        {
-            cur_char = new_char;
-            --replacements_remaining;
-        }
-
-        if (replacements_remaining <= 0)
+        const auto found = kernels.first_index_of_char(dst->data() + index, dst->size() - index, old_char);
+        if (found < 0)
         {
             break;
         }
+
+        index += found;
+        (*dst)[index] = new_char;
+        ++index;
+        --replacements_remaining;
     }
 
     return *dst;
@@ -908,81 +1310,117 @@ String& replace_n(String* dst, const char* old_string, const char* new_string, c
         return *dst;
     }
 
-    auto replacements_remaining = count;
-    auto dst_iter = dst->begin();
-
     const auto old_string_size = str::length(old_string);
     const auto new_string_size = str::length(new_string);
-    const auto removal_size = math::max(1, old_string_size - new_string_size);
 
-    char* dst_substr_ptr = nullptr;
-    const char* old_substr_iter = nullptr;
-    const char* old_string_end = old_string + old_string_size;
+    if (old_string_size <= 0)
+    {
+        return *dst;
+    }
 
-    while (dst_iter < dst->end() && replacements_remaining > 0)
+    auto replacements_remaining = count;
+
+    /*
+     * Three cases:
+     *
+     * old_string_size == new_string_size:
+     *  copy each new string over the old string in-place
+     *
+     * old_string_size > new_string_size:
+     *  compact the string in-place in a single pass - the text between matches is moved down to close the gaps left
+     *  by the smaller replacements
+     *
+     * old_string_size < new_string_size:
+     *  count the matches first so the result can be allocated once and then build it front-to-back. Growing with
+     *  `insert` for each match would shift the rest of the string every time
+     */
+    if (old_string_size == new_string_size)
     {
-        // Keep searching if we can't find the start of the old string
-        if (*dst_iter != *old_string)
+        int index = 0;
+        while (replacements_remaining > 0)
         {
-            ++dst_iter;
-            continue;
+            const auto found = first_index_of_substring(dst->data() + index, dst->size() - index, old_string, old_string_size);
+            if (found < 0)
+            {
+                break;
+            }
+
+            index += found;
+            memcpy(dst->data() + index, new_string, new_string_size);
+            index += old_string_size;
+            --replacements_remaining;
         }
 
-        // Found possible match
-        dst_substr_ptr = dst_iter;
-        old_substr_iter = old_string;
+        return *dst;
+    }
+
+    if (old_string_size > new_string_size)
+    {
+        char* data = dst->data();
+        const auto size = dst->size();
+        int read_index = 0;
+        int write_index = 0;
 
-        // Check all characters are the same comparing from dst_iter to old_string_end
-        while (*dst_iter++ == *old_substr_iter++)
+        while (replacements_remaining > 0)
         {
-            if (old_substr_iter == old_string_end)
+            const auto found = first_index_of_substring(data + read_index, size - read_index, old_string, old_string_size);
+            if (found < 0)
             {
-                /*
-                 * Three cases:
-                 *
-                 * old_string_size > new_string_size:
-                 *  copy new string over old string and remove the difference of old and new size
-                 *
-                 * old_string_size < new_string_size:
-                 *  grow string to at least new_string_size with `insert` and then copy new string into old strings idx
-                 *
-                 * old_string_size == new_string_size:
-                 *  call str::copy and just replace the string
-                 */
-                if (old_string_size > new_string_size)
-                {
-                    const auto replacement_end = sign_cast<i32>(dst_substr_ptr + new_string_size - dst->begin());
-                    memcpy(dst_substr_ptr, new_string, new_string_size);
-                    dst->remove(replacement_end, removal_size);
-                }
-                else if (old_string_size < new_string_size)
-                {
-                    const auto replacement_range = static_cast<i32>(dst->end() - dst_substr_ptr);
-                    const auto replace_ptr_offset = dst_substr_ptr - dst->begin();
-                    const auto src_iter_offset = dst_iter - dst->begin();
-                    dst->insert(dst->size() - replacement_range, new_string_size - old_string_size, ' ');
-
-                    /*
-                     * inserting into the string can reallocate and cause iterators to become invalid - so we need to
-                     * fix up the pointers in case this happens
-                     */
-                    dst_substr_ptr = dst->data() + replace_ptr_offset;
-                    dst_iter = dst->data() + src_iter_offset;
-
-                    // Copy over the string replacement
-                    memcpy(dst_substr_ptr, new_string, new_string_size);
-                }
-                else
-                {
-                    memcpy(dst_substr_ptr, new_string, new_string_size);
-                }
-
-                --replacements_remaining;
                 break;
             }
+
+            memmove(data + write_index, data + read_index, found);
+            write_index += found;
+            memcpy(data + write_index, new_string, new_string_size);
+            write_index += new_string_size;
+            read_index += found + old_string_size;
+            --replacements_remaining;
+        }
+
+        memmove(data + write_index, data + read_index, size - read_index);
+        dst->resize(write_index + size - read_index);
+        return *dst;
+    }
+
+    int match_count = 0;
+    int index = 0;
+
+    while (match_count < replacements_remaining)
+    {
+        const auto found = first_index_of_substring(dst->data() + index, dst->size() - index, old_string, old_string_size);
+        if (found < 0)
+        {
+            break;
         }
+
+        index += found + old_string_size;
+        ++match_count;
+    }
+
+    if (match_count == 0)
+    {
+        return *dst;
     }
 
+    String result(dst->size() + match_count * (new_string_size - old_string_size), '\0', dst->allocator());
+    const char* src = dst->data();
+    char* result_iter = result.data();
+    int read_index = 0;
+
+    for (int match = 0; match < match_count; ++match)
+    {
+        const auto found = first_index_of_substring(src + read_index, dst->size() - read_index, old_string, old_string_size);
+        BEE_ASSERT(found >= 0);
+
+        memcpy(result_iter, src + read_index, found);
+        result_iter += found;
+        memcpy(result_iter, new_string, new_string_size);
+        result_iter += new_string_size;
+        read_index += found + old_string_size;
+    }
+
+    memcpy(result_iter, src + read_index, dst->size() - read_index);
+    *dst = BEE_MOVE(result);
     return *dst;
 }
 
@@ -1365,6 +1803,118 @@ bool is_ascii(const char c)
     return (c & ~0x7f) == 0;
 }
 
+/*
+ * ASCII fast paths for the platform encoding conversions. These only use SSE2 - AVX2 pack/unpack instructions operate
+ * within 128-bit lanes so the wider kernels wouldn't be any faster once the lanes are shuffled back into order
+ */
+i32 widen_ascii(const char* src, const i32 src_size, wchar_t* dst, const i32 dst_size)
+{
+    const auto count = math::min(src_size, dst_size);
+    int index = 0;
+
+#if BEE_SIMD_X86 == 1
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; index + 16 <= count; index += 16)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + index));
+
+        // any char with the high bit set is non-ASCII
+        if (_mm_movemask_epi8(block) != 0)
+        {
+            break;
+        }
+
+        const __m128i low = _mm_unpacklo_epi8(block, zero);
+        const __m128i high = _mm_unpackhi_epi8(block, zero);
+        auto* dst_block = reinterpret_cast<__m128i*>(dst + index);
+
+        if constexpr (sizeof(wchar_t) == 2)
+        {
+            _mm_storeu_si128(dst_block, low);
+            _mm_storeu_si128(dst_block + 1, high);
+        }
+        else
+        {
+            _mm_storeu_si128(dst_block, _mm_unpacklo_epi16(low, zero));
+            _mm_storeu_si128(dst_block + 1, _mm_unpackhi_epi16(low, zero));
+            _mm_storeu_si128(dst_block + 2, _mm_unpacklo_epi16(high, zero));
+            _mm_storeu_si128(dst_block + 3, _mm_unpackhi_epi16(high, zero));
+        }
+    }
+#endif // BEE_SIMD_X86 == 1
+
+    for (; index < count; ++index)
+    {
+        if (!is_ascii(src[index]))
+        {
+            break;
+        }
+
+        dst[index] = static_cast<wchar_t>(src[index]);
+    }
+
+    return index;
+}
+
+i32 narrow_ascii(const wchar_t* src, const i32 src_size, char* dst, const i32 dst_size)
+{
+    const auto count = math::min(src_size, dst_size);
+    int index = 0;
+
+#if BEE_SIMD_X86 == 1
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; index + 16 <= count; index += 16)
+    {
+        const auto* src_block = reinterpret_cast<const __m128i*>(src + index);
+        __m128i low;
+        __m128i high;
+        __m128i non_ascii_bits;
+
+        if constexpr (sizeof(wchar_t) == 2)
+        {
+            low = _mm_loadu_si128(src_block);
+            high = _mm_loadu_si128(src_block + 1);
+            non_ascii_bits = _mm_and_si128(_mm_or_si128(low, high), _mm_set1_epi16(static_cast<short>(0xFF80)));
+        }
+        else
+        {
+            const __m128i v0 = _mm_loadu_si128(src_block);
+            const __m128i v1 = _mm_loadu_si128(src_block + 1);
+            const __m128i v2 = _mm_loadu_si128(src_block + 2);
+            const __m128i v3 = _mm_loadu_si128(src_block + 3);
+            non_ascii_bits = _mm_and_si128(
+                _mm_or_si128(_mm_or_si128(v0, v1), _mm_or_si128(v2, v3)),
+                _mm_set1_epi32(static_cast<int>(0xFFFFFF80))
+            );
+            // every value is < 0x80 if this block is ASCII so the signed saturation never kicks in
+            low = _mm_packs_epi32(v0, v1);
+            high = _mm_packs_epi32(v2, v3);
+        }
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(non_ascii_bits, zero)) != 0xFFFF)
+        {
+            break;
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + index), _mm_packus_epi16(low, high));
+    }
+#endif // BEE_SIMD_X86 == 1
+
+    for (; index < count; ++index)
+    {
+        if (static_cast<u32>(src[index]) > 0x7Fu)
+        {
+            break;
+        }
+
+        dst[index] = static_cast<char>(src[index]);
+    }
+
+    return index;
+}
+
 char to_uppercase_ascii(const char c)
 {
     return is_ascii(c) ? static_cast<char>(toupper(c)) : c;
@@ -158,6 +158,12 @@ private:
 class BEE_REFLECT(serializable, use_builder) BEE_CORE_API String
 {
 public:
+    /*
+     * Capacity of the inline storage used before any memory is allocated - the small buffer reuses the storage of the
+     * heap pointer, size and capacity so it fits 15 chars plus a null-terminator on 64-bit platforms
+     */
+    static constexpr i32 small_buffer_capacity = static_cast<i32>(sizeof(char*) + 2 * sizeof(i32));
+
     explicit String(Allocator* allocator = system_allocator()) noexcept;
 
     String(i32 count, char fill_char, Allocator* allocator = system_allocator());
@@ -219,74 +225,74 @@ public:
 
     inline char& operator[](const i32 index)
     {
-        BEE_ASSERT(index < size_);
-        return data_[index];
+        BEE_ASSERT(index < size());
+        return data()[index];
     }
 
     inline const char& operator[](const i32 index) const
     {
-        BEE_ASSERT(index < size_);
-        return data_[index];
+        BEE_ASSERT(index < size());
+        return data()[index];
     }
 
     inline char& back()
     {
-        return data_[size_ - 1];
+        return data()[size() - 1];
     }
 
     inline const char& back() const
     {
-        return data_[size_ - 1];
+        return data()[size() - 1];
     }
 
     inline const char* c_str() const
     {
-        return data_;
+        return data();
     }
 
     inline char* begin()
     {
-        return data_;
+        return data();
     }
 
     inline const char* begin() const
     {
-        return data_;
+        return data();
     }
 
     inline char* end()
     {
-        return data_ + size_;
+        return data() + size();
     }
 
     inline const char* end() const
     {
-        return data_ + size_;
+        return data() + size();
     }
 
     inline char* data()
     {
-        return data_;
+        return is_small() ? small_buffer_ : heap_.data;
     }
 
     inline const char* data() const
     {
-        return data_;
+        return is_small() ? small_buffer_ : heap_.data;
     }
 
     inline constexpr bool empty() const
     {
-        return size_ <= 0;
+        return size() <= 0;
     }
 
     inline constexpr i32 size() const
     {
-        return size_;
+        return is_small() ? small_tag_index - small_buffer_[small_tag_index] : heap_.size;
     }
 
     inline constexpr i32 capacity() const
     {
-        return capacity_;
+        return is_small() ? small_buffer_capacity : static_cast<i32>(heap_.capacity & ~heap_capacity_flag);
     }
 
     inline const Allocator* allocator() const
@@ -301,16 +307,47 @@ public:
 
     inline StringView view() const
     {
-        return StringView(data_, size_);
+        return StringView(data(), size());
     }
+
+    inline constexpr bool is_small() const
+    {
+        return (static_cast<u8>(small_buffer_[small_tag_index]) & small_tag_heap_bit) == 0;
+    }
+
 private:
     static constexpr i32 growth_factor_ = 2;
-    static constexpr char empty_string_ = '\0';
+    static constexpr i32 small_tag_index = small_buffer_capacity - 1;
+    static constexpr u32 heap_capacity_flag = 1u << 31u;
+    static constexpr u8 small_tag_heap_bit = 0x80u;
+
+    struct HeapData
+    {
+        char*   data;
+        i32     size;
+        u32     capacity; // always has `heap_capacity_flag` set
+    };
 
-    i32         size_ { 0 };
-    i32         capacity_ { 0 };
     Allocator*  allocator_ { nullptr };
-    char*       data_ { const_cast<char*>(&empty_string_) };
+
+    /*
+     * Strings that fit in the small buffer (including the null-terminator) are stored inline and never touch the
+     * allocator. The small buffer and the heap representation share the same storage so `String` is still the size of
+     * a pointer, allocator, size and capacity. The two are told apart by the last byte of the small buffer which
+     * overlaps the most significant byte of `HeapData::capacity`:
+     *
+     * - heap strings always set the top bit of their capacity
+     * - small strings store their remaining capacity in the last byte - this is 0 when the buffer is full so the same
+     *   byte doubles as the null-terminator for a 15 char string
+     *
+     * `data()` is recomputed from the tag rather than caching a pointer into the small buffer so strings remain safe
+     * to memmove/memcpy around like the containers do
+     */
+    union
+    {
+        HeapData    heap_;
+        char        small_buffer_[small_buffer_capacity] { '\0' };
+    };
 
     friend i32 str::compare(const String& lhs, const String& rhs);
 
@@ -325,6 +362,10 @@ private:
     void destroy();
 
     void grow(const i32 new_size);
+
+    void set_size(const i32 new_size);
+
+    void reset_small_buffer();
 };
 
 
@@ -710,10 +751,14 @@ inline i32 format_buffer(StaticString<Capacity>* string, const char* format, ...
     va_list args;
     va_start(args, format);
 
-    const auto length = system_snprintf(nullptr, 0, format, args);
+    va_list length_args;
+    va_copy(length_args, args);
+    const auto length = system_snprintf(nullptr, 0, format, length_args);
+    va_end(length_args);
 
     if (length > Capacity)
     {
+        va_end(args);
         return length;
     }
 
@@ -845,6 +890,16 @@ BEE_CORE_API wchar_array_t to_wchar(const StringView& src, Allocator* allocator
 
 BEE_CORE_API i32 to_wchar(const StringView& src, wchar_t* buffer, const i32 buffer_size);
 
+/**
+ * `widen_ascii` & `narrow_ascii` - vectorized fast paths for the encoding conversions above. Converts the leading run
+ * of ASCII characters in `src` into `dst` and returns the number of characters converted, stopping at the first
+ * non-ASCII character or when either `src` or `dst` runs out. Any remaining characters can be converted separately
+ * and appended as the ASCII run always ends on a character boundary
+ */
+BEE_CORE_API i32 widen_ascii(const char* src, i32 src_size, wchar_t* dst, i32 dst_size);
+
+BEE_CORE_API i32 narrow_ascii(const wchar_t* src, i32 src_size, char* dst, i32 dst_size);
+
 template <i32 Size>
 inline StaticArray<wchar_t, Size> to_wchar(const StringView& src)
 {
@@ -0,0 +1,167 @@
+/*
+ *  StringTable.cpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#include "Bee/Core/StringTable.hpp"
+#include "Bee/Core/Math/Math.hpp"
+
+
+namespace bee {
+
+
+StringTable::StringTable(const size_t block_size, Allocator* allocator)
+    : block_size_(block_size),
+      allocator_(allocator)
+{}
+
+StringTable::~StringTable()
+{
+    scoped_rw_write_lock_t lock(mutex_);
+
+    auto* block = blocks_;
+    while (block != nullptr)
+    {
+        auto* next = block->next;
+        BEE_FREE(allocator_, block);
+        block = next;
+    }
+
+    blocks_ = nullptr;
+    allocated_size_ = 0;
+    count_ = 0;
+    buckets_.clear();
+}
+
+InternedString StringTable::intern(const StringView& string)
+{
+    return intern(string, Hash<StringView>{}(string));
+}
+
+InternedString StringTable::intern(const StringView& string, const u32 hash)
+{
+    // Entries are bucketed by the callers hash so a mismatched one would intern a duplicate that nothing can find
+    BEE_ASSERT_F(hash == Hash<StringView>{}(string), "StringTable: hash 0x%08x doesn't match the string being interned", hash);
+
+    // Fast path - most strings are interned once and looked up many times so try a shared lookup first
+    {
+        scoped_rw_read_lock_t lock(mutex_);
+        const auto* existing = find_no_lock(string, hash);
+        if (existing != nullptr)
+        {
+            return InternedString(existing);
+        }
+    }
+
+    scoped_rw_write_lock_t lock(mutex_);
+
+    // Another thread may have interned the same string between releasing the read lock and acquiring the write lock
+    const auto* existing = find_no_lock(string, hash);
+    if (existing != nullptr)
+    {
+        return InternedString(existing);
+    }
+
+    auto* entry = allocate_entry(string, hash);
+    auto* bucket = buckets_.find(hash);
+
+    if (bucket == nullptr)
+    {
+        buckets_.insert(hash, entry);
+    }
+    else
+    {
+        entry->next = bucket->value;
+        bucket->value = entry;
+    }
+
+    ++count_;
+    return InternedString(entry);
+}
+
+InternedString StringTable::find(const StringView& string) const
+{
+    return find(string, Hash<StringView>{}(string));
+}
+
+InternedString StringTable::find(const StringView& string, const u32 hash) const
+{
+    BEE_ASSERT_F(hash == Hash<StringView>{}(string), "StringTable: hash 0x%08x doesn't match the string being looked up", hash);
+
+    scoped_rw_read_lock_t lock(mutex_);
+    return InternedString(find_no_lock(string, hash));
+}
+
+i32 StringTable::size() const
+{
+    scoped_rw_read_lock_t lock(mutex_);
+    return count_;
+}
+
+size_t StringTable::allocated_size() const
+{
+    scoped_rw_read_lock_t lock(mutex_);
+    return allocated_size_;
+}
+
+const InternedStringEntry* StringTable::find_no_lock(const StringView& string, const u32 hash) const
+{
+    const auto* bucket = buckets_.find(hash);
+    if (bucket == nullptr)
+    {
+        return nullptr;
+    }
+
+    for (const auto* entry = bucket->value; entry != nullptr; entry = entry->next)
+    {
+        if (entry->length == string.size() && memcmp(entry->data(), string.data(), string.size()) == 0)
+        {
+            return entry;
+        }
+    }
+
+    return nullptr;
+}
+
+InternedStringEntry* StringTable::allocate_entry(const StringView& string, const u32 hash)
+{
+    const auto entry_size = round_up(sizeof(InternedStringEntry) + string.size() + 1, alignof(InternedStringEntry));
+
+    if (blocks_ == nullptr || blocks_->offset + entry_size > blocks_->capacity)
+    {
+        // Strings larger than a block get a dedicated block of their own
+        const auto capacity = math::max(block_size_, round_up(sizeof(Block), alignof(InternedStringEntry)) + entry_size);
+        auto* block = static_cast<Block*>(BEE_MALLOC_ALIGNED(allocator_, capacity, alignof(Block)));
+        new (block) Block{};
+        block->next = blocks_;
+        block->capacity = capacity;
+        block->offset = round_up(sizeof(Block), alignof(InternedStringEntry));
+        blocks_ = block;
+        allocated_size_ += capacity;
+    }
+
+    auto* entry = reinterpret_cast<InternedStringEntry*>(reinterpret_cast<u8*>(blocks_) + blocks_->offset);
+    blocks_->offset += entry_size;
+
+    new (entry) InternedStringEntry{};
+    entry->hash = hash;
+    entry->length = string.size();
+
+    auto* data = reinterpret_cast<char*>(entry + 1);
+    memcpy(data, string.data(), string.size());
+    data[string.size()] = '\0';
+
+    return entry;
+}
+
+
+StringTable* global_string_table()
+{
+    static StringTable table;
+    return &table;
+}
+
+
+} // namespace bee
@@ -0,0 +1,200 @@
+/*
+ *  StringTable.hpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#pragma once
+
+#include "Bee/Core/String.hpp"
+#include "Bee/Core/Hash.hpp"
+#include "Bee/Core/Concurrency.hpp"
+#include "Bee/Core/Containers/HashMap.hpp"
+
+
+namespace bee {
+
+
+struct InternedStringEntry
+{
+    u32                     hash { 0 };
+    i32                     length { 0 };
+    InternedStringEntry*    next { nullptr };   // next entry in the same hash bucket
+
+    inline const char* data() const
+    {
+        return reinterpret_cast<const char*>(this + 1);
+    }
+};
+
+/*
+ *******************************************************************************************************************
+ *
+ * `InternedString` - a handle to an immutable string stored in a `StringTable`. Every unique string value is
+ * stored exactly once per table so two interned strings from the same table are equal if and only if they point to
+ * the same entry - equality is a single pointer compare and the hash is computed once at intern time. The hash is
+ * identical to `Hash<StringView>` so an interned strings hash can be used to look up maps keyed by the raw string
+ *
+ *******************************************************************************************************************
+ */
+class InternedString
+{
+public:
+    constexpr InternedString() noexcept = default;
+
+    explicit constexpr InternedString(const InternedStringEntry* entry) noexcept
+        : entry_(entry)
+    {}
+
+    inline bool is_valid() const
+    {
+        return entry_ != nullptr;
+    }
+
+    inline u32 hash() const
+    {
+        return entry_ != nullptr ? entry_->hash : 0;
+    }
+
+    inline i32 size() const
+    {
+        return entry_ != nullptr ? entry_->length : 0;
+    }
+
+    inline bool empty() const
+    {
+        return size() == 0;
+    }
+
+    inline const char* c_str() const
+    {
+        return entry_ != nullptr ? entry_->data() : "";
+    }
+
+    inline StringView view() const
+    {
+        return StringView(c_str(), size());
+    }
+
+    inline bool operator==(const InternedString& other) const
+    {
+        return entry_ == other.entry_;
+    }
+
+    inline bool operator!=(const InternedString& other) const
+    {
+        return entry_ != other.entry_;
+    }
+
+    inline const InternedStringEntry* entry() const
+    {
+        return entry_;
+    }
+
+private:
+    const InternedStringEntry* entry_ { nullptr };
+};
+
+
+/*
+ *******************************************************************************************************************
+ *
+ * `StringTable` - thread-safe string interning. Strings are copied into large arena blocks that are never freed
+ * until the table is destroyed so `InternedString` handles and the `const char*` they point to remain valid for
+ * the lifetime of the table. Lookups take a shared reader lock and only interning a new string takes the writer
+ * lock so hot-path lookups of existing strings never contend with each other
+ *
+ *******************************************************************************************************************
+ */
+class BEE_CORE_API StringTable final : public Noncopyable
+{
+public:
+    static constexpr size_t default_block_size = 64 * 1024;
+
+    explicit StringTable(const size_t block_size = default_block_size, Allocator* allocator = system_allocator());
+
+    ~StringTable();
+
+    InternedString intern(const StringView& string);
+
+    InternedString intern(const StringView& string, const u32 hash);
+
+    InternedString find(const StringView& string) const;
+
+    InternedString find(const StringView& string, const u32 hash) const;
+
+    i32 size() const;
+
+    size_t allocated_size() const;
+
+private:
+    struct Block
+    {
+        Block*  next { nullptr };
+        size_t  capacity { 0 };
+        size_t  offset { 0 };
+    };
+
+    size_t                                              block_size_ { 0 };
+    Allocator*                                          allocator_ { nullptr };
+    Block*                                              blocks_ { nullptr };
+    size_t                                              allocated_size_ { 0 };
+    i32                                                 count_ { 0 };
+    BEE_PAD(4);
+    DynamicHashMap<u32, InternedStringEntry*>           buckets_;
+    mutable ReaderWriterMutex                           mutex_;
+
+    const InternedStringEntry* find_no_lock(const StringView& string, const u32 hash) const;
+
+    InternedStringEntry* allocate_entry(const StringView& string, const u32 hash);
+};
+
+
+/*
+ * Global string table used by the engine for asset, type, plugin and shader names etc.
+ */
+BEE_CORE_API StringTable* global_string_table();
+
+BEE_FORCE_INLINE InternedString intern_string(const StringView& string)
+{
+    return global_string_table()->intern(string);
+}
+
+BEE_FORCE_INLINE InternedString find_interned_string(const StringView& string)
+{
+    return global_string_table()->find(string);
+}
+
+
+template <>
+struct Hash<InternedString>
+{
+    inline u32 operator()(const InternedString& key) const
+    {
+        return key.hash();
+    }
+};
+
+inline bool operator==(const InternedString& lhs, const StringView& rhs)
+{
+    return lhs.view() == rhs;
+}
+
+inline bool operator==(const StringView& lhs, const InternedString& rhs)
+{
+    return lhs == rhs.view();
+}
+
+inline bool operator!=(const InternedString& lhs, const StringView& rhs)
+{
+    return !(lhs == rhs);
+}
+
+inline bool operator!=(const StringView& lhs, const InternedString& rhs)
+{
+    return !(lhs == rhs);
+}
+
+
+} // namespace bee
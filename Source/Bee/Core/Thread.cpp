@@ -75,7 +75,7 @@ Thread& Thread::operator=(Thread&& other) noexcept
 
 Thread::~Thread()
 {
-    if (native_thread_ == nullptr)
+    if (!joinable())
     {
         return;
     }
@@ -92,7 +92,7 @@ void Thread::move_construct(Thread& other) noexcept
     name_ = BEE_MOVE(other.name_);
     native_thread_ = other.native_thread_;
 
-    other.native_thread_ = nullptr;
+    other.native_thread_ = native_thread_t{};
 }
 
 
@@ -193,7 +193,7 @@ public:
 
     inline bool joinable() const
     {
-        return native_thread_ != nullptr;
+        return native_thread_ != native_thread_t{};
     }
 private:
 
@@ -214,7 +214,7 @@ private:
         BEE_PAD(7);
     };
 
-    native_thread_t                     native_thread_ { nullptr };
+    native_thread_t                     native_thread_ {};
     StaticString<BEE_THREAD_MAX_NAME>   name_;
 
     void init(const ThreadCreateInfo& create_info, ExecuteParams* params);
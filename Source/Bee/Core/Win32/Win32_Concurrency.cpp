@@ -78,6 +78,9 @@ ReaderWriterMutex::ReaderWriterMutex() noexcept
     ::InitializeSRWLock(&native_handle);
 }
 
+// SRW locks don't own any resources so there's nothing to delete
+ReaderWriterMutex::~ReaderWriterMutex() = default;
+
 void ReaderWriterMutex::lock_read()
 {
     ::AcquireSRWLockShared(&native_handle);
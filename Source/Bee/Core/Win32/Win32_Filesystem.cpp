@@ -11,6 +11,7 @@
 #include "Bee/Core/Concurrency.hpp"
 #include "Bee/Core/Logger.hpp"
 #include "Bee/Core/Bit.hpp"
+#include "Bee/Core/Memory/Memory.hpp"
 
 #define BEE_MINWINDOWS_ENABLE_SHELLAPI
 #include "Bee/Core/Win32/MinWindows.h"
@@ -119,6 +120,118 @@ void DirectoryIterator::next()
     path_ = entry->buffer.view();
 }
 
+/*
+ *****************************************
+ *
+ * Directory scanning - implementation
+ *
+ *****************************************
+ */
+bool is_scan_entry_included(const DirectoryScanInfo& info, const PathView& path, const DirectoryEntryType type);
+
+bool native_scan_dir(const PathView& directory, const DirectoryScanInfo& info, DynamicArray<DirectoryEntryInfo>* entries)
+{
+    StaticString<4096> entry_path(directory.string_view());
+    const char last_char = entry_path[entry_path.size() - 1];
+    if (last_char != Path::preferred_slash && last_char != Path::generic_slash)
+    {
+        entry_path.append(Path::preferred_slash);
+    }
+
+    const auto root_size = entry_path.size();
+    entry_path.append('*');
+
+    // FindFirstFileEx returns the size, attributes and timestamps with each entry so nothing else needs to be queried
+    WIN32_FIND_DATAW find_data{};
+    const auto u16s = str::to_wchar<MAX_PATH>(entry_path.view());
+    auto* handle = ::FindFirstFileExW(
+        u16s.data,
+        FindExInfoBasic,
+        &find_data,
+        FindExSearchNameMatch,
+        nullptr,
+        FIND_FIRST_EX_LARGE_FETCH
+    );
+
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        log_error("Failed to open directory %" BEE_PRIsv ": %s", BEE_FMT_SV(directory), win32_get_last_error_string());
+        return false;
+    }
+
+    char u8s_filename[MAX_PATH + 4];
+
+    do
+    {
+        const i32 size = str::from_wchar(
+            u8s_filename,
+            static_array_length(u8s_filename),
+            find_data.cFileName,
+            static_cast<i32>(::wcslen(find_data.cFileName))
+        );
+
+        const StringView name(u8s_filename, size);
+        if (name == "." || name == "..")
+        {
+            continue;
+        }
+
+        entry_path.resize(root_size);
+        entry_path.append(name);
+
+        auto type = DirectoryEntryType::file;
+        if ((find_data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0)
+        {
+            type = DirectoryEntryType::symlink;
+        }
+        else if ((find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+        {
+            type = DirectoryEntryType::directory;
+        }
+
+        if (!is_scan_entry_included(info, entry_path.view(), type))
+        {
+            continue;
+        }
+
+        DirectoryEntryInfo entry{};
+        entry.path = entry_path.view();
+        entry.type = type;
+        entry.size = static_cast<i64>((static_cast<u64>(find_data.nFileSizeHigh) << 32) + static_cast<u64>(find_data.nFileSizeLow));
+        entry.last_modified = (static_cast<u64>(find_data.ftLastWriteTime.dwHighDateTime) << 32) + static_cast<u64>(find_data.ftLastWriteTime.dwLowDateTime);
+        entries->push_back(BEE_MOVE(entry));
+    } while (::FindNextFileW(handle, &find_data) != 0);
+
+    ::FindClose(handle);
+    return true;
+}
+
+bool get_entry_info(const PathView& path, DirectoryEntryInfo* info)
+{
+    WIN32_FILE_ATTRIBUTE_DATA data{};
+    const auto u16s = str::to_wchar<1024>(path.string_view());
+    if (::GetFileAttributesExW(u16s.data, GetFileExInfoStandard, &data) == 0)
+    {
+        return false;
+    }
+
+    info->path = path;
+    info->type = DirectoryEntryType::file;
+    if ((data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0)
+    {
+        info->type = DirectoryEntryType::symlink;
+    }
+    else if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+    {
+        info->type = DirectoryEntryType::directory;
+    }
+
+    info->size = static_cast<i64>((static_cast<u64>(data.nFileSizeHigh) << 32) + static_cast<u64>(data.nFileSizeLow));
+    info->last_modified = (static_cast<u64>(data.ftLastWriteTime.dwHighDateTime) << 32) + static_cast<u64>(data.ftLastWriteTime.dwLowDateTime);
+    info->inode = 0;
+    return true;
+}
+
 /*
  *************************************
  *
@@ -472,7 +585,7 @@ File open_file(const PathView& path, const OpenMode mode)
         dwShareMode,
         nullptr,
         dwCreationDisposition,
-        FILE_ATTRIBUTE_NORMAL,
+        FILE_ATTRIBUTE_NORMAL | decode_flag(mode, OpenMode::unbuffered, FILE_FLAG_NO_BUFFERING),
         nullptr
     );
 
@@ -574,6 +687,52 @@ i64 write(const File& file, const void* buffer, const i64 buffer_size)
     return sign_cast<i64>(bytes_written);
 }
 
+size_t unbuffered_io_alignment()
+{
+    // FILE_FLAG_NO_BUFFERING needs the volumes sector size which is never larger than a page
+    return get_page_size();
+}
+
+i64 read_at(const File& file, const i64 offset, const i64 size, void* buffer)
+{
+    OVERLAPPED overlapped{};
+    overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+    DWORD bytes_read = 0;
+    const auto read_res = ::ReadFile(file.handle, buffer, static_cast<DWORD>(size), &bytes_read, &overlapped);
+    if (read_res == FALSE && ::GetLastError() != ERROR_HANDLE_EOF)
+    {
+        log_error("Failed to read file at offset %" PRIi64 ": %s", offset, win32_get_last_error_string());
+        return 0;
+    }
+
+    return bytes_read;
+}
+
+i64 write_at(const File& file, const i64 offset, const void* buffer, const i64 buffer_size)
+{
+    OVERLAPPED overlapped{};
+    overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+    DWORD bytes_written = 0;
+    const auto err = ::WriteFile(
+        static_cast<HANDLE>(file.handle),
+        buffer,
+        static_cast<DWORD>(buffer_size),
+        &bytes_written,
+        &overlapped
+    );
+
+    if (BEE_FAIL_F(err == TRUE, "Error writing to file at offset %" PRIi64 ": %s", offset, win32_get_last_error_string()))
+    {
+        return 0;
+    }
+
+    return sign_cast<i64>(bytes_written);
+}
+
 bool is_dir(const PathView& path)
 {
     const auto u16s = str::to_wchar<1024>(path.string_view());
@@ -668,6 +827,79 @@ bool move(const PathView& current_path, const PathView& new_path)
     return false;
 }
 
+bool native_replace_file(const PathView& src_path, const PathView& dst_path)
+{
+    const auto src_u16s = str::to_wchar<1024>(src_path.string_view());
+    const auto dst_u16s = str::to_wchar<1024>(dst_path.string_view());
+
+    // MOVEFILE_WRITE_THROUGH doesn't return until the rename has been flushed to disk which is what
+    // `native_sync_file_names` relies on
+    const auto result = ::MoveFileExW(src_u16s.data, dst_u16s.data, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+
+    if (result != FALSE)
+    {
+        return true;
+    }
+
+    log_error("Unable to replace %" BEE_PRIsv " with %" BEE_PRIsv ": %s", BEE_FMT_SV(dst_path), BEE_FMT_SV(src_path), win32_get_last_error_string());
+    return false;
+}
+
+bool sync_file(const File& file)
+{
+    if (::FlushFileBuffers(static_cast<HANDLE>(file.handle)) == FALSE)
+    {
+        log_error("Failed to sync file to disk: %s", win32_get_last_error_string());
+        return false;
+    }
+
+    return true;
+}
+
+bool native_sync_file_data(const Path* const* paths, const i32 count)
+{
+    // Flushing a whole volume requires admin rights so each file has to be flushed individually
+    for (int i = 0; i < count; ++i)
+    {
+        const auto u16s = str::to_wchar<1024>(paths[i]->string_view());
+        auto* handle = ::CreateFileW(
+            u16s.data,
+            GENERIC_WRITE,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr
+        );
+
+        if (handle == INVALID_HANDLE_VALUE)
+        {
+            log_error("Failed to open %s for syncing: %s", paths[i]->c_str(), win32_get_last_error_string());
+            return false;
+        }
+
+        const auto result = ::FlushFileBuffers(handle);
+        ::CloseHandle(handle);
+
+        if (result == FALSE)
+        {
+            log_error("Failed to sync %s to disk: %s", paths[i]->c_str(), win32_get_last_error_string());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool native_sync_file_names(const Path* const* paths, const i32 count)
+{
+    BEE_UNUSED(paths);
+    BEE_UNUSED(count);
+
+    // Files are renamed with MOVEFILE_WRITE_THROUGH so there's nothing left to flush
+    return true;
+}
+
 bool copy(const PathView& src_filepath, const PathView& dst_filepath, bool overwrite)
 {
     const auto src_u16s = str::to_wchar<1024>(src_filepath.string_view());
@@ -712,8 +944,13 @@ Path user_local_appdata_path()
  *
  ******************************************
  */
-bool mmap_file_map(MemoryMappedFile* file, const PathView& path, const OpenMode open_mode)
+bool mmap_file_map_range(MemoryMappedFile* file, const PathView& path, const OpenMode open_mode, const i64 offset, const i64 size)
 {
+    if (BEE_FAIL_F(offset >= 0, "Invalid memory mapped file offset: %" PRIi64, offset))
+    {
+        return false;
+    }
+
     const DWORD desired_access = decode_flag(open_mode, OpenMode::read, GENERIC_READ)
                                | decode_flag(open_mode, OpenMode::write, GENERIC_WRITE);
 
@@ -738,8 +975,27 @@ bool mmap_file_map(MemoryMappedFile* file, const PathView& path, const OpenMode
         return false;
     }
 
-    const DWORD protect = decode_flag(open_mode, OpenMode::read, PAGE_READONLY)
-                        | decode_flag(open_mode, OpenMode::write, PAGE_READWRITE);
+    LARGE_INTEGER file_size{};
+    if (::GetFileSizeEx(file->handles[0], &file_size) == FALSE || file_size.QuadPart <= 0)
+    {
+        log_error("Failed to memory map file %" BEE_PRIsv ": file is empty or can't be read", BEE_FMT_SV(path));
+        ::CloseHandle(file->handles[0]);
+        file->handles[0] = nullptr;
+        return false;
+    }
+
+    const i64 range_size = size < 0 ? file_size.QuadPart - offset : size;
+
+    if (offset + range_size > file_size.QuadPart || range_size <= 0)
+    {
+        log_error("Failed to memory map file %" BEE_PRIsv ": range [%" PRIi64 ", %" PRIi64 ") is outside the file", BEE_FMT_SV(path), offset, offset + range_size);
+        ::CloseHandle(file->handles[0]);
+        file->handles[0] = nullptr;
+        return false;
+    }
+
+    // PAGE_READONLY | PAGE_READWRITE isn't a valid combination so read-write mappings only use the latter
+    const DWORD protect = (open_mode & OpenMode::write) != OpenMode::none ? PAGE_READWRITE : PAGE_READONLY;
 
     file->handles[1] = ::CreateFileMappingW(
         file->handles[0],
@@ -756,10 +1012,25 @@ bool mmap_file_map(MemoryMappedFile* file, const PathView& path, const OpenMode
         return false;
     }
 
+    // View offsets have to be a multiple of the allocation granularity (usually 64KiB) rather than the page size
+    SYSTEM_INFO system_info{};
+    ::GetSystemInfo(&system_info);
+
+    const i64 granularity = system_info.dwAllocationGranularity;
+    const i64 view_offset = offset - offset % granularity;
+    const i64 view_size = range_size + (offset - view_offset);
+
     const DWORD view_access = decode_flag(open_mode, OpenMode::read, FILE_MAP_READ)
                             | decode_flag(open_mode, OpenMode::write, FILE_MAP_WRITE);
-    file->data = ::MapViewOfFile(file->handles[1], view_access, 0, 0, 0);
-    if (file->data == nullptr)
+    file->view = ::MapViewOfFile(
+        file->handles[1],
+        view_access,
+        static_cast<DWORD>(static_cast<u64>(view_offset) >> 32u),
+        static_cast<DWORD>(static_cast<u64>(view_offset) & 0xFFFFFFFF),
+        static_cast<SIZE_T>(view_size)
+    );
+
+    if (file->view == nullptr)
     {
         log_error("Failed to map file view %" BEE_PRIsv ": %s", BEE_FMT_SV(path), win32_get_last_error_string());
         ::CloseHandle(file->handles[0]);
@@ -767,12 +1038,18 @@ bool mmap_file_map(MemoryMappedFile* file, const PathView& path, const OpenMode
         return false;
     }
 
+    file->view_size = view_size;
+    file->data = static_cast<u8*>(file->view) + (offset - view_offset);
+    file->size = range_size;
+    file->offset = offset;
+    file->file_size = file_size.QuadPart;
+    file->mode = open_mode;
     return true;
 }
 
 bool mmap_file_unmap(MemoryMappedFile* file)
 {
-    if (::UnmapViewOfFile(file->data) == FALSE)
+    if (::UnmapViewOfFile(file->view) == FALSE)
     {
         log_error("Failed to unmap file view: %s", win32_get_last_error_string());
         return false;
@@ -784,6 +1061,52 @@ bool mmap_file_unmap(MemoryMappedFile* file)
     return true;
 }
 
+bool mmap_file_advise(const MemoryMappedFile& file, const MemoryMappedAdvice advice)
+{
+    // Windows only has an equivalent for prefetching - the other hints can only be given when the file is opened
+    if (advice == MemoryMappedAdvice::will_need)
+    {
+        return mmap_file_prefetch(file, 0, file.size);
+    }
+
+    if (advice == MemoryMappedAdvice::dont_need)
+    {
+        // Only drops the pages from the working set - they stay in the standby list until the memory is needed
+        if (::VirtualUnlock(file.data, static_cast<SIZE_T>(file.size)) == FALSE && ::GetLastError() != ERROR_NOT_LOCKED)
+        {
+            log_error("Failed to advise memory mapped file: %s", win32_get_last_error_string());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool mmap_file_prefetch(const MemoryMappedFile& file, const i64 offset, const i64 size)
+{
+    if (BEE_FAIL_F(offset >= 0 && size >= 0 && offset + size <= file.size, "Prefetch range is outside the mapped range"))
+    {
+        return false;
+    }
+
+    if (size == 0)
+    {
+        return true;
+    }
+
+    WIN32_MEMORY_RANGE_ENTRY range{};
+    range.VirtualAddress = static_cast<u8*>(file.data) + offset;
+    range.NumberOfBytes = static_cast<SIZE_T>(size);
+
+    if (::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0) == FALSE)
+    {
+        log_error("Failed to prefetch memory mapped file: %s", win32_get_last_error_string());
+        return false;
+    }
+
+    return true;
+}
+
 
 } // namespace fs
 } // namespace bee
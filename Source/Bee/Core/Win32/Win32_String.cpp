@@ -11,6 +11,7 @@
 #include "Bee/Core/Win32/MinWindows.h"
 
 #include <string.h>
+#include <wchar.h>
 
 namespace bee {
 namespace str {
@@ -24,19 +25,8 @@ namespace str {
  */
 String from_wchar(const wchar_t* wchar_str, Allocator* allocator)
 {
-    const auto byte_count = WideCharToMultiByte(
-        CP_UTF8,    // utf8 codepage
-        0,          // no flags
-        wchar_str,  // src string
-        -1,         // process whole string to get length - assumes null-termination
-        nullptr,    // no buffer - just getting length
-        0,          // no buffer size
-        nullptr,    // default char if unable to match character - use system default
-        nullptr     // we don't need to know if a default char has been used
-    );
-
-    // process whole string to get length - assumes null-termination
-    return from_wchar(wchar_str, byte_count, allocator);
+    // assumes null-termination
+    return from_wchar(wchar_str, static_cast<i32>(::wcslen(wchar_str)), allocator);
 }
 
 String from_wchar(const wchar_t* wchar_str, const i32 byte_size, Allocator* allocator)
@@ -59,24 +49,56 @@ void from_wchar(String* dst, const wchar_t* wchar_str, const i32 byte_size)
     }
 
     const auto offset = dst->size();
-    dst->insert(offset, byte_size, '\0');
+    dst->insert(offset, length, '\0');
+
+    // Most paths and identifiers are pure ASCII so try the vectorized conversion first
+    const auto ascii_count = narrow_ascii(wchar_str, length, dst->data() + offset, length);
+    if (ascii_count == length)
+    {
+        return;
+    }
+
+    const auto remaining = length - ascii_count;
+    const auto remaining_utf8_size = WideCharToMultiByte(
+        CP_UTF8, 0, wchar_str + ascii_count, remaining, nullptr, 0, nullptr, nullptr
+    );
+
+    dst->resize(offset + ascii_count + remaining_utf8_size);
 
     const auto utf8_size = WideCharToMultiByte(
         CP_UTF8,                        // utf-8 codepage
         0,                              // no flags
-        wchar_str,                      // utf16 string
-        length,                         // utf16 string length
-        dst->data() + offset,           // utf8 string
-        byte_size,                      // utf8 string capacity
+        wchar_str + ascii_count,        // utf16 string
+        remaining,                      // utf16 string length
+        dst->data() + offset + ascii_count, // utf8 string
+        remaining_utf8_size,            // utf8 string capacity
         nullptr,                        // default char
         nullptr                         // was the default char used?
     );
 
-    dst->resize(utf8_size);
+    dst->resize(offset + ascii_count + utf8_size);
 }
 
 i32 from_wchar(char* dst, const i32 dst_size, const wchar_t* wchar_str, const i32 wchar_size)
 {
+    if (dst != nullptr && wchar_size > 0)
+    {
+        const auto ascii_count = narrow_ascii(wchar_str, wchar_size, dst, dst_size);
+        if (ascii_count == wchar_size)
+        {
+            return ascii_count;
+        }
+
+        // convert the rest of the string after the ASCII run - otherwise `dst` is too small so fall through and fail
+        if (ascii_count < dst_size)
+        {
+            const auto converted = WideCharToMultiByte(
+                CP_UTF8, 0, wchar_str + ascii_count, wchar_size - ascii_count, dst + ascii_count, dst_size - ascii_count, nullptr, nullptr
+            );
+            return converted > 0 ? ascii_count + converted : 0;
+        }
+    }
+
     return WideCharToMultiByte(
         CP_UTF8,    // utf8 codepage
         0,          // no flags
@@ -97,24 +119,35 @@ wchar_array_t to_wchar(const StringView& src, Allocator* allocator)
         return wchar_array_t(allocator);
     }
 
-    // Get num characters that will be written
-    auto wstring_size = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, src.c_str(), src.size(), nullptr, 0);
-    if (BEE_FAIL_F(wstring_size != 0, "Failed to convert utf8 string to wchar string: %s", win32_get_last_error_string()))
+    /*
+     * A UTF-8 string never has fewer bytes than UTF-16 code units so the byte size is always enough space - this lets
+     * us convert directly into the result without asking the system for the converted size first. Add 1 extra for
+     * null-termination
+     */
+    auto result = wchar_array_t::with_size(src.size() + 1, '\0', allocator);
+
+    const auto ascii_count = widen_ascii(src.c_str(), src.size(), result.data(), src.size());
+    if (ascii_count == src.size())
     {
-        return wchar_array_t(allocator);
+        result.resize(ascii_count); // resize back to string size minus null-terminator
+        return result;
     }
 
-    // Convert to wchar - add 1 extra for null-termination
-    auto result = wchar_array_t::with_size(wstring_size + 1, '\0', allocator);
-    result.resize(wstring_size); // resize back to string size minus null-terminator
-
-    wstring_size = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, src.c_str(), src.size(), result.data(), result.size());
+    const auto wstring_size = MultiByteToWideChar(
+        CP_UTF8,
+        MB_ERR_INVALID_CHARS,
+        src.c_str() + ascii_count,
+        src.size() - ascii_count,
+        result.data() + ascii_count,
+        src.size() - ascii_count
+    );
 
     if (BEE_FAIL_F(wstring_size != 0, "Failed to convert UTF-8 string to wchar string: %s", win32_get_last_error_string()))
     {
         return wchar_array_t(allocator);
     }
 
+    result.resize(ascii_count + wstring_size); // resize back to string size minus null-terminator
     return result;
 }
 
@@ -137,6 +170,14 @@ i32 to_wchar(const StringView& src, wchar_t* buffer, const i32 buffer_size)
         return wstring_size;
     }
 
+    if (wstring_size == src.size() && wstring_size < buffer_size)
+    {
+        // the same number of UTF-16 code units as UTF-8 bytes means the string is pure ASCII
+        widen_ascii(src.c_str(), src.size(), buffer, buffer_size - 1);
+        buffer[wstring_size] = '\0';
+        return wstring_size;
+    }
+
     // Convert to wchar - add 1 extra for null-termination
     wstring_size = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, src.c_str(), src.size(), buffer, buffer_size - 1);
     if (BEE_FAIL_F(wstring_size != 0, "Failed to convert UTF-8 string to wchar string: %s", win32_get_last_error_string()))
@@ -38,14 +38,17 @@ struct DataConnection
 {
     static constexpr i32 default_port = 8888;
     static constexpr i32 max_clients = 16;
+    static constexpr i32 min_compressed_packet_size = 64; // smaller packets aren't worth compressing
 
     DataConnectionFlags                 flags { DataConnectionFlags::invalid };
-    BEE_PAD(4);
+    CompressionCodec                    codec { CompressionCodec::none };
+    BEE_PAD(3);
     SocketAddress                       address;
     socket_t                            socket;
     FixedArray<ThreadData>              thread_data;
     DynamicArray<DataConnectionPacket>  recv_packets;
     DynamicArray<u8>                    recv_buffer;
+    DynamicArray<u8>                    recv_compressed_buffer;
 
     // Server data
     Client                  clients[max_clients];
@@ -225,12 +228,45 @@ Result<void, DataConnectionError> send_packet(DataConnection* connection, const
     msg.type_hash = type->hash;
     msg.serialized_size = serialized_size;
 
+    const auto header_offset = thread.send_buffer.size();
     thread.send_buffer.append({ reinterpret_cast<const u8*>(&msg), sizeof(DataConnectionPacket) });
+
+    if (connection->codec != CompressionCodec::none && serialized_size >= DataConnection::min_compressed_packet_size)
+    {
+        // Compress straight into the send buffer and fall back to sending the raw data if it didn't compress
+        const auto data_offset = thread.send_buffer.size();
+        const auto bound = compress_bound(connection->codec, serialized_size);
+        thread.send_buffer.resize_no_raii(data_offset + bound);
+
+        const auto compressed_size = compress_block(connection->codec, serialized_data, serialized_size, thread.send_buffer.data() + data_offset, bound);
+
+        if (compressed_size > 0 && compressed_size < serialized_size)
+        {
+            auto* header = reinterpret_cast<DataConnectionPacket*>(thread.send_buffer.data() + header_offset);
+            header->codec = connection->codec;
+            header->compressed_size = compressed_size;
+            thread.send_buffer.resize_no_raii(data_offset + compressed_size);
+            return {};
+        }
+
+        thread.send_buffer.resize_no_raii(data_offset);
+    }
+
     thread.send_buffer.append({ static_cast<const u8*>(serialized_data), msg.serialized_size });
 
     return {};
 }
 
+void set_compression(DataConnection* connection, const CompressionCodec codec)
+{
+    connection->codec = codec;
+}
+
+static i32 get_packet_data_size(const DataConnectionPacket& packet)
+{
+    return packet.codec == CompressionCodec::none ? packet.serialized_size : packet.compressed_size;
+}
+
 Result<Allocator*, DataConnectionError> get_packet_allocator(DataConnection* connection)
 {
     if ((connection->flags & DataConnectionFlags::connected) == DataConnectionFlags::invalid)
@@ -241,10 +277,8 @@ Result<Allocator*, DataConnectionError> get_packet_allocator(DataConnection* con
     return &connection->get_thread().packet_allocator;
 }
 
-static Result<void, DataConnectionError> recv_socket(socket_t socket, DynamicArray<DataConnectionPacket>* packets, DynamicArray<u8>* data)
+static Result<void, DataConnectionError> recv_socket(socket_t socket, DynamicArray<DataConnectionPacket>* packets, DynamicArray<u8>* data, DynamicArray<u8>* compressed_data)
 {
-    DataConnectionPacket header{};
-
     // Recv as many serialized packets as we can
     while (true)
     {
@@ -264,21 +298,48 @@ static Result<void, DataConnectionError> recv_socket(socket_t socket, DynamicArr
             return { DataConnectionError::packet_failed };
         }
 
-        // Reserve enough bytes to contain the serialized data
         auto& packet = packets->back();
+        const auto data_size = get_packet_data_size(packet);
+
+        if (packet.serialized_size < 0 || data_size < 0 || packet.codec >= CompressionCodec::count)
+        {
+            packets->pop_back();
+            return { DataConnectionError::packet_failed };
+        }
+
+        // Reserve enough bytes to contain the serialized data
         packet.offset = data->size();
-        data->append(header.serialized_size, 0);
+        data->append(packet.serialized_size, 0);
+
+        // Compressed packets are received into a separate buffer and decompressed into the packet data
+        auto* recv_dst = data->data() + packet.offset;
+        if (packet.codec != CompressionCodec::none)
+        {
+            compressed_data->resize_no_raii(data_size);
+            recv_dst = compressed_data->data();
+        }
 
         // get the serialized data and check that the bytecount received is valid
-        recv_count = socket_recv(socket, data->data() + packet.offset, header.serialized_size);
+        recv_count = socket_recv(socket, recv_dst, data_size);
 
-        if (recv_count != header.serialized_size)
+        bool is_valid = recv_count == data_size;
+        if (is_valid && packet.codec != CompressionCodec::none)
+        {
+            const auto decompressed_size = decompress_block(packet.codec, compressed_data->data(), data_size, data->data() + packet.offset, packet.serialized_size);
+            is_valid = decompressed_size == packet.serialized_size;
+        }
+
+        if (!is_valid)
         {
             // erase the newly received data if recv failed
             data->resize(packet.offset);
             packets->pop_back();
             return { DataConnectionError::packet_failed };
         }
+
+        // packets are always handed out decompressed
+        packet.codec = CompressionCodec::none;
+        packet.compressed_size = 0;
     }
 
     // success
@@ -293,7 +354,7 @@ static Result<void, DataConnectionError> send_connection(DataConnection* connect
         {
             auto* packet = thread.send_buffer.data() + thread.flush_offset;
             auto* header = reinterpret_cast<DataConnectionPacket*>(packet);
-            const i32 packet_size = sizeof(DataConnectionPacket) + header->serialized_size;
+            const i32 packet_size = sizeof(DataConnectionPacket) + get_packet_data_size(*header);
 
             auto res = socket_send(connection->socket, packet, packet_size);
             if (!res)
@@ -378,7 +439,7 @@ static Result<void, DataConnectionError> flush_server(DataConnection* connection
             continue;
         }
 
-        auto recv_result = recv_socket(client.socket, &connection->recv_packets, &connection->recv_buffer);
+        auto recv_result = recv_socket(client.socket, &connection->recv_packets, &connection->recv_buffer, &connection->recv_compressed_buffer);
         if (!recv_result)
         {
             return recv_result.unwrap_error();
@@ -393,7 +454,7 @@ static Result<void, DataConnectionError> flush_client(DataConnection* connection
 {
     // Receive new packets and then send the pending ones
     connection->clear_recv_buffers();
-    auto res = recv_socket(connection->socket, &connection->recv_packets, &connection->recv_buffer);
+    auto res = recv_socket(connection->socket, &connection->recv_packets, &connection->recv_buffer, &connection->recv_compressed_buffer);
     if (!res)
     {
         return res;
@@ -453,6 +514,7 @@ BEE_PLUGIN_API void bee_load_plugin(bee::PluginLoader* loader, const bee::Plugin
     g_module.connect_client = bee::connect_client;
     g_module.disconnect_client = bee::disconnect_client;
     g_module.send_packet = bee::send_packet;
+    g_module.set_compression = bee::set_compression;
     g_module.get_packet_allocator = bee::get_packet_allocator;
     g_module.flush = bee::flush;
     g_module.get_received_data = bee::get_received_data;
@@ -11,6 +11,7 @@
 #include "Bee/Core/Enum.hpp"
 #include "Bee/Core/Move.hpp"
 #include "Bee/Core/Serialization/BinarySerializer.hpp"
+#include "Bee/Core/Compression.hpp"
 
 
 namespace bee {
@@ -59,16 +60,19 @@ struct DataConnectionError
             "DataConnection is already connected",
             "DataConnection is not connected",
             "Max pending client connections reached on server connection",
-            "Data packet format was invalid or missing a header"
+            "Data packet format was invalid, missing a header or failed to decompress"
         );
     }
 };
 
 struct DataConnectionPacket
 {
-    u32 type_hash;
-    i32 offset { 0 };
-    i32 serialized_size { 0 };
+    u32                 type_hash;
+    i32                 offset { 0 };
+    i32                 serialized_size { 0 };
+    i32                 compressed_size { 0 };  // size of the packet data sent over the socket if `codec` isn't `none`
+    CompressionCodec    codec { CompressionCodec::none };
+    BEE_PAD(3);
 };
 
 #define BEE_DATA_CONNECTION_MODULE_NAME "BEE_DATA_CONNECTION"
@@ -94,6 +98,9 @@ struct DataConnectionModule
 
     Result<void, DataConnectionError> (*send_packet)(DataConnection* connection, const Type type, const i32 serialized_size, const void* serialized_data) { nullptr };
 
+    // Packets sent after this call are compressed with `codec` - received packets are always decompressed
+    void (*set_compression)(DataConnection* connection, const CompressionCodec codec) { nullptr };
+
     Result<Allocator*, DataConnectionError> (*get_packet_allocator)(DataConnection* connection) { nullptr };
 
     Result<void, DataConnectionError> (*flush)(DataConnection* connection, const u64 timeout_ms) { nullptr };
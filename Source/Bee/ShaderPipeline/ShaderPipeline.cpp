@@ -88,6 +88,7 @@ struct ShaderPipeline
 static ShaderPipeline* g_shader_pipeline = nullptr;
 
 static AssetPipelineModule* g_asset_pipeline = nullptr;
+static AssetDatabaseModule* g_assetdb = nullptr;
 extern ShaderCompilerModule g_shader_compiler;
 
 
@@ -377,6 +378,22 @@ void unload_shader(Shader* shader)
     }
 }
 
+static void read_shader_artifact(io::Stream* stream, Shader* shader)
+{
+    // Shader artifacts are written as compressed frames by the asset database
+    if (io::CompressedStream::is_compressed(stream))
+    {
+        io::CompressedStream decompressed(stream);
+        StreamSerializer serializer(&decompressed);
+        serialize(SerializerMode::reading, &serializer, shader, temp_allocator());
+    }
+    else
+    {
+        StreamSerializer serializer(stream);
+        serialize(SerializerMode::reading, &serializer, shader, temp_allocator());
+    }
+}
+
 Result<void, AssetPipelineError> shader_loader_load(const GUID guid, const AssetLocation* location, void* user_data, const AssetHandle handle, void* data)
 {
     auto* shader = static_cast<Shader*>(data);
@@ -385,18 +402,30 @@ Result<void, AssetPipelineError> shader_loader_load(const GUID guid, const Asset
     {
         if (stream_info.kind == AssetStreamInfo::Kind::file)
         {
-            auto file = fs::open_file(stream_info.path.view(), fs::OpenMode::read);
-            io::FileStream stream(&file);
-            stream.seek(stream_info.offset, io::SeekOrigin::begin);
-            StreamSerializer serializer(&stream);
-            serialize(SerializerMode::reading, &serializer, shader, temp_allocator());
+            // Artifacts are read straight out of a shared mapping rather than copied through a file stream
+            const auto* mapped = fs::mmap_file_acquire_shared(stream_info.path.view());
+            if (mapped == nullptr)
+            {
+                return { AssetPipelineError::missing_data };
+            }
+
+            // The mapping can be shared with a bundle that's advised for random access so only read ahead the blob
+            // this artifact is stored in rather than changing the advice for the whole file
+            const auto blob_offset = static_cast<i64>(stream_info.offset);
+            const auto blob_size = stream_info.size > 0 ? static_cast<i64>(stream_info.size) : mapped->size - blob_offset;
+            fs::mmap_file_prefetch(*mapped, blob_offset, blob_size);
+
+            // Bundles pack blobs back to back so the stream has to end with this blob - compressed frames are read
+            // from their footer at the end of the stream
+            io::MemoryStream stream(static_cast<const void*>(static_cast<const u8*>(mapped->data) + blob_offset), blob_size);
+            read_shader_artifact(&stream, shader);
+            fs::mmap_file_release_shared(mapped);
         }
         else
         {
             io::MemoryStream stream(stream_info.buffer, stream_info.size);
             stream.seek(stream_info.offset, io::SeekOrigin::begin);
-            StreamSerializer serializer(&stream);
-            serialize(SerializerMode::reading, &serializer, shader, temp_allocator());
+            read_shader_artifact(&stream, shader);
         }
     }
 
@@ -433,6 +462,13 @@ void init(AssetPipeline* asset_pipeline, GpuBackend* gpu, const DeviceHandle dev
         if (res)
         {
             g_shader_pipeline->importer_threads.resize(job_system_worker_count());
+
+            // SPIR-V and the reflected shader data compress well and are loaded often so are worth compressing
+            auto db = g_asset_pipeline->get_asset_database(asset_pipeline);
+            if (db && g_assetdb != nullptr)
+            {
+                g_assetdb->set_artifact_compression(db.unwrap(), get_type<Shader>(), CompressionCodec::lz);
+            }
         }
 
         res = g_asset_pipeline->register_loader(asset_pipeline, &g_shader_pipeline->loader, nullptr);
@@ -556,4 +592,5 @@ BEE_PLUGIN_API void bee_load_plugin(bee::PluginLoader* loader, const bee::Plugin
     loader->set_module(BEE_SHADER_PIPELINE_MODULE_NAME, &g_module, state);
 
     bee::g_asset_pipeline = static_cast<bee::AssetPipelineModule*>(loader->get_module(BEE_ASSET_PIPELINE_MODULE_NAME));
+    bee::g_assetdb = static_cast<bee::AssetDatabaseModule*>(loader->get_module(BEE_ASSET_DATABASE_MODULE_NAME));
 }
\ No newline at end of file
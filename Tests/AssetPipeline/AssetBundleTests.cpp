@@ -0,0 +1,362 @@
+/*
+ *  AssetBundleTests.cpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#include <Bee/AssetPipeline/AssetBundle.hpp>
+#include <Bee/Core/Filesystem.hpp>
+#include <Bee/Core/Hash.hpp>
+#include <Bee/Core/IO.hpp>
+#include <Bee/Core/Random.hpp>
+
+#include <GTest.hpp>
+
+#include <algorithm>
+
+
+class AssetBundleTests : public ::testing::Test
+{
+protected:
+    bee::Path root;
+    bee::Path bundle_path;
+
+    void SetUp() override
+    {
+        root = bee::fs::roots().data.join("AssetBundleTests");
+        if (root.exists())
+        {
+            ASSERT_TRUE(bee::fs::rmdir(root.view(), true));
+        }
+        ASSERT_TRUE(bee::fs::mkdir(root.view()));
+        bundle_path = root.join("Test.bundle");
+    }
+
+    void TearDown() override
+    {
+        bee::fs::rmdir(root.view(), true);
+    }
+
+    // Writes an artifact file the same way the asset database does - named after its content hash
+    bee::u128 add_artifact(const bee::DynamicArray<bee::u8>& data)
+    {
+        const auto hash = bee::get_hash128(data.data(), data.size(), 0);
+        const auto path = root.join(bee::str::to_string(hash).view());
+        EXPECT_EQ(bee::fs::write_all(path.view(), data.data(), data.size()), data.size());
+        return hash;
+    }
+
+    bool write_bundle(const bee::AssetBundleWriteAsset* assets, const bee::i32 count, const bee::CompressionCodec codec = bee::CompressionCodec::none)
+    {
+        bee::AssetBundleWriteInfo info{};
+        info.codec = codec;
+        info.blob_alignment = 64;
+        return bee::write_asset_bundle(bundle_path.view(), info, assets, count, get_artifact_path, &root);
+    }
+
+    static void get_artifact_path(const bee::u128& content_hash, bee::Path* dst, void* user_data)
+    {
+        *dst = static_cast<const bee::Path*>(user_data)->join(bee::str::to_string(content_hash).view());
+    }
+};
+
+static bee::DynamicArray<bee::u8> make_compressible_data(const bee::i32 size, const char* word)
+{
+    bee::DynamicArray<bee::u8> data;
+    for (int i = 0; data.size() < size; ++i)
+    {
+        data.push_back(static_cast<bee::u8>(word[i % strlen(word)]));
+    }
+    return data;
+}
+
+static bee::DynamicArray<bee::u8> make_random_data(const bee::i32 size, const bee::u32 seed)
+{
+    bee::RandomGenerator<bee::Xorshift> random(seed);
+    bee::DynamicArray<bee::u8> data;
+    for (int i = 0; i < size; ++i)
+    {
+        data.push_back(static_cast<bee::u8>(random.random_unsigned_range(0, 255)));
+    }
+    return data;
+}
+
+static bee::AssetBundleArtifact make_artifact(const bee::u128& content_hash, const bee::u32 key)
+{
+    bee::AssetBundleArtifact artifact{};
+    artifact.content_hash = content_hash;
+    artifact.type_hash = 0xBEEF;
+    artifact.key = key;
+    return artifact;
+}
+
+TEST_F(AssetBundleTests, compressed_round_trip)
+{
+    const bee::DynamicArray<bee::u8> contents[] = {
+        make_compressible_data(20000, "vertex fragment uniform "),
+        make_compressible_data(30000, "float4 position sampler "),
+        make_random_data(5000, 11)
+    };
+
+    bee::u128 hashes[bee::static_array_length(contents)];
+    for (int i = 0; i < bee::static_array_length(contents); ++i)
+    {
+        hashes[i] = add_artifact(contents[i]);
+    }
+
+    const bee::AssetBundleArtifact first_artifacts[] = { make_artifact(hashes[0], 0), make_artifact(hashes[2], 1) };
+    const bee::AssetBundleArtifact second_artifacts[] = { make_artifact(hashes[1], 0) };
+
+    bee::AssetBundleWriteAsset assets[2];
+    assets[0].guid = bee::generate_guid();
+    assets[0].name = "Textures/First";
+    assets[0].artifacts = first_artifacts;
+    assets[0].artifact_count = bee::static_array_length(first_artifacts);
+    assets[1].guid = bee::generate_guid();
+    assets[1].name = "Shaders/Second";
+    assets[1].artifacts = second_artifacts;
+    assets[1].artifact_count = bee::static_array_length(second_artifacts);
+
+    ASSERT_TRUE(write_bundle(assets, bee::static_array_length(assets), bee::CompressionCodec::lz));
+
+    const auto bundle = bee::fs::read_all_bytes(bundle_path.view());
+    ASSERT_TRUE(bee::is_valid_asset_bundle(bundle.data(), bundle.size()));
+
+    const auto tables = bee::get_asset_bundle_tables(bundle.data());
+    ASSERT_EQ(tables.header->asset_count, 2);
+    ASSERT_EQ(tables.header->name_count, 2);
+    ASSERT_EQ(tables.header->artifact_count, 3);
+    ASSERT_EQ(tables.header->blob_count, 3);
+
+    int compressed_count = 0;
+
+    for (const auto& src : assets)
+    {
+        const auto asset_index = bee::find_asset_bundle_asset(tables, src.guid);
+        ASSERT_GE(asset_index, 0);
+
+        const auto& asset = tables.assets[asset_index];
+        ASSERT_EQ(asset.guid, src.guid);
+        ASSERT_EQ(asset.artifact_count, src.artifact_count);
+
+        for (int i = 0; i < asset.artifact_count; ++i)
+        {
+            const auto& artifact = tables.artifacts[asset.first_artifact + i];
+            ASSERT_EQ(artifact.content_hash, src.artifacts[i].content_hash);
+            ASSERT_EQ(artifact.key, src.artifacts[i].key);
+            ASSERT_EQ(artifact.type_hash, src.artifacts[i].type_hash);
+
+            const auto& blob = tables.blobs[artifact.blob_index];
+            ASSERT_EQ(blob.content_hash, artifact.content_hash);
+            ASSERT_EQ(blob.offset % tables.header->blob_alignment, 0u);
+
+            const auto content_index = static_cast<int>(std::find(hashes, hashes + bee::static_array_length(hashes), blob.content_hash) - hashes);
+            const auto& expected = contents[content_index];
+            ASSERT_EQ(blob.uncompressed_size, static_cast<bee::u64>(expected.size()));
+
+            const auto* blob_data = bundle.data() + blob.offset;
+            const auto blob_size = static_cast<bee::i64>(blob.size);
+
+            if ((blob.flags & bee::AssetBundleBlobFlags::compressed) == bee::AssetBundleBlobFlags::none)
+            {
+                // Random data doesn't compress so it's stored raw
+                ASSERT_EQ(content_index, 2);
+                ASSERT_EQ(blob_size, expected.size());
+                ASSERT_EQ(memcmp(blob_data, expected.data(), expected.size()), 0);
+                continue;
+            }
+
+            ++compressed_count;
+            ASSERT_LT(blob_size, expected.size());
+
+            bee::DynamicArray<bee::u8> decompressed;
+            decompressed.resize(expected.size());
+
+            // Loaders see only the blobs range so the frame footer is at the end of the stream
+            bee::io::MemoryStream blob_stream(blob_data, blob_size);
+            ASSERT_TRUE(bee::io::CompressedStream::is_compressed(&blob_stream));
+            bee::io::CompressedStream blob_reader(&blob_stream);
+            ASSERT_TRUE(blob_reader.is_valid());
+            ASSERT_EQ(blob_reader.read(decompressed.data(), decompressed.size()), expected.size());
+            ASSERT_EQ(memcmp(decompressed.data(), expected.data(), expected.size()), 0);
+
+            // Reading the frame from a stream over the whole bundle needs its length as other blobs follow it
+            bee::io::MemoryStream bundle_stream(bundle.data(), bundle.size());
+            bundle_stream.seek(static_cast<bee::i64>(blob.offset), bee::io::SeekOrigin::begin);
+            bee::io::CompressedStream bundle_reader(&bundle_stream, blob_size);
+            ASSERT_TRUE(bundle_reader.is_valid());
+            decompressed.clear();
+            decompressed.resize(expected.size());
+            ASSERT_EQ(bundle_reader.read(decompressed.data(), decompressed.size()), expected.size());
+            ASSERT_EQ(memcmp(decompressed.data(), expected.data(), expected.size()), 0);
+        }
+    }
+
+    ASSERT_EQ(compressed_count, 2);
+}
+
+TEST_F(AssetBundleTests, find_assets)
+{
+    bee::DynamicArray<bee::AssetBundleArtifact> artifacts;
+    for (int i = 0; i < 8; ++i)
+    {
+        artifacts.push_back(make_artifact(add_artifact(make_random_data(100, i + 1)), 0));
+    }
+
+    const char* names[] = { "Textures/Grass", "Textures/Rock", "Shaders/Terrain", "", "Meshes/Tree", "Meshes/Rock", "Audio/Wind", "" };
+    bee::AssetBundleWriteAsset assets[bee::static_array_length(names)];
+
+    for (int i = 0; i < bee::static_array_length(assets); ++i)
+    {
+        assets[i].guid = bee::generate_guid();
+        assets[i].name = names[i];
+        assets[i].artifacts = &artifacts[i];
+        assets[i].artifact_count = 1;
+    }
+
+    ASSERT_TRUE(write_bundle(assets, bee::static_array_length(assets)));
+
+    const auto bundle = bee::fs::read_all_bytes(bundle_path.view());
+    ASSERT_TRUE(bee::is_valid_asset_bundle(bundle.data(), bundle.size()));
+
+    const auto tables = bee::get_asset_bundle_tables(bundle.data());
+    ASSERT_EQ(tables.header->asset_count, 8);
+
+    // Unnamed assets can only be found by GUID
+    ASSERT_EQ(tables.header->name_count, 6);
+
+    for (int i = 0; i < bee::static_array_length(assets); ++i)
+    {
+        const auto by_guid = bee::find_asset_bundle_asset(tables, assets[i].guid);
+        ASSERT_GE(by_guid, 0);
+        ASSERT_EQ(tables.assets[by_guid].guid, assets[i].guid);
+        ASSERT_EQ(tables.artifacts[tables.assets[by_guid].first_artifact].content_hash, artifacts[i].content_hash);
+
+        if (!assets[i].name.empty())
+        {
+            ASSERT_EQ(bee::find_asset_bundle_asset(tables, assets[i].name), by_guid);
+        }
+    }
+
+    ASSERT_EQ(bee::find_asset_bundle_asset(tables, bee::generate_guid()), -1);
+    ASSERT_EQ(bee::find_asset_bundle_asset(tables, bee::GUID{}), -1);
+    ASSERT_EQ(bee::find_asset_bundle_asset(tables, "Textures/Missing"), -1);
+    ASSERT_EQ(bee::find_asset_bundle_asset(tables, "Textures/Gras"), -1);
+}
+
+TEST_F(AssetBundleTests, shared_artifacts_are_stored_once)
+{
+    const auto shared = add_artifact(make_random_data(1000, 1));
+    const auto first_unique = add_artifact(make_random_data(1000, 2));
+    const auto second_unique = add_artifact(make_random_data(1000, 3));
+
+    const bee::AssetBundleArtifact first_artifacts[] = { make_artifact(shared, 0), make_artifact(first_unique, 1) };
+    const bee::AssetBundleArtifact second_artifacts[] = { make_artifact(second_unique, 0), make_artifact(shared, 1) };
+
+    bee::AssetBundleWriteAsset assets[2];
+    assets[0].guid = bee::generate_guid();
+    assets[0].artifacts = first_artifacts;
+    assets[0].artifact_count = bee::static_array_length(first_artifacts);
+    assets[1].guid = bee::generate_guid();
+    assets[1].artifacts = second_artifacts;
+    assets[1].artifact_count = bee::static_array_length(second_artifacts);
+
+    ASSERT_TRUE(write_bundle(assets, bee::static_array_length(assets)));
+
+    const auto bundle = bee::fs::read_all_bytes(bundle_path.view());
+    ASSERT_TRUE(bee::is_valid_asset_bundle(bundle.data(), bundle.size()));
+
+    const auto tables = bee::get_asset_bundle_tables(bundle.data());
+    ASSERT_EQ(tables.header->artifact_count, 4);
+    ASSERT_EQ(tables.header->blob_count, 3);
+
+    const auto& first = tables.assets[bee::find_asset_bundle_asset(tables, assets[0].guid)];
+    const auto& second = tables.assets[bee::find_asset_bundle_asset(tables, assets[1].guid)];
+    const auto& first_shared = tables.artifacts[first.first_artifact];
+    const auto& second_shared = tables.artifacts[second.first_artifact + 1];
+
+    ASSERT_EQ(first_shared.content_hash, shared);
+    ASSERT_EQ(second_shared.content_hash, shared);
+    ASSERT_EQ(first_shared.blob_index, second_shared.blob_index);
+    ASSERT_NE(tables.artifacts[first.first_artifact + 1].blob_index, tables.artifacts[second.first_artifact].blob_index);
+}
+
+TEST_F(AssetBundleTests, duplicate_assets_are_rejected)
+{
+    const bee::AssetBundleArtifact artifacts[] = { make_artifact(add_artifact(make_random_data(100, 1)), 0) };
+
+    bee::AssetBundleWriteAsset assets[2];
+    assets[0].guid = bee::generate_guid();
+    assets[0].artifacts = artifacts;
+    assets[0].artifact_count = 1;
+    assets[1] = assets[0];
+
+    ASSERT_FALSE(write_bundle(assets, bee::static_array_length(assets)));
+}
+
+TEST_F(AssetBundleTests, corrupt_bundles_are_rejected)
+{
+    const bee::AssetBundleArtifact artifacts[] = { make_artifact(add_artifact(make_random_data(1000, 1)), 0) };
+
+    bee::AssetBundleWriteAsset asset;
+    asset.guid = bee::generate_guid();
+    asset.name = "Corrupt";
+    asset.artifacts = artifacts;
+    asset.artifact_count = 1;
+
+    ASSERT_TRUE(write_bundle(&asset, 1));
+
+    const auto bundle = bee::fs::read_all_bytes(bundle_path.view());
+    ASSERT_TRUE(bee::is_valid_asset_bundle(bundle.data(), bundle.size()));
+    ASSERT_FALSE(bee::is_valid_asset_bundle(bundle.data(), bundle.size() - 1));
+    ASSERT_FALSE(bee::is_valid_asset_bundle(bundle.data(), sizeof(bee::AssetBundleHeader) - 1));
+    ASSERT_FALSE(bee::is_valid_asset_bundle(nullptr, bundle.size()));
+
+    // Each corruption is applied to a fresh copy of the bundle
+    const auto is_valid_with = [&](auto corrupt)
+    {
+        bee::DynamicArray<bee::u8> copy;
+        copy.resize(bundle.size());
+        memcpy(copy.data(), bundle.data(), bundle.size());
+
+        const auto& header = *reinterpret_cast<const bee::AssetBundleHeader*>(copy.data());
+        corrupt(copy.data(), header);
+        return bee::is_valid_asset_bundle(copy.data(), copy.size());
+    };
+
+    ASSERT_FALSE(is_valid_with([](bee::u8* data, const bee::AssetBundleHeader& /* header */)
+    {
+        reinterpret_cast<bee::AssetBundleHeader*>(data)->magic = 0;
+    }));
+
+    ASSERT_FALSE(is_valid_with([](bee::u8* data, const bee::AssetBundleHeader& header)
+    {
+        reinterpret_cast<bee::AssetBundleHeader*>(data)->blobs_offset = header.size;
+    }));
+
+    ASSERT_FALSE(is_valid_with([](bee::u8* data, const bee::AssetBundleHeader& /* header */)
+    {
+        reinterpret_cast<bee::AssetBundleHeader*>(data)->artifact_count = -1;
+    }));
+
+    ASSERT_FALSE(is_valid_with([](bee::u8* data, const bee::AssetBundleHeader& header)
+    {
+        reinterpret_cast<bee::AssetBundleAsset*>(data + header.assets_offset)->first_artifact = header.artifact_count;
+    }));
+
+    ASSERT_FALSE(is_valid_with([](bee::u8* data, const bee::AssetBundleHeader& header)
+    {
+        reinterpret_cast<bee::AssetBundleName*>(data + header.names_offset)->string_size = header.strings_size + 1;
+    }));
+
+    ASSERT_FALSE(is_valid_with([](bee::u8* data, const bee::AssetBundleHeader& header)
+    {
+        reinterpret_cast<bee::AssetBundleArtifact*>(data + header.artifacts_offset)->blob_index = header.blob_count;
+    }));
+
+    ASSERT_FALSE(is_valid_with([](bee::u8* data, const bee::AssetBundleHeader& header)
+    {
+        reinterpret_cast<bee::AssetBundleBlob*>(data + header.blobs_offset)->offset = header.size - 1;
+    }));
+}
@@ -0,0 +1,249 @@
+/*
+ *  AsyncIOTests.cpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#include <Bee/Core/AsyncIO.hpp>
+#include <Bee/Core/Jobs/JobSystem.hpp>
+
+#include <GTest.hpp>
+
+
+class AsyncIOTests : public ::testing::TestWithParam<bool>
+{
+protected:
+    static constexpr bee::i32 chunk_size = 4096;
+    static constexpr bee::i32 chunk_count = 64;
+
+    bee::Path filepath;
+
+    static void SetUpTestSuite()
+    {
+        bee::JobSystemInitInfo info{};
+        info.num_workers = bee::JobSystemInitInfo::auto_worker_count;
+        bee::job_system_init(info);
+    }
+
+    static void TearDownTestSuite()
+    {
+        bee::job_system_shutdown();
+    }
+
+    void SetUp() override
+    {
+        bee::fs::AsyncIOInitInfo info{};
+        info.queue_depth = 16; // smaller than the chunk count so batches have to be split
+        info.force_thread_pool = GetParam();
+        ASSERT_TRUE(bee::fs::async_io_init(info));
+
+        if (GetParam())
+        {
+            ASSERT_EQ(bee::fs::async_io_backend(), bee::fs::AsyncIOBackend::thread_pool);
+        }
+
+        filepath = bee::fs::roots().data.join("AsyncIOTest.bin");
+
+        bee::DynamicArray<bee::u8> data;
+        data.resize(chunk_size * chunk_count);
+        for (int i = 0; i < data.size(); ++i)
+        {
+            data[i] = static_cast<bee::u8>(i * 31 + i / chunk_size);
+        }
+
+        ASSERT_EQ(bee::fs::write_all(filepath.view(), data.data(), data.size()), data.size());
+    }
+
+    void TearDown() override
+    {
+        bee::fs::async_io_shutdown();
+
+        if (filepath.exists())
+        {
+            bee::fs::remove(filepath.view());
+        }
+    }
+
+    static bool is_expected_chunk(const bee::u8* data, const int chunk)
+    {
+        for (int i = 0; i < chunk_size; ++i)
+        {
+            const auto offset = chunk * chunk_size + i;
+            if (data[i] != static_cast<bee::u8>(offset * 31 + offset / chunk_size))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+TEST_P(AsyncIOTests, batched_reads_complete_job_group)
+{
+    auto file = bee::fs::open_file(filepath.view(), bee::fs::OpenMode::read);
+    ASSERT_TRUE(file.is_valid());
+
+    bee::fs::AsyncIORequest requests[chunk_count];
+    bee::DynamicArray<bee::u8> buffer;
+    buffer.resize(chunk_size * chunk_count);
+
+    // read the chunks in reverse order to check they land at the right offsets
+    bee::JobGroup group;
+    for (int i = chunk_count - 1; i >= 0; --i)
+    {
+        ASSERT_TRUE(bee::fs::async_read(&requests[i], file, i * chunk_size, chunk_size, buffer.data() + i * chunk_size, &group));
+    }
+
+    bee::fs::async_io_submit();
+    bee::job_wait(&group);
+
+    for (int i = 0; i < chunk_count; ++i)
+    {
+        ASSERT_EQ(requests[i].get_status(), bee::fs::AsyncIOStatus::complete);
+        ASSERT_EQ(requests[i].bytes_transferred(), chunk_size);
+        ASSERT_TRUE(is_expected_chunk(buffer.data() + i * chunk_size, i));
+    }
+}
+
+TEST_P(AsyncIOTests, write_then_read)
+{
+    static constexpr char test_string[] = "This is a test string";
+    static constexpr bee::i64 offset = chunk_size * 3 + 7;
+
+    auto file = bee::fs::open_file(filepath.view(), bee::fs::OpenMode::read | bee::fs::OpenMode::write);
+    ASSERT_TRUE(file.is_valid());
+
+    bee::fs::AsyncIORequest request;
+    ASSERT_TRUE(bee::fs::async_write(&request, file, offset, test_string, sizeof(test_string)));
+    ASSERT_TRUE(bee::fs::async_io_wait(&request));
+    ASSERT_EQ(request.bytes_transferred(), sizeof(test_string));
+
+    char read_string[sizeof(test_string)] = {};
+    ASSERT_TRUE(bee::fs::async_read(&request, file, offset, sizeof(read_string), read_string));
+    ASSERT_TRUE(bee::fs::async_io_wait(&request));
+    ASSERT_STREQ(read_string, test_string);
+}
+
+TEST_P(AsyncIOTests, read_past_end_of_file)
+{
+    auto file = bee::fs::open_file(filepath.view(), bee::fs::OpenMode::read);
+    ASSERT_TRUE(file.is_valid());
+
+    bee::u8 buffer[chunk_size];
+    bee::fs::AsyncIORequest request;
+    ASSERT_TRUE(bee::fs::async_read(&request, file, chunk_size * chunk_count - 16, chunk_size, buffer));
+    ASSERT_TRUE(bee::fs::async_io_wait(&request));
+    ASSERT_EQ(request.bytes_transferred(), 16);
+}
+
+TEST_P(AsyncIOTests, failed_read)
+{
+    // reading from a write-only file fails before reaching the end of the file so it mustn't look like a short read
+    auto file = bee::fs::open_file(filepath.view(), bee::fs::OpenMode::write);
+    ASSERT_TRUE(file.is_valid());
+
+    bee::u8 buffer[chunk_size] = {};
+    ASSERT_EQ(bee::fs::write(file, buffer, chunk_size), chunk_size);
+    bee::fs::AsyncIORequest request;
+    ASSERT_TRUE(bee::fs::async_read(&request, file, 0, chunk_size, buffer));
+    ASSERT_FALSE(bee::fs::async_io_wait(&request));
+    ASSERT_EQ(request.get_status(), bee::fs::AsyncIOStatus::failed);
+    ASSERT_NE(request.error, 0);
+    ASSERT_EQ(request.bytes_transferred(), 0);
+}
+
+TEST_P(AsyncIOTests, wait_for_each_request)
+{
+    auto file = bee::fs::open_file(filepath.view(), bee::fs::OpenMode::read);
+    ASSERT_TRUE(file.is_valid());
+
+    bee::fs::AsyncIORequest requests[chunk_count];
+    bee::DynamicArray<bee::u8> buffer;
+    buffer.resize(chunk_size * chunk_count);
+
+    // more requests than the queue depth so submitting has to wait for earlier requests to complete
+    for (int i = 0; i < chunk_count; ++i)
+    {
+        ASSERT_TRUE(bee::fs::async_read(&requests[i], file, i * chunk_size, chunk_size, buffer.data() + i * chunk_size));
+    }
+
+    for (int i = chunk_count - 1; i >= 0; --i)
+    {
+        ASSERT_TRUE(bee::fs::async_io_wait(&requests[i]));
+        ASSERT_EQ(requests[i].bytes_transferred(), chunk_size);
+        ASSERT_TRUE(is_expected_chunk(buffer.data() + i * chunk_size, i));
+    }
+}
+
+TEST_P(AsyncIOTests, registered_buffers)
+{
+    auto file = bee::fs::open_file(filepath.view(), bee::fs::OpenMode::read);
+    ASSERT_TRUE(file.is_valid());
+
+    bee::DynamicArray<bee::u8> buffer;
+    buffer.resize(chunk_size * 4);
+
+    bee::fs::AsyncIOBuffer registered{};
+    registered.data = buffer.data();
+    registered.size = buffer.size();
+    ASSERT_TRUE(bee::fs::async_io_register_buffers(&registered, 1));
+
+    bee::fs::AsyncIORequest requests[4];
+    bee::JobGroup group;
+
+    for (int i = 0; i < bee::static_array_length(requests); ++i)
+    {
+        const auto chunk = i * 5;
+        ASSERT_TRUE(bee::fs::async_read(&requests[i], file, chunk * chunk_size, chunk_size, buffer.data() + i * chunk_size, &group));
+        ASSERT_EQ(requests[i].buffer_index, 0);
+    }
+
+    bee::fs::async_io_submit();
+    bee::job_wait(&group);
+
+    for (int i = 0; i < bee::static_array_length(requests); ++i)
+    {
+        ASSERT_EQ(requests[i].get_status(), bee::fs::AsyncIOStatus::complete);
+        ASSERT_TRUE(is_expected_chunk(buffer.data() + i * chunk_size, i * 5));
+    }
+
+    bee::fs::async_io_unregister_buffers();
+}
+
+struct DoubleBufferedReadCheck
+{
+    const bee::u8*  expected { nullptr };
+    const void*     last_chunk { nullptr };
+    bee::i64        next_offset { 0 };
+    bool            matched { true };
+    bool            swapped_buffers { false };
+};
+
+TEST_P(AsyncIOTests, read_chunked_double_buffered)
+{
+    const auto expected = bee::fs::read_all_bytes(filepath.view());
+
+    DoubleBufferedReadCheck check{};
+    check.expected = expected.data();
+
+    bee::fs::ChunkedReadInfo info{};
+    info.chunk_size = chunk_size * 5; // doesn't divide the file so the last chunk is short
+    info.user_data = &check;
+    info.callback = [](const void* chunk, const bee::i64 size, const bee::i64 offset, void* user_data)
+    {
+        auto* check = static_cast<DoubleBufferedReadCheck*>(user_data);
+        check->matched = check->matched && offset == check->next_offset && memcmp(chunk, check->expected + offset, size) == 0;
+        check->swapped_buffers = check->swapped_buffers || (check->last_chunk != nullptr && chunk != check->last_chunk);
+        check->last_chunk = chunk;
+        check->next_offset = offset + size;
+        return true;
+    };
+
+    ASSERT_EQ(bee::fs::read_chunked(filepath.view(), info), expected.size());
+    ASSERT_TRUE(check.matched);
+    ASSERT_TRUE(check.swapped_buffers);
+    ASSERT_EQ(check.next_offset, expected.size());
+}
+
+INSTANTIATE_TEST_SUITE_P(AsyncIOBackends, AsyncIOTests, ::testing::Values(false, true));
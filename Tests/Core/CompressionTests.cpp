@@ -0,0 +1,353 @@
+/*
+ *  CompressionTests.cpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#include <Bee/Core/Compression.hpp>
+#include <Bee/Core/Filesystem.hpp>
+#include <Bee/Core/Jobs/JobSystem.hpp>
+#include <Bee/Core/Math/Math.hpp>
+#include <Bee/Core/Random.hpp>
+#include <Bee/Core/Time.hpp>
+
+#include <GTest.hpp>
+
+
+class CompressionTests : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        bee::JobSystemInitInfo info{};
+        info.num_workers = bee::JobSystemInitInfo::auto_worker_count;
+        bee::job_system_init(info);
+    }
+
+    static void TearDownTestSuite()
+    {
+        bee::job_system_shutdown();
+    }
+};
+
+// Generates data that's roughly as compressible as cooked text assets - runs of repeated words mixed with noise
+static bee::DynamicArray<bee::u8> make_test_data(const bee::i32 size, const bee::u32 seed = 23)
+{
+    static constexpr const char* words[] = { "vertex", "fragment", "float4", "position", "uniform", "sampler", " ", "\n", "{", "}" };
+    static constexpr int word_count = bee::static_array_length(words);
+
+    bee::RandomGenerator<bee::Xorshift> random(seed);
+    bee::DynamicArray<bee::u8> data;
+    data.reserve(size);
+
+    while (data.size() < size)
+    {
+        if (random.random_unsigned_range(0, 8) == 0)
+        {
+            data.push_back(static_cast<bee::u8>(random.random_unsigned_range(0, 255)));
+            continue;
+        }
+
+        const auto* word = words[random.random_unsigned_range(0, word_count - 1)];
+        for (int i = 0; word[i] != '\0' && data.size() < size; ++i)
+        {
+            data.push_back(static_cast<bee::u8>(word[i]));
+        }
+    }
+
+    return data;
+}
+
+TEST_F(CompressionTests, block_round_trip)
+{
+    const auto src = make_test_data(100000);
+
+    bee::DynamicArray<bee::u8> compressed;
+    compressed.resize(bee::compress_bound(bee::CompressionCodec::lz, src.size()));
+    const auto compressed_size = bee::compress_block(bee::CompressionCodec::lz, src.data(), src.size(), compressed.data(), compressed.size());
+    ASSERT_GT(compressed_size, 0);
+    ASSERT_LT(compressed_size, src.size());
+
+    bee::DynamicArray<bee::u8> decompressed;
+    decompressed.resize(src.size());
+    ASSERT_EQ(bee::decompress_block(bee::CompressionCodec::lz, compressed.data(), compressed_size, decompressed.data(), decompressed.size()), src.size());
+    ASSERT_EQ(memcmp(src.data(), decompressed.data(), src.size()), 0);
+
+    // Empty and tiny blocks are stored as literals only
+    const bee::u8 tiny[] = { 1, 2, 3 };
+    bee::u8 tiny_compressed[32]; // must be at least compress_bound(lz, 3)
+    bee::u8 tiny_decompressed[3];
+    const auto tiny_size = bee::compress_block(bee::CompressionCodec::lz, tiny, 3, tiny_compressed, bee::static_array_length(tiny_compressed));
+    ASSERT_EQ(bee::decompress_block(bee::CompressionCodec::lz, tiny_compressed, tiny_size, tiny_decompressed, 3), 3);
+    ASSERT_EQ(memcmp(tiny, tiny_decompressed, 3), 0);
+
+    // Not enough space for the worst case
+    ASSERT_EQ(bee::compress_block(bee::CompressionCodec::lz, src.data(), src.size(), compressed.data(), 16), 0);
+}
+
+TEST_F(CompressionTests, corrupt_blocks_are_rejected)
+{
+    const auto src = make_test_data(4096);
+
+    bee::DynamicArray<bee::u8> compressed;
+    compressed.resize(bee::compress_bound(bee::CompressionCodec::lz, src.size()));
+    const auto compressed_size = bee::compress_block(bee::CompressionCodec::lz, src.data(), src.size(), compressed.data(), compressed.size());
+
+    // Destination too small
+    bee::DynamicArray<bee::u8> decompressed;
+    decompressed.resize(src.size());
+    ASSERT_EQ(bee::decompress_block(bee::CompressionCodec::lz, compressed.data(), compressed_size, decompressed.data(), src.size() / 2), -1);
+
+    // Truncated input
+    ASSERT_EQ(bee::decompress_block(bee::CompressionCodec::lz, compressed.data(), compressed_size / 2, decompressed.data(), decompressed.size()), -1);
+
+    // Random garbage must never read or write out of bounds - it either fails or produces some output
+    bee::RandomGenerator<bee::Xorshift> random(99);
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto garbage = compressed;
+        for (int j = 0; j < 8; ++j)
+        {
+            garbage[static_cast<int>(random.random_unsigned_range(0, compressed_size - 1))] = static_cast<bee::u8>(random.random_unsigned_range(0, 255));
+        }
+        const auto result = bee::decompress_block(bee::CompressionCodec::lz, garbage.data(), compressed_size, decompressed.data(), decompressed.size());
+        ASSERT_LE(result, decompressed.size());
+    }
+}
+
+TEST_F(CompressionTests, frame_round_trip)
+{
+    static constexpr bee::i32 block_size = 16 * 1024;
+
+    const auto src = make_test_data(block_size * 10 + 123);
+
+    bee::DynamicArray<bee::u8> frame;
+    ASSERT_TRUE(bee::compress_frame(bee::CompressionCodec::lz, src.data(), src.size(), &frame, block_size));
+    ASSERT_TRUE(bee::is_compressed_frame(frame.data(), frame.size()));
+    ASSERT_EQ(bee::get_decompressed_frame_size(frame.data(), frame.size()), src.size());
+    ASSERT_LT(frame.size(), src.size());
+
+    bee::DynamicArray<bee::u8> decompressed;
+    decompressed.resize(src.size());
+    ASSERT_TRUE(bee::decompress_frame(frame.data(), frame.size(), decompressed.data(), decompressed.size()));
+    ASSERT_EQ(memcmp(src.data(), decompressed.data(), src.size()), 0);
+
+    // Decompress each block in its own job
+    bee::JobGroup group{};
+    memset(decompressed.data(), 0, decompressed.size());
+    ASSERT_TRUE(bee::decompress_frame(frame.data(), frame.size(), decompressed.data(), decompressed.size(), &group));
+    ASSERT_EQ(memcmp(src.data(), decompressed.data(), src.size()), 0);
+
+    // Truncated frames are rejected
+    ASSERT_FALSE(bee::is_compressed_frame(frame.data(), frame.size() - 1));
+    ASSERT_FALSE(bee::decompress_frame(frame.data(), frame.size() - 1, decompressed.data(), decompressed.size()));
+
+    // Too small a destination is rejected
+    ASSERT_FALSE(bee::decompress_frame(frame.data(), frame.size(), decompressed.data(), decompressed.size() - 1));
+
+    // Corrupting a compressed block fails in both the serial and parallel path
+    frame[sizeof(bee::CompressedFrameHeader) + 10] ^= 0xFF;
+    frame[sizeof(bee::CompressedFrameHeader) + 11] ^= 0xFF;
+    bee::DynamicArray<bee::u8> expected;
+    expected.resize(src.size());
+    const auto serial_result = bee::decompress_frame(frame.data(), frame.size(), expected.data(), expected.size());
+    const auto parallel_result = bee::decompress_frame(frame.data(), frame.size(), decompressed.data(), decompressed.size(), &group);
+    ASSERT_EQ(serial_result, parallel_result);
+}
+
+TEST_F(CompressionTests, compressed_stream)
+{
+    static constexpr bee::i32 block_size = 4096;
+
+    const auto src = make_test_data(block_size * 5 + 17);
+
+    bee::DynamicArray<bee::u8> frame;
+    bee::io::MemoryStream frame_stream(&frame);
+    {
+        bee::io::CompressedStream writer(&frame_stream, bee::CompressionCodec::lz, block_size);
+        ASSERT_TRUE(writer.is_valid());
+
+        // Write in odd-sized chunks to cross block boundaries
+        bee::i64 written = 0;
+        while (written < src.size())
+        {
+            const auto chunk = bee::math::min<bee::i64>(1000, src.size() - written);
+            ASSERT_EQ(writer.write(src.data() + written, chunk), chunk);
+            written += chunk;
+        }
+
+        ASSERT_EQ(writer.size(), src.size());
+        ASSERT_TRUE(writer.finish());
+        ASSERT_EQ(writer.block_count(), 6);
+        ASSERT_EQ(writer.compressed_size(), frame.size());
+    }
+
+    frame_stream.seek(0, bee::io::SeekOrigin::begin);
+    ASSERT_TRUE(bee::io::CompressedStream::is_compressed(&frame_stream));
+    ASSERT_EQ(frame_stream.offset(), 0);
+
+    bee::io::CompressedStream reader(&frame_stream);
+    ASSERT_TRUE(reader.is_valid());
+    ASSERT_EQ(reader.size(), src.size());
+    ASSERT_EQ(reader.codec(), bee::CompressionCodec::lz);
+
+    bee::DynamicArray<bee::u8> decompressed;
+    decompressed.resize(src.size());
+    ASSERT_EQ(reader.read(decompressed.data(), decompressed.size()), src.size());
+    ASSERT_EQ(memcmp(src.data(), decompressed.data(), src.size()), 0);
+
+    // Reading past the end returns nothing
+    bee::u8 byte = 0;
+    ASSERT_EQ(reader.read(&byte, 1), 0);
+
+    // Seek into the middle of a block and read across the boundary into the next one
+    const bee::i64 seek_offset = block_size * 3 - 100;
+    ASSERT_EQ(reader.seek(seek_offset, bee::io::SeekOrigin::begin), seek_offset);
+    bee::u8 range[200];
+    ASSERT_EQ(reader.read(range, 200), 200);
+    ASSERT_EQ(memcmp(range, src.data() + seek_offset, 200), 0);
+
+    ASSERT_EQ(reader.seek(-50, bee::io::SeekOrigin::end), src.size() - 50);
+    ASSERT_EQ(reader.read(range, 200), 50);
+    ASSERT_EQ(memcmp(range, src.data() + src.size() - 50, 50), 0);
+
+    // Uncompressed data isn't detected as a frame
+    bee::io::MemoryStream raw_stream(src.data(), src.size());
+    ASSERT_FALSE(bee::io::CompressedStream::is_compressed(&raw_stream));
+}
+
+TEST_F(CompressionTests, compressed_stream_followed_by_other_data)
+{
+    const auto first = make_test_data(10000, 1);
+    const auto second = make_test_data(20000, 2);
+
+    // Two frames packed back to back like blobs in an asset bundle
+    bee::DynamicArray<bee::u8> first_frame;
+    bee::DynamicArray<bee::u8> second_frame;
+    ASSERT_TRUE(bee::compress_frame(bee::CompressionCodec::lz, first.data(), first.size(), &first_frame, 4096));
+    ASSERT_TRUE(bee::compress_frame(bee::CompressionCodec::lz, second.data(), second.size(), &second_frame, 4096));
+
+    bee::DynamicArray<bee::u8> packed;
+    packed.append(first_frame.const_span());
+    packed.append(second_frame.const_span());
+
+    bee::io::MemoryStream packed_stream(packed.data(), packed.size());
+    bee::io::CompressedStream reader(&packed_stream, first_frame.size());
+    ASSERT_TRUE(reader.is_valid());
+    ASSERT_EQ(reader.size(), first.size());
+
+    bee::DynamicArray<bee::u8> decompressed;
+    decompressed.resize(first.size());
+    ASSERT_EQ(reader.read(decompressed.data(), decompressed.size()), first.size());
+    ASSERT_EQ(memcmp(first.data(), decompressed.data(), first.size()), 0);
+
+    // Without the frame length the footer is read from the end of the stream, which belongs to the second frame
+    packed_stream.seek(0, bee::io::SeekOrigin::begin);
+    bee::io::CompressedStream unbounded_reader(&packed_stream);
+    ASSERT_FALSE(unbounded_reader.is_valid());
+
+    // A frame length past the end of the stream is rejected
+    packed_stream.seek(first_frame.size(), bee::io::SeekOrigin::begin);
+    bee::io::CompressedStream truncated_reader(&packed_stream, second_frame.size() + 1);
+    ASSERT_FALSE(truncated_reader.is_valid());
+}
+
+TEST_F(CompressionTests, incompressible_blocks_are_stored_raw)
+{
+    bee::RandomGenerator<bee::Xorshift> random(7);
+    bee::DynamicArray<bee::u8> src;
+    for (int i = 0; i < 50000; ++i)
+    {
+        src.push_back(static_cast<bee::u8>(random.random_unsigned_range(0, 255)));
+    }
+
+    bee::DynamicArray<bee::u8> frame;
+    ASSERT_TRUE(bee::compress_frame(bee::CompressionCodec::lz, src.data(), src.size(), &frame, 8192));
+
+    // Only the frame overhead should be added
+    const auto overhead = sizeof(bee::CompressedFrameHeader) + sizeof(bee::CompressedFrameFooter) + 7 * sizeof(bee::CompressedBlockInfo);
+    ASSERT_EQ(static_cast<size_t>(frame.size()), src.size() + overhead);
+
+    bee::DynamicArray<bee::u8> decompressed;
+    decompressed.resize(src.size());
+    ASSERT_TRUE(bee::decompress_frame(frame.data(), frame.size(), decompressed.data(), decompressed.size()));
+    ASSERT_EQ(memcmp(src.data(), decompressed.data(), src.size()), 0);
+}
+
+TEST_F(CompressionTests, benchmark)
+{
+    struct Sample
+    {
+        const char*                 name { nullptr };
+        bee::DynamicArray<bee::u8>  data;
+    };
+
+    bee::DynamicArray<Sample> samples;
+
+    // Real cooked assets if they're available next to the binaries
+    const char* asset_paths[] = { "Shaders/ImGui.bsc", "Materials/ImGui.mat" };
+    for (const char* relative_path : asset_paths)
+    {
+        const auto path = bee::fs::roots().assets.join(relative_path);
+        if (!path.exists())
+        {
+            continue;
+        }
+
+        auto bytes = bee::fs::read_all_bytes(path.view());
+        samples.emplace_back();
+        samples.back().name = relative_path;
+        samples.back().data.append({ bytes.data(), bytes.size() });
+    }
+
+    samples.emplace_back();
+    samples.back().name = "generated (8MB)";
+    samples.back().data = make_test_data(8 * 1024 * 1024);
+
+    bee::JobGroup group{};
+
+    for (auto& sample : samples)
+    {
+        const auto& src = sample.data;
+        const auto iterations = bee::math::max(1, (32 * 1024 * 1024) / bee::math::max(1, src.size()));
+        const auto total_mb = static_cast<double>(src.size()) * iterations / (1024.0 * 1024.0);
+
+        bee::DynamicArray<bee::u8> frame;
+        auto begin = bee::time::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            ASSERT_TRUE(bee::compress_frame(bee::CompressionCodec::lz, src.data(), src.size(), &frame));
+        }
+        const auto compress_s = bee::TimePoint(bee::time::now() - begin).total_seconds();
+
+        bee::DynamicArray<bee::u8> decompressed;
+        decompressed.resize(src.size());
+        begin = bee::time::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            ASSERT_TRUE(bee::decompress_frame(frame.data(), frame.size(), decompressed.data(), decompressed.size()));
+        }
+        const auto decompress_s = bee::TimePoint(bee::time::now() - begin).total_seconds();
+
+        begin = bee::time::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            ASSERT_TRUE(bee::decompress_frame(frame.data(), frame.size(), decompressed.data(), decompressed.size(), &group));
+        }
+        const auto parallel_s = bee::TimePoint(bee::time::now() - begin).total_seconds();
+
+        ASSERT_EQ(memcmp(src.data(), decompressed.data(), src.size()), 0);
+
+        printf(
+            "%-20s %10d bytes -> %10d bytes (%5.1f%%) compress %8.1f MB/s decompress %8.1f MB/s (%8.1f MB/s parallel)\n",
+            sample.name,
+            src.size(),
+            frame.size(),
+            100.0 * static_cast<double>(frame.size()) / static_cast<double>(bee::math::max(1, src.size())),
+            total_mb / compress_s,
+            total_mb / decompress_s,
+            total_mb / parallel_s
+        );
+    }
+}
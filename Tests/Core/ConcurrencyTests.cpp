@@ -119,4 +119,242 @@ TEST(ConcurrencyTests, atomic_ptr_stack_stress_test)
     {
         delete static_cast<int*>(node.data[0]);
     }
-}
\ No newline at end of file
+}
+
+TEST(ConcurrencyTests, semaphore_count_is_clamped_to_max)
+{
+    bee::Semaphore semaphore(1, 2);
+    semaphore.release();
+    ASSERT_TRUE(semaphore.try_acquire());
+    ASSERT_TRUE(semaphore.try_acquire());
+    ASSERT_FALSE(semaphore.try_acquire());
+
+    // Releasing a full semaphore leaves it at the max count
+    semaphore.release(2);
+    semaphore.release();
+    ASSERT_TRUE(semaphore.try_acquire());
+    ASSERT_TRUE(semaphore.try_acquire());
+    ASSERT_FALSE(semaphore.try_acquire());
+
+    // A blocked acquire wakes up once another thread releases
+    std::thread thread([&]()
+    {
+        bee::current_thread::sleep(bee::time::milliseconds(10));
+        semaphore.release();
+    });
+    semaphore.acquire();
+    thread.join();
+    ASSERT_FALSE(semaphore.try_acquire());
+}
+
+TEST(ConcurrencyTests, condition_variable_wait_for_times_out)
+{
+    bee::Mutex mutex;
+    bee::ConditionVariable cv;
+    bool signaled = false;
+    std::thread thread;
+
+    {
+        bee::scoped_lock_t lock(mutex);
+        const auto begin = bee::time::now();
+        ASSERT_FALSE(cv.wait_for(lock, bee::TimePoint(bee::time::milliseconds(20)), [&]() { return signaled; }));
+        ASSERT_GE(bee::time::now() - begin, bee::time::milliseconds(20));
+
+        // The notifying thread can only take the lock once the wait has released it
+        thread = std::thread([&]()
+        {
+            bee::scoped_lock_t notify_lock(mutex);
+            signaled = true;
+            cv.notify_one();
+        });
+        EXPECT_TRUE(cv.wait_for(lock, bee::TimePoint(bee::time::seconds(10)), [&]() { return signaled; }));
+    }
+
+    thread.join();
+}
+
+TEST(ConcurrencyTests, recursive_mutex)
+{
+    bee::RecursiveMutex mutex;
+    mutex.lock();
+    ASSERT_TRUE(mutex.try_lock());
+    mutex.lock();
+
+    // Other threads can't take the lock until the owner has unlocked it as many times as it locked it
+    const auto try_lock_on_other_thread = [&]()
+    {
+        bool locked = false;
+        std::thread thread([&]()
+        {
+            locked = mutex.try_lock();
+            if (locked)
+            {
+                mutex.unlock();
+            }
+        });
+        thread.join();
+        return locked;
+    };
+
+    mutex.unlock();
+    mutex.unlock();
+    ASSERT_FALSE(try_lock_on_other_thread());
+    mutex.unlock();
+    ASSERT_TRUE(try_lock_on_other_thread());
+}
+
+TEST(ConcurrencyTests, barrier_can_be_reused)
+{
+    constexpr int thread_count = 4;
+    constexpr int phase_count = 100;
+
+    bee::Barrier barrier(thread_count);
+    std::atomic_int32_t arrived[phase_count] {};
+    std::atomic_int32_t mismatch_count { 0 };
+    std::thread threads[thread_count];
+
+    for (auto& t : threads)
+    {
+        t = std::thread([&]()
+        {
+            for (int phase = 0; phase < phase_count; ++phase)
+            {
+                arrived[phase].fetch_add(1, std::memory_order_relaxed);
+                barrier.wait();
+
+                // Every thread has to have reached this phase before any of them leave it
+                if (arrived[phase].load(std::memory_order_relaxed) != thread_count)
+                {
+                    mismatch_count.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    ASSERT_EQ(mismatch_count.load(), 0);
+}
+
+// Disabled by default as it only prints timings - run with --gtest_also_run_disabled_tests to compare backends
+TEST(ConcurrencyTests, DISABLED_primitives_benchmark)
+{
+    // Each platform runs the same loops so the numbers printed here can be compared directly between backends
+    constexpr int iteration_count = 1000000;
+    constexpr int round_trip_count = 20000;
+    constexpr int thread_count = 4;
+
+    const auto print_result = [&](const char* name, const bee::u64 begin, const int op_count)
+    {
+        const auto ns = bee::TimePoint(bee::time::now() - begin).total_microseconds() * 1000.0;
+        printf("%s: %.2f ns/op\n", name, ns / static_cast<double>(op_count));
+    };
+
+    auto begin = bee::time::now();
+    bee::u64 now_sum = 0;
+    for (int i = 0; i < iteration_count; ++i)
+    {
+        now_sum += bee::time::now();
+    }
+    print_result("time::now", begin, iteration_count);
+    ASSERT_GT(now_sum, 0u);
+
+    bee::Mutex mutex;
+    int counter = 0;
+    begin = bee::time::now();
+    for (int i = 0; i < iteration_count; ++i)
+    {
+        bee::scoped_lock_t lock(mutex);
+        ++counter;
+    }
+    print_result("Mutex (uncontended)", begin, iteration_count);
+    ASSERT_EQ(counter, iteration_count);
+
+    std::thread threads[thread_count];
+    counter = 0;
+    begin = bee::time::now();
+    for (auto& t : threads)
+    {
+        t = std::thread([&]()
+        {
+            for (int i = 0; i < iteration_count / thread_count; ++i)
+            {
+                bee::scoped_lock_t lock(mutex);
+                ++counter;
+            }
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    print_result("Mutex (contended)", begin, iteration_count);
+    ASSERT_EQ(counter, iteration_count);
+
+    // ping-pong between two threads to measure the cost of a full sleep/wake cycle
+    bee::Semaphore ping(0, 1);
+    bee::Semaphore pong(0, 1);
+    begin = bee::time::now();
+    std::thread semaphore_thread([&]()
+    {
+        for (int i = 0; i < round_trip_count; ++i)
+        {
+            ping.acquire();
+            pong.release();
+        }
+    });
+    for (int i = 0; i < round_trip_count; ++i)
+    {
+        ping.release();
+        pong.acquire();
+    }
+    semaphore_thread.join();
+    print_result("Semaphore (round trip)", begin, round_trip_count);
+
+    bee::ConditionVariable cv;
+    int turn = 0;
+    begin = bee::time::now();
+    std::thread cv_thread([&]()
+    {
+        for (int i = 0; i < round_trip_count; ++i)
+        {
+            bee::scoped_lock_t lock(mutex);
+            cv.wait(lock, [&]() { return turn == 1; });
+            turn = 0;
+            cv.notify_one();
+        }
+    });
+    for (int i = 0; i < round_trip_count; ++i)
+    {
+        bee::scoped_lock_t lock(mutex);
+        turn = 1;
+        cv.notify_one();
+        cv.wait(lock, [&]() { return turn == 0; });
+    }
+    cv_thread.join();
+    print_result("ConditionVariable (round trip)", begin, round_trip_count);
+
+    bee::Barrier barrier(thread_count);
+    std::atomic_int32_t phases { 0 };
+    begin = bee::time::now();
+    for (auto& t : threads)
+    {
+        t = std::thread([&]()
+        {
+            for (int i = 0; i < round_trip_count; ++i)
+            {
+                barrier.wait();
+            }
+            phases.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    print_result("Barrier (phase)", begin, round_trip_count);
+    ASSERT_EQ(phases.load(), thread_count);
+}
@@ -0,0 +1,111 @@
+/*
+ *  FileStateJournalTests.cpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#include <Bee/Core/FileStateJournal.hpp>
+
+#include <GTest.hpp>
+
+
+class FileStateJournalTests : public ::testing::Test
+{
+protected:
+    bee::Path journal_path;
+    bee::Path file_path;
+
+    void SetUp() override
+    {
+        journal_path = bee::fs::roots().data.join("FileStates.journal");
+        file_path = bee::fs::roots().data.join("FileStateTest.txt");
+        ASSERT_EQ(bee::fs::write_all(file_path.view(), "File state test"), bee::str::length("File state test"));
+    }
+
+    void TearDown() override
+    {
+        if (journal_path.exists())
+        {
+            bee::fs::remove(journal_path.view());
+        }
+
+        if (file_path.exists())
+        {
+            bee::fs::remove(file_path.view());
+        }
+    }
+};
+
+TEST_F(FileStateJournalTests, record_and_check)
+{
+    bee::fs::FileStateJournal journal;
+    ASSERT_TRUE(journal.open(journal_path.view()));
+
+    bee::fs::DirectoryEntryInfo entry{};
+    ASSERT_TRUE(bee::fs::get_entry_info(file_path.view(), &entry));
+    ASSERT_EQ(journal.check(entry), bee::fs::FileStateChange::added);
+    ASSERT_TRUE(journal.record(entry));
+    ASSERT_EQ(journal.check(entry), bee::fs::FileStateChange::unchanged);
+
+    // Files without a recorded hash are reported as modified when their metadata changes and hashed at the same time
+    entry.last_modified += 1;
+    bee::u128 hash{};
+    ASSERT_EQ(journal.check(entry, &hash), bee::fs::FileStateChange::modified);
+    ASSERT_NE(hash, bee::u128{});
+    ASSERT_TRUE(journal.record(entry, hash));
+
+    // Once hashed, touching the file without changing its content isn't a modification
+    entry.last_modified += 1;
+    ASSERT_EQ(journal.check(entry), bee::fs::FileStateChange::unchanged);
+    ASSERT_EQ(journal.find(file_path.view())->last_modified, entry.last_modified);
+
+    ASSERT_EQ(bee::fs::write_all(file_path.view(), "Different contents"), bee::str::length("Different contents"));
+    ASSERT_TRUE(bee::fs::get_entry_info(file_path.view(), &entry));
+    ASSERT_EQ(journal.check(entry), bee::fs::FileStateChange::modified);
+
+    ASSERT_TRUE(journal.remove(file_path.view()));
+    ASSERT_EQ(journal.find(file_path.view()), nullptr);
+    ASSERT_EQ(journal.check(entry), bee::fs::FileStateChange::added);
+}
+
+TEST_F(FileStateJournalTests, persists_and_grows)
+{
+    static constexpr int record_count = 100;
+
+    bee::fs::DirectoryEntryInfo entry{};
+    ASSERT_TRUE(bee::fs::get_entry_info(file_path.view(), &entry));
+
+    {
+        bee::fs::FileStateJournal journal;
+        ASSERT_TRUE(journal.open(journal_path.view(), 16));
+        ASSERT_EQ(journal.capacity(), 16);
+
+        // the entries don't need to exist on disk to be recorded
+        for (int i = 0; i < record_count; ++i)
+        {
+            bee::fs::DirectoryEntryInfo fake_entry{};
+            fake_entry.path = bee::fs::roots().data.join(bee::str::to_string(i).view());
+            fake_entry.size = i;
+            fake_entry.last_modified = static_cast<bee::u64>(i);
+            ASSERT_TRUE(journal.record(fake_entry));
+        }
+
+        ASSERT_TRUE(journal.record(entry));
+        ASSERT_EQ(journal.size(), record_count + 1);
+        ASSERT_GE(journal.capacity(), (record_count + 1) * 4 / 3);
+    }
+
+    bee::fs::FileStateJournal journal;
+    ASSERT_TRUE(journal.open(journal_path.view()));
+    ASSERT_EQ(journal.size(), record_count + 1);
+    ASSERT_EQ(journal.check(entry), bee::fs::FileStateChange::unchanged);
+
+    for (int i = 0; i < record_count; ++i)
+    {
+        const auto path = bee::fs::roots().data.join(bee::str::to_string(i).view());
+        const auto* record = journal.find(path.view());
+        ASSERT_NE(record, nullptr);
+        ASSERT_EQ(record->size, i);
+    }
+}
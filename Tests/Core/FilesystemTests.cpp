@@ -6,6 +6,9 @@
  */
 
 #include <Bee/Core/Filesystem.hpp>
+#include <Bee/Core/Memory/Memory.hpp>
+#include <Bee/Core/Thread.hpp>
+#include <Bee/Core/Time.hpp>
 
 #include <GTest.hpp>
 
@@ -89,6 +92,383 @@ TEST(FilesystemTests, copy_file)
     ASSERT_TRUE(bee::fs::remove(dst_filepath.view()));
 }
 
+TEST(FilesystemTests, read_write_at_offset)
+{
+    static constexpr bee::u8 test_bytes[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    const auto filepath = bee::fs::roots().data.join("TestFile.bin");
+
+    ASSERT_FALSE(filepath.exists());
+    {
+        auto file = bee::fs::open_file(filepath.view(), bee::fs::OpenMode::read | bee::fs::OpenMode::write);
+        ASSERT_TRUE(file.is_valid());
+
+        // write the second half first to check that positional writes don't depend on the current offset
+        ASSERT_EQ(bee::fs::write_at(file, 4, test_bytes + 4, 4), 4);
+        ASSERT_EQ(bee::fs::write_at(file, 0, test_bytes, 4), 4);
+        ASSERT_EQ(bee::fs::get_size(file), bee::static_array_length(test_bytes));
+
+        bee::u8 read_bytes[4] = { 0 };
+        ASSERT_EQ(bee::fs::read_at(file, 2, 4, read_bytes), 4);
+        for (int b = 0; b < bee::static_array_length(read_bytes); ++b)
+        {
+            ASSERT_EQ(read_bytes[b], test_bytes[b + 2]);
+        }
+
+        // reading past the end of the file returns a short read
+        ASSERT_EQ(bee::fs::read_at(file, 6, 4, read_bytes), 2);
+        ASSERT_EQ(read_bytes[0], test_bytes[6]);
+        ASSERT_EQ(read_bytes[1], test_bytes[7]);
+    }
+
+    ASSERT_TRUE(bee::fs::remove(filepath.view()));
+}
+
+struct ChunkedReadCheck
+{
+    const bee::u8*  expected { nullptr };
+    bee::i64        next_offset { 0 };
+    bool            matched { true };
+};
+
+static bool check_chunk(const void* chunk, const bee::i64 chunk_size, const bee::i64 offset, void* user_data)
+{
+    auto* check = static_cast<ChunkedReadCheck*>(user_data);
+    check->matched = check->matched
+        && offset == check->next_offset
+        && bee::is_aligned(chunk, bee::fs::unbuffered_io_alignment())
+        && memcmp(chunk, check->expected + offset, chunk_size) == 0;
+    check->next_offset = offset + chunk_size;
+    return true;
+}
+
+TEST(FilesystemTests, chunked_unbuffered_read)
+{
+    const auto filepath = bee::fs::roots().data.join("TestFile.bin");
+    const auto alignment = static_cast<bee::i32>(bee::fs::unbuffered_io_alignment());
+    ASSERT_GT(alignment, 0);
+
+    // Not a multiple of the alignment so the last chunk is a short read
+    bee::DynamicArray<bee::u8> data;
+    data.resize(alignment * 10 + 123);
+    for (int i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<bee::u8>(i * 31 + i / alignment);
+    }
+    ASSERT_EQ(bee::fs::write_all(filepath.view(), data.data(), data.size()), data.size());
+
+    const bee::fs::OpenMode modes[] = { bee::fs::OpenMode::read, bee::fs::OpenMode::read | bee::fs::OpenMode::unbuffered };
+    for (const auto mode : modes)
+    {
+        ChunkedReadCheck check{};
+        check.expected = data.data();
+
+        bee::fs::ChunkedReadInfo info{};
+        info.chunk_size = alignment * 3 - 1; // rounded up to the alignment
+        info.callback = check_chunk;
+        info.user_data = &check;
+
+        ASSERT_EQ(bee::fs::read_chunked(filepath.view(), info, mode), data.size());
+        ASSERT_TRUE(check.matched);
+        ASSERT_EQ(check.next_offset, data.size());
+    }
+
+    // Returning false from the callback stops reading after the current chunk
+    bee::fs::ChunkedReadInfo info{};
+    info.chunk_size = alignment * 3;
+    info.callback = [](const void* /* chunk */, const bee::i64 /* chunk_size */, const bee::i64 /* offset */, void* /* user_data */)
+    {
+        return false;
+    };
+    ASSERT_EQ(bee::fs::read_chunked(filepath.view(), info), alignment * 3);
+
+    ASSERT_TRUE(bee::fs::remove(filepath.view()));
+}
+
+static bool copy_to_staging(const void* chunk, const bee::i64 chunk_size, const bee::i64 /* offset */, void* user_data)
+{
+    memcpy(static_cast<bee::DynamicArray<bee::u8>*>(user_data)->data(), chunk, chunk_size);
+    return true;
+}
+
+// Disabled by default as it writes and reads several GB - run with --gtest_also_run_disabled_tests to compare
+TEST(FilesystemTests, DISABLED_unbuffered_read_benchmark)
+{
+    // Larger than the page cache on most machines so buffered reads can't all be served from memory
+    static constexpr bee::i64 file_size = 4ll * 1024 * 1024 * 1024;
+    static constexpr bee::i32 chunk_size = 8 * 1024 * 1024;
+
+    const auto filepath = bee::fs::roots().data.join("UnbufferedReadBenchmark.bin");
+
+    // Every chunk is copied into a staging buffer the same as it would be for an upload to the GPU
+    bee::DynamicArray<bee::u8> staging;
+    staging.resize(chunk_size);
+    for (int i = 0; i < staging.size(); ++i)
+    {
+        staging[i] = static_cast<bee::u8>(i * 7);
+    }
+
+    {
+        auto file = bee::fs::open_file(filepath.view(), bee::fs::OpenMode::write);
+        ASSERT_TRUE(file.is_valid());
+
+        for (bee::i64 offset = 0; offset < file_size; offset += chunk_size)
+        {
+            ASSERT_EQ(bee::fs::write(file, staging.data(), chunk_size), chunk_size);
+        }
+    }
+
+    const auto megabytes = static_cast<double>(file_size) / (1024.0 * 1024.0);
+    const auto print_result = [&](const char* name, const bee::u64 begin)
+    {
+        const auto ms = bee::TimePoint(bee::time::now() - begin).total_milliseconds();
+        printf("%s: %.2f MB in %f ms (%.2f MB/s)\n", name, megabytes, ms, megabytes / (ms / 1000.0));
+    };
+
+    // read_all_bytes can't hold more than 2GB so only chunked reads are compared. The end of the file was just written
+    // so some buffered reads are likely served from the page cache - unbuffered reads never are
+    bee::fs::ChunkedReadInfo info{};
+    info.chunk_size = chunk_size;
+    info.callback = copy_to_staging;
+    info.user_data = &staging;
+
+    auto begin = bee::time::now();
+    ASSERT_EQ(bee::fs::read_chunked(filepath.view(), info, bee::fs::OpenMode::read), file_size);
+    print_result("read_chunked (buffered)", begin);
+
+    begin = bee::time::now();
+    ASSERT_EQ(bee::fs::read_chunked(filepath.view(), info, bee::fs::OpenMode::read | bee::fs::OpenMode::unbuffered), file_size);
+    print_result("read_chunked (unbuffered)", begin);
+
+    ASSERT_TRUE(bee::fs::remove(filepath.view()));
+}
+
+TEST(FilesystemTests, memory_mapped_file_range)
+{
+    const auto filepath = bee::fs::roots().data.join("TestFile.bin");
+
+    // large enough to cover several pages so the range offset isn't page-aligned
+    bee::DynamicArray<bee::u8> data;
+    data.resize(256 * 1024 + 17);
+    for (int i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<bee::u8>(i % 251);
+    }
+
+    ASSERT_EQ(bee::fs::write_all(filepath.view(), data.data(), data.size()), data.size());
+
+    bee::fs::MemoryMappedFile mapped{};
+    ASSERT_TRUE(bee::fs::mmap_file_map(&mapped, filepath.view(), bee::fs::OpenMode::read));
+    ASSERT_EQ(mapped.size, data.size());
+    ASSERT_EQ(mapped.file_size, data.size());
+    ASSERT_EQ(memcmp(mapped.data, data.data(), data.size()), 0);
+    ASSERT_TRUE(bee::fs::mmap_file_unmap(&mapped));
+    ASSERT_FALSE(mapped.is_mapped());
+
+    const bee::i64 offset = 70000;
+    ASSERT_TRUE(bee::fs::mmap_file_map_range(&mapped, filepath.view(), bee::fs::OpenMode::read, offset, 4096));
+    ASSERT_EQ(mapped.size, 4096);
+    ASSERT_EQ(mapped.offset, offset);
+    ASSERT_EQ(mapped.file_size, data.size());
+    ASSERT_TRUE(bee::fs::mmap_file_advise(mapped, bee::fs::MemoryMappedAdvice::sequential));
+    ASSERT_TRUE(bee::fs::mmap_file_prefetch(mapped, 100, 1000));
+    ASSERT_EQ(memcmp(mapped.data, data.data() + offset, 4096), 0);
+    ASSERT_TRUE(bee::fs::mmap_file_unmap(&mapped));
+
+    // negative sizes map to the end of the file
+    ASSERT_TRUE(bee::fs::mmap_file_map_range(&mapped, filepath.view(), bee::fs::OpenMode::read, offset, -1));
+    ASSERT_EQ(mapped.size, data.size() - offset);
+    ASSERT_EQ(memcmp(mapped.data, data.data() + offset, static_cast<size_t>(mapped.size)), 0);
+    ASSERT_TRUE(bee::fs::mmap_file_unmap(&mapped));
+
+    ASSERT_TRUE(bee::fs::remove(filepath.view()));
+}
+
+TEST(FilesystemTests, shared_memory_mapped_files)
+{
+    static constexpr char test_string[] = "Shared mapping test";
+    const auto filepath = bee::fs::roots().data.join("TestFile.txt");
+
+    ASSERT_EQ(bee::fs::write_all(filepath.view(), test_string), bee::str::length(test_string));
+
+    const auto* first = bee::fs::mmap_file_acquire_shared(filepath.view());
+    ASSERT_NE(first, nullptr);
+
+    // a non-normalized path to the same file should share the mapping
+    auto other_path = bee::fs::roots().data.join("Logs").append("..").append("TestFile.txt");
+    const auto* second = bee::fs::mmap_file_acquire_shared(other_path.view());
+    ASSERT_EQ(first, second);
+    ASSERT_EQ(bee::StringView(static_cast<const char*>(first->data), static_cast<bee::i32>(first->size)), test_string);
+
+    bee::fs::mmap_file_release_shared(second);
+    bee::fs::mmap_file_release_shared(first);
+
+    // the mapping is recreated once the last reference is released
+    const auto* third = bee::fs::mmap_file_acquire_shared(filepath.view());
+    ASSERT_NE(third, nullptr);
+    bee::fs::mmap_file_release_shared(third);
+
+    ASSERT_TRUE(bee::fs::remove(filepath.view()));
+}
+
+static int count_files(const bee::PathView& directory)
+{
+    int count = 0;
+    for (const auto path : bee::fs::read_dir(directory))
+    {
+        if (bee::fs::is_file(path))
+        {
+            ++count;
+        }
+    }
+    return count;
+}
+
+TEST(FilesystemTests, atomic_write)
+{
+    const auto dirpath = bee::fs::roots().data.join("AtomicWriteTestDir");
+    const auto filepath = dirpath.join("TestFile.txt");
+    if (!dirpath.exists())
+    {
+        ASSERT_TRUE(bee::fs::mkdir(dirpath.view()));
+    }
+
+    ASSERT_EQ(bee::fs::write_all_atomic(filepath.view(), "Original contents"), bee::str::length("Original contents"));
+    ASSERT_EQ(bee::fs::read_all_text(filepath.view()), "Original contents");
+
+    // replaces the existing file without leaving the temporary one behind
+    ASSERT_EQ(bee::fs::write_all_atomic(filepath.view(), "New contents"), bee::str::length("New contents"));
+    ASSERT_EQ(bee::fs::read_all_text(filepath.view()), "New contents");
+    ASSERT_EQ(count_files(dirpath.view()), 1);
+
+    ASSERT_TRUE(bee::fs::rmdir(dirpath.view(), true));
+}
+
+TEST(FilesystemTests, file_write_batch)
+{
+    static constexpr int file_count = 8;
+
+    const auto dirpath = bee::fs::roots().data.join("WriteBatchTestDir");
+    if (!dirpath.exists())
+    {
+        ASSERT_TRUE(bee::fs::mkdir(dirpath.view()));
+    }
+
+    const auto existing_path = dirpath.join("0.txt");
+    ASSERT_EQ(bee::fs::write_all(existing_path.view(), "Original contents"), bee::str::length("Original contents"));
+
+    // aborted writes are discarded and leave existing files untouched
+    {
+        bee::fs::FileWriteBatch batch;
+        for (int i = 0; i < file_count; ++i)
+        {
+            const auto path = dirpath.join(bee::str::format("%d.txt", i).view());
+            ASSERT_TRUE(batch.write(path.view(), "Aborted contents"));
+        }
+
+        ASSERT_EQ(batch.size(), file_count);
+        batch.abort();
+        ASSERT_TRUE(batch.empty());
+    }
+
+    ASSERT_EQ(count_files(dirpath.view()), 1);
+    ASSERT_EQ(bee::fs::read_all_text(existing_path.view()), "Original contents");
+
+    // nothing is visible until the batch is committed
+    bee::fs::FileWriteBatch batch;
+    bee::u64 last_modified[file_count] = { 0 };
+
+    for (int i = 0; i < file_count; ++i)
+    {
+        const auto path = dirpath.join(bee::str::format("%d.txt", i).view());
+        ASSERT_TRUE(batch.write(path.view(), "Aborted contents"));
+        ASSERT_TRUE(batch.write(path.view(), bee::str::format("Committed %d", i).view(), &last_modified[i]));
+    }
+
+    ASSERT_EQ(batch.size(), file_count);
+    ASSERT_EQ(bee::fs::read_all_text(existing_path.view()), "Original contents");
+    ASSERT_TRUE(batch.commit());
+    ASSERT_TRUE(batch.empty());
+    ASSERT_EQ(count_files(dirpath.view()), file_count);
+
+    for (int i = 0; i < file_count; ++i)
+    {
+        const auto path = dirpath.join(bee::str::format("%d.txt", i).view());
+        ASSERT_EQ(bee::fs::read_all_text(path.view()), bee::str::format("Committed %d", i));
+        ASSERT_EQ(bee::fs::last_modified(path.view()), last_modified[i]);
+    }
+
+    ASSERT_TRUE(bee::fs::rmdir(dirpath.view(), true));
+}
+
+TEST(FilesystemTests, merged_file_write_batches_sync_once)
+{
+    static constexpr int file_count = 8;
+
+    const auto dirpath = bee::fs::roots().data.join("MergedWriteBatchTestDir");
+    if (!dirpath.exists())
+    {
+        ASSERT_TRUE(bee::fs::mkdir(dirpath.view()));
+    }
+
+    const auto removed_path = dirpath.join("Removed.txt");
+    const auto rewritten_path = dirpath.join("Rewritten.txt");
+    ASSERT_EQ(bee::fs::write_all(removed_path.view(), "Removed"), bee::str::length("Removed"));
+    ASSERT_EQ(bee::fs::write_all(rewritten_path.view(), "Original contents"), bee::str::length("Original contents"));
+
+    bee::fs::FileWriteBatch batch;
+    batch.remove(removed_path.view());
+    batch.remove(rewritten_path.view());
+
+    // each unit of work stages into its own batch and merges it in once it succeeds, e.g. one per imported asset
+    for (int i = 0; i < file_count; ++i)
+    {
+        bee::fs::FileWriteBatch unit;
+        const auto path = dirpath.join(bee::str::format("%d.txt", i).view());
+        ASSERT_TRUE(unit.write(path.view(), bee::str::format("Committed %d", i).view()));
+        batch.merge(&unit);
+        ASSERT_TRUE(unit.empty());
+    }
+
+    // writing a file that an earlier unit removed cancels the removal
+    {
+        bee::fs::FileWriteBatch unit;
+        ASSERT_TRUE(unit.write(rewritten_path.view(), "New contents"));
+        batch.merge(&unit);
+    }
+
+    // aborted units don't affect the batch they would have been merged into
+    {
+        bee::fs::FileWriteBatch unit;
+        ASSERT_TRUE(unit.write(dirpath.join("Aborted.txt").view(), "Aborted contents"));
+        unit.remove(rewritten_path.view());
+        ASSERT_TRUE(unit.is_pending_removal(rewritten_path.view()));
+    }
+
+    ASSERT_TRUE(batch.is_pending_removal(removed_path.view()));
+    ASSERT_FALSE(batch.is_pending_removal(rewritten_path.view()));
+    ASSERT_EQ(batch.size(), file_count + 2);
+
+    const auto sync_count = bee::fs::get_write_batch_sync_count();
+    ASSERT_TRUE(batch.commit_writes());
+    ASSERT_EQ(bee::fs::get_write_batch_sync_count(), sync_count + 1);
+
+    // removals are held back until they're committed separately
+    ASSERT_TRUE(removed_path.exists());
+    batch.commit_removals();
+    ASSERT_TRUE(batch.empty());
+    ASSERT_FALSE(removed_path.exists());
+    ASSERT_EQ(bee::fs::read_all_text(rewritten_path.view()), "New contents");
+    ASSERT_EQ(count_files(dirpath.view()), file_count + 1);
+
+    for (int i = 0; i < file_count; ++i)
+    {
+        const auto path = dirpath.join(bee::str::format("%d.txt", i).view());
+        ASSERT_EQ(bee::fs::read_all_text(path.view()), bee::str::format("Committed %d", i));
+    }
+
+    ASSERT_TRUE(bee::fs::rmdir(dirpath.view(), true));
+}
+
 TEST(FilesystemTests, make_and_remove_directory)
 {
     const auto dirpath = bee::fs::roots().data.join("NonRecursiveTestDir");
@@ -168,6 +548,110 @@ void read_dir_recursive(const bee::PathView& root, const bee::Span<bee::Path>& t
     }
 }
 
+static bool scan_test_filter(const bee::PathView& path, const bee::fs::DirectoryEntryType type, void* user_data)
+{
+    ++*static_cast<int*>(user_data);
+    return path.filename() != "Skipped";
+}
+
+TEST(FilesystemTests, scan_directory)
+{
+    static constexpr char test_string[] = "scan_directory test file";
+
+    const auto dirpath = bee::fs::roots().data.join("ScanTestDir");
+    const bee::Path test_paths[] = {
+        dirpath.join("Nested"),
+        dirpath.join("Nested").join("Text.txt"),
+        dirpath.join("Nested").join("Image.png"),
+        dirpath.join("Nested").join("Nested2"),
+        dirpath.join("Nested").join("Nested2").join("Text.txt"),
+        dirpath.join(".git"),
+        dirpath.join(".git").join("Text.txt"),
+        dirpath.join("Skipped"),
+        dirpath.join("Skipped").join("Text.txt"),
+        dirpath.join("Text.txt")
+    };
+
+    if (dirpath.exists())
+    {
+        ASSERT_TRUE(bee::fs::rmdir(dirpath.view(), true));
+    }
+
+    // `.git` has an extension as far as Path is concerned so files are told apart by their extension instead
+    const auto is_test_file = [](const bee::Path& path)
+    {
+        return path.extension() == ".txt" || path.extension() == ".png";
+    };
+
+    ASSERT_TRUE(bee::fs::mkdir(dirpath.view()));
+    for (const auto& path : test_paths)
+    {
+        if (!is_test_file(path))
+        {
+            ASSERT_TRUE(bee::fs::mkdir(path.view()));
+        }
+        else
+        {
+            ASSERT_EQ(bee::fs::write_all(path.view(), test_string), bee::str::length(test_string));
+        }
+    }
+
+    // Unfiltered scans should return everything along with its metadata
+    bee::fs::DirectoryScanInfo info{};
+    info.include_directories = true;
+
+    bee::DynamicArray<bee::fs::DirectoryEntryInfo> entries;
+    ASSERT_TRUE(bee::fs::scan_dir(dirpath.view(), info, &entries));
+    ASSERT_EQ(entries.size(), bee::static_array_length(test_paths));
+
+    for (const auto& entry : entries)
+    {
+        if (entry.type == bee::fs::DirectoryEntryType::file)
+        {
+            ASSERT_EQ(entry.size, bee::str::length(test_string));
+            ASSERT_EQ(entry.last_modified, bee::fs::last_modified(entry.path.view()));
+        }
+        else
+        {
+            ASSERT_EQ(entry.type, bee::fs::DirectoryEntryType::directory);
+            ASSERT_FALSE(is_test_file(entry.path));
+        }
+    }
+
+    // Excluded names and filtered directories shouldn't be descended into
+    const bee::StringView include_extensions[] = { ".txt" };
+    const bee::StringView exclude_names[] = { ".git" };
+    int filter_calls = 0;
+
+    info.include_directories = false;
+    info.include_extensions = bee::Span<const bee::StringView>(include_extensions);
+    info.exclude_names = bee::Span<const bee::StringView>(exclude_names);
+    info.filter = scan_test_filter;
+    info.filter_user_data = &filter_calls;
+
+    entries.clear();
+    ASSERT_TRUE(bee::fs::scan_dir(dirpath.view(), info, &entries));
+    ASSERT_EQ(entries.size(), 3);
+    ASSERT_GT(filter_calls, 0);
+
+    for (const auto& entry : entries)
+    {
+        ASSERT_EQ(entry.type, bee::fs::DirectoryEntryType::file);
+        ASSERT_EQ(entry.path.filename(), "Text.txt");
+        ASSERT_NE(entry.path.parent().filename(), ".git");
+        ASSERT_NE(entry.path.parent().filename(), "Skipped");
+    }
+
+    // Non-recursive scans only read the root directory
+    info.recursive = false;
+    entries.clear();
+    ASSERT_TRUE(bee::fs::scan_dir(dirpath.view(), info, &entries));
+    ASSERT_EQ(entries.size(), 1);
+
+    ASSERT_TRUE(bee::fs::rmdir(dirpath.view(), true));
+    ASSERT_FALSE(dirpath.exists());
+}
+
 TEST(FilesystemTests, read_directory)
 {
     static constexpr int max_nested_dir_level = 4;
@@ -226,3 +710,83 @@ TEST(FilesystemTests, read_directory)
 
     ASSERT_TRUE(bee::fs::rmdir(dirpath.view(), true));
 }
+
+static bool wait_for_file_event(bee::fs::DirectoryWatcher* watcher, const bee::Path& path, const bee::fs::FileAction action)
+{
+    // events are only popped once they've settled for a short while so poll until one shows up or we give up
+    bee::DynamicArray<bee::fs::FileNotifyInfo> events;
+    const auto timeout = bee::time::now() + bee::time::seconds(5);
+
+    while (bee::time::now() < timeout)
+    {
+        events.clear();
+        watcher->pop_events(&events);
+
+        for (const auto& event : events)
+        {
+            if (event.action == action && event.file == path)
+            {
+                return true;
+            }
+        }
+
+        bee::current_thread::sleep(bee::time::milliseconds(10));
+    }
+
+    return false;
+}
+
+TEST(FilesystemTests, directory_watcher)
+{
+    const auto dirpath = bee::fs::roots().data.join("DirectoryWatcherTestDir");
+    if (dirpath.exists())
+    {
+        ASSERT_TRUE(bee::fs::rmdir(dirpath.view(), true));
+    }
+    ASSERT_TRUE(bee::fs::mkdir(dirpath.view()));
+
+    bee::fs::DirectoryWatcher watcher(true);
+    ASSERT_TRUE(watcher.add_directory(dirpath.view()));
+    watcher.start("DirectoryWatcherTest");
+    ASSERT_TRUE(watcher.is_running());
+    ASSERT_EQ(watcher.watched_directories().size(), 1);
+
+    // added
+    const auto file = dirpath.join("Watched.txt");
+    ASSERT_GT(bee::fs::write_all(file.view(), "added"), 0);
+    ASSERT_TRUE(wait_for_file_event(&watcher, file, bee::fs::FileAction::added));
+
+    // modified
+    ASSERT_GT(bee::fs::write_all(file.view(), "modified"), 0);
+    ASSERT_TRUE(wait_for_file_event(&watcher, file, bee::fs::FileAction::modified));
+
+    // files in a subdirectory created after the watcher started are reported when watching recursively
+    const auto subdir = dirpath.join("Nested");
+    ASSERT_TRUE(bee::fs::mkdir(subdir.view()));
+    ASSERT_TRUE(wait_for_file_event(&watcher, subdir, bee::fs::FileAction::added));
+
+    const auto nested_file = subdir.join("Nested.txt");
+    ASSERT_GT(bee::fs::write_all(nested_file.view(), "nested"), 0);
+    ASSERT_TRUE(wait_for_file_event(&watcher, nested_file, bee::fs::FileAction::added));
+
+    // removed
+    ASSERT_TRUE(bee::fs::remove(file.view()));
+    ASSERT_TRUE(wait_for_file_event(&watcher, file, bee::fs::FileAction::removed));
+
+    // nothing is reported for a directory once it's been removed from the watcher
+    watcher.remove_directory(dirpath.view());
+    ASSERT_EQ(watcher.watched_directories().size(), 0);
+
+    const auto unwatched_file = dirpath.join("Unwatched.txt");
+    ASSERT_GT(bee::fs::write_all(unwatched_file.view(), "unwatched"), 0);
+    bee::current_thread::sleep(bee::time::milliseconds(100));
+
+    bee::DynamicArray<bee::fs::FileNotifyInfo> events;
+    watcher.pop_events(&events);
+    ASSERT_TRUE(events.empty());
+
+    watcher.stop();
+    ASSERT_FALSE(watcher.is_running());
+
+    ASSERT_TRUE(bee::fs::rmdir(dirpath.view(), true));
+}
@@ -6,6 +6,10 @@
  */
 
 #include <Bee/Core/Hash.hpp>
+#include <Bee/Core/Filesystem.hpp>
+#include <Bee/Core/Jobs/JobSystem.hpp>
+#include <Bee/Core/Random.hpp>
+#include <Bee/Core/Time.hpp>
 
 #include <GTest.hpp>
 
@@ -35,4 +39,136 @@ TEST(HashTests, compile_time_string_hashing)
     const auto compile_time_hash = bee::get_static_string_hash("Hashing a string for unit testing");
     const auto runtime_hash = bee::detail::runtime_fnv1a("Hashing a string for unit testing");
     ASSERT_EQ(compile_time_hash, runtime_hash);
-}
\ No newline at end of file
+}
+
+class HashThroughputTests : public ::testing::Test
+{
+protected:
+    static constexpr size_t buffer_size = 256u * 1024u * 1024u;
+
+    bee::FixedArray<bee::u8> buffer;
+
+    static void SetUpTestSuite()
+    {
+        bee::JobSystemInitInfo info{};
+        info.num_workers = bee::JobSystemInitInfo::auto_worker_count;
+        bee::job_system_init(info);
+    }
+
+    static void TearDownTestSuite()
+    {
+        bee::job_system_shutdown();
+    }
+
+    void SetUp() override
+    {
+        bee::RandomGenerator<bee::Xorshift> random(0xF00D);
+        buffer = bee::FixedArray<bee::u8>::with_size(static_cast<bee::i32>(buffer_size));
+        for (auto& byte : buffer)
+        {
+            byte = static_cast<bee::u8>(random.random_range(0, 255));
+        }
+    }
+};
+
+template <typename HashFunc>
+void print_throughput(const char* name, const size_t size, HashFunc&& hash)
+{
+    const auto begin = bee::time::now();
+    hash();
+    const auto ms = bee::TimePoint(bee::time::now() - begin).total_milliseconds();
+    const auto gb_per_sec = (static_cast<double>(size) / (1024.0 * 1024.0 * 1024.0)) / (ms / 1000.0);
+    printf("%-24s %10.3f ms %8.2f GB/s\n", name, ms, gb_per_sec);
+}
+
+TEST_F(HashThroughputTests, parallel_hash_is_stable)
+{
+    // Single-chunk inputs must match a plain XXH3-128 hash so small artifacts keep their existing content hash
+    const auto small_size = bee::parallel_hash_default_chunk_size;
+    ASSERT_EQ(bee::get_parallel_hash128(buffer.data(), small_size, 0xF00D), bee::get_hash128(buffer.data(), small_size, 0xF00D));
+
+    // Tree hashes must be deterministic regardless of how the leaves were scheduled
+    const auto parallel_hash = bee::get_parallel_hash128(buffer.data(), buffer_size, 0xF00D);
+    ASSERT_EQ(parallel_hash, bee::get_parallel_hash128(buffer.data(), buffer_size, 0xF00D));
+    ASSERT_NE(parallel_hash, bee::get_parallel_hash128(buffer.data(), buffer_size - 1, 0xF00D));
+    ASSERT_NE(parallel_hash, bee::get_parallel_hash128(buffer.data(), buffer_size, 0xF00D, bee::parallel_hash_default_chunk_size * 2));
+}
+
+TEST_F(HashThroughputTests, file_hash_matches_buffer_hash)
+{
+    const auto filepath = bee::fs::roots().data.join("HashTestFile.bin");
+    const auto file_size = bee::parallel_hash_default_chunk_size * 8 + 17;
+
+    ASSERT_EQ(bee::fs::write_all(filepath.view(), buffer.data(), file_size), static_cast<bee::i64>(file_size));
+
+    bee::u128 file_hash{};
+    ASSERT_TRUE(bee::fs::get_file_hash128(filepath.view(), 0xF00D, &file_hash));
+    ASSERT_EQ(file_hash, bee::get_parallel_hash128(buffer.data(), file_size, 0xF00D));
+    ASSERT_TRUE(bee::fs::remove(filepath.view()));
+}
+
+TEST_F(HashThroughputTests, bulk_hash_throughput)
+{
+    volatile bee::u64 sink = 0;
+
+    print_throughput("XXH32", buffer_size, [&]()
+    {
+        sink = sink + bee::get_hash(buffer.data(), buffer_size, 0xF00D);
+    });
+    print_throughput("XXH64", buffer_size, [&]()
+    {
+        sink = sink + bee::get_hash64(buffer.data(), buffer_size, 0xF00D);
+    });
+    print_throughput("XXH3-64", buffer_size, [&]()
+    {
+        sink = sink + bee::get_fast_hash64(buffer.data(), buffer_size, 0xF00D);
+    });
+    print_throughput("XXH3-128", buffer_size, [&]()
+    {
+        sink = sink + bee::get_hash128(buffer.data(), buffer_size, 0xF00D).low;
+    });
+    print_throughput("XXH3-128 tree (jobs)", buffer_size, [&]()
+    {
+        sink = sink + bee::get_parallel_hash128(buffer.data(), buffer_size, 0xF00D).low;
+    });
+
+    const auto filepath = bee::fs::roots().data.join("HashThroughputTestFile.bin");
+    ASSERT_EQ(bee::fs::write_all(filepath.view(), buffer.data(), buffer_size), static_cast<bee::i64>(buffer_size));
+
+    print_throughput("File (mmap + tree)", buffer_size, [&]()
+    {
+        bee::u128 hash{};
+        ASSERT_TRUE(bee::fs::get_file_hash128(filepath.view(), 0xF00D, &hash));
+        sink = sink + hash.low;
+    });
+
+    ASSERT_TRUE(bee::fs::remove(filepath.view()));
+}
+
+TEST(HashTests, small_key_throughput)
+{
+    constexpr int key_count = 1 << 22;
+    static constexpr const char* keys[] = { "a", "Bee.Core", "ShaderPipeline::Compiler", "Assets/Textures/Ground/Grass_Albedo.png" };
+
+    for (const auto* key : keys)
+    {
+        const auto length = bee::str::length(key);
+        volatile bee::u32 sink = 0;
+
+        auto begin = bee::time::now();
+        for (int i = 0; i < key_count; ++i)
+        {
+            sink = sink + bee::get_hash(key, length, static_cast<bee::u32>(i));
+        }
+        const auto xxh32_ms = bee::TimePoint(bee::time::now() - begin).total_milliseconds();
+
+        begin = bee::time::now();
+        for (int i = 0; i < key_count; ++i)
+        {
+            sink = sink + bee::get_fast_hash(key, length, static_cast<bee::u32>(i));
+        }
+        const auto xxh3_ms = bee::TimePoint(bee::time::now() - begin).total_milliseconds();
+
+        printf("%2d byte keys: XXH32 %8.3f ms XXH3 %8.3f ms\n", length, xxh32_ms, xxh3_ms);
+    }
+}
@@ -6,6 +6,7 @@
  */
 
 #include <Bee/Core/IO.hpp>
+#include <Bee/Core/Filesystem.hpp>
 
 #include <GTest.hpp>
 
@@ -151,3 +152,69 @@ TEST(IOTests, stringstream)
           => reason: This works! Another test 1)";
     ASSERT_STREQ(msg.c_str(), expected.c_str());
 }
+
+TEST(IOTests, buffered_filestream)
+{
+    static constexpr int value_count = 100000;
+    static constexpr bee::i32 block_size = 4096;
+    static constexpr bee::i64 int_size = sizeof(int);
+
+    const auto filepath = bee::fs::roots().data.join("BufferedFileStream.bin");
+    bee::DynamicArray<bee::u8> large_write(block_size * 3);
+    for (int i = 0; i < large_write.size(); ++i)
+    {
+        large_write[i] = static_cast<bee::u8>(i % 251);
+    }
+
+    {
+        auto file = bee::fs::open_file(filepath.view(), bee::fs::OpenMode::write);
+        bee::io::FileStream stream(&file, block_size);
+        ASSERT_TRUE(stream.is_buffered());
+
+        // lots of small writes that only hit the file once per block
+        for (int i = 0; i < value_count; ++i)
+        {
+            ASSERT_EQ(stream.write(&i, int_size), int_size);
+        }
+        ASSERT_EQ(stream.offset(), value_count * int_size);
+        ASSERT_EQ(stream.size(), value_count * int_size);
+
+        // writes larger than the block bypass the buffer
+        ASSERT_EQ(stream.write(large_write.data(), large_write.size()), large_write.size());
+
+        // seeking back and overwriting flushes the pending block first
+        const int overwrite = -1;
+        stream.seek(10 * int_size, bee::io::SeekOrigin::begin);
+        stream.write(&overwrite, int_size);
+        stream.seek(0, bee::io::SeekOrigin::end);
+        ASSERT_EQ(stream.offset(), value_count * int_size + large_write.size());
+    }
+
+    {
+        auto file = bee::fs::open_file(filepath.view(), bee::fs::OpenMode::read);
+        ASSERT_EQ(bee::fs::get_size(file), value_count * int_size + large_write.size());
+
+        bee::io::FileStream stream(&file, block_size);
+        for (int i = 0; i < value_count; ++i)
+        {
+            int value = 0;
+            ASSERT_EQ(stream.read(&value, int_size), int_size);
+            ASSERT_EQ(value, i == 10 ? -1 : i);
+        }
+
+        bee::DynamicArray<bee::u8> large_read(large_write.size());
+        ASSERT_EQ(stream.read(large_read.data(), large_read.size()), large_read.size());
+        ASSERT_EQ(memcmp(large_read.data(), large_write.data(), large_write.size()), 0);
+
+        // reading past the end of the file
+        ASSERT_EQ(stream.read(large_read.data(), 1), 0);
+
+        // seeking back within the read-ahead block and re-reading
+        int value = 0;
+        stream.seek(5 * int_size, bee::io::SeekOrigin::begin);
+        ASSERT_EQ(stream.read(&value, int_size), int_size);
+        ASSERT_EQ(value, 5);
+    }
+
+    ASSERT_TRUE(bee::fs::remove(filepath.view()));
+}
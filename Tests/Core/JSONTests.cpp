@@ -6,6 +6,9 @@
  */
 
 #include <Bee/Core/JSON/JSON.hpp>
+#include <Bee/Core/Jobs/JobSystem.hpp>
+#include <Bee/Core/Serialization/JSONSerializer.hpp>
+#include <Bee/Core/Time.hpp>
 
 #include <GTest.hpp>
 
@@ -535,3 +538,305 @@ TEST(JSONTests, number_parsing)
         ++i;
     }
 }
+
+TEST(JSONTests, escapes_across_block_boundaries)
+{
+    // Shift the same escape sequences through every position of the 64 byte blocks the structural index is built from
+    for (int padding = 0; padding < 130; ++padding)
+    {
+        bee::String json_str = "[\"";
+        json_str.append(bee::String(padding, 'x'));
+        json_str += R"(", "a\"b\\c\\\"d\\\\", "\\", "\"", "tail"])";
+
+        bee::json::Document doc(bee::json::ParseOptions{});
+        const auto success = doc.parse(json_str.data());
+        ASSERT_TRUE(success) << "Padding: " << padding << " " << doc.get_error_string().c_str();
+
+        const char* expected[] = { nullptr, "a\"b\\c\\\"d\\\\", "\\", "\"", "tail" };
+        int i = 0;
+        for (auto handle : doc.get_elements_range(doc.root()))
+        {
+            if (i > 0)
+            {
+                ASSERT_STREQ(doc.get_data(handle).as_string(), expected[i]) << "Padding: " << padding;
+            }
+            else
+            {
+                ASSERT_EQ(bee::str::length(doc.get_data(handle).as_string()), padding);
+            }
+            ++i;
+        }
+        ASSERT_EQ(i, 5);
+    }
+}
+
+TEST(JSONTests, relaxed_syntax_across_block_boundaries)
+{
+    const bee::String long_text(100, 'y');
+
+    bee::String json_str = "# a comment with \"quotes\", 'apostrophes', ''' and {[,:]} that's longer than one block\n";
+    json_str += "multiline: '''line one \"quoted\" # not a comment\n";
+    json_str += long_text;
+    json_str += "'''\n";
+    json_str += "after: \"# not a comment either ''' \"\n";
+    json_str += "list: [1 2 3] # trailing comment \"with an unterminated quote\n";
+    json_str += "last: true";
+
+    bee::json::ParseOptions options{};
+    options.allow_multiline_strings = true;
+    options.allow_comments = true;
+    options.require_string_keys = false;
+    options.require_root_element = false;
+    options.require_commas = false;
+
+    bee::json::Document doc(options);
+    const auto success = doc.parse(json_str.data());
+    ASSERT_TRUE(success) << doc.get_error_string().c_str();
+
+    bee::String expected_multiline = "line one \"quoted\" # not a comment\n";
+    expected_multiline += long_text;
+
+    ASSERT_STREQ(doc.get_member_data(doc.root(), "multiline").as_string(), expected_multiline.c_str());
+    ASSERT_STREQ(doc.get_member_data(doc.root(), "after").as_string(), "# not a comment either ''' ");
+    ASSERT_TRUE(doc.get_member_data(doc.root(), "last").as_boolean());
+
+    const auto list = doc.get_member(doc.root(), "list");
+    ASSERT_DOUBLE_EQ(doc.get_element_data(list, 0).as_number(), 1.0);
+    ASSERT_DOUBLE_EQ(doc.get_element_data(list, 1).as_number(), 2.0);
+    ASSERT_DOUBLE_EQ(doc.get_element_data(list, 2).as_number(), 3.0);
+}
+
+TEST(JSONTests, invalid_strings)
+{
+    char control_char_str[] = "{\"key\": \"line\nbreak\"}";
+    bee::json::Document doc(bee::json::ParseOptions{});
+    ASSERT_FALSE(doc.parse(control_char_str));
+    ASSERT_EQ(doc.get_error_code(), bee::json::ErrorCode::unexpected_character);
+
+    char unterminated_str[] = R"({"key": "value})";
+    ASSERT_FALSE(doc.parse(unterminated_str));
+    ASSERT_EQ(doc.get_error_code(), bee::json::ErrorCode::expected_character);
+
+    char trailing_chars_str[] = "[true, 1.5x]";
+    ASSERT_FALSE(doc.parse(trailing_chars_str));
+    ASSERT_EQ(doc.get_error_code(), bee::json::ErrorCode::unexpected_character);
+}
+
+TEST(JSONTests, empty_arrays_inside_arrays)
+{
+    char json_str[] = R"([[], [1, [ ]], {"a": []}, [[[]]], 2])";
+    bee::json::Document doc(bee::json::ParseOptions{});
+    const auto success = doc.parse(json_str);
+    ASSERT_TRUE(success) << doc.get_error_string().c_str();
+
+    int count = 0;
+    for (auto handle : doc.get_elements_range(doc.root()))
+    {
+        BEE_UNUSED(handle);
+        ++count;
+    }
+    ASSERT_EQ(count, 5);
+
+    const auto second = doc.get_element(doc.root(), 1);
+    ASSERT_DOUBLE_EQ(doc.get_element_data(second, 0).as_number(), 1.0);
+    ASSERT_EQ(doc.get_element_data(second, 1).type, bee::json::ValueType::array);
+    ASSERT_EQ(doc.get_element_data(doc.root(), 2).type, bee::json::ValueType::object);
+    ASSERT_DOUBLE_EQ(doc.get_element_data(doc.root(), 4).as_number(), 2.0);
+}
+
+TEST(JSONTests, parse_throughput_benchmark)
+{
+    constexpr int object_count = 20000;
+    constexpr int iterations = 10;
+
+    bee::String json_str = "[";
+    for (int i = 0; i < object_count; ++i)
+    {
+        bee::str::format(
+            &json_str,
+            "%s\n  {\n    \"name\": \"Assets/Textures/Texture_%d.png\",\n    \"size\": %d,\n"
+            "    \"scale\": [%d.25, 0.5, 1.0],\n    \"enabled\": %s,\n    \"parent\": null,\n"
+            "    \"path\": \"C:\\\\Assets\\\\Textures\\\\\\\"quoted\\\".png\"\n  }",
+            i > 0 ? "," : "", i, i * 37, i % 7, i % 2 == 0 ? "true" : "false"
+        );
+    }
+    json_str += "\n]";
+
+    bee::String source(json_str.size(), '\0');
+    bee::json::Document doc(bee::json::ParseOptions{});
+    double total_ms = 0.0;
+
+    for (int i = 0; i < iterations; ++i)
+    {
+        // parsing is destructive so needs a fresh copy every time
+        memcpy(source.data(), json_str.c_str(), json_str.size());
+
+        const auto begin = bee::time::now();
+        const auto success = doc.parse(source.data());
+        total_ms += bee::TimePoint(bee::time::now() - begin).total_milliseconds();
+
+        ASSERT_TRUE(success) << doc.get_error_string().c_str();
+    }
+
+    const auto megabytes = static_cast<double>(json_str.size()) / (1024.0 * 1024.0);
+    const auto average_ms = total_ms / iterations;
+    printf("json::Document parse: %.2f MB in %f ms (%.2f MB/s)\n", megabytes, average_ms, megabytes / (average_ms / 1000.0));
+
+    ASSERT_STREQ(
+        doc.get_member_data(doc.get_element(doc.root(), object_count - 1), "path").as_string(),
+        "C:\\Assets\\Textures\\\"quoted\".png"
+    );
+}
+
+TEST(JSONTests, wide_object_member_lookup)
+{
+    constexpr int member_count = 256;
+    constexpr int iterations = 100;
+
+    bee::String json_str = "{";
+    for (int i = 0; i < member_count; ++i)
+    {
+        bee::str::format(&json_str, "\"field_%d\": { \"value\": %d }, ", i, i);
+    }
+    // duplicate keys resolve to the first member, same as iterating
+    json_str += "\"field_0\": -1 }";
+
+    bee::json::ParseOptions indexed_options{};
+    bee::json::ParseOptions linear_options{};
+    linear_options.build_member_index = false;
+
+    bee::String indexed_source(json_str.view());
+    bee::String linear_source(json_str.view());
+    bee::json::Document indexed_doc(indexed_options);
+    bee::json::Document linear_doc(linear_options);
+    ASSERT_TRUE(indexed_doc.parse(indexed_source.data())) << indexed_doc.get_error_string().c_str();
+    ASSERT_TRUE(linear_doc.parse(linear_source.data())) << linear_doc.get_error_string().c_str();
+
+    int count = 0;
+    for (auto& member : indexed_doc.get_members_range(indexed_doc.root()))
+    {
+        BEE_UNUSED(member);
+        ++count;
+    }
+    ASSERT_EQ(count, member_count + 1);
+
+    bee::String keys[member_count];
+    for (int i = 0; i < member_count; ++i)
+    {
+        keys[i] = bee::str::format("field_%d", i);
+
+        const auto indexed = indexed_doc.get_member(indexed_doc.root(), keys[i].c_str());
+        const auto linear = linear_doc.get_member(linear_doc.root(), keys[i].c_str());
+        ASSERT_TRUE(indexed.is_valid()) << keys[i].c_str();
+        ASSERT_EQ(indexed.id, linear.id) << keys[i].c_str();
+        ASSERT_DOUBLE_EQ(indexed_doc.get_member_data(indexed, "value").as_number(), static_cast<double>(i));
+
+        const auto hash = bee::json::get_key_hash(keys[i].c_str(), keys[i].size());
+        ASSERT_EQ(indexed_doc.get_member(indexed_doc.root(), keys[i].c_str(), hash).id, indexed.id);
+    }
+
+    ASSERT_FALSE(indexed_doc.has_member(indexed_doc.root(), "field_256"));
+    ASSERT_FALSE(linear_doc.has_member(linear_doc.root(), "field_256"));
+    ASSERT_FALSE(indexed_doc.has_member(indexed_doc.root(), "value"));
+
+    double indexed_ms = 0.0;
+    double linear_ms = 0.0;
+    int found = 0;
+
+    for (int i = 0; i < iterations; ++i)
+    {
+        auto begin = bee::time::now();
+        for (const auto& key : keys)
+        {
+            found += indexed_doc.has_member(indexed_doc.root(), key.c_str()) ? 1 : 0;
+        }
+        indexed_ms += bee::TimePoint(bee::time::now() - begin).total_milliseconds();
+
+        begin = bee::time::now();
+        for (const auto& key : keys)
+        {
+            found += linear_doc.has_member(linear_doc.root(), key.c_str()) ? 1 : 0;
+        }
+        linear_ms += bee::TimePoint(bee::time::now() - begin).total_milliseconds();
+    }
+
+    printf("json::Document member lookup (%d members): indexed %f ms, linear %f ms\n", member_count, indexed_ms, linear_ms);
+    ASSERT_EQ(found, 2 * iterations * member_count);
+}
+
+TEST(JSONTests, parallel_write_matches_serial)
+{
+    bee::JobSystemInitInfo info{};
+    info.num_workers = bee::JobSystemInitInfo::auto_worker_count;
+    ASSERT_TRUE(bee::job_system_init(info));
+
+    constexpr int object_count = 5000;
+
+    bee::String json_str = "{";
+    for (int i = 0; i < object_count; ++i)
+    {
+        bee::str::format(
+            &json_str,
+            "\"item_%d\": { \"name\": \"Texture_%d\", \"scale\": [%d.25, 0.5, [], {}], \"enabled\": %s, \"parent\": null }, ",
+            i, i, i % 7, i % 2 == 0 ? "true" : "false"
+        );
+    }
+    json_str += "\"last\": 1 }";
+
+    bee::json::Document doc(bee::json::ParseOptions{});
+    ASSERT_TRUE(doc.parse(json_str.data())) << doc.get_error_string().c_str();
+
+    bee::JobGroup group{};
+    bee::String serial;
+    bee::String parallel;
+
+    auto begin = bee::time::now();
+    bee::json::write_to_string(&serial, doc, 4);
+    const auto serial_ms = bee::TimePoint(bee::time::now() - begin).total_milliseconds();
+
+    begin = bee::time::now();
+    bee::json::write_to_string(&parallel, doc, 4, &group);
+    const auto parallel_ms = bee::TimePoint(bee::time::now() - begin).total_milliseconds();
+
+    printf("json::write_to_string (%d members): serial %f ms, parallel %f ms\n", object_count, serial_ms, parallel_ms);
+    ASSERT_EQ(serial.size(), parallel.size());
+    ASSERT_STREQ(serial.c_str(), parallel.c_str());
+
+    // Numeric arrays written through JSONSerializer, nested so that the splice has to match the indentation
+    bee::DynamicArray<float> values;
+    for (int i = 0; i < 100000; ++i)
+    {
+        values.push_back(static_cast<float>(i) * 0.37f - 1000.0f);
+    }
+
+    auto write_values = [&](bee::JSONSerializer* serializer)
+    {
+        serializer->mode = bee::SerializerMode::writing;
+        serializer->begin();
+
+        int member_count = 1;
+        serializer->begin_object(&member_count);
+        bee::String key("values");
+        serializer->serialize_key(&key);
+
+        int count = values.size();
+        serializer->begin_array(&count);
+        serializer->serialize_fundamental_array(bee::FundamentalKind::float_kind, reinterpret_cast<bee::u8*>(values.data()), count);
+        serializer->end_array();
+
+        serializer->end_object();
+        serializer->end();
+    };
+
+    bee::JSONSerializer serial_serializer;
+    bee::JSONSerializer parallel_serializer;
+    parallel_serializer.set_parallel_write_group(&group);
+
+    write_values(&serial_serializer);
+    write_values(&parallel_serializer);
+
+    ASSERT_EQ(serial_serializer.string_size(), parallel_serializer.string_size());
+    ASSERT_STREQ(serial_serializer.c_str(), parallel_serializer.c_str());
+
+    bee::job_system_shutdown();
+}
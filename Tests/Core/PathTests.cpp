@@ -9,6 +9,10 @@
 
 #include <GTest.hpp>
 
+#if BEE_OS_LINUX == 1
+    #include <limits.h>
+#endif // BEE_OS_LINUX == 1
+
 TEST(PathTests, path_returns_correct_executable_path)
 {
     // "../Build/Debug/Tests/"
@@ -73,6 +77,19 @@ TEST(PathTests, exists_returns_false_for_paths_that_dont_exist)
     ASSERT_TRUE(!path.exists());
 }
 
+#if BEE_OS_LINUX == 1
+TEST(PathTests, exists_returns_false_for_paths_longer_than_path_max)
+{
+    bee::Path path("/This/Is/A/Test/Path");
+    for (int i = 0; i < 1000; ++i)
+    {
+        path.append("LongPathSegment");
+    }
+    ASSERT_GE(path.size(), PATH_MAX);
+    ASSERT_FALSE(path.exists());
+}
+#endif // BEE_OS_LINUX == 1
+
 TEST(PathTests, path_returns_filename_for_paths_with_extensions)
 {
     bee::Path path("/This/Is/A/Test/Path.txt");
@@ -215,3 +232,63 @@ TEST(PathTests, string_view_comparison)
     ASSERT_NE(path_with_slashes, path_with_slashes2);
     ASSERT_EQ(path_with_slashes, path_with_repeated_slashes);
 }
+
+TEST(PathTests, static_path_matches_path)
+{
+    bee::Path path("/This/Is/A/Test");
+    bee::StaticPath<64> static_path("/This/Is/A/Test");
+
+    path.append("Path").set_extension("txt").append_extension(".meta");
+    static_path.append("Path").set_extension("txt").append_extension(".meta");
+    ASSERT_EQ(static_path.view(), path.view());
+    ASSERT_EQ(static_path.extension(), ".meta");
+    ASSERT_EQ(bee::str::length(static_path.c_str()), static_path.size());
+
+    path.set_extension("");
+    static_path.set_extension("");
+    ASSERT_EQ(static_path.view(), path.view());
+
+    path.replace_filename("File.bin");
+    static_path.replace_filename("File.bin");
+    ASSERT_EQ(static_path.view(), path.view());
+    ASSERT_EQ(static_path.filename(), "File.bin");
+
+    // appending an absolute path replaces the current one
+    static_path.append("/Absolute/Path");
+    ASSERT_EQ(static_path.view(), "/Absolute/Path");
+
+    static_path.clear();
+    ASSERT_TRUE(static_path.empty());
+    ASSERT_EQ(static_path.append("Relative").append("Path").make_generic().view(), "Relative/Path");
+}
+
+TEST(PathTests, normalize_lexically)
+{
+    const auto normalize = [](const char* str)
+    {
+        return bee::Path(str).normalize_lexically().make_generic();
+    };
+
+    ASSERT_EQ(normalize("/This//Is/./A/Test/../Path/").view(), "/This/Is/A/Path");
+    ASSERT_EQ(normalize("This/Is/../../..").view(), "..");
+    ASSERT_EQ(normalize("../This/../../Is").view(), "../../Is");
+    ASSERT_EQ(normalize("/../This").view(), "/This");
+    ASSERT_EQ(normalize("This/..").view(), ".");
+    ASSERT_EQ(normalize("/").view(), "/");
+
+    bee::StaticPath<64> static_path("/This//Is/./A/Test/../Path/");
+    ASSERT_EQ(static_path.normalize_lexically().make_generic().view(), "/This/Is/A/Path");
+}
+
+TEST(PathTests, hashed_path)
+{
+    const bee::HashedPathView path("/This/Is/A/Test/Path");
+    const bee::HashedPathView repeated_slashes("/This//Is/A///Test/Path");
+    const bee::HashedPathView different_components("/This/Is/AT/est/Path");
+
+    ASSERT_EQ(path.hash, repeated_slashes.hash);
+    ASSERT_EQ(path, repeated_slashes);
+    ASSERT_NE(path.hash, different_components.hash);
+    ASSERT_NE(path, different_components);
+    ASSERT_EQ(bee::get_hash(path), bee::get_hash(repeated_slashes));
+}
@@ -0,0 +1,120 @@
+/*
+ *  ReflectionRegistryTests.cpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#include <Bee/Core/Reflection.hpp>
+
+#include <GTest.hpp>
+
+BEE_PUSH_WARNING
+    BEE_DISABLE_PADDING_WARNINGS
+    #include <atomic>
+    #include <thread>
+BEE_POP_WARNING
+
+
+template <typename T>
+static bee::Type get_registry_test_type()
+{
+    return bee::get_type<T>();
+}
+
+TEST(ReflectionRegistryTests, concurrent_get_type)
+{
+    constexpr int reader_count = 4;
+    constexpr int module_iterations = 2000;
+    constexpr int type_count = 4;
+
+    // The module registers builtin TypeInfos under hashes that aren't used by anything else
+    const bee::get_type_callback_t callbacks[type_count] {
+        get_registry_test_type<bee::i32>,
+        get_registry_test_type<bee::u64>,
+        get_registry_test_type<float>,
+        get_registry_test_type<bool>
+    };
+
+    bee::u32 hashes[type_count];
+    const bee::TypeInfo* expected[type_count];
+
+    for (int i = 0; i < type_count; ++i)
+    {
+        hashes[i] = bee::get_type_hash(bee::str::format("ReflectionRegistryTests::Type%d", i).view());
+        expected[i] = callbacks[i]().get();
+        ASSERT_TRUE(bee::get_type(hashes[i]).is_unknown());
+    }
+
+    std::atomic<bool> done { false };
+    std::atomic<int> started_count { 0 };
+    std::atomic<int> found_count { 0 };
+    std::atomic<int> mismatch_count { 0 };
+    std::thread readers[reader_count];
+
+    for (auto& reader : readers)
+    {
+        reader = std::thread([&]()
+        {
+            started_count.fetch_add(1, std::memory_order_release);
+
+            while (!done.load(std::memory_order_acquire))
+            {
+                for (int i = 0; i < type_count; ++i)
+                {
+                    // A lookup either misses or returns the registered type - never a type read from a freed table
+                    const auto type = bee::get_type(hashes[i]);
+                    if (type.is_unknown())
+                    {
+                        continue;
+                    }
+
+                    if (type.get() == expected[i])
+                    {
+                        found_count.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    else
+                    {
+                        mismatch_count.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+        });
+    }
+
+    while (started_count.load(std::memory_order_acquire) < reader_count)
+    {
+        std::this_thread::yield();
+    }
+
+    // Keep going until the readers have seen the module registered at least once
+    for (int i = 0; i < module_iterations || found_count.load(std::memory_order_relaxed) == 0; ++i)
+    {
+        const auto* module = bee::create_reflection_module("ReflectionRegistryTests", type_count, hashes, callbacks);
+        ASSERT_NE(module, nullptr);
+        ASSERT_EQ(bee::get_type(module, 0).get(), expected[0]);
+        bee::destroy_reflection_module(module);
+    }
+
+    done.store(true, std::memory_order_release);
+
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+
+    ASSERT_EQ(mismatch_count.load(), 0);
+    ASSERT_GT(found_count.load(), 0);
+
+    for (int i = 0; i < type_count; ++i)
+    {
+        ASSERT_TRUE(bee::get_type(hashes[i]).is_unknown());
+    }
+
+    // With no readers left the next publish frees every table retired while they were running
+    const auto* module = bee::create_reflection_module("ReflectionRegistryTests", type_count, hashes, callbacks);
+    ASSERT_EQ(bee::get_retired_type_registry_count(), 0);
+    ASSERT_EQ(bee::get_type(hashes[type_count - 1]).get(), expected[type_count - 1]);
+    bee::destroy_reflection_module(module);
+    ASSERT_EQ(bee::get_retired_type_registry_count(), 0);
+}
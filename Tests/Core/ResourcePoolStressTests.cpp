@@ -6,9 +6,15 @@
  */
 
 #include <Bee/Core/Containers/ResourcePool.hpp>
+#include <Bee/Core/Time.hpp>
 
 #include <GTest.hpp>
 
+BEE_PUSH_WARNING
+    BEE_DISABLE_PADDING_WARNINGS
+    #include <thread>
+BEE_POP_WARNING
+
 struct MockResource {
     static constexpr int new_intval = -1;
     static constexpr char new_charval = '\0';
@@ -32,28 +38,172 @@ constexpr char MockResource::new_charval;
 constexpr int MockResource::deallocated_intval;
 constexpr char MockResource::deallocated_charval;
 
+constexpr bee::u32 stress_test_capacity = 1u << 23u;
+constexpr size_t stress_test_chunk_size = sizeof(MockResource) * (stress_test_capacity / 128u);
+
+// AtomicResourcePool needs chunk capacity * MaxChunks to fit in the 24 index bits of a 32 bit handle. The capacity is
+// kept a multiple of the chunk capacity so every slot is recycled before a fresh one is handed out
+constexpr bee::u32 atomic_stress_test_chunk_capacity = stress_test_capacity / 128u - 1u;
+constexpr bee::u32 atomic_stress_test_capacity = atomic_stress_test_chunk_capacity * 128u;
+constexpr size_t atomic_stress_test_chunk_size = sizeof(MockResource) * atomic_stress_test_chunk_capacity;
+
 TEST(ResourcePoolStressTests, stress_test)
 {
-    bee::ResourcePool<1 << 23, MockResourceHandle, MockResource> stress_test_pool;
-    bee::FixedArray<MockResourceHandle> allocated_handles(stress_test_pool.capacity);
+    bee::ResourcePool<MockResourceHandle, MockResource> stress_test_pool(stress_test_chunk_size);
+    auto allocated_handles = bee::FixedArray<MockResourceHandle>::with_size(stress_test_capacity);
 
-    for (bee::u32 i = 0; i < stress_test_pool.capacity; ++i) {
-        ASSERT_NO_FATAL_FAILURE(allocated_handles.push_back(stress_test_pool.allocate())) << "Index: " << i;
+    for (bee::u32 i = 0; i < stress_test_capacity; ++i) {
+        ASSERT_NO_FATAL_FAILURE(allocated_handles[i] = stress_test_pool.allocate()) << "Index: " << i;
         ASSERT_EQ(allocated_handles[i].version(), 1u);
     }
 
-    ASSERT_EQ(stress_test_pool.allocated_count(), 1u << 23u);
+    ASSERT_EQ(stress_test_pool.size(), stress_test_capacity);
 
-    for (bee::u32 i = 0; i < stress_test_pool.capacity; ++i) {
+    for (bee::u32 i = 0; i < stress_test_capacity; ++i) {
         ASSERT_NO_FATAL_FAILURE(stress_test_pool.deallocate(allocated_handles[i])) << "Index: " << i;
     }
 
-    for (bee::u32 i = 0; i < stress_test_pool.capacity; ++i) {
+    // Free indices are reused in LIFO order so the last handle freed is the first one reallocated
+    for (bee::u32 i = 0; i < stress_test_capacity; ++i) {
         MockResourceHandle handle{};
         ASSERT_NO_FATAL_FAILURE(handle = stress_test_pool.allocate()) << "Index: " << i;
         ASSERT_EQ(handle.version(), 2u) << "Index: " << i;
-        ASSERT_EQ(handle.index(), allocated_handles[i].index()) << "Index: " << i;
+        ASSERT_EQ(handle.index(), allocated_handles[stress_test_capacity - 1 - i].index()) << "Index: " << i;
     }
 }
 
+TEST(ResourcePoolStressTests, atomic_pool_stress_test)
+{
+    bee::AtomicResourcePool<MockResourceHandle, MockResource> stress_test_pool(atomic_stress_test_chunk_size);
+    auto allocated_handles = bee::FixedArray<MockResourceHandle>::with_size(atomic_stress_test_capacity);
+
+    for (bee::u32 i = 0; i < atomic_stress_test_capacity; ++i) {
+        ASSERT_NO_FATAL_FAILURE(allocated_handles[i] = stress_test_pool.allocate()) << "Index: " << i;
+        ASSERT_EQ(allocated_handles[i].version(), 1u);
+    }
+
+    ASSERT_EQ(stress_test_pool.size(), atomic_stress_test_capacity);
+
+    for (bee::u32 i = 0; i < atomic_stress_test_capacity; ++i) {
+        ASSERT_NO_FATAL_FAILURE(stress_test_pool.deallocate(allocated_handles[i])) << "Index: " << i;
+        ASSERT_FALSE(stress_test_pool.is_active(allocated_handles[i])) << "Index: " << i;
+    }
+
+    ASSERT_EQ(stress_test_pool.size(), 0u);
+
+    for (bee::u32 i = 0; i < atomic_stress_test_capacity; ++i) {
+        MockResourceHandle handle{};
+        ASSERT_NO_FATAL_FAILURE(handle = stress_test_pool.allocate()) << "Index: " << i;
+        ASSERT_EQ(handle.version(), 2u) << "Index: " << i;
+    }
+}
+
+/*
+ * Multi-threaded throughput: every thread churns through allocate/deallocate pairs on a shared pool. The locked
+ * `ResourcePool` is the baseline that users had to write by hand before `AtomicResourcePool` existed
+ */
+constexpr int churn_thread_count = 8;
+constexpr int churn_iterations = 1 << 18;
+constexpr int churn_live_handles = 64;
+
+template <typename PoolType, typename AllocateFunc, typename DeallocateFunc>
+double run_churn(PoolType* pool, AllocateFunc&& allocate, DeallocateFunc&& deallocate, std::atomic_int32_t* errors)
+{
+    std::thread threads[churn_thread_count];
 
+    const auto begin = bee::time::now();
+
+    for (auto& t : threads)
+    {
+        t = std::thread([&, pool]()
+        {
+            MockResourceHandle live[churn_live_handles];
+
+            for (int i = 0; i < churn_iterations; ++i)
+            {
+                auto& slot = live[i % churn_live_handles];
+
+                if (i >= churn_live_handles)
+                {
+                    if ((*pool)[slot].intval != i - churn_live_handles)
+                    {
+                        errors->fetch_add(1, std::memory_order_relaxed);
+                    }
+
+                    deallocate(slot);
+                }
+
+                slot = allocate();
+                (*pool)[slot].intval = i;
+            }
+
+            for (auto& handle : live)
+            {
+                deallocate(handle);
+            }
+        });
+    }
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    return bee::TimePoint(bee::time::now() - begin).total_milliseconds();
+}
+
+TEST(ResourcePoolStressTests, multithreaded_churn_throughput)
+{
+    constexpr size_t chunk_size = sizeof(MockResource) * 4096;
+    constexpr double total_ops = static_cast<double>(churn_thread_count) * churn_iterations * 2.0;
+
+    // Baseline: ResourcePool guarded by a mutex
+    std::atomic_int32_t locked_errors { 0 };
+    bee::ResourcePool<MockResourceHandle, MockResource> locked_pool(chunk_size);
+    bee::Mutex mutex;
+
+    const auto locked_time = run_churn(
+        &locked_pool,
+        [&]()
+        {
+            bee::scoped_lock_t lock(mutex);
+            return locked_pool.allocate();
+        },
+        [&](const MockResourceHandle& handle)
+        {
+            bee::scoped_lock_t lock(mutex);
+            locked_pool.deallocate(handle);
+        },
+        &locked_errors
+    );
+
+    // Lock-free pool
+    std::atomic_int32_t atomic_errors { 0 };
+    bee::AtomicResourcePool<MockResourceHandle, MockResource> atomic_pool(chunk_size);
+
+    const auto atomic_time = run_churn(
+        &atomic_pool,
+        [&]()
+        {
+            return atomic_pool.allocate();
+        },
+        [&](const MockResourceHandle& handle)
+        {
+            atomic_pool.deallocate(handle);
+        },
+        &atomic_errors
+    );
+
+    printf(
+        "ResourcePool + Mutex: %f ms (%.2f Mops/s)\nAtomicResourcePool: %f ms (%.2f Mops/s)\n",
+        locked_time, total_ops / (locked_time * 1000.0),
+        atomic_time, total_ops / (atomic_time * 1000.0)
+    );
+
+    ASSERT_EQ(locked_errors.load(), 0);
+    ASSERT_EQ(atomic_errors.load(), 0);
+    ASSERT_EQ(locked_pool.size(), 0u);
+    ASSERT_EQ(atomic_pool.size(), 0u);
+    // The live handles across all threads fit into a single chunk so the atomic pool should never have needed to grow
+    ASSERT_EQ(atomic_pool.chunk_count(), 1u);
+}
@@ -12,10 +12,10 @@
 #include <Bee/Core/Serialization/StreamSerializer.hpp>
 #include <Bee/Core/Serialization/BinarySerializer.hpp>
 #include <Bee/Core/IO.hpp>
+#include <Bee/Core/Time.hpp>
 #include <Bee/Core/Containers/HashMap.hpp>
 
 #include <GTest.hpp>
-#include <rapidjson/filereadstream.h>
 
 
 using namespace bee;
@@ -190,7 +190,7 @@ TEST(SerializationTestsV2, complex_type)
     }
 })";
     String json_str(json_buffer);
-    bee::JSONSerializer serializer(json_str.data(), rapidjson::ParseFlag::kParseInsituFlag);
+    bee::JSONSerializer serializer(json_str.data(), JSONSerializeFlags::parse_in_situ);
     TestStruct test;
     serialize(SerializerMode::reading, &serializer, &test);
     ASSERT_EQ(test.value, 25);
@@ -201,7 +201,7 @@ TEST(SerializationTestsV2, complex_type)
     }
 
     json_str = json_buffer;
-    serializer.reset(json_str.data(), rapidjson::ParseFlag::kParseInsituFlag);
+    serializer.reset(json_str.data(), JSONSerializeFlags::parse_in_situ);
     serialize(SerializerMode::writing, &serializer, &test);
     ASSERT_STREQ(serializer.c_str(), json_buffer);
 }
@@ -303,7 +303,7 @@ TEST(SerializationTestsV2, core_types)
     }
 
     // Test paths
-    auto test_path = Path::executable_path();
+    Path test_path(executable_path());
     serialize(SerializerMode::writing, &serializer, &test_path);
     assert_serialized_datav2(buffer.begin(), test_path, &serialized_size);
 
@@ -330,3 +330,544 @@ TEST(SerializationTestsV2, core_types)
         ASSERT_EQ(val.value, found->value);
     }
 }
+
+template <typename T>
+static void serialize_with_type(const SerializerMode mode, BinarySerializer* serializer, const Type& type, T* data)
+{
+    serializer->mode = mode;
+    serializer->begin();
+    serialize_type(serializer, SerializeTypeParams(type, reinterpret_cast<u8*>(data), system_allocator(), nullptr, SerializationFlags::none));
+    serializer->end();
+}
+
+TEST(SerializationTestsV2, table_format_field_headers)
+{
+    const auto type = get_type_as<VersionedTableStruct, RecordTypeInfo>();
+
+    VersionedTableStruct value{};
+    value.id = 23;
+    value.legacy_flags = 0xF; // removed in the current version so shouldn't be written
+    value.scale = 0.25f;
+    value.hash = 0xDEADBEEFCAFEF00D;
+    value.enabled = true;
+
+    DynamicArray<u8> buffer;
+    BinarySerializer serializer(&buffer);
+    serialize_with_type(SerializerMode::writing, &serializer, Type(type.get()), &value);
+
+    // | version | flags | field count | (type hash | field hash | value) for each field in declaration order
+    io::MemoryStream stream(buffer.data(), buffer.size());
+    RecordHeader header{};
+    i32 field_count = -1;
+    stream.read(&header, sizeof(RecordHeader));
+    stream.read(&field_count, sizeof(i32));
+
+    ASSERT_EQ(header.version, 3);
+    ASSERT_EQ(header.serialization_flags, SerializationFlags::table_format);
+    ASSERT_EQ(field_count, 4);
+
+    for (const Field& field : type->fields)
+    {
+        if (field.version_removed <= 3)
+        {
+            continue;
+        }
+
+        FieldHeader field_header{};
+        stream.read(&field_header, sizeof(FieldHeader));
+        ASSERT_EQ(field_header.type_hash, field.type->hash) << field.name;
+        ASSERT_EQ(field_header.field_hash, field.hash) << field.name;
+        ASSERT_EQ(memcmp(buffer.data() + stream.offset(), reinterpret_cast<const u8*>(&value) + field.offset, field.type->size), 0) << field.name;
+        stream.seek(field.type->size, io::SeekOrigin::current);
+    }
+
+    ASSERT_EQ(stream.offset(), buffer.size());
+
+    auto expected = value;
+    expected.legacy_flags = 0;
+
+    VersionedTableStruct read_value{};
+    serialize_with_type(SerializerMode::reading, &serializer, Type(type.get()), &read_value);
+    ASSERT_EQ(read_value, expected);
+}
+
+TEST(SerializationTestsV2, table_format_old_versions)
+{
+    const auto type = get_type_as<VersionedTableStruct, RecordTypeInfo>();
+
+    VersionedTableStruct value{};
+    value.id = 42;
+    value.legacy_flags = 7;
+    value.scale = 2.0f;
+    value.hash = 0xF00D;
+    value.enabled = true;
+
+    // Write the struct as version 1 did - `hash` didn't exist yet and `legacy_flags` hadn't been removed
+    RecordTypeInfo v1_type = *type;
+    v1_type.serialized_version = 1;
+
+    DynamicArray<u8> v1_buffer;
+    BinarySerializer v1_serializer(&v1_buffer);
+    serialize_with_type(SerializerMode::writing, &v1_serializer, Type(&v1_type), &value);
+
+    // Same version but with the fields written in reverse order, i.e. from a build where they were declared differently
+    Field reversed_fields[8];
+    ASSERT_LE(type->fields.size(), static_array_length(reversed_fields));
+    for (int i = 0; i < type->fields.size(); ++i)
+    {
+        reversed_fields[i] = type->fields[type->fields.size() - 1 - i];
+    }
+
+    RecordTypeInfo v1_reordered_type = v1_type;
+    v1_reordered_type.fields = Span<Field>(reversed_fields, type->fields.size());
+
+    DynamicArray<u8> reordered_buffer;
+    BinarySerializer reordered_serializer(&reordered_buffer);
+    serialize_with_type(SerializerMode::writing, &reordered_serializer, Type(&v1_reordered_type), &value);
+    ASSERT_EQ(reordered_buffer.size(), v1_buffer.size());
+    ASSERT_NE(memcmp(reordered_buffer.data(), v1_buffer.data(), v1_buffer.size()), 0);
+
+    // Reading old data into the current version keeps removed fields it still has storage for and leaves added ones as default
+    auto expected = value;
+    expected.hash = 0;
+
+    VersionedTableStruct read_value{};
+    serialize_with_type(SerializerMode::reading, &v1_serializer, Type(type.get()), &read_value);
+    ASSERT_EQ(read_value, expected);
+
+    /*
+     * The remap plan for version 1 is now cached in declaration order - reading the reordered data has the same type
+     * and version but different field headers at each position so the plan has to be invalidated rather than used
+     */
+    new (&read_value) VersionedTableStruct{};
+    serialize_with_type(SerializerMode::reading, &reordered_serializer, Type(type.get()), &read_value);
+    ASSERT_EQ(read_value, expected);
+
+    // ...and reading the original order again has to repair the plan the other way
+    new (&read_value) VersionedTableStruct{};
+    serialize_with_type(SerializerMode::reading, &v1_serializer, Type(type.get()), &read_value);
+    ASSERT_EQ(read_value, expected);
+
+    // A field whose type has changed since the data was written can't be remapped
+    Field changed_fields[8];
+    for (int i = 0; i < type->fields.size(); ++i)
+    {
+        changed_fields[i] = type->fields[i];
+        if (str::compare(changed_fields[i].name, "scale") == 0)
+        {
+            changed_fields[i].type = get_type<double>();
+        }
+    }
+
+    RecordTypeInfo changed_type = v1_type;
+    changed_type.fields = Span<Field>(changed_fields, type->fields.size());
+
+    DynamicArray<u8> changed_buffer;
+    BinarySerializer changed_serializer(&changed_buffer);
+    serialize_with_type(SerializerMode::writing, &changed_serializer, Type(&changed_type), &value);
+
+    new (&read_value) VersionedTableStruct{};
+    ASSERT_DEATH(serialize_with_type(SerializerMode::reading, &changed_serializer, Type(type.get()), &read_value), "detected missing field");
+}
+
+TEST(SerializationTestsV2, packed_archive_relative_pointers)
+{
+    constexpr int vertex_count = 4096;
+
+    PackedArchiveWriter writer;
+    const auto mesh = writer.allocate<PackedMesh>();
+    const auto vertices = writer.allocate<PackedVertex>(vertex_count);
+    const auto submeshes = writer.allocate<PackedSubmesh>(3);
+
+    for (int i = 0; i < vertex_count; ++i)
+    {
+        auto& vertex = writer.get(vertices)[i];
+        vertex.position[0] = static_cast<float>(i);
+        vertex.uv[1] = static_cast<float>(i) * 0.5f;
+    }
+
+    for (int i = 0; i < submeshes.count; ++i)
+    {
+        writer.get(submeshes)[i] = { i * 100, 100 };
+    }
+
+    writer.get(mesh)->flags = 0xF00D;
+    writer.link(&writer.get(mesh)->vertices, vertices);
+    writer.link(&writer.get(mesh)->submeshes, submeshes);
+    writer.link(&writer.get(mesh)->lod0, submeshes);
+
+    DynamicArray<u8> archive;
+    ASSERT_TRUE(writer.finish(mesh, &archive));
+    ASSERT_EQ(writer.fixup_count(), 0);
+
+    // Relative pointers don't need any fixups so the archive can be used from read-only memory
+    auto* data = BEE_MALLOC_ALIGNED(system_allocator(), archive.size(), packed_archive_payload_alignment);
+    memcpy(data, archive.data(), archive.size());
+
+    const auto* loaded = get_packed_archive_root<PackedMesh>(data, archive.size());
+    ASSERT_NE(loaded, nullptr);
+    ASSERT_EQ(loaded->flags, 0xF00Du);
+    ASSERT_EQ(loaded->vertices.size(), vertex_count);
+    ASSERT_EQ(loaded->submeshes.size(), 3);
+    ASSERT_FLOAT_EQ(loaded->vertices[vertex_count - 1].position[0], static_cast<float>(vertex_count - 1));
+    ASSERT_FLOAT_EQ(loaded->vertices[100].uv[1], 50.0f);
+    ASSERT_EQ(loaded->submeshes[2].first_index, 200);
+    ASSERT_EQ(loaded->lod0->index_count, 100);
+
+    // Wrong root type or a truncated archive is rejected
+    ASSERT_EQ(get_packed_archive_root<PackedShader>(data, archive.size()), nullptr);
+    ASSERT_EQ(get_packed_archive_root<PackedMesh>(data, archive.size() - 1), nullptr);
+    BEE_FREE(system_allocator(), data);
+
+    // Memory mapped from disk
+    const auto path = fs::roots().data.join("PackedMesh.bin");
+    ASSERT_EQ(fs::write_all(path.view(), archive.data(), archive.size()), archive.size());
+    {
+        PackedArchiveFile file;
+        const auto* mapped = file.open<PackedMesh>(path.view());
+        ASSERT_NE(mapped, nullptr);
+        ASSERT_TRUE(file.is_mapped());
+        ASSERT_FLOAT_EQ(mapped->vertices[1234].position[0], 1234.0f);
+        ASSERT_EQ(mapped->lod0->first_index, 0);
+    }
+    ASSERT_TRUE(fs::remove(path.view()));
+}
+
+TEST(SerializationTestsV2, packed_archive_pointer_fixups)
+{
+    const char vertex_code[] = "float4 main() : SV_Position { return 0; }";
+    const char pixel_code[] = "float4 main() : SV_Target { return 1; }";
+
+    PackedArchiveWriter writer;
+    const auto vertex_shader = writer.allocate<PackedShader>();
+    const auto pixel_shader = writer.allocate<PackedShader>();
+    const auto vertex_source = writer.write(vertex_code, static_cast<i32>(sizeof(vertex_code)));
+    const auto pixel_source = writer.write(pixel_code, static_cast<i32>(sizeof(pixel_code)));
+
+    writer.get(vertex_shader)->stage = 0;
+    writer.get(vertex_shader)->code_size = vertex_source.count;
+    writer.link(&writer.get(vertex_shader)->code, vertex_source);
+    writer.link(&writer.get(vertex_shader)->next_stage, pixel_shader);
+
+    writer.get(pixel_shader)->stage = 1;
+    writer.get(pixel_shader)->code_size = pixel_source.count;
+    writer.link(&writer.get(pixel_shader)->code, pixel_source);
+
+    DynamicArray<u8> archive;
+    ASSERT_TRUE(writer.finish(vertex_shader, &archive));
+    ASSERT_EQ(writer.fixup_count(), 3);
+
+    auto* data = BEE_MALLOC_ALIGNED(system_allocator(), archive.size(), packed_archive_payload_alignment);
+    memcpy(data, archive.data(), archive.size());
+
+    // Raw pointers have to be fixed up before the archive can be used
+    ASSERT_EQ(get_packed_archive_root<PackedShader>(data, archive.size()), nullptr);
+
+    const auto* loaded = load_packed_archive_in_place<PackedShader>(data, archive.size());
+    ASSERT_NE(loaded, nullptr);
+    ASSERT_STREQ(loaded->code, vertex_code);
+    ASSERT_NE(loaded->next_stage, nullptr);
+    ASSERT_EQ(loaded->next_stage->stage, 1);
+    ASSERT_STREQ(loaded->next_stage->code, pixel_code);
+    ASSERT_EQ(loaded->next_stage->next_stage, nullptr);
+
+    // Loading again is a no-op
+    ASSERT_EQ(load_packed_archive_in_place<PackedShader>(data, archive.size()), loaded);
+    ASSERT_STREQ(loaded->next_stage->code, pixel_code);
+    BEE_FREE(system_allocator(), data);
+
+    const auto path = fs::roots().data.join("PackedShader.bin");
+    ASSERT_EQ(fs::write_all(path.view(), archive.data(), archive.size()), archive.size());
+    {
+        PackedArchiveFile file;
+        const auto* shader = file.open<PackedShader>(path.view());
+        ASSERT_NE(shader, nullptr);
+        ASSERT_FALSE(file.is_mapped());
+        ASSERT_STREQ(shader->next_stage->code, pixel_code);
+    }
+    ASSERT_TRUE(fs::remove(path.view()));
+}
+
+TEST(SerializationTestsV2, packed_archive_root_type)
+{
+    PackedArchiveWriter writer;
+    const auto root = writer.allocate<PrimitivesStructV2>();
+    DynamicArray<u8> archive;
+
+    // Only packed records that can be relocated with a memcpy can be the root of an archive
+    ASSERT_DEATH(writer.finish(get_type<i32>(), root.value, &archive), "must be a reflected record");
+    ASSERT_DEATH(writer.finish(root, &archive), "must be marked `format = packed`");
+
+    // GeneratedSerializerStruct is packed but its String field owns memory outside the archive
+    ASSERT_DEATH(writer.finish(get_type<GeneratedSerializerStruct>(), root.value, &archive), "can't be relocated");
+
+    const auto mesh = writer.allocate<PackedMesh>();
+    ASSERT_TRUE(writer.finish(mesh, &archive));
+}
+
+static void assert_same_bytes(const DynamicArray<u8>& generated, const DynamicArray<u8>& reflected)
+{
+    ASSERT_EQ(generated.size(), reflected.size());
+    for (int i = 0; i < generated.size(); ++i)
+    {
+        ASSERT_EQ(generated[i], reflected[i]) << "generated and reflected output differ at byte " << i;
+    }
+}
+
+TEST(SerializationTestsV2, generated_binary_serializer)
+{
+    const auto generated_type = get_type_as<GeneratedSerializerStruct, RecordTypeInfo>();
+    ASSERT_NE(generated_type->binary_serializer_function, nullptr);
+
+    // Table formats and custom serializers always use reflection
+    const auto table_type = get_type_as<PrimitivesStructV2, RecordTypeInfo>();
+    const auto builder_type = get_type_as<PrimitivesStructV3, RecordTypeInfo>();
+    ASSERT_EQ(table_type->binary_serializer_function, nullptr);
+    ASSERT_EQ(builder_type->binary_serializer_function, nullptr);
+
+    // Copy the type without its generated serializer to force serialize_type to use the reflected fields
+    RecordTypeInfo reflected_type = *generated_type;
+    reflected_type.binary_serializer_function = nullptr;
+
+    GeneratedSerializerStruct value{};
+    value.id = 23;
+    value.flags = 0xF00D;
+    value.kind = GeneratedSerializerKind::shader;
+    value.scale = 0.5f;
+    value.cached = 100;
+    value.weight = 12.25;
+    value.is_visible = true;
+    value.lod = 3;
+    value.name = "Generated";
+    value.parent.value = 42;
+    value.hash = 0xDEADBEEFCAFEF00D;
+
+    // Default, populated and limit values - the generated runs have to match reflection byte for byte in each case
+    GeneratedSerializerStruct limits_value = value;
+    limits_value.id = limits::min<i32>();
+    limits_value.flags = limits::max<u32>();
+    limits_value.kind = GeneratedSerializerKind::texture;
+    limits_value.scale = -limits::max<float>();
+    limits_value.weight = limits::min<double>();
+    limits_value.lod = limits::max<u8>();
+    limits_value.name = "A name long enough to not fit in the small string buffer";
+    limits_value.hash = limits::max<u64>();
+
+    GeneratedSerializerStruct values[] = { GeneratedSerializerStruct{}, value, limits_value };
+
+    DynamicArray<u8> generated_buffer;
+    DynamicArray<u8> reflected_buffer;
+    BinarySerializer generated_serializer(&generated_buffer);
+    BinarySerializer reflected_serializer(&reflected_buffer);
+
+    for (auto& test_value : values)
+    {
+        serialize_with_type(SerializerMode::writing, &generated_serializer, Type(generated_type.get()), &test_value);
+        serialize_with_type(SerializerMode::writing, &reflected_serializer, Type(&reflected_type), &test_value);
+        assert_same_bytes(generated_buffer, reflected_buffer);
+    }
+
+    // Unversioned sources skip the record header - the rest of the output still has to match
+    generated_serializer.source_flags = SerializerSourceFlags::all;
+    reflected_serializer.source_flags = SerializerSourceFlags::all;
+    serialize_with_type(SerializerMode::writing, &generated_serializer, Type(generated_type.get()), &value);
+    serialize_with_type(SerializerMode::writing, &reflected_serializer, Type(&reflected_type), &value);
+    assert_same_bytes(generated_buffer, reflected_buffer);
+    generated_serializer.source_flags = SerializerSourceFlags::none;
+    reflected_serializer.source_flags = SerializerSourceFlags::none;
+
+    serialize_with_type(SerializerMode::writing, &generated_serializer, Type(generated_type.get()), &value);
+    serialize_with_type(SerializerMode::writing, &reflected_serializer, Type(&reflected_type), &value);
+    assert_same_bytes(generated_buffer, reflected_buffer);
+
+    auto expected = value;
+    expected.cached = 0; // nonserialized
+
+    GeneratedSerializerStruct read_value{};
+    serialize_with_type(SerializerMode::reading, &generated_serializer, Type(generated_type.get()), &read_value);
+    ASSERT_EQ(read_value, expected);
+    ASSERT_EQ(generated_serializer.read_offset, generated_buffer.size());
+
+    new (&read_value) GeneratedSerializerStruct{};
+    serialize_with_type(SerializerMode::reading, &reflected_serializer, Type(&reflected_type), &read_value);
+    ASSERT_EQ(read_value, expected);
+
+    // Compare the cost of both paths
+    constexpr int iterations = 100000;
+    DynamicArray<u8> bench_buffer;
+    BinarySerializer bench_serializer(&bench_buffer);
+    bench_buffer.reserve(generated_buffer.size());
+
+    auto begin = time::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        serialize_with_type(SerializerMode::writing, &bench_serializer, Type(generated_type.get()), &value);
+    }
+    const auto generated_ms = TimePoint(time::now() - begin).total_milliseconds();
+
+    begin = time::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        serialize_with_type(SerializerMode::writing, &bench_serializer, Type(&reflected_type), &value);
+    }
+    const auto reflected_ms = TimePoint(time::now() - begin).total_milliseconds();
+
+    printf("Generated binary serializer: %f ms\nReflected binary serializer: %f ms\n", generated_ms, reflected_ms);
+    ASSERT_EQ(bench_buffer.size(), generated_buffer.size());
+}
+
+TEST(SerializationTestsV2, bulk_arrays)
+{
+    DynamicArray<u8> buffer;
+    BinarySerializer serializer(&buffer);
+
+    // Fundamentals are written as the element count followed by the raw array
+    auto floats = FixedArray<float>::with_size(1024);
+    for (int i = 0; i < floats.size(); ++i)
+    {
+        floats[i] = static_cast<float>(i) * 0.25f;
+    }
+
+    serialize(SerializerMode::writing, &serializer, &floats);
+    ASSERT_EQ(buffer.size(), sizeof(i32) + floats.size() * sizeof(float));
+    ASSERT_EQ(*reinterpret_cast<i32*>(buffer.data()), floats.size());
+    ASSERT_EQ(memcmp(buffer.data() + sizeof(i32), floats.data(), floats.size() * sizeof(float)), 0);
+
+    FixedArray<float> read_floats;
+    serialize(SerializerMode::reading, &serializer, &read_floats);
+    ASSERT_EQ(read_floats.size(), floats.size());
+    ASSERT_EQ(memcmp(read_floats.data(), floats.data(), floats.size() * sizeof(float)), 0);
+
+    // Enums are serialized in bulk as their underlying type
+    DynamicArray<GeneratedSerializerKind> kinds = { GeneratedSerializerKind::shader, GeneratedSerializerKind::mesh, GeneratedSerializerKind::texture };
+    serialize(SerializerMode::writing, &serializer, &kinds);
+    ASSERT_EQ(buffer.size(), sizeof(i32) + kinds.size() * sizeof(GeneratedSerializerKind));
+
+    DynamicArray<GeneratedSerializerKind> read_kinds;
+    serialize(SerializerMode::reading, &serializer, &read_kinds);
+    ASSERT_EQ(read_kinds.size(), kinds.size());
+    for (int i = 0; i < kinds.size(); ++i)
+    {
+        ASSERT_EQ(read_kinds[i], kinds[i]);
+    }
+
+    // Packed records are only copied in bulk if they're serialized without a version and flags header
+    DynamicArray<PackedSubmesh> submeshes;
+    for (int i = 0; i < 64; ++i)
+    {
+        submeshes.push_back(PackedSubmesh { i * 3, i + 1 });
+    }
+
+    serialize(SerializerMode::writing, &serializer, &submeshes);
+    ASSERT_EQ(buffer.size(), sizeof(i32) + submeshes.size() * (sizeof(RecordHeader) + sizeof(PackedSubmesh)));
+
+    serialize(SerializerMode::writing, SerializerSourceFlags::all, &serializer, &submeshes);
+    ASSERT_EQ(buffer.size(), sizeof(i32) + submeshes.size() * sizeof(PackedSubmesh));
+    ASSERT_EQ(memcmp(buffer.data() + sizeof(i32), submeshes.data(), submeshes.size() * sizeof(PackedSubmesh)), 0);
+
+    DynamicArray<PackedSubmesh> read_submeshes;
+    serialize(SerializerMode::reading, SerializerSourceFlags::all, &serializer, &read_submeshes);
+    ASSERT_EQ(read_submeshes.size(), submeshes.size());
+    ASSERT_EQ(memcmp(read_submeshes.data(), submeshes.data(), submeshes.size() * sizeof(PackedSubmesh)), 0);
+    serializer.source_flags = SerializerSourceFlags::none;
+
+    // JSON arrays are written and read in a single batch
+    DynamicArray<double> doubles = { 0.5, -1.25, 100.0, 3.0e10 };
+    JSONSerializer json_serializer;
+    serialize(SerializerMode::writing, &json_serializer, &doubles);
+
+    String json(json_serializer.c_str());
+    json_serializer.reset(json.data(), JSONSerializeFlags::none);
+
+    DynamicArray<double> read_doubles;
+    serialize(SerializerMode::reading, &json_serializer, &read_doubles);
+    ASSERT_EQ(read_doubles.size(), doubles.size());
+    for (int i = 0; i < doubles.size(); ++i)
+    {
+        ASSERT_EQ(read_doubles[i], doubles[i]);
+    }
+}
+
+template <typename SerializerType>
+static void serialize_floats_individually(const SerializerMode mode, SerializerType* serializer, FixedArray<float>* array)
+{
+    serializer->mode = mode;
+    serializer->begin();
+    i32 count = array->size();
+    serializer->begin_array(&count);
+    if (mode == SerializerMode::reading)
+    {
+        array->resize(count);
+    }
+    serializer->Serializer::serialize_fundamental_array(FundamentalKind::float_kind, reinterpret_cast<u8*>(array->data()), count);
+    serializer->end_array();
+    serializer->end();
+}
+
+TEST(SerializationTestsV2, bulk_array_benchmark)
+{
+    constexpr int vertex_count = 1000000;
+
+    auto vertices = FixedArray<float>::with_size(vertex_count);
+    for (int i = 0; i < vertex_count; ++i)
+    {
+        vertices[i] = static_cast<float>(i % 1000) * 0.125f;
+    }
+
+    // Binary
+    DynamicArray<u8> bulk_buffer;
+    DynamicArray<u8> individual_buffer;
+    BinarySerializer bulk_serializer(&bulk_buffer);
+    BinarySerializer individual_serializer(&individual_buffer);
+    FixedArray<float> read_vertices;
+
+    auto begin = time::now();
+    serialize(SerializerMode::writing, &bulk_serializer, &vertices);
+    const auto bulk_write_ms = TimePoint(time::now() - begin).total_milliseconds();
+
+    begin = time::now();
+    serialize(SerializerMode::reading, &bulk_serializer, &read_vertices);
+    const auto bulk_read_ms = TimePoint(time::now() - begin).total_milliseconds();
+    ASSERT_EQ(memcmp(read_vertices.data(), vertices.data(), vertex_count * sizeof(float)), 0);
+
+    begin = time::now();
+    serialize_floats_individually(SerializerMode::writing, &individual_serializer, &vertices);
+    const auto individual_write_ms = TimePoint(time::now() - begin).total_milliseconds();
+
+    begin = time::now();
+    serialize_floats_individually(SerializerMode::reading, &individual_serializer, &read_vertices);
+    const auto individual_read_ms = TimePoint(time::now() - begin).total_milliseconds();
+
+    ASSERT_EQ(bulk_buffer.size(), individual_buffer.size());
+    ASSERT_EQ(memcmp(bulk_buffer.data(), individual_buffer.data(), bulk_buffer.size()), 0);
+
+    printf(
+        "Binary bulk write: %f ms read: %f ms\nBinary per-element write: %f ms read: %f ms\n",
+        bulk_write_ms, bulk_read_ms, individual_write_ms, individual_read_ms
+    );
+
+    // JSON - the batched output has to be identical to writing each element individually
+    JSONSerializer bulk_json;
+    JSONSerializer individual_json;
+
+    begin = time::now();
+    serialize(SerializerMode::writing, &bulk_json, &vertices);
+    const auto json_bulk_write_ms = TimePoint(time::now() - begin).total_milliseconds();
+
+    begin = time::now();
+    serialize_floats_individually(SerializerMode::writing, &individual_json, &vertices);
+    const auto json_individual_write_ms = TimePoint(time::now() - begin).total_milliseconds();
+
+    ASSERT_STREQ(bulk_json.c_str(), individual_json.c_str());
+
+    String json(bulk_json.c_str());
+    bulk_json.reset(json.data(), JSONSerializeFlags::parse_in_situ);
+    read_vertices.clear();
+
+    begin = time::now();
+    serialize(SerializerMode::reading, &bulk_json, &read_vertices);
+    const auto json_bulk_read_ms = TimePoint(time::now() - begin).total_milliseconds();
+    ASSERT_EQ(memcmp(read_vertices.data(), vertices.data(), vertex_count * sizeof(float)), 0);
+
+    printf("JSON bulk write: %f ms read: %f ms\nJSON per-element write: %f ms\n", json_bulk_write_ms, json_bulk_read_ms, json_individual_write_ms);
+}
@@ -9,6 +9,7 @@
 
 #include <Bee/Core/Reflection.hpp>
 #include <Bee/Core/Serialization/Serialization.hpp>
+#include <Bee/Core/Serialization/PackedArchive.hpp>
 
 namespace bee {
 
@@ -134,6 +135,35 @@ BEE_SERIALIZE_TYPE(SerializationBuilder* builder, PrimitivesStructV3* data)
 }
 
 
+// Version 1 had `legacy_flags`, version 2 added `hash` and version 3 removed `legacy_flags`
+struct BEE_REFLECT(serializable, version = 3, format = table) VersionedTableStruct
+{
+    BEE_REFLECT(id = 0, added = 1)
+    i32     id { -1 };
+
+    BEE_REFLECT(id = 1, added = 1, removed = 3)
+    u8      legacy_flags { 0 };
+
+    BEE_REFLECT(id = 2, added = 1)
+    float   scale { 1.0f };
+
+    BEE_REFLECT(id = 3, added = 2)
+    u64     hash { 0 };
+
+    BEE_REFLECT(id = 4, added = 1)
+    bool    enabled { false };
+};
+
+inline bool operator==(const VersionedTableStruct& lhs, const VersionedTableStruct& rhs)
+{
+    return lhs.id == rhs.id
+        && lhs.legacy_flags == rhs.legacy_flags
+        && lhs.scale == rhs.scale
+        && lhs.hash == rhs.hash
+        && lhs.enabled == rhs.enabled;
+}
+
+
 struct BEE_REFLECT(serializable) Id
 {
     u32 value { 0 };
@@ -167,4 +197,74 @@ struct BEE_REFLECT(serializable) TestStruct
 };
 
 
+struct BEE_REFLECT(serializable, format = packed) PackedVertex
+{
+    float position[3] { 0.0f, 0.0f, 0.0f };
+    float uv[2] { 0.0f, 0.0f };
+};
+
+struct BEE_REFLECT(serializable, format = packed) PackedSubmesh
+{
+    i32 first_index { 0 };
+    i32 index_count { 0 };
+};
+
+struct BEE_REFLECT(serializable, format = packed) PackedMesh
+{
+    u32                         flags { 0 };
+    RelativeArray<PackedVertex> vertices;
+    RelativeArray<PackedSubmesh> submeshes;
+    RelativePtr<PackedSubmesh>  lod0;
+};
+
+struct BEE_REFLECT(serializable, format = packed) PackedShader
+{
+    i32                 stage { 0 };
+    i32                 code_size { 0 };
+    const char*         code { nullptr };
+    const PackedShader* next_stage { nullptr };
+};
+
+
+enum class BEE_REFLECT(serializable) GeneratedSerializerKind : i32
+{
+    mesh,
+    texture,
+    shader
+};
+
+struct BEE_REFLECT(serializable, format = packed) GeneratedSerializerStruct
+{
+    i32                     id { 0 };
+    u32                     flags { 0 };
+    GeneratedSerializerKind kind { GeneratedSerializerKind::mesh };
+    float                   scale { 1.0f };
+
+    BEE_REFLECT(nonserialized)
+    i32                     cached { 0 };
+
+    double                  weight { 0.0 };
+    bool                    is_visible { false };
+    u8                      lod { 0 };
+    String                  name;
+    Id                      parent;
+    u64                     hash { 0 };
+};
+
+inline bool operator==(const GeneratedSerializerStruct& lhs, const GeneratedSerializerStruct& rhs)
+{
+    return lhs.id == rhs.id
+        && lhs.flags == rhs.flags
+        && lhs.kind == rhs.kind
+        && lhs.scale == rhs.scale
+        && lhs.cached == rhs.cached
+        && lhs.weight == rhs.weight
+        && lhs.is_visible == rhs.is_visible
+        && lhs.lod == rhs.lod
+        && lhs.name == rhs.name
+        && lhs.parent.value == rhs.parent.value
+        && lhs.hash == rhs.hash;
+}
+
+
 } // namespace bee
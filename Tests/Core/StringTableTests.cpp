@@ -0,0 +1,136 @@
+/*
+ *  StringTableTests.cpp
+ *  Bee
+ *
+ *  Copyright (c) 2021 Jacob Milligan. All rights reserved.
+ */
+
+#include <Bee/Core/StringTable.hpp>
+#include <Bee/Core/Time.hpp>
+
+#include <GTest.hpp>
+
+BEE_PUSH_WARNING
+    BEE_DISABLE_PADDING_WARNINGS
+    #include <thread>
+BEE_POP_WARNING
+
+TEST(StringTableTests, interning_is_unique)
+{
+    bee::StringTable table;
+
+    const auto a = table.intern("Bee.Core");
+    const auto b = table.intern(bee::String("Bee.Core").view());
+    const auto c = table.intern("Bee.AssetPipeline");
+
+    ASSERT_TRUE(a.is_valid());
+    ASSERT_EQ(a, b);
+    ASSERT_EQ(a.entry(), b.entry());
+    ASSERT_NE(a, c);
+    ASSERT_EQ(table.size(), 2);
+
+    ASSERT_STREQ(a.c_str(), "Bee.Core");
+    ASSERT_EQ(a.size(), 8);
+    ASSERT_EQ(a, bee::StringView("Bee.Core"));
+    ASSERT_EQ(a.hash(), bee::get_hash(bee::StringView("Bee.Core")));
+    ASSERT_EQ(bee::get_hash(a), a.hash());
+}
+
+TEST(StringTableTests, find_does_not_intern)
+{
+    bee::StringTable table;
+
+    ASSERT_FALSE(table.find("not interned").is_valid());
+    ASSERT_EQ(table.size(), 0);
+
+    const auto interned = table.intern("interned");
+    ASSERT_EQ(table.find("interned"), interned);
+
+    // Empty and default-constructed strings are distinct
+    const auto empty = table.intern("");
+    ASSERT_TRUE(empty.is_valid());
+    ASSERT_TRUE(empty.empty());
+    ASSERT_NE(empty, bee::InternedString{});
+    ASSERT_STREQ(bee::InternedString{}.c_str(), "");
+}
+
+TEST(StringTableTests, large_strings_get_their_own_block)
+{
+    bee::StringTable table(256);
+    bee::String large(1024, 'x');
+
+    const auto small = table.intern("small");
+    const auto interned = table.intern(large.view());
+
+    ASSERT_EQ(interned.view(), large.view());
+    ASSERT_STREQ(small.c_str(), "small");
+    ASSERT_GE(table.allocated_size(), 256u + 1024u);
+}
+
+TEST(StringTableTests, concurrent_interning)
+{
+    constexpr int thread_count = 8;
+    constexpr int string_count = 4096;
+
+    bee::StringTable table;
+    bee::InternedString results[thread_count][string_count];
+    std::thread threads[thread_count];
+
+    for (int t = 0; t < thread_count; ++t)
+    {
+        threads[t] = std::thread([&, t]()
+        {
+            for (int i = 0; i < string_count; ++i)
+            {
+                // every thread interns the same set of strings in a different order
+                const int index = (i + t * 127) % string_count;
+                const auto string = bee::str::format("Assets/Textures/Texture_%d.png", index);
+                results[t][index] = table.intern(string.view());
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(table.size(), string_count);
+
+    for (int t = 1; t < thread_count; ++t)
+    {
+        for (int i = 0; i < string_count; ++i)
+        {
+            ASSERT_EQ(results[t][i], results[0][i]) << "Thread: " << t << " String: " << i;
+        }
+    }
+}
+
+TEST(StringTableTests, lookup_benchmark)
+{
+    constexpr int iterations = 1 << 20;
+    const bee::StringView name = "ShaderPipeline.Compiler.EntryPoint.main_fragment";
+
+    bee::StringTable table;
+    const auto interned = table.intern(name);
+    const auto other = table.intern("ShaderPipeline.Compiler.EntryPoint.main_vertex");
+    int matches = 0;
+
+    auto begin = bee::time::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        const auto hash = bee::get_hash(name);
+        matches += hash == bee::get_hash(name) && name == bee::StringView("ShaderPipeline.Compiler.EntryPoint.main_fragment");
+    }
+    const auto string_ms = bee::TimePoint(bee::time::now() - begin).total_milliseconds();
+
+    begin = bee::time::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        matches += interned == (i % 2 == 0 ? interned : other);
+    }
+    const auto interned_ms = bee::TimePoint(bee::time::now() - begin).total_milliseconds();
+
+    printf("StringView hash + compare: %f ms\nInternedString compare: %f ms\n", string_ms, interned_ms);
+    ASSERT_EQ(matches, iterations + iterations / 2);
+}
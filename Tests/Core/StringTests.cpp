@@ -8,6 +8,10 @@
 #include <Bee/Core/String.hpp>
 #include <Bee/Core/Memory/MallocAllocator.hpp>
 #include <Bee/Core/Memory/LinearAllocator.hpp>
+#include <Bee/Core/Memory/Memory.hpp>
+#include <Bee/Core/Time.hpp>
+#include <Bee/Core/Path.hpp>
+#include <Bee/Core/Serialization/JSONSerializer.hpp>
 
 #include <GTest.hpp>
 
@@ -16,7 +20,8 @@ TEST(StringTests, construct_copy_move)
     bee::MallocAllocator malloc_allocator;
     bee::LinearAllocator linear_allocator(bee::kilobytes(4));
 
-    const char* raw_test_string = "Test string 1";
+    // long enough to not fit in the small buffer so the allocator is used
+    const char* raw_test_string = "Test string 1 - allocated on the heap";
 
     // Test construction
     bee::String string_a(&malloc_allocator);
@@ -27,14 +32,15 @@ TEST(StringTests, construct_copy_move)
     {
         ASSERT_STREQ(string.data(), "\0");
         ASSERT_EQ(string.size(), 0);
-        ASSERT_EQ(string.capacity(), 0);
+        ASSERT_EQ(string.capacity(), bee::String::small_buffer_capacity);
     };
 
     auto test_string_b = [](const bee::String& string, const char* char_sequence)
     {
         ASSERT_STREQ(string.c_str(), char_sequence);
         ASSERT_EQ(string.size(), 10);
-        ASSERT_EQ(string.capacity(), 11);
+        ASSERT_EQ(string.capacity(), bee::String::small_buffer_capacity);
+        ASSERT_TRUE(string.is_small());
     };
 
     auto test_string_c = [](const bee::String& string, const char* raw_string)
@@ -42,13 +48,15 @@ TEST(StringTests, construct_copy_move)
         ASSERT_STREQ(string.c_str(), raw_string);
         ASSERT_EQ(string.size(), strlen(raw_string));
         ASSERT_EQ(string.capacity(), strlen(raw_string) + 1);
+        ASSERT_FALSE(string.is_small());
     };
 
     auto test_moved_from = [](const bee::String& string)
     {
         ASSERT_EQ(string.allocator(), nullptr);
         ASSERT_EQ(string.size(), 0);
-        ASSERT_EQ(string.capacity(), 0);
+        ASSERT_EQ(string.capacity(), bee::String::small_buffer_capacity);
+        ASSERT_STREQ(string.c_str(), "");
     };
 
     test_string_a(string_a);
@@ -85,7 +93,7 @@ TEST(StringTests, construct_copy_move)
     test_moved_from(string_c);
 
     // Test copy and move with different allocators
-    const char* raw_allocator_string = "Allocator test 1";
+    const char* raw_allocator_string = "Allocator test 1 - allocated on the heap";
     bee::String allocator_test_a(&linear_allocator);
     bee::String allocator_test_b(10, 'y', &linear_allocator);
     bee::String allocator_test_c(raw_allocator_string, &linear_allocator);
@@ -110,7 +118,7 @@ TEST(StringTests, construct_copy_move)
 
     /*
      * Test memory allocated is as expected with the new allocator. Need to check each allocation was aligned correctly
-     * by the allocator
+     * by the allocator. Strings stored in the small buffer shouldn't have allocated anything
      */
     bee::String* strings[] = { &allocator_test_a, &allocator_test_b, &allocator_test_c, &copy_a, &copy_b, &copy_c };
     int total_size = 0;
@@ -118,7 +126,7 @@ TEST(StringTests, construct_copy_move)
     for (const auto& s : strings)
     {
         total_size += s->size();
-        if (!s->empty())
+        if (!s->is_small())
         {
             expected_size = bee::round_up(expected_size + sizeof(size_t), sizeof(void*)) + s->size() + 1;
         }
@@ -136,6 +144,69 @@ TEST(StringTests, construct_copy_move)
     ASSERT_EQ(linear_allocator.offset(), expected_size);
 }
 
+TEST(StringTests, small_buffer)
+{
+    bee::MallocAllocator allocator;
+    bee::String string("small", &allocator);
+
+    ASSERT_TRUE(string.is_small());
+    ASSERT_STREQ(string.c_str(), "small");
+
+    // The small buffer reuses the heap pointer, size and capacity so String is no bigger than it was without it
+    ASSERT_EQ(sizeof(bee::String), sizeof(bee::Allocator*) + sizeof(char*) + 2 * sizeof(bee::i32));
+
+    // fill the small buffer right up to the null-terminator
+    string.append("-that-fits");
+    ASSERT_EQ(string.size(), bee::String::small_buffer_capacity - 1);
+    ASSERT_TRUE(string.is_small());
+    ASSERT_STREQ(string.c_str(), "small-that-fits");
+
+    // grows onto the heap and keeps the existing contents
+    string.append('!');
+    ASSERT_FALSE(string.is_small());
+    ASSERT_STREQ(string.c_str(), "small-that-fits!");
+    ASSERT_GE(string.capacity(), bee::String::small_buffer_capacity + 1);
+
+    // Shrinking a heap string keeps the heap buffer
+    string.resize(2);
+    ASSERT_FALSE(string.is_small());
+    ASSERT_STREQ(string.c_str(), "sm");
+
+    // Clearing or shrinking a small string keeps the size and null-terminator in step
+    bee::String cleared("cleared", &allocator);
+    cleared.clear();
+    ASSERT_TRUE(cleared.empty());
+    ASSERT_STREQ(cleared.c_str(), "");
+    cleared.append("abc");
+    cleared.remove(1);
+    ASSERT_EQ(cleared.size(), 1);
+    ASSERT_STREQ(cleared.c_str(), "a");
+
+    // Moving a small string copies the buffer rather than stealing a pointer
+    bee::String small("moved", &allocator);
+    bee::String moved(std::move(small));
+    ASSERT_STREQ(moved.c_str(), "moved");
+    ASSERT_STREQ(small.c_str(), "");
+    ASSERT_NE(moved.c_str(), small.c_str());
+
+    /*
+     * Containers memmove their elements around so small strings must not store a pointer to their own buffer -
+     * inserting at the front of the array shifts every string in memory
+     */
+    bee::DynamicArray<bee::String> array(&allocator);
+    for (int i = 0; i < 32; ++i)
+    {
+        array.emplace_back(bee::str::format("string %d", i).view(), &allocator);
+    }
+    array.insert(0, bee::String("first", &allocator));
+    array.erase(10);
+
+    ASSERT_STREQ(array[0].c_str(), "first");
+    ASSERT_STREQ(array[1].c_str(), "string 0");
+    ASSERT_STREQ(array[10].c_str(), "string 10");
+    ASSERT_STREQ(array.back().c_str(), "string 31");
+}
+
 TEST(StringTests, append)
 {
     auto string = bee::String("Test string");
@@ -273,6 +344,401 @@ TEST(StringTests, replace)
     ASSERT_STREQ(string.c_str(), "Replace the smaller string");
 }
 
+TEST(StringTests, long_string_search)
+{
+    // Long enough to exercise the vectorized search kernels as well as their scalar tails
+    bee::String string(1000, '.');
+    string[0] = 'x';
+    string[17] = 'x';
+    string[500] = 'x';
+    string[998] = 'x';
+    bee::str::replace_range(&string, 40, 4, "node");
+    bee::str::replace_range(&string, 700, 4, "node");
+    bee::str::replace_range(&string, 995, 4, "node");
+
+    ASSERT_EQ(bee::str::first_index_of(string, 'x'), 0);
+    ASSERT_EQ(bee::str::last_index_of(string, 'x'), 500);
+    ASSERT_EQ(bee::str::first_index_of(string, '?'), -1);
+    ASSERT_EQ(bee::str::last_index_of(string, '?'), -1);
+
+    ASSERT_EQ(bee::str::first_index_of(string, "node"), 40);
+    ASSERT_EQ(bee::str::last_index_of(string, "node"), 995);
+    ASSERT_EQ(bee::str::first_index_of(string, "nodes"), -1);
+    ASSERT_EQ(bee::str::last_index_of(string, ".x."), 499);
+
+    for (int i = 0; i < string.size(); ++i)
+    {
+        const auto view = bee::str::substring(string, i);
+        ASSERT_EQ(bee::str::first_index_of(view, "de"), i <= 42 ? 42 - i : (i <= 702 ? 702 - i : (i <= 997 ? 997 - i : -1)));
+        ASSERT_EQ(bee::str::last_index_of(view, 'n'), i <= 995 ? 995 - i : -1);
+    }
+
+    bee::String other(string);
+    ASSERT_EQ(bee::str::compare(string, other), 0);
+    other[900] = 'y';
+    ASSERT_LT(bee::str::compare(string, other), 0);
+    ASSERT_GT(bee::str::compare(other, string), 0);
+    ASSERT_LT(bee::str::compare(bee::str::substring(string, 0, 900), other.view()), 0);
+}
+
+TEST(StringTests, replace_grow_and_shrink)
+{
+    bee::String string;
+    for (int i = 0; i < 100; ++i)
+    {
+        string += "a/b/";
+    }
+
+    bee::str::replace(&string, "/", "::");
+    ASSERT_EQ(string.size(), 600);
+    ASSERT_EQ(bee::str::first_index_of(string, "a::b::a::b"), 0);
+    ASSERT_EQ(bee::str::first_index_of(string, '/'), -1);
+
+    bee::str::replace(&string, "::", "/");
+    ASSERT_EQ(string.size(), 400);
+    ASSERT_EQ(bee::str::first_index_of(string, ':'), -1);
+
+    bee::str::replace_n(&string, "a/", "path/", 2);
+    ASSERT_EQ(bee::str::first_index_of(string, "path/b/path/b/a/b/"), 0);
+    ASSERT_EQ(string.size(), 406);
+}
+
+TEST(StringTests, ascii_wchar_conversion)
+{
+    bee::String string(300, 'a');
+    for (int i = 0; i < string.size(); ++i)
+    {
+        string[i] = static_cast<char>('!' + i % 90);
+    }
+
+    wchar_t wide[300];
+    ASSERT_EQ(bee::str::widen_ascii(string.c_str(), string.size(), wide, 300), 300);
+
+    char narrow[300];
+    ASSERT_EQ(bee::str::narrow_ascii(wide, 300, narrow, 300), 300);
+    ASSERT_EQ(bee::StringView(narrow, 300), string.view());
+
+    // conversion stops at the first non-ASCII char or when the destination is full
+    string[200] = static_cast<char>(0xC3);
+    ASSERT_EQ(bee::str::widen_ascii(string.c_str(), string.size(), wide, 300), 200);
+    ASSERT_EQ(bee::str::widen_ascii(string.c_str(), string.size(), wide, 50), 50);
+
+    wide[123] = 0x00E9;
+    ASSERT_EQ(bee::str::narrow_ascii(wide, 300, narrow, 300), 123);
+}
+
+/*
+ * Two readable pages followed by an inaccessible guard page - strings placed against the guard page fault if any of
+ * the search or compare kernels load past their end, and strings placed across the first page boundary exercise the
+ * kernels blocks that straddle a page
+ */
+struct GuardedPages
+{
+    size_t  page_size { 0 };
+    char*   pages { nullptr };
+
+    GuardedPages()
+        : page_size(bee::get_page_size())
+    {
+        pages = static_cast<char*>(bee::vm_map(page_size * 3));
+        bee::guard_memory(pages + page_size * 2, page_size, bee::MemoryProtectionMode::none);
+    }
+
+    ~GuardedPages()
+    {
+        bee::guard_memory(pages + page_size * 2, page_size, bee::MemoryProtectionMode::read | bee::MemoryProtectionMode::write);
+        bee::vm_unmap(pages, page_size * 3);
+    }
+
+    // Returns a buffer of `size` chars that ends exactly at the guard page
+    char* end_of_buffer(const int size)
+    {
+        return pages + page_size * 2 - size;
+    }
+
+    // Returns a buffer whose first `offset` chars are on the first page and the rest on the second
+    char* across_page(const int offset)
+    {
+        return pages + page_size - offset;
+    }
+};
+
+TEST(StringTests, search_at_end_of_buffer)
+{
+    GuardedPages guarded;
+
+    for (int size = 1; size <= 100; ++size)
+    {
+        auto* buffer = guarded.end_of_buffer(size);
+        memset(buffer, '.', size);
+        const bee::StringView view(buffer, size);
+
+        ASSERT_EQ(bee::str::first_index_of(view, 'x'), -1) << "Size: " << size;
+        ASSERT_EQ(bee::str::last_index_of(view, 'x'), -1) << "Size: " << size;
+        ASSERT_EQ(bee::str::first_index_of(view, "xy"), -1) << "Size: " << size;
+        ASSERT_EQ(bee::str::last_index_of(view, "xy"), -1) << "Size: " << size;
+
+        buffer[size - 1] = 'x';
+        ASSERT_EQ(bee::str::first_index_of(view, 'x'), size - 1) << "Size: " << size;
+        ASSERT_EQ(bee::str::last_index_of(view, 'x'), size - 1) << "Size: " << size;
+
+        if (size >= 2)
+        {
+            buffer[size - 2] = 'w';
+            ASSERT_EQ(bee::str::first_index_of(view, "wx"), size - 2) << "Size: " << size;
+            ASSERT_EQ(bee::str::last_index_of(view, "wx"), size - 2) << "Size: " << size;
+        }
+    }
+}
+
+TEST(StringTests, compare_at_end_of_buffer)
+{
+    GuardedPages guarded;
+    const bee::String lhs(100, 'a');
+
+    // `rhs` is null-terminated right before the guard page and shorter than the count given to compare_n
+    for (int length = 0; length < 100; ++length)
+    {
+        auto* rhs = guarded.end_of_buffer(length + 1);
+        memset(rhs, 'a', length);
+        rhs[length] = '\0';
+
+        const auto lhs_prefix = bee::str::substring(lhs, 0, length);
+
+        ASSERT_GT(bee::str::compare_n(lhs, rhs, lhs.size()), 0) << "Length: " << length;
+        ASSERT_EQ(bee::str::compare_n(lhs_prefix, rhs, length), 0) << "Length: " << length;
+        ASSERT_LT(bee::str::compare_n(rhs, lhs.c_str(), lhs.size()), 0) << "Length: " << length;
+        ASSERT_EQ(bee::str::compare(bee::StringView(rhs, length), lhs_prefix), 0) << "Length: " << length;
+    }
+}
+
+TEST(StringTests, compare_and_search_across_page_boundary)
+{
+    GuardedPages guarded;
+    const bee::String lhs(128, 'a');
+
+    // Move the page boundary through every position in the first few 32-char blocks
+    for (int offset = 1; offset <= 96; ++offset)
+    {
+        auto* rhs = guarded.across_page(offset);
+        memset(rhs, 'a', 128);
+        rhs[128] = '\0';
+
+        ASSERT_EQ(bee::str::compare_n(lhs, rhs, 128), 0) << "Offset: " << offset;
+
+        rhs[offset] = 'b';
+        ASSERT_LT(bee::str::compare_n(lhs, rhs, 128), 0) << "Offset: " << offset;
+        ASSERT_EQ(bee::str::first_index_of(bee::StringView(rhs, 128), 'b'), offset) << "Offset: " << offset;
+        ASSERT_EQ(bee::str::last_index_of(bee::StringView(rhs, 128), "ab"), offset - 1) << "Offset: " << offset;
+
+        rhs[offset] = 'a';
+        rhs[offset - 1] = '\0';
+        ASSERT_GT(bee::str::compare_n(lhs, rhs, 128), 0) << "Offset: " << offset;
+    }
+}
+
+/*
+ * Benchmarks - compares the `str` search functions against the plain byte loops they used to be implemented with
+ */
+static int naive_first_index_of(const bee::StringView& src, const char* substring, const int substring_size)
+{
+    for (int i = 0; i + substring_size <= src.size(); ++i)
+    {
+        int j = 0;
+        while (j < substring_size && src[i + j] == substring[j])
+        {
+            ++j;
+        }
+
+        if (j == substring_size)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static int naive_first_index_of(const bee::StringView& src, const char character)
+{
+    for (int i = 0; i < src.size(); ++i)
+    {
+        if (src[i] == character)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+TEST(StringTests, search_benchmark)
+{
+    constexpr int iterations = 200;
+
+    // Something that looks like shader source - lots of partial matches for the substring
+    bee::String source;
+    while (source.size() < 1024 * 1024)
+    {
+        source += "float4 main_fragment(VertexOutput input) : SV_Target { return input.color * main_texture.Sample(); }\n";
+    }
+    const auto expected_index = source.size() + 7;
+    source += "float4 main_vertex(VertexInput input)";
+
+    const char* substring = "main_vertex";
+    const int substring_size = bee::str::length(substring);
+    int found = 0;
+
+    auto begin = bee::time::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        found += naive_first_index_of(source.view(), substring, substring_size) == expected_index;
+    }
+    const auto naive_substring_ms = bee::TimePoint(bee::time::now() - begin).total_milliseconds();
+
+    begin = bee::time::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        found += bee::str::first_index_of(source.view(), substring) == expected_index;
+    }
+    const auto substring_ms = bee::TimePoint(bee::time::now() - begin).total_milliseconds();
+
+    begin = bee::time::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        found += naive_first_index_of(source.view(), '#') == -1;
+    }
+    const auto naive_char_ms = bee::TimePoint(bee::time::now() - begin).total_milliseconds();
+
+    begin = bee::time::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        found += bee::str::first_index_of(source.view(), '#') == -1;
+    }
+    const auto char_ms = bee::TimePoint(bee::time::now() - begin).total_milliseconds();
+
+    bee::String copy(source.view());
+    begin = bee::time::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        found += bee::str::compare(source, copy) == 0;
+    }
+    const auto compare_ms = bee::TimePoint(bee::time::now() - begin).total_milliseconds();
+
+    printf(
+        "first_index_of(substring): naive %f ms, str %f ms\n"
+        "first_index_of(char): naive %f ms, str %f ms\n"
+        "compare: %f ms\n",
+        naive_substring_ms, substring_ms, naive_char_ms, char_ms, compare_ms
+    );
+
+    ASSERT_EQ(found, iterations * 5);
+}
+
+/*
+ * Counts every allocation made by strings in the Path and JSONSerializer workloads below to show how many are avoided
+ * by storing short strings in the small buffer
+ */
+class CountingAllocator final : public bee::MallocAllocator
+{
+public:
+    int allocation_count { 0 };
+
+    void* allocate(size_t size, size_t alignment) override
+    {
+        ++allocation_count;
+        return MallocAllocator::allocate(size, alignment);
+    }
+
+    void* allocate(size_t size) override
+    {
+        ++allocation_count;
+        return MallocAllocator::allocate(size);
+    }
+
+    void* reallocate(void* ptr, size_t old_size, size_t new_size, size_t alignment) override
+    {
+        ++allocation_count;
+        return MallocAllocator::reallocate(ptr, old_size, new_size, alignment);
+    }
+};
+
+TEST(StringTests, small_buffer_allocation_benchmark)
+{
+    constexpr int count = 10000;
+    char buffer[256];
+
+    // Path workload - short relative asset paths built up from components
+    CountingAllocator path_allocator;
+    int path_string_count = 0;
+
+    auto begin = bee::time::now();
+    for (int i = 0; i < count; ++i)
+    {
+        bee::Path path("Textures", &path_allocator);
+        bee::str::format_buffer(buffer, bee::static_array_length(buffer), "tex_%d", i % 100);
+        path.append(buffer);
+        path.append_extension(i % 2 == 0 ? "png" : "texture_asset");
+        path_string_count += path.size() > 0 ? 1 : 0;
+    }
+    const auto path_ms = bee::TimePoint(bee::time::now() - begin).total_milliseconds();
+
+    // JSONSerializer workload - an array of asset names with a few long paths mixed in
+    bee::DynamicArray<bee::String> names;
+    int long_name_count = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (i % 10 == 0)
+        {
+            names.emplace_back(bee::str::format("Assets/Textures/Characters/Hero/diffuse_%d.png", i).view());
+            ++long_name_count;
+        }
+        else
+        {
+            names.emplace_back(bee::str::format("asset_%d", i).view());
+        }
+    }
+
+    bee::JSONSerializer writer;
+    bee::serialize(bee::SerializerMode::writing, &writer, &names);
+    const bee::String json(writer.c_str());
+
+    /*
+     * Reading into an array of the same size doesn't reconstruct the elements so this lets us control the allocator
+     * used by each string the serializer reads into
+     */
+    CountingAllocator json_allocator;
+    bee::DynamicArray<bee::String> deserialized;
+    for (int i = 0; i < count; ++i)
+    {
+        deserialized.emplace_back(&json_allocator);
+    }
+
+    begin = bee::time::now();
+    bee::JSONSerializer reader(json.c_str(), bee::JSONSerializeFlags::none);
+    bee::serialize(bee::SerializerMode::reading, &reader, &deserialized);
+    const auto json_ms = bee::TimePoint(bee::time::now() - begin).total_milliseconds();
+
+    printf(
+        "Path: %d paths, %d allocations (%f ms)\n"
+        "JSONSerializer: %d strings, %d allocations - %d without the small buffer (%f ms)\n",
+        path_string_count, path_allocator.allocation_count, path_ms,
+        count, json_allocator.allocation_count, count, json_ms
+    );
+
+    ASSERT_EQ(deserialized.size(), names.size());
+    for (int i = 0; i < count; ++i)
+    {
+        ASSERT_EQ(deserialized[i], names[i]);
+    }
+
+    // "Textures/tex_N" fits in the small buffer so each path only allocates once its extension is appended
+    ASSERT_LE(path_allocator.allocation_count, count);
+    // Only the long names needed to allocate - each one exactly once
+    ASSERT_EQ(json_allocator.allocation_count, long_name_count);
+}
+
 TEST(StringTests, substring)
 {
     bee::String string("Test string for substring testing");
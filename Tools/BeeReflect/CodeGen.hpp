@@ -95,6 +95,11 @@ public:
 
     void serializer_function(const char* field_name, const char* specialized_type_name);
 
+    inline void require_serialization_header()
+    {
+        include_serialization_header_ = true;
+    }
+
     template <typename LambdaType>
     void scope(LambdaType&& lambda)
     {
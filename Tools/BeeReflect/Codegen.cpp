@@ -531,6 +531,152 @@ void codegen_field(const FieldStorage& storage, const char* attributes_array_nam
     });
 }
 
+/*
+ * Binary serializers write fundamentals and enums as raw bytes so any fields of those types that are next to each
+ * other in both memory and serialization order can be read/written in a single block without going through reflection
+ */
+static bool is_serialized_at_current_version(const Field& field, const i32 version)
+{
+    if (field.version_added <= 0 || version < field.version_added || version >= field.version_removed)
+    {
+        return false;
+    }
+
+    return (field.qualifier & (Qualifier::lvalue_ref | Qualifier::rvalue_ref | Qualifier::pointer)) == Qualifier::none;
+}
+
+static bool is_binary_run_field(const FieldStorage& storage)
+{
+    const auto& field = storage.field;
+
+    if (field.template_argument_in_parent >= 0 || has_serializer_function(storage))
+    {
+        return false;
+    }
+
+    // `bytes` fields are prefixed with their size
+    if (((field.serialization_flags | field.type->serialization_flags) & SerializationFlags::bytes) != SerializationFlags::none)
+    {
+        return false;
+    }
+
+    auto type = field.type;
+
+    if (type->is(TypeKind::enum_decl))
+    {
+        const auto as_enum = type->as<EnumTypeInfo>();
+        if (as_enum->constants.empty())
+        {
+            return false;
+        }
+        type = as_enum->constants[0].underlying_type;
+    }
+
+    if (!type->is(TypeKind::fundamental) || type->size != field.type->size)
+    {
+        return false;
+    }
+
+    // long types are serialized as 32 bit values regardless of their size on the target platform
+    const auto kind = type->as<FundamentalTypeInfo>()->fundamental_kind;
+    return kind != FundamentalKind::long_kind && kind != FundamentalKind::unsigned_long_kind;
+}
+
+static bool codegen_binary_serializer(const RecordTypeStorage* storage, CodeGenerator* codegen)
+{
+    const auto& type = storage->type;
+    const auto version = type.serialized_version;
+
+    if (version <= 0 || type.is(TypeKind::template_decl))
+    {
+        return false;
+    }
+
+    // Custom serializers, table formats etc. are always handled by reflection
+    const auto unsupported_flags = SerializationFlags::uses_builder | SerializationFlags::table_format | SerializationFlags::bytes;
+    if ((type.serialization_flags & SerializationFlags::packed_format) == SerializationFlags::none || (type.serialization_flags & unsupported_flags) != SerializationFlags::none)
+    {
+        return false;
+    }
+
+    const auto has_run = find_index_if(storage->fields, [&](const FieldStorage& field)
+    {
+        return is_serialized_at_current_version(field.field, version) && is_binary_run_field(field);
+    }) >= 0;
+
+    if (!has_run)
+    {
+        return false;
+    }
+
+    const char* type_ident = codegen->as_ident(type);
+    codegen->write("static auto %s__binary_serializer_function = [](Serializer* serializer, const SerializeTypeParams& params)", type_ident);
+    codegen->scope([&]()
+    {
+        int run_begin = -1;
+        int run_last = -1;
+        size_t run_end_offset = 0;
+
+        const auto end_run = [&]()
+        {
+            if (run_begin < 0)
+            {
+                return;
+            }
+
+            const auto run_offset = storage->fields[run_begin].field.offset;
+            codegen->write_line(
+                "serialize_binary_run(serializer, params.data + %zu, %zu); // %s..%s",
+                run_offset,
+                run_end_offset - run_offset,
+                storage->fields[run_begin].field.name,
+                storage->fields[run_last].field.name
+            );
+            run_begin = -1;
+        };
+
+        for (const auto field_storage : enumerate(storage->fields))
+        {
+            const auto& field = field_storage.value.field;
+
+            if (!is_serialized_at_current_version(field, version))
+            {
+                continue;
+            }
+
+            if (!is_binary_run_field(field_storage.value))
+            {
+                end_run();
+                codegen->write_line(
+                    "serialize_record_field(serializer, %s__fields[%d], params);",
+                    codegen->as_ident(type),
+                    field_storage.index
+                );
+                continue;
+            }
+
+            // A field that isn't directly after the previous one in memory (i.e. padding or a nonserialized field) starts a new run
+            if (run_begin >= 0 && field.offset != run_end_offset)
+            {
+                end_run();
+            }
+
+            if (run_begin < 0)
+            {
+                run_begin = field_storage.index;
+            }
+
+            run_last = field_storage.index;
+            run_end_offset = field.offset + field.type->size;
+        }
+
+        end_run();
+    }, ";");
+    codegen->newline(2);
+    codegen->require_serialization_header();
+    return true;
+}
+
 void codegen_array_type(CodeGenerator* codegen, ArrayTypeStorage* storage)
 {
     if (storage->is_generated)
@@ -860,6 +1006,8 @@ void codegen_record(CodeGenerator* codegen, const RecordTypeStorage* storage)
 
         codegen_create_instance(storage->type, codegen);
 
+        const auto has_binary_serializer = codegen_binary_serializer(storage, codegen);
+
         codegen->write("static RecordTypeInfo instance");
         codegen->scope([&]()
         {
@@ -929,6 +1077,11 @@ void codegen_record(CodeGenerator* codegen, const RecordTypeStorage* storage)
                 codegen->append_line("{}");
             }
 
+            if (has_binary_serializer)
+            {
+                codegen->append_line(", %s__binary_serializer_function", codegen->as_ident(storage->type));
+            }
+
         }, ";\n\n");
         codegen->write_line("return Type(&instance);");
     });